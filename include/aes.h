@@ -3,7 +3,10 @@
 
 /* AES for 128, 192 & 256 bits keys
  * Checks for AES-NI support (amd64) & auto uses it
+ *  - VAES (AVX2 / AVX-512) for bulk work when present
+ *  - or uses SSSE3 vector permute fallback
  *  - or uses pure c fallback
+ * Backend is picked once per process, or at compile-time with CRYPTOCORE_ASSUME_* (see common.h)
  * Features:
  *  - Key & schedule types (full, enc-focused, dec-focused)
  *  - Helper macros for typed key literals
@@ -12,6 +15,7 @@
  */
 
 #include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
 #include <stdbool.h>
 #include "common.h"
 
@@ -46,10 +50,20 @@ typedef struct { uint8_t bytes[176]; } aes128_sched_dec_t;  /* 11 round keys = 1
 typedef struct { uint8_t bytes[208]; } aes192_sched_dec_t;  /* 13 round keys = 208 bytes */
 typedef struct { uint8_t bytes[240]; } aes256_sched_dec_t;  /* 15 round keys = 240 bytes */
 
+/* Schedule layouts (round keys as 16 byte blocks, R = rounds)
+ *   full: k0 ... kR, then InvMixColumns(kR-1 ... k1) in decryption usage order
+ *   enc:  k0 ... kR
+ *   dec:  k0, InvMixColumns(k1 ... kR-1), kR (same offsets as enc, decryption walks it back to front) */
+typedef enum {
+    AES_SCHED_FULL = 0,
+    AES_SCHED_ENC  = 1,
+    AES_SCHED_DEC  = 2
+} aes_sched_type_t;
+
 /* --- Key schedule generators --- (writes to provided array) */
-void aes128_load_key_internal(const aes128_key_t* key, aes128_sched_full_t* schedule, bool full);
-void aes192_load_key_internal(const aes192_key_t* key, aes192_sched_full_t* schedule, bool full);
-void aes256_load_key_internal(const aes256_key_t* key, aes256_sched_full_t* schedule, bool full);
+void aes128_load_key_internal(const aes128_key_t* key, uint8_t* schedule, aes_sched_type_t type);
+void aes192_load_key_internal(const aes192_key_t* key, uint8_t* schedule, aes_sched_type_t type);
+void aes256_load_key_internal(const aes256_key_t* key, uint8_t* schedule, aes_sched_type_t type);
 
 INLINE void aes128_load_key(const aes128_key_t* key, aes128_sched_full_t* schedule);
 INLINE void aes192_load_key(const aes192_key_t* key, aes192_sched_full_t* schedule);
@@ -63,6 +77,24 @@ INLINE void aes128_load_key_dec(const aes128_key_t* key, aes128_sched_dec_t* sch
 INLINE void aes192_load_key_dec(const aes192_key_t* key, aes192_sched_dec_t* schedule);
 INLINE void aes256_load_key_dec(const aes256_key_t* key, aes256_sched_dec_t* schedule);
 
+/* --- Batched key schedule generators --- (num_keys keys in, num_keys contiguous schedules out)
+ * Expands several keys at once (interleaved on AES-NI), for rekeying many sessions together */
+void aes128_load_keys_internal(const aes128_key_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type);
+void aes192_load_keys_internal(const aes192_key_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type);
+void aes256_load_keys_internal(const aes256_key_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type);
+
+INLINE void aes128_load_keys(const aes128_key_t* keys, aes128_sched_full_t* schedules, size_t num_keys);
+INLINE void aes192_load_keys(const aes192_key_t* keys, aes192_sched_full_t* schedules, size_t num_keys);
+INLINE void aes256_load_keys(const aes256_key_t* keys, aes256_sched_full_t* schedules, size_t num_keys);
+
+INLINE void aes128_load_keys_enc(const aes128_key_t* keys, aes128_sched_enc_t* schedules, size_t num_keys);
+INLINE void aes192_load_keys_enc(const aes192_key_t* keys, aes192_sched_enc_t* schedules, size_t num_keys);
+INLINE void aes256_load_keys_enc(const aes256_key_t* keys, aes256_sched_enc_t* schedules, size_t num_keys);
+
+INLINE void aes128_load_keys_dec(const aes128_key_t* keys, aes128_sched_dec_t* schedules, size_t num_keys);
+INLINE void aes192_load_keys_dec(const aes192_key_t* keys, aes192_sched_dec_t* schedules, size_t num_keys);
+INLINE void aes256_load_keys_dec(const aes256_key_t* keys, aes256_sched_dec_t* schedules, size_t num_keys);
+
 /* --- Encrypt blocks transforms --- (in-place operation allowed) */
 void aes128_encrypt_blocks(const aes128_sched_enc_t*  schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks);
 void aes192_encrypt_blocks(const aes192_sched_enc_t*  schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks);
@@ -71,6 +103,17 @@ void aes256_encrypt_blocks(const aes256_sched_enc_t*  schedule, const uint8_t (*
 void aes128_decrypt_blocks(const aes128_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
 void aes192_decrypt_blocks(const aes192_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
 void aes256_decrypt_blocks(const aes256_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+/* --- Decrypt blocks transforms (dec schedules) --- (in-place operation allowed) */
+void aes128_decrypt_blocks_dec(const aes128_sched_dec_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes192_decrypt_blocks_dec(const aes192_sched_dec_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes256_decrypt_blocks_dec(const aes256_sched_dec_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+/* --- Decrypt blocks transforms (enc schedules) --- (in-place operation allowed, round keys inverted once per call) */
+void aes128_decrypt_blocks_enc(const aes128_sched_enc_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes192_decrypt_blocks_enc(const aes192_sched_enc_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes256_decrypt_blocks_enc(const aes256_sched_enc_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+
+/* Re-pick the backend after toggling _hardware (pointer table builds only) */
+void aes_dispatch_update(void);
 
 /* --- Encrypt block transforms --- (in-place operation allowed) */
 INLINE void aes128_encrypt_block(const aes128_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]);
@@ -80,19 +123,76 @@ INLINE void aes256_encrypt_block(const aes256_sched_enc_t*  schedule, const uint
 INLINE void aes128_decrypt_block(const aes128_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
 INLINE void aes192_decrypt_block(const aes192_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
 INLINE void aes256_decrypt_block(const aes256_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
+/* --- Decrypt block transforms (dec schedules) --- (in-place operation allowed) */
+INLINE void aes128_decrypt_block_dec(const aes128_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
+INLINE void aes192_decrypt_block_dec(const aes192_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
+INLINE void aes256_decrypt_block_dec(const aes256_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
+/* --- Decrypt block transforms (enc schedules) --- (in-place operation allowed) */
+INLINE void aes128_decrypt_block_enc(const aes128_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
+INLINE void aes192_decrypt_block_enc(const aes192_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
+INLINE void aes256_decrypt_block_enc(const aes256_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]);
 
 
 
 /* --- END OF API --- */
 
 /* --- Inline definitions --- */
-INLINE void aes128_load_key(const aes128_key_t* key, aes128_sched_full_t* schedule)         { aes128_load_key_internal(key, schedule, true ); }
-INLINE void aes192_load_key(const aes192_key_t* key, aes192_sched_full_t* schedule)         { aes192_load_key_internal(key, schedule, true ); }
-INLINE void aes256_load_key(const aes256_key_t* key, aes256_sched_full_t* schedule)         { aes256_load_key_internal(key, schedule, true ); }
-INLINE void aes128_load_key_enc_only(const aes128_key_t* key, aes128_sched_enc_t* schedule) { aes128_load_key_internal(key, schedule, false); }
-INLINE void aes192_load_key_enc_only(const aes192_key_t* key, aes192_sched_enc_t* schedule) { aes192_load_key_internal(key, schedule, false); }
-INLINE void aes256_load_key_enc_only(const aes256_key_t* key, aes256_sched_enc_t* schedule) { aes256_load_key_internal(key, schedule, false); }
-
+INLINE void aes128_load_key(const aes128_key_t* key, aes128_sched_full_t* schedule)    { aes128_load_key_internal(key, schedule->bytes, AES_SCHED_FULL); }
+INLINE void aes192_load_key(const aes192_key_t* key, aes192_sched_full_t* schedule)    { aes192_load_key_internal(key, schedule->bytes, AES_SCHED_FULL); }
+INLINE void aes256_load_key(const aes256_key_t* key, aes256_sched_full_t* schedule)    { aes256_load_key_internal(key, schedule->bytes, AES_SCHED_FULL); }
+INLINE void aes128_load_key_enc(const aes128_key_t* key, aes128_sched_enc_t* schedule) { aes128_load_key_internal(key, schedule->bytes, AES_SCHED_ENC ); }
+INLINE void aes192_load_key_enc(const aes192_key_t* key, aes192_sched_enc_t* schedule) { aes192_load_key_internal(key, schedule->bytes, AES_SCHED_ENC ); }
+INLINE void aes256_load_key_enc(const aes256_key_t* key, aes256_sched_enc_t* schedule) { aes256_load_key_internal(key, schedule->bytes, AES_SCHED_ENC ); }
+INLINE void aes128_load_key_dec(const aes128_key_t* key, aes128_sched_dec_t* schedule) { aes128_load_key_internal(key, schedule->bytes, AES_SCHED_DEC ); }
+INLINE void aes192_load_key_dec(const aes192_key_t* key, aes192_sched_dec_t* schedule) { aes192_load_key_internal(key, schedule->bytes, AES_SCHED_DEC ); }
+INLINE void aes256_load_key_dec(const aes256_key_t* key, aes256_sched_dec_t* schedule) { aes256_load_key_internal(key, schedule->bytes, AES_SCHED_DEC ); }
+
+INLINE void aes128_load_keys(const aes128_key_t* keys, aes128_sched_full_t* schedules, size_t num_keys)    { aes128_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_FULL); }
+INLINE void aes192_load_keys(const aes192_key_t* keys, aes192_sched_full_t* schedules, size_t num_keys)    { aes192_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_FULL); }
+INLINE void aes256_load_keys(const aes256_key_t* keys, aes256_sched_full_t* schedules, size_t num_keys)    { aes256_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_FULL); }
+INLINE void aes128_load_keys_enc(const aes128_key_t* keys, aes128_sched_enc_t* schedules, size_t num_keys) { aes128_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_ENC ); }
+INLINE void aes192_load_keys_enc(const aes192_key_t* keys, aes192_sched_enc_t* schedules, size_t num_keys) { aes192_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_ENC ); }
+INLINE void aes256_load_keys_enc(const aes256_key_t* keys, aes256_sched_enc_t* schedules, size_t num_keys) { aes256_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_ENC ); }
+INLINE void aes128_load_keys_dec(const aes128_key_t* keys, aes128_sched_dec_t* schedules, size_t num_keys) { aes128_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_DEC ); }
+INLINE void aes192_load_keys_dec(const aes192_key_t* keys, aes192_sched_dec_t* schedules, size_t num_keys) { aes192_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_DEC ); }
+INLINE void aes256_load_keys_dec(const aes256_key_t* keys, aes256_sched_dec_t* schedules, size_t num_keys) { aes256_load_keys_internal(keys, schedules->bytes, num_keys, AES_SCHED_DEC ); }
+
+#if defined(CRYPTOCORE_ASSUME_AESNI)
+/* AES-NI known at compile-time: single blocks run inline (round keys in schedule usage order) */
+#include <wmmintrin.h>
+INLINE void aes_encrypt_block_aesni(const uint8_t* s, int rounds, const uint8_t plain[16], uint8_t cipher[16]) {
+    const __m128i* k = (const __m128i*) s;
+    __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i*) plain), _mm_loadu_si128(k));
+    for (int r = 1; r < rounds; r++) m = _mm_aesenc_si128(m, _mm_loadu_si128(k + r));
+    _mm_storeu_si128((__m128i*) cipher, _mm_aesenclast_si128(m, _mm_loadu_si128(k + rounds)));
+}
+/* dec_step: 1 for full schedules (kR, kR+1 ... k2R-1, k0), -1 for dec & enc schedules (kR, kR-1 ... k1, k0)
+ * imc: invert the intermediate keys on the fly (enc schedules, aesimc runs off the block's dependency chain) */
+INLINE void aes_decrypt_block_aesni(const uint8_t* s, int rounds, int dec_step, bool imc, const uint8_t cipher[16], uint8_t plain[16]) {
+    const __m128i* k = (const __m128i*) s;
+    __m128i m = _mm_xor_si128(_mm_loadu_si128((const __m128i*) cipher), _mm_loadu_si128(k + rounds));
+    for (int r = 1; r < rounds; r++) {
+        const __m128i rk = _mm_loadu_si128(k + rounds + dec_step * r);
+        m = _mm_aesdec_si128(m, imc ? _mm_aesimc_si128(rk) : rk);
+    }
+    _mm_storeu_si128((__m128i*) plain, _mm_aesdeclast_si128(m, _mm_loadu_si128(k)));
+}
+INLINE void aes128_encrypt_block(const aes128_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]) { aes_encrypt_block_aesni(schedule->bytes, 10, plain, cipher); }
+INLINE void aes192_encrypt_block(const aes192_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]) { aes_encrypt_block_aesni(schedule->bytes, 12, plain, cipher); }
+INLINE void aes256_encrypt_block(const aes256_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]) { aes_encrypt_block_aesni(schedule->bytes, 14, plain, cipher); }
+
+INLINE void aes128_decrypt_block(const aes128_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 10, 1, false, cipher, plain); }
+INLINE void aes192_decrypt_block(const aes192_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 12, 1, false, cipher, plain); }
+INLINE void aes256_decrypt_block(const aes256_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 14, 1, false, cipher, plain); }
+
+INLINE void aes128_decrypt_block_dec(const aes128_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 10, -1, false, cipher, plain); }
+INLINE void aes192_decrypt_block_dec(const aes192_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 12, -1, false, cipher, plain); }
+INLINE void aes256_decrypt_block_dec(const aes256_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 14, -1, false, cipher, plain); }
+
+INLINE void aes128_decrypt_block_enc(const aes128_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 10, -1, true, cipher, plain); }
+INLINE void aes192_decrypt_block_enc(const aes192_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 12, -1, true, cipher, plain); }
+INLINE void aes256_decrypt_block_enc(const aes256_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes_decrypt_block_aesni(schedule->bytes, 14, -1, true, cipher, plain); }
+#else
 INLINE void aes128_encrypt_block(const aes128_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]) { aes128_encrypt_blocks(schedule, (const uint8_t (*)[16])plain,  (uint8_t (*)[16])cipher, 1); }
 INLINE void aes192_encrypt_block(const aes192_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]) { aes192_encrypt_blocks(schedule, (const uint8_t (*)[16])plain,  (uint8_t (*)[16])cipher, 1); }
 INLINE void aes256_encrypt_block(const aes256_sched_enc_t*  schedule, const uint8_t plain[16], uint8_t cipher[16]) { aes256_encrypt_blocks(schedule, (const uint8_t (*)[16])plain,  (uint8_t (*)[16])cipher, 1); }
@@ -101,4 +201,13 @@ INLINE void aes128_decrypt_block(const aes128_sched_full_t* schedule, const uint
 INLINE void aes192_decrypt_block(const aes192_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes192_decrypt_blocks(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
 INLINE void aes256_decrypt_block(const aes256_sched_full_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes256_decrypt_blocks(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
 
+INLINE void aes128_decrypt_block_dec(const aes128_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes128_decrypt_blocks_dec(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
+INLINE void aes192_decrypt_block_dec(const aes192_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes192_decrypt_blocks_dec(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
+INLINE void aes256_decrypt_block_dec(const aes256_sched_dec_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes256_decrypt_blocks_dec(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
+
+INLINE void aes128_decrypt_block_enc(const aes128_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes128_decrypt_blocks_enc(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
+INLINE void aes192_decrypt_block_enc(const aes192_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes192_decrypt_blocks_enc(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
+INLINE void aes256_decrypt_block_enc(const aes256_sched_enc_t* schedule, const uint8_t cipher[16], uint8_t plain[16]) { aes256_decrypt_blocks_enc(schedule, (const uint8_t (*)[16])cipher, (uint8_t (*)[16])plain, 1); }
+#endif
+
 #endif // __AES_H__
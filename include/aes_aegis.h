@@ -0,0 +1,43 @@
+#ifndef __AES_AEGIS_H__
+#define __AES_AEGIS_H__
+
+/* AEGIS-128L & AEGIS-256 authenticated encryption (draft-irtf-cfrg-aegis-aead)
+ * The state update is raw AES rounds (no key schedule): 8 (128L) or 6 (256) independent AESENC per block of input,
+ * so AES-NI runs them in parallel & a message costs about one round latency per 32 (16) bytes.
+ * Checks for AES-NI support (amd64) & auto uses it, AEGIS-128L pairs state blocks on 256-bit registers with VAES,
+ * or a bitsliced constant-time pure C round.
+ * Features:
+ *  - Seal / open with 16 or 32 byte tags (AEGIS-128L: 16 byte key & nonce, AEGIS-256: 32 byte key & nonce)
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Seal (encrypt & tag) or open (verify & decrypt) each message with the key & a unique nonce
+ *      (no context: the key goes straight into the state). Random nonces are fine for both variants.
+ */
+
+/* --- Seal --- (cipher = plain ^ keystream, tag over aad & plain, in-place operation allowed)
+ * tag_len: 16 or 32 bytes, aad_len & len: below 2^61 bytes, anything else returns false & writes nothing */
+bool aegis128l_seal(const aes128_key_t* key, const uint8_t nonce[16], const uint8_t* aad, size_t aad_len,
+                    const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aegis256_seal(const aes256_key_t* key, const uint8_t nonce[32], const uint8_t* aad, size_t aad_len,
+                   const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+
+/* --- Open --- (true if the tag matches, else false & plain is zeroed, in-place operation allowed)
+ * Same parameter limits as seal (anything else fails) */
+bool aegis128l_open(const aes128_key_t* key, const uint8_t nonce[16], const uint8_t* aad, size_t aad_len,
+                    const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aegis256_open(const aes256_key_t* key, const uint8_t nonce[32], const uint8_t* aad, size_t aad_len,
+                   const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+
+/* Re-pick the AEGIS backend after toggling _hardware (pointer table builds only) */
+void aes_aegis_dispatch_update(void);
+
+/* --- END OF API --- */
+
+#endif // __AES_AEGIS_H__
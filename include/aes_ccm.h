@@ -0,0 +1,46 @@
+#ifndef __AES_CCM_H__
+#define __AES_CCM_H__
+
+/* AES-CCM authenticated encryption for 128, 192 & 256 bits keys (RFC 3610, NIST SP 800-38C)
+ * Checks for AES-NI support (amd64) & auto uses it (CBC-MAC chain & CTR keystream stitched in one pass over the data),
+ * or runs the CBC-MAC block by block & CTR through aes_modes.h.
+ * Features:
+ *  - Seal / open on an enc schedule with 7 - 13 byte nonces & 4 - 16 byte (even) tags
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Generate an enc-focused schedule from the key with aes.h (or a full one cast to enc).
+ *   2. Seal (encrypt & tag) or open (verify & decrypt) each message with a unique nonce.
+ *      The nonce length n fixes the length field: messages up to 2^(8 * (15 - n)) - 1 bytes (13 byte nonce: 64 KiB - 1).
+ */
+
+/* --- Seal --- (cipher = CTR(plain), tag = CBC-MAC over the B0 block, aad & plain, in-place operation allowed)
+ * nonce_len: 7 - 13 bytes, tag_len: 4, 6 ... 16 bytes, len: below the nonce's limit, anything else returns false & writes nothing */
+bool aes128_ccm_seal(const aes128_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aes192_ccm_seal(const aes192_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aes256_ccm_seal(const aes256_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+
+/* --- Open --- (true if the tag matches, else false & plain is zeroed, in-place operation allowed)
+ * Same parameter limits as seal (anything else fails) */
+bool aes128_ccm_open(const aes128_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes192_ccm_open(const aes192_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes256_ccm_open(const aes256_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+
+/* Re-pick the CCM backend after toggling _hardware (pointer table builds only) */
+void aes_ccm_dispatch_update(void);
+
+/* --- END OF API --- */
+
+#endif // __AES_CCM_H__
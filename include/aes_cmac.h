@@ -0,0 +1,64 @@
+#ifndef __AES_CMAC_H__
+#define __AES_CMAC_H__
+
+/* AES-CMAC message authentication for 128, 192 & 256 bits keys (NIST SP 800-38B, RFC 4493)
+ * One chain is serial, so many messages run side by side through the multi-buffer CBC-MAC of aes_modes.h
+ * (8 lanes in lockstep on AES-NI, 16 on VAES), each lane under its own key if needed.
+ * Features:
+ *  - Key context (enc schedule & the K1 / K2 subkeys next to it)
+ *  - Tag & verify (8 - 16 byte tags), one message or many at a time
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Build a context from the key once (*_cmac_init).
+ *   2. Tag or verify one message (*_cmac, *_cmac_verify), or a batch of messages (*_mb: prefer these for short packets).
+ */
+
+/* --- Context types --- (enc schedule, L = E(0^128), K1 = dbl(L), K2 = dbl(K1)) */
+typedef struct { aes128_sched_enc_t schedule; uint8_t k1[16], k2[16]; } aes128_cmac_ctx_t;
+typedef struct { aes192_sched_enc_t schedule; uint8_t k1[16], k2[16]; } aes192_cmac_ctx_t;
+typedef struct { aes256_sched_enc_t schedule; uint8_t k1[16], k2[16]; } aes256_cmac_ctx_t;
+
+/* --- Context generators --- */
+void aes128_cmac_init(aes128_cmac_ctx_t* ctx, const aes128_key_t* key);
+void aes192_cmac_init(aes192_cmac_ctx_t* ctx, const aes192_key_t* key);
+void aes256_cmac_init(aes256_cmac_ctx_t* ctx, const aes256_key_t* key);
+
+/* --- Tag --- (full 16 byte tag, truncate by keeping its first bytes) */
+void aes128_cmac(const aes128_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, uint8_t tag[16]);
+void aes192_cmac(const aes192_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, uint8_t tag[16]);
+void aes256_cmac(const aes256_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, uint8_t tag[16]);
+
+/* --- Verify --- (true if tag matches the first tag_len bytes, constant-time compare)
+ * tag_len: 8 - 16 bytes (SP 800-38B's lower bound), anything else returns false */
+bool aes128_cmac_verify(const aes128_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes192_cmac_verify(const aes192_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes256_cmac_verify(const aes256_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, const uint8_t* tag, size_t tag_len);
+
+/* --- Multi-buffer --- (independent messages in lockstep, any lengths & count)
+ * One message of a batch: */
+typedef struct {
+    const uint8_t* msg;
+    size_t         len;
+    uint8_t        tag[16];  /* *_cmac_mb: written, *_cmac_verify_mb: checked (first tag_len bytes) */
+    bool           valid;    /* *_cmac_verify_mb: the tag matched */
+} aes_cmac_msg_t;
+
+/* ctxs[i] keys msgs[i] (entries may repeat, e.g. all the same context) */
+void aes128_cmac_mb(const aes128_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs);
+void aes192_cmac_mb(const aes192_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs);
+void aes256_cmac_mb(const aes256_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs);
+/* true if every message is valid; tag_len outside 8 - 16 returns false & marks every message invalid */
+bool aes128_cmac_verify_mb(const aes128_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs, size_t tag_len);
+bool aes192_cmac_verify_mb(const aes192_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs, size_t tag_len);
+bool aes256_cmac_verify_mb(const aes256_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs, size_t tag_len);
+
+/* --- END OF API --- */
+
+#endif // __AES_CMAC_H__
@@ -0,0 +1,114 @@
+#ifndef __AES_GCM_H__
+#define __AES_GCM_H__
+
+/* AES-GCM authenticated encryption for 128, 192 & 256 bits keys (NIST SP 800-38D)
+ * Checks for AES-NI + PCLMULQDQ support (amd64) & auto uses it (CTR stitched with GHASH, 16 blocks per pass on VAES + VPCLMULQDQ),
+ * or runs CTR through aes_modes.h with a constant-time pure c GHASH.
+ * Features:
+ *  - Key context (enc schedule & precomputed GHASH key powers)
+ *  - Seal / open with any non-empty iv & aad length, SP 800-38D tag lengths (4, 8 & 12 - 16 bytes)
+ *  - AES-GCM-SIV (RFC 8452) seal / open for 128 & 256 bits keys (nonce misuse resistant)
+ *  - GMAC (authentication only), one shot or streamed
+ *  - Raw GHASH / POLYVAL streams on precomputed key tables (8 blocks per reduction, 16 on VAES + VPCLMULQDQ AVX-512)
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Build a context from the key once (*_gcm_init).
+ *   2. Seal (encrypt & tag) or open (verify & decrypt) each message with a unique iv (96 bit ivs are the fast path).
+ *   GCM-SIV: seal / open straight on the enc schedule of the key-generating key, per-nonce keys are derived on each call.
+ *   GMAC: GCM over aad only, from the same context (*_gmac, or *_gmac_start then aes_gmac_update / aes_gmac_final).
+ *   GHASH / POLYVAL: init a context with the hash key once per key, then update / final per hashed string.
+ *   Contexts & streams hold tables for the backend that built them (rebuild after aes_gcm_dispatch_update).
+ */
+
+/* --- Context types --- (enc schedule + GHASH table: H^1 ... H^16 & their Karatsuba halves) */
+typedef struct { aes128_sched_enc_t schedule; uint8_t htable[512]; } aes128_gcm_ctx_t;
+typedef struct { aes192_sched_enc_t schedule; uint8_t htable[512]; } aes192_gcm_ctx_t;
+typedef struct { aes256_sched_enc_t schedule; uint8_t htable[512]; } aes256_gcm_ctx_t;
+
+/* --- Context generators --- */
+void aes128_gcm_init(aes128_gcm_ctx_t* ctx, const aes128_key_t* key);
+void aes192_gcm_init(aes192_gcm_ctx_t* ctx, const aes192_key_t* key);
+void aes256_gcm_init(aes256_gcm_ctx_t* ctx, const aes256_key_t* key);
+
+/* --- Seal --- (cipher = CTR(plain), tag over aad & cipher, in-place operation allowed)
+ * iv_len: at least 1 byte, tag_len: 4, 8 or 12 - 16 bytes, len: at most 2^36 - 32 bytes per message,
+ * aad_len: at most 2^61 - 1 bytes (else false & nothing is written) */
+bool aes128_gcm_seal(const aes128_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aes192_gcm_seal(const aes192_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aes256_gcm_seal(const aes256_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+
+/* --- Open --- (true if the tag matches, else false & plain is zeroed, in-place operation allowed)
+ * iv_len, tag_len, len & aad_len: as for seal (else false & nothing is written) */
+bool aes128_gcm_open(const aes128_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes192_gcm_open(const aes192_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes256_gcm_open(const aes256_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+
+/* --- GCM-SIV seal --- (tag = POLYVAL based SIV over aad & plain, cipher = CTR(plain) from the tag, in-place operation allowed)
+ * nonce: 12 bytes, tag: 16 bytes, aad_len & len: at most 2^36 bytes (else false & nothing is written)
+ * A repeated nonce only reveals whether the same (aad, plain) pair was sealed again. */
+bool aes128_gcm_siv_seal(const aes128_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len,
+                         const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag);
+bool aes256_gcm_siv_seal(const aes256_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len,
+                         const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag);
+
+/* --- GCM-SIV open --- (true if the tag matches, else false & plain is zeroed, in-place operation allowed)
+ * Same parameter limits as seal (anything else fails) */
+bool aes128_gcm_siv_open(const aes128_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len,
+                         const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag);
+bool aes256_gcm_siv_open(const aes256_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len,
+                         const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag);
+
+/* --- GMAC --- (tag = GCM tag over aad with an empty payload; limits as for GCM seal / open)
+ * gmac: false & nothing written on an empty iv, a tag_len outside 4, 8 & 12 - 16 or a too long aad_len; verify: true if the tag matches */
+bool aes128_gmac(const aes128_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, uint8_t* tag, size_t tag_len);
+bool aes192_gmac(const aes192_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, uint8_t* tag, size_t tag_len);
+bool aes256_gmac(const aes256_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, uint8_t* tag, size_t tag_len);
+bool aes128_gmac_verify(const aes128_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, const uint8_t* tag, size_t tag_len);
+bool aes192_gmac_verify(const aes192_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, const uint8_t* tag, size_t tag_len);
+bool aes256_gmac_verify(const aes256_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, const uint8_t* tag, size_t tag_len);
+
+/* --- GMAC streams --- (aad fed in pieces of any size, e.g. a log as it is written)
+ * The stream points at its context's table (the context must outlive it)
+ * start: false on an empty iv (the stream still takes updates, but its final / final_verify fail) */
+typedef struct { const uint8_t* htable; uint8_t y[16], buf[16], ek_j0[16]; size_t buf_len; uint64_t aad_len; } aes_gmac_stream_t;
+bool aes128_gmac_start(const aes128_gcm_ctx_t* ctx, aes_gmac_stream_t* stream, const uint8_t* iv, size_t iv_len);
+bool aes192_gmac_start(const aes192_gcm_ctx_t* ctx, aes_gmac_stream_t* stream, const uint8_t* iv, size_t iv_len);
+bool aes256_gmac_start(const aes256_gcm_ctx_t* ctx, aes_gmac_stream_t* stream, const uint8_t* iv, size_t iv_len);
+void aes_gmac_update(aes_gmac_stream_t* stream, const uint8_t* aad, size_t len);
+/* final: tag_len 4, 8 or 12 - 16 bytes, false & nothing written on any other tag_len or aad past the GCM limit;
+ * final_verify: true if the tag matches (same tag_len set, else false). Both end the stream (start it again to reuse) */
+bool aes_gmac_final(aes_gmac_stream_t* stream, uint8_t* tag, size_t tag_len);
+bool aes_gmac_final_verify(aes_gmac_stream_t* stream, const uint8_t* tag, size_t tag_len);
+
+/* --- GHASH / POLYVAL --- (SP 800-38D GHASH_H & RFC 8452 POLYVAL_H over the concatenated updates, the last block zero
+ * padded; context: table of the powers of H, running state & a partial block) */
+typedef struct { uint8_t htable[512], y[16], buf[16]; size_t buf_len; } aes_ghash_ctx_t;
+typedef struct { uint8_t htable[512], y[16], buf[16]; size_t buf_len; } aes_polyval_ctx_t;
+/* init: table from the hash key h (16 bytes, e.g. AES_K(0^128) for GHASH) & an empty state */
+void aes_ghash_init(aes_ghash_ctx_t* ctx, const uint8_t h[16]);
+void aes_polyval_init(aes_polyval_ctx_t* ctx, const uint8_t h[16]);
+void aes_ghash_update(aes_ghash_ctx_t* ctx, const uint8_t* in, size_t len);
+void aes_polyval_update(aes_polyval_ctx_t* ctx, const uint8_t* in, size_t len);
+/* final: out = hash of everything since init / the last final, then the state is empty again (same key) */
+void aes_ghash_final(aes_ghash_ctx_t* ctx, uint8_t out[16]);
+void aes_polyval_final(aes_polyval_ctx_t* ctx, uint8_t out[16]);
+
+/* Re-pick the GCM backend after toggling _hardware (pointer table builds only) */
+void aes_gcm_dispatch_update(void);
+
+/* --- END OF API --- */
+
+#endif // __AES_GCM_H__
@@ -0,0 +1,85 @@
+#ifndef __AES_KW_H__
+#define __AES_KW_H__
+
+/* AES Key Wrap (RFC 3394, NIST SP 800-38F KW) & Key Wrap with Padding (RFC 5649, KWP) for 128, 192 & 256 bits keys
+ * One wrap is 6 * n serial block transforms (n = 8 byte halves of the key data), so batches step many wraps together:
+ * step s of every wrap still running goes through one *_encrypt_blocks / *_decrypt_blocks call (aes.h pipelines
+ * 8 blocks on AES-NI, 16+ on VAES), finished wraps hand their lane to the next job.
+ * Features:
+ *  - Key context (full schedule: wrap encrypts, unwrap decrypts)
+ *  - KW wrap / unwrap (16+ bytes, multiples of 8), KWP wrap / unwrap (1 - 2^32 - 1 bytes)
+ *  - Batches of independent jobs under one key (key rotation, rewrapping many data keys)
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Build a context from the key encryption key once (*_kw_init).
+ *   2. Wrap or unwrap one key (*_kw_wrap, *_kwp_unwrap, ...) or a batch of them (*_batch: prefer these for many keys).
+ *   Bad lengths return false & write nothing, a failed unwrap integrity check returns false & zeroes out.
+ *   in & out may be the same buffer (out sized for the larger of the two).
+ */
+
+/* --- Sizes --- (wrapped output of len bytes) */
+#define AES_KW_WRAPPED_LEN(len)  ((len) + 8)
+#define AES_KWP_WRAPPED_LEN(len) ((((len) + 7) & ~(size_t) 7) + 8)
+
+/* --- Context types --- */
+typedef struct { aes128_sched_full_t schedule; } aes128_kw_ctx_t;
+typedef struct { aes192_sched_full_t schedule; } aes192_kw_ctx_t;
+typedef struct { aes256_sched_full_t schedule; } aes256_kw_ctx_t;
+
+/* --- Context generators --- */
+void aes128_kw_init(aes128_kw_ctx_t* ctx, const aes128_key_t* key);
+void aes192_kw_init(aes192_kw_ctx_t* ctx, const aes192_key_t* key);
+void aes256_kw_init(aes256_kw_ctx_t* ctx, const aes256_key_t* key);
+
+/* --- KW --- (wrap: len a multiple of 8 & >= 16, out gets len + 8 bytes
+ *             unwrap: len a multiple of 8 & >= 24, out gets len - 8 bytes) */
+bool aes128_kw_wrap(const aes128_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes192_kw_wrap(const aes192_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes256_kw_wrap(const aes256_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes128_kw_unwrap(const aes128_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes192_kw_unwrap(const aes192_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes256_kw_unwrap(const aes256_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+
+/* --- KWP --- (wrap: len 1 - 2^32 - 1, out gets AES_KWP_WRAPPED_LEN(len) bytes
+ *              unwrap: len a multiple of 8 & >= 16, out needs len - 8 bytes, *out_len gets the key length, 0 on failure) */
+bool aes128_kwp_wrap(const aes128_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes192_kwp_wrap(const aes192_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes256_kwp_wrap(const aes256_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out);
+bool aes128_kwp_unwrap(const aes128_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out, size_t* out_len);
+bool aes192_kwp_unwrap(const aes192_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out, size_t* out_len);
+bool aes256_kwp_unwrap(const aes256_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out, size_t* out_len);
+
+/* --- Batches --- (independent jobs under one key, any lengths & count)
+ * One job of a batch: */
+typedef struct {
+    const uint8_t* in;
+    size_t         len;
+    uint8_t*       out;      /* sized as for the single calls */
+    size_t         out_len;  /* written: bytes in out (0 if invalid) */
+    bool           valid;    /* wrap: the length was accepted, unwrap: the length & integrity check passed */
+} aes_kw_job_t;
+
+/* true if every job is valid (invalid unwraps leave their out zeroed) */
+bool aes128_kw_wrap_batch(const aes128_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes192_kw_wrap_batch(const aes192_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes256_kw_wrap_batch(const aes256_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes128_kw_unwrap_batch(const aes128_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes192_kw_unwrap_batch(const aes192_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes256_kw_unwrap_batch(const aes256_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes128_kwp_wrap_batch(const aes128_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes192_kwp_wrap_batch(const aes192_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes256_kwp_wrap_batch(const aes256_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes128_kwp_unwrap_batch(const aes128_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes192_kwp_unwrap_batch(const aes192_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+bool aes256_kwp_unwrap_batch(const aes256_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs);
+
+/* --- END OF API --- */
+
+#endif // __AES_KW_H__
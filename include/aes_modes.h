@@ -0,0 +1,102 @@
+#ifndef __AES_MODES_H__
+#define __AES_MODES_H__
+
+/* Block cipher modes on top of the AES schedules (aes.h)
+ * Same backend selection as aes.h (AES-NI / VAES kernels, else built on the *_blocks transforms)
+ * Features:
+ *  - CTR keystream xor (32, 64 & 128 bit big-endian counters, any byte length)
+ *  - CBC decryption (parallel across blocks, full, dec or enc schedules)
+ *  - Multi-buffer CBC / CFB encryption, OFB & CBC-MAC (many independent streams in lockstep)
+ *  - XTS-AES-128 / 256 (IEEE 1619, ciphertext stealing, batches of sectors)
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Generate the schedule the mode needs with aes.h (CTR: enc-focused or full cast to enc, CBC decryption: any, multi-buffer: enc).
+ *      XTS needs two schedules from independent keys (data: enc or full, tweak: enc).
+ *   2. Call the mode with its per-message state (counter block, iv ...).
+ */
+
+/* --- CTR --- (keystream = AES(counter), AES(counter + 1) ...; encryption & decryption are the same xor)
+ * Counter widths: only the low 32, 64 or 128 bits of the big-endian counter block increment (wrapping within them),
+ * the bytes above stay fixed (e.g. GCM uses 32, RFC 3686 uses 32, SP 800-38A allows any) */
+typedef enum {
+    AES_CTR32  = 32,
+    AES_CTR64  = 64,
+    AES_CTR128 = 128
+} aes_ctr_width_t;
+
+/* out = in ^ keystream for len bytes (in-place operation allowed)
+ * counter is advanced past every block used, a partial last block consumes a whole one (start a new message after it) */
+void aes128_ctr_xor(const aes128_sched_enc_t* schedule, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len);
+void aes192_ctr_xor(const aes192_sched_enc_t* schedule, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len);
+void aes256_ctr_xor(const aes256_sched_enc_t* schedule, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len);
+
+/* --- CBC decryption --- (plain[i] = AES^-1(cipher[i]) ^ cipher[i - 1], cipher[-1] = iv; in-place operation allowed)
+ * iv is updated to the last ciphertext block, so a message can be decrypted across several calls */
+void aes128_cbc_decrypt(const aes128_sched_full_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes192_cbc_decrypt(const aes192_sched_full_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes256_cbc_decrypt(const aes256_sched_full_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+/* --- CBC decryption (dec schedules) --- */
+void aes128_cbc_decrypt_dec(const aes128_sched_dec_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes192_cbc_decrypt_dec(const aes192_sched_dec_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes256_cbc_decrypt_dec(const aes256_sched_dec_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+/* --- CBC decryption (enc schedules) --- (round keys inverted once per call) */
+void aes128_cbc_decrypt_enc(const aes128_sched_enc_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes192_cbc_decrypt_enc(const aes192_sched_enc_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+void aes256_cbc_decrypt_enc(const aes256_sched_enc_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks);
+
+/* --- Multi-buffer serial modes --- (CBC & CFB encryption, OFB and CBC-MAC can't run one stream's blocks in parallel,
+ * so independent streams run side by side instead: 8 at a time on AES-NI, 16 on VAES, lanes refilled as streams end)
+ * One stream of a call: */
+typedef struct {
+    const uint8_t* in;     /* plaintext (OFB: either direction) */
+    uint8_t*       out;    /* may equal in, must not overlap other streams (CBC-MAC: unused) */
+    size_t         len;    /* bytes - CBC & CBC-MAC: whole blocks only (trailing bytes ignored), CFB & OFB: a partial last block ends the stream */
+    uint8_t        iv[16]; /* updated to the chaining value after the last whole block (CBC, CBC-MAC & CFB: last cipher block, OFB: last keystream block) */
+} aes_mb_stream_t;
+
+/* schedules[i] drives streams[i] (entries may repeat, e.g. all the same schedule), any num_streams */
+void aes128_cbc_encrypt_mb(const aes128_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes192_cbc_encrypt_mb(const aes192_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes256_cbc_encrypt_mb(const aes256_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes128_cfb_encrypt_mb(const aes128_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes192_cfb_encrypt_mb(const aes192_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes256_cfb_encrypt_mb(const aes256_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes128_ofb_xor_mb(const aes128_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes192_ofb_xor_mb(const aes192_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes256_ofb_xor_mb(const aes256_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+/* CBC-MAC: CBC encryption that only keeps the chaining value (iv in: the MAC state, out: the state after len bytes),
+ * the MAC passes of CMAC style constructions (their padded last block is left to the caller) */
+void aes128_cbc_mac_mb(const aes128_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes192_cbc_mac_mb(const aes192_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+void aes256_cbc_mac_mb(const aes256_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams);
+
+/* --- XTS --- (IEEE 1619: data unit of len bytes, tweak = AES_tweak(iv), ciphertext stealing for a partial last block)
+ * len: at least 16 bytes (else false & nothing is written), in-place operation allowed */
+bool aes128_xts_encrypt(const aes128_sched_enc_t* data, const aes128_sched_enc_t* tweak, const uint8_t iv[16], const uint8_t* plain, uint8_t* cipher, size_t len);
+bool aes256_xts_encrypt(const aes256_sched_enc_t* data, const aes256_sched_enc_t* tweak, const uint8_t iv[16], const uint8_t* plain, uint8_t* cipher, size_t len);
+bool aes128_xts_decrypt(const aes128_sched_full_t* data, const aes128_sched_enc_t* tweak, const uint8_t iv[16], const uint8_t* cipher, uint8_t* plain, size_t len);
+bool aes256_xts_decrypt(const aes256_sched_full_t* data, const aes256_sched_enc_t* tweak, const uint8_t iv[16], const uint8_t* cipher, uint8_t* plain, size_t len);
+/* --- XTS sectors --- (num_sectors consecutive units of sector_size bytes, e.g. 512 or 4096 (any >= 16),
+ * iv of each = its sector number as a 128-bit little-endian value, starting at sector) */
+bool aes128_xts_encrypt_sectors(const aes128_sched_enc_t* data, const aes128_sched_enc_t* tweak, uint64_t sector, size_t sector_size,
+                                const uint8_t* plain, uint8_t* cipher, size_t num_sectors);
+bool aes256_xts_encrypt_sectors(const aes256_sched_enc_t* data, const aes256_sched_enc_t* tweak, uint64_t sector, size_t sector_size,
+                                const uint8_t* plain, uint8_t* cipher, size_t num_sectors);
+bool aes128_xts_decrypt_sectors(const aes128_sched_full_t* data, const aes128_sched_enc_t* tweak, uint64_t sector, size_t sector_size,
+                                const uint8_t* cipher, uint8_t* plain, size_t num_sectors);
+bool aes256_xts_decrypt_sectors(const aes256_sched_full_t* data, const aes256_sched_enc_t* tweak, uint64_t sector, size_t sector_size,
+                                const uint8_t* cipher, uint8_t* plain, size_t num_sectors);
+
+/* Re-pick the modes backend after toggling _hardware (pointer table builds only) */
+void aes_modes_dispatch_update(void);
+
+/* --- END OF API --- */
+
+#endif // __AES_MODES_H__
@@ -0,0 +1,54 @@
+#ifndef __AES_OCB_H__
+#define __AES_OCB_H__
+
+/* AES-OCB3 authenticated encryption for 128, 192 & 256 bits keys (RFC 7253)
+ * One AES pass per block covers both privacy & authentication (no GHASH): offsets are xored around batches of
+ * *_encrypt_blocks / *_decrypt_blocks calls (aes.h picks the AES-NI / VAES / fallback kernels), so it needs no PCLMULQDQ.
+ * Features:
+ *  - Key context (full schedule & precomputed L_* / L_$ / L_i offsets)
+ *  - Seal / open with 1 - 15 byte nonces, any aad & tag length (1 - 16 bytes)
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Build a context from the key once (*_ocb_init).
+ *   2. Seal (encrypt & tag) or open (verify & decrypt) each message with a unique nonce (12 bytes is the usual choice).
+ */
+
+/* --- Context types --- (full schedule + L_*, L_$, L_0 ... L_63 & gray[j] = L_ntz(1) ^ ... ^ L_ntz(j) for j < 8) */
+typedef struct { aes128_sched_full_t schedule; uint8_t l_star[16], l_dollar[16], gray[8][16], l[64][16]; } aes128_ocb_ctx_t;
+typedef struct { aes192_sched_full_t schedule; uint8_t l_star[16], l_dollar[16], gray[8][16], l[64][16]; } aes192_ocb_ctx_t;
+typedef struct { aes256_sched_full_t schedule; uint8_t l_star[16], l_dollar[16], gray[8][16], l[64][16]; } aes256_ocb_ctx_t;
+
+/* --- Context generators --- */
+void aes128_ocb_init(aes128_ocb_ctx_t* ctx, const aes128_key_t* key);
+void aes192_ocb_init(aes192_ocb_ctx_t* ctx, const aes192_key_t* key);
+void aes256_ocb_init(aes256_ocb_ctx_t* ctx, const aes256_key_t* key);
+
+/* --- Seal --- (cipher = OCB(plain), tag over nonce, aad & plain, in-place operation allowed)
+ * nonce_len: 1 - 15 bytes, tag_len: 1 - 16 bytes (part of the nonce block, so it must match on open),
+ * anything else returns false & writes nothing */
+bool aes128_ocb_seal(const aes128_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aes192_ocb_seal(const aes192_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+bool aes256_ocb_seal(const aes256_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len);
+
+/* --- Open --- (true if the tag matches, else false & plain is zeroed, in-place operation allowed)
+ * nonce_len: 1 - 15 bytes, tag_len: 1 - 16 bytes (anything else fails) */
+bool aes128_ocb_open(const aes128_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes192_ocb_open(const aes192_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+bool aes256_ocb_open(const aes256_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len);
+
+/* --- END OF API --- */
+
+#endif // __AES_OCB_H__
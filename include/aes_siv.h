@@ -0,0 +1,77 @@
+#ifndef __AES_SIV_H__
+#define __AES_SIV_H__
+
+/* AES-SIV deterministic authenticated encryption for 128, 192 & 256 bits keys (RFC 5297)
+ * S2V runs the CMAC chains of every associated data component & of the plaintext side by side (multi-buffer CBC-MAC
+ * of aes_modes.h: 8 lanes on AES-NI, 16 on VAES), then CTR through aes_modes.h. Batches of short messages share
+ * those lanes & one block transform call for their last blocks & keystream.
+ * Features:
+ *  - Key context (CMAC context of aes_cmac.h, ctr enc schedule & the S2V start value)
+ *  - Seal / open with 0 - 126 associated data components, one message or a batch
+ */
+
+#include <stdint.h> /* for uint8_t */
+#include <stddef.h> /* for size_t */
+#include <stdbool.h>
+#include "aes.h"
+#include "aes_cmac.h"
+
+/* ----- PUBLIC API -----
+ * Guide:
+ *   1. Build a context from the two key halves once (*_siv_init, RFC 5297 key = mac_key || ctr_key: "AES-SIV-256" is aes128).
+ *   2. Seal (SIV & encrypt) or open (decrypt & verify). Equal aad & plaintext give equal outputs (deterministic),
+ *      for nonce-based use pass the nonce as the last aad component.
+ */
+
+/* --- Context types --- (CMAC context of the mac key, ctr schedule & S2V's D0 = CMAC(0^128)) */
+typedef struct { aes128_cmac_ctx_t mac; aes128_sched_enc_t ctr; uint8_t d0[16]; } aes128_siv_ctx_t;
+typedef struct { aes192_cmac_ctx_t mac; aes192_sched_enc_t ctr; uint8_t d0[16]; } aes192_siv_ctx_t;
+typedef struct { aes256_cmac_ctx_t mac; aes256_sched_enc_t ctr; uint8_t d0[16]; } aes256_siv_ctx_t;
+
+/* --- Context generators --- */
+void aes128_siv_init(aes128_siv_ctx_t* ctx, const aes128_key_t* mac_key, const aes128_key_t* ctr_key);
+void aes192_siv_init(aes192_siv_ctx_t* ctx, const aes192_key_t* mac_key, const aes192_key_t* ctr_key);
+void aes256_siv_init(aes256_siv_ctx_t* ctx, const aes256_key_t* mac_key, const aes256_key_t* ctr_key);
+
+/* --- Seal --- (siv = S2V(aad[0] ... aad[num_aad - 1], plain), cipher = CTR(plain) from the siv, in-place operation allowed)
+ * num_aad: 0 - 126 components (aad may be NULL when 0, components may be empty), anything else returns false & writes nothing */
+bool aes128_siv_seal(const aes128_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t siv[16]);
+bool aes192_siv_seal(const aes192_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t siv[16]);
+bool aes256_siv_seal(const aes256_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad,
+                     const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t siv[16]);
+
+/* --- Open --- (true if the siv matches, else false & plain is zeroed, in-place operation allowed)
+ * Same parameter limits as seal (anything else fails) */
+bool aes128_siv_open(const aes128_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t siv[16]);
+bool aes192_siv_open(const aes192_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t siv[16]);
+bool aes256_siv_open(const aes256_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad,
+                     const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t siv[16]);
+
+/* --- Batches --- (many independent messages under one context, e.g. the values of a column)
+ * One message of a batch: */
+typedef struct {
+    const uint8_t* const* aad;      /* associated data components (NULL when num_aad is 0) */
+    const size_t*         aad_lens;
+    size_t                num_aad;  /* 0 - 126 */
+    const uint8_t*        in;       /* seal: plaintext, open: ciphertext */
+    uint8_t*              out;      /* may equal in, must not overlap other messages */
+    size_t                len;
+    uint8_t               siv[16];  /* seal: written, open: checked */
+    bool                  valid;    /* open: the siv matched (else out is zeroed) */
+} aes_siv_msg_t;
+
+/* seal: false & nothing written if any message has too many components; open: true if every message is valid */
+bool aes128_siv_seal_batch(const aes128_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs);
+bool aes192_siv_seal_batch(const aes192_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs);
+bool aes256_siv_seal_batch(const aes256_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs);
+bool aes128_siv_open_batch(const aes128_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs);
+bool aes192_siv_open_batch(const aes192_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs);
+bool aes256_siv_open_batch(const aes256_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs);
+
+/* --- END OF API --- */
+
+#endif // __AES_SIV_H__
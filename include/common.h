@@ -3,10 +3,38 @@
 
 /* Contains general macros, shared values and some startup code */
 
-/* Hardware support - exposed to toggle pure c and intrinsics workflows. */
-struct {
-    _Bool aes; /* AES hardware acceleration (SSE2, AES) */
-} _hardware;
+/* Hardware support - exposed to toggle pure c and intrinsics workflows.
+ * Filled at startup. Backends are picked once per process (GNU ifunc in shared builds, else at startup):
+ * after toggling flags call the module's *_dispatch_update() (no effect in ifunc & CRYPTOCORE_ASSUME_* builds),
+ * while no other thread is calling into that module. */
+typedef struct {
+    _Bool aes;     /* AES hardware acceleration (SSE2, AES) */
+    _Bool aeskga;  /* Fast aeskeygenassist (not microcoded, AMD Zen): AES key schedules use it over aesenclast */
+    _Bool pclmul;  /* Carry-less multiply on 128-bit registers (SSE2, PCLMULQDQ): GHASH */
+    _Bool ssse3;   /* Byte shuffles for the vector permute AES fallback (SSE2, SSSE3) */
+    _Bool vaes;    /* AES on 256-bit registers (AVX2, VAES & OS saves YMM state) */
+    _Bool vaes512; /* AES on 512-bit registers (AVX512F, VAES & OS saves ZMM state) */
+    _Bool vpclmul; /* Carry-less multiply on 512-bit registers (AVX512F, VPCLMULQDQ & OS saves ZMM state) */
+} hardware_t;
+extern hardware_t _hardware;
+
+/* Compile-time backend (removes runtime dispatch, lets hot loops inline single block calls)
+ * Define at most one for both the library & its users, needs the matching compiler flags (e.g. -maes -mvaes):
+ *   CRYPTOCORE_ASSUME_VAES512  -> VAES + VPCLMULQDQ + AVX512F (implies VAES)
+ *   CRYPTOCORE_ASSUME_VAES     -> VAES + AVX2    (implies AESNI)
+ *   CRYPTOCORE_ASSUME_AESNI    -> AES-NI + PCLMULQDQ
+ *   CRYPTOCORE_ASSUME_SSSE3    -> SSSE3 vector permute
+ *   CRYPTOCORE_ASSUME_PORTABLE -> pure c
+ */
+#if defined(CRYPTOCORE_ASSUME_VAES512) && !defined(CRYPTOCORE_ASSUME_VAES)
+    #define CRYPTOCORE_ASSUME_VAES
+#endif
+#if defined(CRYPTOCORE_ASSUME_VAES) && !defined(CRYPTOCORE_ASSUME_AESNI)
+    #define CRYPTOCORE_ASSUME_AESNI
+#endif
+#if defined(CRYPTOCORE_ASSUME_AESNI) || defined(CRYPTOCORE_ASSUME_SSSE3) || defined(CRYPTOCORE_ASSUME_PORTABLE)
+    #define CRYPTOCORE_ASSUME
+#endif
 
 /* Aggressive inline macro for low-cost wrappers */
 #ifndef INLINE
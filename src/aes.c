@@ -1,5 +1,6 @@
 /* AES for 128, 192 & 256 bits keys
  * Checks for AES-NI support (amd64) & auto uses it
+ *  - or uses SSSE3 vector permute fallback
  *  - or uses pure c fallback
  * Features:
  *  - Key & schedule types (full, enc-focused, dec-focused)
@@ -10,8 +11,12 @@
 
 /* Table of Contents
  *  --- General Utility ---
+ *  --- Bitsliced pure C internal --- (constant-time)
+ *  --- Vector permute (SSSE3) internal --- (constant-time)
  *  --- Key schedule generators --- (writes to provided array)
  *  --- Transform rounds internal ---
+ *  --- Backend dispatch --- (one tier per process, picked once)
+ *  --- Public key schedule generators ---
  *  --- Encrypt blocks transforms --- (in-place operation allowed)
  *  --- Decrypt blocks transforms --- (in-place operation allowed)
  *  --- Encrypt block transforms --- (in-place operation allowed)
@@ -20,7 +25,8 @@
 
 #include "aes.h"
 #include "hidden_common.h"
-#include <wmmintrin.h> /* for intrinsics for AES-NI */
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy */
 
 /* --- General Utility --- */
 const uint8_t Sbox[256] = {
@@ -61,20 +67,12 @@ const uint8_t InvSbox[256] = {
     0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
 };
 
-/* Left rotate 1 byte */
-#define ROT_WORD(word) ROTL32(word, 8)
-/* Sbox on each byte */
-#define SUB_WORD(word) \
-    ((uint32_t)Sbox[word && 0xFF] || \
-    ((uint32_t)Sbox[(word >> 8) && 0xFF] << 8) || \
-    ((uint32_t)Sbox[(word >> 16) && 0xFF] << 16) || \
-    ((uint32_t)Sbox[word >> 24] << 24))
-/* Left rotate 1 byte, Sbox on each byte (3 fewer ops combined - for keygen) */
-#define SUBROT_WORD(word) \
-    (((uint32_t)Sbox[word && 0xFF] << 8) || \
-     ((uint32_t)Sbox[(word >> 8) && 0xFF] << 16) || \
-     ((uint32_t)Sbox[(word >> 16) && 0xFF] << 24) || \
-      (uint32_t)Sbox[word >> 24])
+/* Rotate 1 byte towards the front (key words are little-endian: b0 is the LSB) */
+#define ROT_WORD(word) ROTR32(word, 8)
+/* Sbox on each byte (constant-time, see aes_ct64_sub_word) */
+#define SUB_WORD(word) aes_ct64_sub_word(word)
+/* Rotate 1 byte, Sbox on each byte (bytewise Sbox commutes with the rotate - for keygen) */
+#define SUBROT_WORD(word) ROT_WORD(SUB_WORD(word))
 
 /*AES operates on a 4x4 column-major order array of 16 bytes b0 ... b15
 * + b0  b4  b8  b12 +
@@ -174,6 +172,510 @@ const uint8_t InvSbox[256] = {
     (b3) = _w2 ^ _2x_u30 ^ a3; /* [ 11, 13, 9, 14 ]  9 = 1001 */ \
 }
 
+/* --- Bitsliced pure C internal --- (constant-time: no table lookups, no data dependent branches)
+ * 64-bit bitsliced AES: q[0]-q[7] hold bit planes 0-7 of 4 blocks (16 bits per block per plane).
+ * Blocks go in/out through interleave + ortho, kernels run two q sets (8 blocks) side by side.
+ * Round keys use the same layout as the AES-NI schedules (decryption keys have InvMixColumns applied).
+ */
+
+/* Swap bit groups of x & y (cl/ch masks, s shift) - building block of the bit-plane transpose */
+#define CT64_SWAPN(cl, ch, s, x, y) {                              \
+    const uint64_t _a = (x), _b = (y);                              \
+    (x) = (_a & (uint64_t)(cl)) | ((_b & (uint64_t)(cl)) << (s));   \
+    (y) = ((_a & (uint64_t)(ch)) >> (s)) | (_b & (uint64_t)(ch));   \
+}
+#define CT64_SWAP2(x, y) CT64_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, x, y)
+#define CT64_SWAP4(x, y) CT64_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, x, y)
+#define CT64_SWAP8(x, y) CT64_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, x, y)
+
+/* Transpose to/from bit planes (own inverse) */
+static void aes_ct64_ortho(uint64_t* q) {
+    CT64_SWAP2(q[0], q[1]) CT64_SWAP2(q[2], q[3]) CT64_SWAP2(q[4], q[5]) CT64_SWAP2(q[6], q[7])
+    CT64_SWAP4(q[0], q[2]) CT64_SWAP4(q[1], q[3]) CT64_SWAP4(q[4], q[6]) CT64_SWAP4(q[5], q[7])
+    CT64_SWAP8(q[0], q[4]) CT64_SWAP8(q[1], q[5]) CT64_SWAP8(q[2], q[6]) CT64_SWAP8(q[3], q[7])
+}
+
+/* Spread one block (4 little-endian words) over q0 & q1: even/odd bytes of each column */
+static void aes_ct64_interleave_in(uint64_t* q0, uint64_t* q1, const uint8_t block[16]) {
+    uint32_t w[4];
+    memcpy(w, block, 16);
+    uint64_t x0 = w[0], x1 = w[1], x2 = w[2], x3 = w[3];
+    x0 |= x0 << 16; x1 |= x1 << 16; x2 |= x2 << 16; x3 |= x3 << 16;
+    x0 &= 0x0000FFFF0000FFFF; x1 &= 0x0000FFFF0000FFFF; x2 &= 0x0000FFFF0000FFFF; x3 &= 0x0000FFFF0000FFFF;
+    x0 |= x0 << 8; x1 |= x1 << 8; x2 |= x2 << 8; x3 |= x3 << 8;
+    x0 &= 0x00FF00FF00FF00FF; x1 &= 0x00FF00FF00FF00FF; x2 &= 0x00FF00FF00FF00FF; x3 &= 0x00FF00FF00FF00FF;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+/* Inverse of aes_ct64_interleave_in */
+static void aes_ct64_interleave_out(uint8_t block[16], uint64_t q0, uint64_t q1) {
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FF, x1 = q1 & 0x00FF00FF00FF00FF;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FF, x3 = (q1 >> 8) & 0x00FF00FF00FF00FF;
+    x0 |= x0 >> 8; x1 |= x1 >> 8; x2 |= x2 >> 8; x3 |= x3 >> 8;
+    x0 &= 0x0000FFFF0000FFFF; x1 &= 0x0000FFFF0000FFFF; x2 &= 0x0000FFFF0000FFFF; x3 &= 0x0000FFFF0000FFFF;
+    const uint32_t w[4] = {
+        (uint32_t)x0 | (uint32_t)(x0 >> 16), (uint32_t)x1 | (uint32_t)(x1 >> 16),
+        (uint32_t)x2 | (uint32_t)(x2 >> 16), (uint32_t)x3 | (uint32_t)(x3 >> 16)
+    };
+    memcpy(block, w, 16);
+}
+
+/* SubBytes on bit planes (Boyar-Peralta circuit: 113 gates) */
+static void aes_ct64_sbox(uint64_t* q) {
+    uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint64_t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11, y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    uint64_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9, z10, z11, z12, z13, z14, z15, z16, z17;
+    uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint64_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29, t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint64_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49, t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint64_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    // Top linear transformation
+    y14 = x3 ^ x5;  y13 = x0 ^ x6;  y9  = x0 ^ x3;  y8  = x0 ^ x5;
+    t0  = x1 ^ x2;  y1  = t0 ^ x7;  y4  = y1 ^ x3;  y12 = y13 ^ y14;
+    y2  = y1 ^ x0;  y5  = y1 ^ x6;  y3  = y5 ^ y8;  t1  = x4 ^ y12;
+    y15 = t1 ^ x5;  y20 = t1 ^ x1;  y6  = y15 ^ x7; y10 = y15 ^ t0;
+    y11 = y20 ^ y9; y7  = x7 ^ y11; y17 = y10 ^ y11; y19 = y10 ^ y8;
+    y16 = t0 ^ y11; y21 = y13 ^ y16; y18 = x0 ^ y16;
+
+    // Non-linear section
+    t2  = y12 & y15; t3  = y3 & y6;   t4  = t3 ^ t2;   t5  = y4 & x7;
+    t6  = t5 ^ t2;   t7  = y13 & y16; t8  = y5 & y1;   t9  = t8 ^ t7;
+    t10 = y2 & y7;   t11 = t10 ^ t7;  t12 = y9 & y11;  t13 = y14 & y17;
+    t14 = t13 ^ t12; t15 = y8 & y10;  t16 = t15 ^ t12; t17 = t4 ^ t14;
+    t18 = t6 ^ t16;  t19 = t9 ^ t14;  t20 = t11 ^ t16; t21 = t17 ^ y20;
+    t22 = t18 ^ y19; t23 = t19 ^ y21; t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22; t26 = t21 & t23; t27 = t24 ^ t26; t28 = t25 & t27;
+    t29 = t28 ^ t22; t30 = t23 ^ t24; t31 = t22 ^ t26; t32 = t31 & t30;
+    t33 = t32 ^ t24; t34 = t23 ^ t33; t35 = t27 ^ t33; t36 = t24 & t35;
+    t37 = t36 ^ t34; t38 = t27 ^ t36; t39 = t29 & t38; t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37; t42 = t29 ^ t33; t43 = t29 ^ t40; t44 = t33 ^ t37; t45 = t42 ^ t41;
+    z0  = t44 & y15; z1  = t37 & y6;  z2  = t33 & x7;  z3  = t43 & y16;
+    z4  = t40 & y1;  z5  = t29 & y7;  z6  = t42 & y11; z7  = t45 & y17;
+    z8  = t41 & y10; z9  = t44 & y12; z10 = t37 & y3;  z11 = t33 & y4;
+    z12 = t43 & y13; z13 = t40 & y5;  z14 = t29 & y2;  z15 = t42 & y9;
+    z16 = t45 & y14; z17 = t41 & y8;
+
+    // Bottom linear transformation
+    t46 = z15 ^ z16; t47 = z10 ^ z11; t48 = z5 ^ z13;  t49 = z9 ^ z10;
+    t50 = z2 ^ z12;  t51 = z2 ^ z5;   t52 = z7 ^ z8;   t53 = z0 ^ z3;
+    t54 = z6 ^ z7;   t55 = z16 ^ z17; t56 = z12 ^ t48; t57 = t50 ^ t53;
+    t58 = z4 ^ t46;  t59 = z3 ^ t54;  t60 = t46 ^ t57; t61 = z14 ^ t57;
+    t62 = t52 ^ t58; t63 = t49 ^ t58; t64 = z4 ^ t59;  t65 = t61 ^ t62;
+    t66 = z1 ^ t63;  s0  = t59 ^ t63; s6  = t56 ^ ~t62; s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65; s3  = t53 ^ t66; s4  = t51 ^ t66; s5  = t47 ^ t65;
+    s1  = t64 ^ ~s3; s2  = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+/* Inverse affine transform on bit planes (undoes the affine step inside the S-box) */
+#define CT64_INV_AFFINE(q) {                                                      \
+    const uint64_t _q0 = ~(q)[0], _q1 = ~(q)[1], _q2 = (q)[2], _q3 = (q)[3];     \
+    const uint64_t _q4 = (q)[4], _q5 = ~(q)[5], _q6 = ~(q)[6], _q7 = (q)[7];     \
+    (q)[7] = _q1 ^ _q4 ^ _q6; (q)[6] = _q0 ^ _q3 ^ _q5;                          \
+    (q)[5] = _q7 ^ _q2 ^ _q4; (q)[4] = _q6 ^ _q1 ^ _q3;                          \
+    (q)[3] = _q5 ^ _q0 ^ _q2; (q)[2] = _q4 ^ _q7 ^ _q1;                          \
+    (q)[1] = _q3 ^ _q6 ^ _q0; (q)[0] = _q2 ^ _q5 ^ _q7;                          \
+}
+
+/* InvSubBytes: inverse affine, S-box, inverse affine (S-box = affine after inversion) */
+static void aes_ct64_inv_sbox(uint64_t* q) {
+    CT64_INV_AFFINE(q)
+    aes_ct64_sbox(q);
+    CT64_INV_AFFINE(q)
+}
+
+/* Each plane word holds rows as 16-bit groups (4 bits per row per block) */
+static void aes_ct64_shift_rows(uint64_t* q) {
+    for (unsigned i = 0; i < 8; i++) {
+        const uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFF)
+            | ((x & 0x00000000FFF00000) >> 4) | ((x & 0x00000000000F0000) << 12)
+            | ((x & 0x0000FF0000000000) >> 8) | ((x & 0x000000FF00000000) << 8)
+            | ((x & 0xF000000000000000) >> 12) | ((x & 0x0FFF000000000000) << 4);
+    }
+}
+static void aes_ct64_inv_shift_rows(uint64_t* q) {
+    for (unsigned i = 0; i < 8; i++) {
+        const uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFF)
+            | ((x & 0x000000000FFF0000) << 4) | ((x & 0x00000000F0000000) >> 12)
+            | ((x & 0x000000FF00000000) << 8) | ((x & 0x0000FF0000000000) >> 8)
+            | ((x & 0x000F000000000000) << 12) | ((x & 0xFFF0000000000000) >> 4);
+    }
+}
+
+/* Rotate rows: by 1 row (16 bits) & 2 rows (32 bits) */
+#define CT64_ROT16(x) (((x) >> 16) | ((x) << 48))
+#define CT64_ROT32(x) (((x) >> 32) | ((x) << 32))
+
+static void aes_ct64_mix_columns(uint64_t* q) {
+    const uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    const uint64_t r0 = CT64_ROT16(q0), r1 = CT64_ROT16(q1), r2 = CT64_ROT16(q2), r3 = CT64_ROT16(q3);
+    const uint64_t r4 = CT64_ROT16(q4), r5 = CT64_ROT16(q5), r6 = CT64_ROT16(q6), r7 = CT64_ROT16(q7);
+    q[0] = q7 ^ r7 ^ r0 ^ CT64_ROT32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ CT64_ROT32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ CT64_ROT32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ CT64_ROT32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ CT64_ROT32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ CT64_ROT32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ CT64_ROT32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ CT64_ROT32(q7 ^ r7);
+}
+
+/* InvMixColumns = MixColumns after a ^= 4 * (a ^ (a rotated 2 rows)) (each column: [5, 0, 4, 0] circulant) */
+static void aes_ct64_inv_mix_columns(uint64_t* q) {
+    uint64_t t[8];
+    for (unsigned i = 0; i < 8; i++) t[i] = q[i] ^ CT64_ROT32(q[i]);
+    // multiply t by x^2 on bit planes (x^8 = x^4 + x^3 + x + 1)
+    const uint64_t t6 = t[6], t7 = t[7];
+    q[0] ^= t6;
+    q[1] ^= t7 ^ t6;
+    q[2] ^= t[0] ^ t7;
+    q[3] ^= t[1] ^ t6;
+    q[4] ^= t[2] ^ t7 ^ t6;
+    q[5] ^= t[3] ^ t7;
+    q[6] ^= t[4];
+    q[7] ^= t[5];
+    aes_ct64_mix_columns(q);
+}
+
+#define CT64_ADD_ROUND_KEY(q, sk) \
+    for (unsigned _i = 0; _i < 8; _i++) (q)[_i] ^= (sk)[_i];
+
+/* Bitsliced round keys (sk gets 8 words per round key) from schedule round keys in usage order
+ * dec_step 0: encryption k0 ... kR
+ * dec_step 1: decryption (full schedule) kR, kR+1 ... k2R-1, k0
+ * dec_step -1: decryption (dec schedule) kR, kR-1 ... k1, k0 */
+static void aes_ct64_load_keys(const uint8_t* s, uint32_t rounds, int32_t dec_step, uint64_t* sk) {
+    for (uint32_t r = 0; r <= rounds; r++, sk += 8) {
+        const uint32_t i = dec_step ? (r == rounds ? 0 : (uint32_t)((int32_t)rounds + dec_step * (int32_t)r)) : r;
+        aes_ct64_interleave_in(&sk[0], &sk[4], s + (i << 4));
+        sk[1] = sk[2] = sk[3] = sk[0];
+        sk[5] = sk[6] = sk[7] = sk[4];
+        aes_ct64_ortho(sk);
+    }
+}
+
+/* Load up to 8 blocks into two q sets (missing blocks are zeros) & transpose */
+static void aes_ct64_load8(uint64_t* qa, uint64_t* qb, const uint8_t (*src)[16], size_t n) {
+    static const uint8_t zero[16];
+    for (unsigned i = 0; i < 4; i++) {
+        aes_ct64_interleave_in(&qa[i], &qa[i + 4], i     < n ? src[i]     : zero);
+        aes_ct64_interleave_in(&qb[i], &qb[i + 4], i + 4 < n ? src[i + 4] : zero);
+    }
+    aes_ct64_ortho(qa);
+    aes_ct64_ortho(qb);
+}
+static void aes_ct64_store8(uint8_t (*dst)[16], uint64_t* qa, uint64_t* qb, size_t n) {
+    uint8_t block[16];
+    aes_ct64_ortho(qa);
+    aes_ct64_ortho(qb);
+    for (unsigned i = 0; i < 4; i++) {
+        aes_ct64_interleave_out(block, qa[i], qa[i + 4]);
+        if (i < n) memcpy(dst[i], block, 16);
+        aes_ct64_interleave_out(block, qb[i], qb[i + 4]);
+        if (i + 4 < n) memcpy(dst[i + 4], block, 16);
+    }
+}
+
+/* Encrypt 8 blocks per iteration (two independent q sets interleaved), tail is zero padded */
+static void aes_ct64_encrypt_blocks(const uint64_t* sk, uint32_t rounds, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) {
+    uint64_t qa[8], qb[8];
+    while (num_blocks) {
+        const size_t n = num_blocks < 8 ? num_blocks : 8;
+        aes_ct64_load8(qa, qb, src, n);
+        CT64_ADD_ROUND_KEY(qa, sk) CT64_ADD_ROUND_KEY(qb, sk)
+        for (uint32_t r = 1; r < rounds; r++) {
+            aes_ct64_sbox(qa);         aes_ct64_sbox(qb);
+            aes_ct64_shift_rows(qa);   aes_ct64_shift_rows(qb);
+            aes_ct64_mix_columns(qa);  aes_ct64_mix_columns(qb);
+            CT64_ADD_ROUND_KEY(qa, sk + (r << 3)) CT64_ADD_ROUND_KEY(qb, sk + (r << 3))
+        }
+        aes_ct64_sbox(qa);       aes_ct64_sbox(qb);
+        aes_ct64_shift_rows(qa); aes_ct64_shift_rows(qb);
+        CT64_ADD_ROUND_KEY(qa, sk + (rounds << 3)) CT64_ADD_ROUND_KEY(qb, sk + (rounds << 3))
+        aes_ct64_store8(dst, qa, qb, n);
+        num_blocks -= n; src += n; dst += n;
+    }
+}
+
+/* Decrypt 8 blocks per iteration, same round structure as aesdec (equivalent inverse cipher keys) */
+static void aes_ct64_decrypt_blocks(const uint64_t* sk, uint32_t rounds, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) {
+    uint64_t qa[8], qb[8];
+    while (num_blocks) {
+        const size_t n = num_blocks < 8 ? num_blocks : 8;
+        aes_ct64_load8(qa, qb, src, n);
+        CT64_ADD_ROUND_KEY(qa, sk) CT64_ADD_ROUND_KEY(qb, sk)
+        for (uint32_t r = 1; r < rounds; r++) {
+            aes_ct64_inv_shift_rows(qa);  aes_ct64_inv_shift_rows(qb);
+            aes_ct64_inv_sbox(qa);        aes_ct64_inv_sbox(qb);
+            aes_ct64_inv_mix_columns(qa); aes_ct64_inv_mix_columns(qb);
+            CT64_ADD_ROUND_KEY(qa, sk + (r << 3)) CT64_ADD_ROUND_KEY(qb, sk + (r << 3))
+        }
+        aes_ct64_inv_shift_rows(qa); aes_ct64_inv_shift_rows(qb);
+        aes_ct64_inv_sbox(qa);       aes_ct64_inv_sbox(qb);
+        CT64_ADD_ROUND_KEY(qa, sk + (rounds << 3)) CT64_ADD_ROUND_KEY(qb, sk + (rounds << 3))
+        aes_ct64_store8(dst, qa, qb, n);
+        num_blocks -= n; src += n; dst += n;
+    }
+}
+
+/* One AESENC round (SubBytes, ShiftRows, MixColumns, then xor rk[i]) on up to 8 blocks, each with its own round key
+ * (the pure C tier of the AES round based AEADs, see hidden_aes.h) */
+void aes_ct64_enc_round8(const uint8_t (*src)[16], const uint8_t (*rk)[16], uint8_t (*dst)[16], size_t n) {
+    uint64_t qa[8], qb[8], ka[8], kb[8];
+    aes_ct64_load8(qa, qb, src, n);
+    aes_ct64_load8(ka, kb, rk, n); /* same bit layout as the blocks: the xor commutes with the transpose */
+    aes_ct64_sbox(qa);        aes_ct64_sbox(qb);
+    aes_ct64_shift_rows(qa);  aes_ct64_shift_rows(qb);
+    aes_ct64_mix_columns(qa); aes_ct64_mix_columns(qb);
+    for (unsigned i = 0; i < 8; i++) { qa[i] ^= ka[i]; qb[i] ^= kb[i]; }
+    aes_ct64_store8(dst, qa, qb, n);
+}
+
+/* SubWord on one little-endian key word through the bitsliced S-box */
+static uint32_t aes_ct64_sub_word(uint32_t word) {
+    uint64_t q[8] = { word };
+    aes_ct64_ortho(q);
+    aes_ct64_sbox(q);
+    aes_ct64_ortho(q);
+    return (uint32_t)q[0];
+}
+
+/* --- Vector permute (SSSE3) internal --- (constant-time, for CPUs without AES-NI)
+ * Hamburg style pshufb S-box: a byte is mapped (two nibble table lookups) to tower field coordinates
+ * x = i*u + k over GF(16) (u a root of t^2 + 2t + 2), inverted with GF(16) 1/x & a/x lookups
+ * (1/0 = 0x80 so pshufb zeroes it), then mapped back by two more nibble lookups.
+ * ShiftRows & the MixColumns rotations are pshufb's, xtime is SSE2 arithmetic.
+ * Round keys use the AES-NI schedule layout (decryption follows aesdec with InvMixColumns'd keys).
+ */
+enum {
+    VP_IPT_LO, VP_IPT_HI,   /* standard byte -> tower coordinates (i << 4 | k) */
+    VP_DIPT_LO, VP_DIPT_HI, /* inverse affine (incl. 0x63) then tower coordinates */
+    VP_INV, VP_INV_A,       /* GF(16) 1/x & a/x (a = 2) */
+    VP_SO_I, VP_SO_J,       /* io, jo -> affine(inverse) without 0x63 */
+    VP_DO_I, VP_DO_J,       /* io, jo -> inverse */
+    VP_DO5_I, VP_DO5_J,     /* io, jo -> 5 * inverse (InvMixColumns pre-step) */
+    VP_DO4_I, VP_DO4_J,     /* io, jo -> 4 * inverse */
+    VP_SR, VP_INV_SR,       /* ShiftRows, InvShiftRows */
+    VP_ROT1, VP_ROT2,       /* rotate each column up by 1, 2 rows */
+    VP_ASSIST               /* keygenassist layout: X1, RotWord(X1), X3, RotWord(X3) */
+};
+static const uint8_t aes_vp_tables[][16] = {
+    /* IPT_LO  */ { 0x00, 0x01, 0x37, 0x36, 0xD0, 0xD1, 0xE7, 0xE6, 0xD2, 0xD3, 0xE5, 0xE4, 0x02, 0x03, 0x35, 0x34 },
+    /* IPT_HI  */ { 0x00, 0xBB, 0x7B, 0xC0, 0xBF, 0x04, 0xC4, 0x7F, 0xC8, 0x73, 0xB3, 0x08, 0x77, 0xCC, 0x0C, 0xB7 },
+    /* DIPT_LO */ { 0xD1, 0x8B, 0x72, 0x28, 0x79, 0x23, 0xDA, 0x80, 0xE2, 0xB8, 0x41, 0x1B, 0x4A, 0x10, 0xE9, 0xB3 },
+    /* DIPT_HI */ { 0x00, 0x63, 0x6C, 0x0F, 0x44, 0x27, 0x28, 0x4B, 0xAA, 0xC9, 0xC6, 0xA5, 0xEE, 0x8D, 0x82, 0xE1 },
+    /* INV     */ { 0x80, 0x01, 0x08, 0x0D, 0x0F, 0x06, 0x05, 0x0E, 0x02, 0x0C, 0x0B, 0x0A, 0x09, 0x03, 0x07, 0x04 },
+    /* INV_A   */ { 0x80, 0x02, 0x01, 0x0C, 0x08, 0x0B, 0x0D, 0x0A, 0x04, 0x0E, 0x07, 0x05, 0x03, 0x06, 0x09, 0x0F },
+    /* SO_I    */ { 0x00, 0xFA, 0x6A, 0x35, 0xBB, 0x2B, 0x5F, 0x41, 0x8E, 0xCF, 0x1E, 0xE4, 0x90, 0x74, 0xD1, 0xA5 },
+    /* SO_J    */ { 0x00, 0x81, 0x76, 0x99, 0xFD, 0x0A, 0xEF, 0x7C, 0x64, 0x18, 0x93, 0x12, 0xF7, 0xE5, 0x8B, 0x6E },
+    /* DO_I    */ { 0x00, 0x9C, 0x1D, 0x8E, 0x44, 0xC5, 0x93, 0xD8, 0xCA, 0x12, 0x4B, 0xD7, 0x81, 0x56, 0x59, 0x0F },
+    /* DO_J    */ { 0x00, 0x6F, 0xC2, 0x99, 0x6B, 0xC6, 0x5B, 0x04, 0xF2, 0xF6, 0x5F, 0x30, 0xAD, 0x9D, 0xA9, 0x34 },
+    /* DO5_I   */ { 0x00, 0xDA, 0x69, 0x80, 0x4F, 0xFC, 0xE9, 0x95, 0xCF, 0x5A, 0x7C, 0xA6, 0xB3, 0x15, 0x26, 0x33 },
+    /* DO5_J   */ { 0x00, 0xC8, 0xE7, 0xCB, 0xDC, 0xF3, 0x2C, 0x14, 0x17, 0x03, 0x38, 0xF0, 0x2F, 0xDF, 0x3B, 0xE4 },
+    /* DO4_I   */ { 0x00, 0x46, 0x74, 0x0E, 0x0B, 0x39, 0x7A, 0x4D, 0x05, 0x48, 0x37, 0x71, 0x32, 0x43, 0x7F, 0x3C },
+    /* DO4_J   */ { 0x00, 0xA7, 0x25, 0x52, 0xB7, 0x35, 0x77, 0x10, 0xE5, 0xF5, 0x67, 0xC0, 0x82, 0x42, 0x92, 0xD0 },
+    /* SR      */ { 0x00, 0x05, 0x0A, 0x0F, 0x04, 0x09, 0x0E, 0x03, 0x08, 0x0D, 0x02, 0x07, 0x0C, 0x01, 0x06, 0x0B },
+    /* INV_SR  */ { 0x00, 0x0D, 0x0A, 0x07, 0x04, 0x01, 0x0E, 0x0B, 0x08, 0x05, 0x02, 0x0F, 0x0C, 0x09, 0x06, 0x03 },
+    /* ROT1    */ { 0x01, 0x02, 0x03, 0x00, 0x05, 0x06, 0x07, 0x04, 0x09, 0x0A, 0x0B, 0x08, 0x0D, 0x0E, 0x0F, 0x0C },
+    /* ROT2    */ { 0x02, 0x03, 0x00, 0x01, 0x06, 0x07, 0x04, 0x05, 0x0A, 0x0B, 0x08, 0x09, 0x0E, 0x0F, 0x0C, 0x0D },
+    /* ASSIST  */ { 0x04, 0x05, 0x06, 0x07, 0x05, 0x06, 0x07, 0x04, 0x0C, 0x0D, 0x0E, 0x0F, 0x0D, 0x0E, 0x0F, 0x0C }
+};
+#define VP_TAB(t) _mm_loadu_si128((const __m128i *) aes_vp_tables[t])
+#define VP_LOOKUP(t, idx) _mm_shuffle_epi8(VP_TAB(t), idx) /* bytes of table t at nibble indices idx */
+#define VP_PERMUTE(x, t)  _mm_shuffle_epi8(x, VP_TAB(t))   /* bytes of x moved as table t says */
+
+/* Linear byte transform: lookup low & high nibbles in tables lo & hi */
+TARGET("ssse3") static inline __m128i aes_vp_transform(__m128i x, int lo, int hi) {
+    const __m128i m0f = _mm_set1_epi8(0x0F);
+    return _mm_xor_si128(VP_LOOKUP(lo, _mm_and_si128(x, m0f)), VP_LOOKUP(hi, _mm_and_si128(_mm_srli_epi16(x, 4), m0f)));
+}
+
+/* Tower field inversion core: y = (i << 4 | k) -> io, jo nibbles (0x80 flagged lanes read as 0 by pshufb) */
+#define VP_INVERT(y, io, jo) {                                                       \
+    const __m128i _m0f = _mm_set1_epi8(0x0F);                                        \
+    const __m128i _k = _mm_and_si128(y, _m0f);                                       \
+    const __m128i _i = _mm_and_si128(_mm_srli_epi16(y, 4), _m0f);                    \
+    const __m128i _j = _mm_xor_si128(_i, _k);                                        \
+    const __m128i _ak = VP_LOOKUP(VP_INV_A, _k);                                     \
+    const __m128i _iak = _mm_xor_si128(VP_LOOKUP(VP_INV, _i), _ak); /* 1/i + a/k */  \
+    const __m128i _jak = _mm_xor_si128(VP_LOOKUP(VP_INV, _j), _ak); /* 1/j + a/k */  \
+    (io) = _mm_xor_si128(VP_LOOKUP(VP_INV, _iak), _j);                               \
+    (jo) = _mm_xor_si128(VP_LOOKUP(VP_INV, _jak), _i);                               \
+}
+
+/* Multiply each byte by 2 in GF(2^8) */
+TARGET("ssse3") static inline __m128i aes_vp_xtime(__m128i x) {
+    const __m128i carry = _mm_cmplt_epi8(x, _mm_setzero_si128());
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(carry, _mm_set1_epi8(0x1B)));
+}
+
+/* MixColumns: 2 b0 + 3 b1 + b2 + b3 = xtime(b0 + b1) + b1 + (b2 + b3) */
+TARGET("ssse3") static inline __m128i aes_vp_mix_columns(__m128i x) {
+    const __m128i r1 = VP_PERMUTE(x, VP_ROT1);
+    const __m128i t = _mm_xor_si128(x, r1);
+    return _mm_xor_si128(_mm_xor_si128(aes_vp_xtime(t), r1), VP_PERMUTE(t, VP_ROT2));
+}
+
+/* SubBytes on all 16 bytes */
+TARGET("ssse3") static inline __m128i aes_vp_sub_bytes(__m128i x) {
+    __m128i io, jo;
+    VP_INVERT(aes_vp_transform(x, VP_IPT_LO, VP_IPT_HI), io, jo)
+    return _mm_xor_si128(_mm_xor_si128(VP_LOOKUP(VP_SO_I, io), VP_LOOKUP(VP_SO_J, jo)), _mm_set1_epi8(0x63));
+}
+
+/* Same as _mm_aesenc_si128 / _mm_aesenclast_si128 (SubBytes commutes with ShiftRows, so shift first) */
+TARGET("ssse3") static inline __m128i aes_vp_enc_round(__m128i x, __m128i rk, bool last) {
+    x = aes_vp_sub_bytes(VP_PERMUTE(x, VP_SR));
+    return _mm_xor_si128(last ? x : aes_vp_mix_columns(x), rk);
+}
+
+/* Same as _mm_aesdec_si128 / _mm_aesdeclast_si128
+ * InvMixColumns(z) = MixColumns(5 z + 4 z rotated 2 rows), the 5z & 4z come straight from the output tables */
+TARGET("ssse3") static inline __m128i aes_vp_dec_round(__m128i x, __m128i rk, bool last) {
+    __m128i io, jo;
+    VP_INVERT(aes_vp_transform(VP_PERMUTE(x, VP_INV_SR), VP_DIPT_LO, VP_DIPT_HI), io, jo)
+    if (last) return _mm_xor_si128(_mm_xor_si128(VP_LOOKUP(VP_DO_I, io), VP_LOOKUP(VP_DO_J, jo)), rk);
+    const __m128i z5 = _mm_xor_si128(VP_LOOKUP(VP_DO5_I, io), VP_LOOKUP(VP_DO5_J, jo));
+    const __m128i z4 = _mm_xor_si128(VP_LOOKUP(VP_DO4_I, io), VP_LOOKUP(VP_DO4_J, jo));
+    return _mm_xor_si128(aes_vp_mix_columns(_mm_xor_si128(z5, VP_PERMUTE(z4, VP_ROT2))), rk);
+}
+
+/* Same as _mm_aesimc_si128: MixColumns(x + 4 (x + x rotated 2 rows)) */
+TARGET("ssse3") static inline __m128i aes_vp_inv_mix_columns(__m128i x) {
+    const __m128i t = _mm_xor_si128(x, VP_PERMUTE(x, VP_ROT2));
+    return aes_vp_mix_columns(_mm_xor_si128(x, aes_vp_xtime(aes_vp_xtime(t))));
+}
+
+/* Same as _mm_aeskeygenassist_si128 (rcon may be a runtime value) */
+TARGET("ssse3") static inline __m128i aes_vp_keygenassist(__m128i x, uint32_t rcon) {
+    const __m128i sub = aes_vp_sub_bytes(x);
+    return _mm_xor_si128(VP_PERMUTE(sub, VP_ASSIST), _mm_set_epi32((int)rcon, 0, (int)rcon, 0));
+}
+
+/* Blocks transforms: 2 blocks per pass (independent pshufb chains), schedule round keys in usage order
+ * (encryption k0 ... kR, decryption kR, kR+dec_step ... k0 with dec_step 1 for full & -1 for dec schedules) */
+TARGET("ssse3") static void aes_vp_encrypt_blocks(const uint8_t* s, uint32_t rounds, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) {
+    const __m128i *ks = (const __m128i *) s;
+    for (; num_blocks >= 2; num_blocks -= 2, src += 2, dst += 2) {
+        __m128i rk = _mm_loadu_si128(ks);
+        __m128i m0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (src + 0)), rk);
+        __m128i m1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (src + 1)), rk);
+        for (uint32_t r = 1; r <= rounds; r++) {
+            rk = _mm_loadu_si128(ks + r);
+            m0 = aes_vp_enc_round(m0, rk, r == rounds);
+            m1 = aes_vp_enc_round(m1, rk, r == rounds);
+        }
+        _mm_storeu_si128((__m128i *) (dst + 0), m0);
+        _mm_storeu_si128((__m128i *) (dst + 1), m1);
+    }
+    if (num_blocks) {
+        __m128i m0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) src), _mm_loadu_si128(ks));
+        for (uint32_t r = 1; r <= rounds; r++) m0 = aes_vp_enc_round(m0, _mm_loadu_si128(ks + r), r == rounds);
+        _mm_storeu_si128((__m128i *) dst, m0);
+    }
+}
+TARGET("ssse3") static void aes_vp_decrypt_blocks(const uint8_t* s, uint32_t rounds, int32_t dec_step, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) {
+    const __m128i *ks = (const __m128i *) s;
+    #define VP_DEC_KEY(r) _mm_loadu_si128(ks + (r == rounds ? 0 : (int32_t)rounds + dec_step * (int32_t)r))
+    for (; num_blocks >= 2; num_blocks -= 2, src += 2, dst += 2) {
+        __m128i rk = _mm_loadu_si128(ks + rounds);
+        __m128i m0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (src + 0)), rk);
+        __m128i m1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (src + 1)), rk);
+        for (uint32_t r = 1; r <= rounds; r++) {
+            rk = VP_DEC_KEY(r);
+            m0 = aes_vp_dec_round(m0, rk, r == rounds);
+            m1 = aes_vp_dec_round(m1, rk, r == rounds);
+        }
+        _mm_storeu_si128((__m128i *) (dst + 0), m0);
+        _mm_storeu_si128((__m128i *) (dst + 1), m1);
+    }
+    if (num_blocks) {
+        __m128i m0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *) src), _mm_loadu_si128(ks + rounds));
+        for (uint32_t r = 1; r <= rounds; r++) m0 = aes_vp_dec_round(m0, VP_DEC_KEY(r), r == rounds);
+        _mm_storeu_si128((__m128i *) dst, m0);
+    }
+    #undef VP_DEC_KEY
+}
+
+/* Dec layout from enc layout (k0, InvMixColumns(k1 ... kR-1), kR), dec may alias enc */
+TARGET("ssse3") static void aes_vp_invert_keys(const uint8_t* enc, uint8_t* dec, uint32_t rounds) {
+    const __m128i *e = (const __m128i *) enc;
+    __m128i *d = (__m128i *) dec;
+    _mm_storeu_si128(d, _mm_loadu_si128(e));
+    for (uint32_t i = 1; i < rounds; i++) _mm_storeu_si128(d + i, aes_vp_inv_mix_columns(_mm_loadu_si128(e + i)));
+    _mm_storeu_si128(d + rounds, _mm_loadu_si128(e + rounds));
+}
+
+/* Xor's of: 0, 1, 2, 3 word offsets (running xor of the previous round key's words) */
+TARGET("ssse3") static inline __m128i aes_vp_prefix_xor(__m128i x) {
+    x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+    return _mm_xor_si128(x, _mm_slli_si128(x, 8));
+}
+
+/* Key schedule generator (key_words = 4, 6, 8), same layout as the AES-NI generators
+ * Walks the round keys 4 words at a time (192: 4 + 2 words), keygenassist emulated by the pshufb S-box */
+TARGET("ssse3") static void aes_vp_load_key(const uint8_t* key, uint8_t* schedule, uint32_t key_words, aes_sched_type_t type) {
+    const uint32_t rounds = key_words + 6;
+    uint32_t *s = (uint32_t *) schedule;
+    __m128i a = _mm_loadu_si128((const __m128i *) key);
+    __m128i b = _mm_setzero_si128();
+    _mm_storeu_si128((__m128i *) s, a); s += 4;
+    switch (key_words) {
+        case 8: b = _mm_loadu_si128((const __m128i *) (key + 16)); _mm_storeu_si128((__m128i *) s, b); s += 4; break;
+        case 6: b = _mm_loadl_epi64((const __m128i *) (key + 16));  _mm_storel_epi64((__m128i *) s, b); s += 2; break;
+    }
+    uint32_t *stop = (uint32_t *) schedule + ((rounds + 1) << 2);
+    uint32_t rcon = 0x01;
+    while (s < stop) {
+        switch (key_words) {
+            case 4: // RotWord(SubWord(w3)) + rcon
+                a = _mm_xor_si128(aes_vp_prefix_xor(a), _mm_shuffle_epi32(aes_vp_keygenassist(a, rcon), _MM_SHUFFLE(3, 3, 3, 3)));
+                _mm_storeu_si128((__m128i *) s, a); s += 4;
+                break;
+            case 6: { // RotWord(SubWord(w5)) + rcon, last 2 words chain from the new w3
+                a = _mm_xor_si128(aes_vp_prefix_xor(a), _mm_shuffle_epi32(aes_vp_keygenassist(b, rcon), _MM_SHUFFLE(1, 1, 1, 1)));
+                _mm_storeu_si128((__m128i *) s, a); s += 4;
+                if (s >= stop) break;
+                b = _mm_xor_si128(b, _mm_slli_si128(b, 4));
+                b = _mm_xor_si128(b, _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 3, 3)));
+                _mm_storel_epi64((__m128i *) s, b); s += 2;
+                break;
+            }
+            case 8: // RotWord(SubWord(w7)) + rcon, last 4 words use SubWord(new w3)
+                a = _mm_xor_si128(aes_vp_prefix_xor(a), _mm_shuffle_epi32(aes_vp_keygenassist(b, rcon), _MM_SHUFFLE(3, 3, 3, 3)));
+                _mm_storeu_si128((__m128i *) s, a); s += 4;
+                if (s >= stop) break;
+                b = _mm_xor_si128(aes_vp_prefix_xor(b), _mm_shuffle_epi32(aes_vp_keygenassist(a, 0), _MM_SHUFFLE(2, 2, 2, 2)));
+                _mm_storeu_si128((__m128i *) s, b); s += 4;
+                break;
+        }
+        rcon = (rcon << 1) ^ (0x11BU & -(rcon >> 7));
+    }
+    __m128i *ks = (__m128i *) schedule;
+    switch (type) {
+        case AES_SCHED_FULL: // append inverted intermediates in usage order
+            for (uint32_t i = 1; i < rounds; i++)
+                _mm_storeu_si128(ks + rounds + i, aes_vp_inv_mix_columns(_mm_loadu_si128(ks + rounds - i)));
+            break;
+        case AES_SCHED_DEC: // invert intermediates in place
+            aes_vp_invert_keys(schedule, schedule, rounds);
+            break;
+        default: break;
+    }
+}
+
 /* --- Key schedule generators --- (writes to provided array)
  * keygenassist needs const imm8 values
  * Round key storage:
@@ -181,7 +683,7 @@ const uint8_t InvSbox[256] = {
  * 'last'         = k[N-1] shared by last  encryption & first decryption rounds
  * intermediates  = k[1, N-2] encryption round keys in usage order (enc & full schedules)
  * intermediates* = k[1, N-2] decryption round keys in REVERSE usage order (iterate back to front, dec schedule)
- * intermediates+ = k[N, 2N-3] decryption round keys in REVERSE usage order (iterate back to front, full schedule)
+ * intermediates+ = k[N, 2N-3] decryption round keys in usage order (full schedule, same as AES-NI layout)
  */
 
 typedef enum {
@@ -190,9 +692,9 @@ typedef enum {
     KEY_256_CODE = 0
 } AES_KEY_CODE;
 typedef enum {
-    SCHED_FULL_CODE = 0,
-    SCHED_ENC_CODE  = 1,
-    SCHED_DEC_CODE  = 2
+    SCHED_FULL_CODE = AES_SCHED_FULL,
+    SCHED_ENC_CODE  = AES_SCHED_ENC,
+    SCHED_DEC_CODE  = AES_SCHED_DEC
 } AES_SCHED_TYPE_CODE;
 typedef enum {
     // Encoded data: key_codec_offset (5 bits), sched_type (2 bits)
@@ -214,7 +716,7 @@ void aes_load_key_c(const uint32_t* key, uint32_t* schedule, AES_SCHED_CODE sche
     const uint32_t key_case = SCHED_CODE_GET_KEYCODE(schedcode); // 256=0, 192=1, 128=2
 
     // Copy original key, saving to working variables
-    uint32_t w1, w2, w3, w4, w5, w6, w7, w8, last; // 4-8 words in each iteration
+    uint32_t w1, w2, w3, w4, w5 = 0, w6 = 0, w7 = 0, w8 = 0, last; // 4-8 words in each iteration, unused ones stay 0
     uint32_t *dst;
     {
         const uint32_t offset = 7 - (key_case << 1); // 1 less than 32 bit words in key
@@ -226,10 +728,12 @@ void aes_load_key_c(const uint32_t* key, uint32_t* schedule, AES_SCHED_CODE sche
             case 0: // aes 256
                 w8 = *key--; *dst-- = w8;
                 w7 = *key--; *dst-- = w7;
+                FALLTHROUGH;
             case 1: // aes 192
                 w6 = *key--; *dst-- = w6;
                 w5 = *key--; *dst-- = w5;
-            case 2: // aes 128
+                FALLTHROUGH;
+            default: // aes 128
                 w4 = *key--; *dst-- = w4;
                 w3 = *key--; *dst-- = w3;
                 w2 = *key--; *dst-- = w2;
@@ -240,10 +744,10 @@ void aes_load_key_c(const uint32_t* key, uint32_t* schedule, AES_SCHED_CODE sche
 
     // Produce encryption round keys (intermediates + last)
     uint32_t iterations = (1 << key_case) + 5; // 256=6, 192=7, 128=9, = actual - 1 round key (see goto)
-    uint32_t rcon = 0x01000000U;
+    uint32_t rcon = 0x01U;
     goto aes128_case_block; // 192, 256 only first 4 in last iteration
     while (iterations--) {
-        rcon = (rcon << 1) ^ (0x1B000000U & ((int32_t)rcon >> 31)); // Arithmetic/Signed shift for masking, 0x80000000 or greater
+        rcon = (rcon << 1) ^ (0x11BU & -(rcon >> 7)); // xtime, mask is all ones when 0x80 is shifted out
         switch (key_case) {
             case 0: // aes 256
                 w5 ^= SUB_WORD(w4); *dst++ = w5;
@@ -253,9 +757,10 @@ void aes_load_key_c(const uint32_t* key, uint32_t* schedule, AES_SCHED_CODE sche
                 last = w8;
                 goto aes128_case_block;
             case 1: // aes 192
-                w5 ^= SUB_WORD(w4); *dst++ = w5;
+                w5 ^= w4;           *dst++ = w5;
                 w6 ^= w5;           *dst++ = w6;
                 last = w6;
+                FALLTHROUGH;
             case 2: // aes 128
                 aes128_case_block:
                 w1 ^= SUBROT_WORD(last) ^ rcon; *dst++ = w1;
@@ -271,397 +776,544 @@ void aes_load_key_c(const uint32_t* key, uint32_t* schedule, AES_SCHED_CODE sche
     if (schedtype == SCHED_ENC_CODE) return;
     uint32_t num_dec_keys = 13U - (key_case << 1); // 256=13, 192=11, 128=9
 
-    uint32_t *src = schedule + 4;
-    // dst is currently pointing behind last round KEY_128_CODE
-    // if dec schedule, repoint to round key after initial to overwrite intermediates
-    {
-        // dst = (schedtype == SCHED_DEC_CODE) ? src : dst;
-        dst -= (-(schedtype == SCHED_DEC_CODE)) & (num_dec_keys + 1);
-    }
+    // dst is currently pointing behind last round key
+    // full schedule: walk intermediates back to front, appending after last (usage order)
+    // dec schedule: overwrite intermediates in place (round key after initial)
+    const int32_t step = (schedtype == SCHED_DEC_CODE) ? 4 : -4;
+    uint32_t *src = (schedtype == SCHED_DEC_CODE) ? schedule + 4 : dst - 8;
+    dst = (schedtype == SCHED_DEC_CODE) ? src : dst;
 
     while (num_dec_keys--) {
         uint32_t row0, row1, row2, row3, row0_b, row1_b, row2_b, row3_b;
         LOAD_ROWS(src, row0, row1, row2, row3);
         INV_MIX_COLUMNS(row0, row1, row2, row3, row0_b, row1_b, row2_b, row3_b);
         SAVE_ROWS(dst, row0_b, row1_b, row2_b, row3_b);
-        src++; dst++;
+        src += step; dst += 4;
     }
 }
 
-#define AES_KEY_EXP_ITER_FIRST4(above_words, keygen) \
-    above_words = _mm_xor_si128(above_words, _mm_slli_si128(above_words, 4)); /* xor's of: 0, 1       offsets */ \
-    above_words = _mm_xor_si128(above_words, _mm_slli_si128(above_words, 8)); /* xor's of: 0, 1, 2, 3 offsets */ \
-    keygen = _mm_shuffle_epi32(keygen, _MM_SHUFFLE(3, 3, 3, 3)); /* Copy last word to all 4 words in keygen */   \
-    above_words = _mm_xor_si128(above_words, keygen);
-
-void aes128_load_key_internal(const aes128_key_t* key, aes128_sched_full_t* schedule, bool full) {
-    if (_hardware.aes) {
-        __m128i *s = (__m128i *) (schedule->bytes);
-        __m128i last = _mm_loadu_si128((const __m128i*) (key->bytes));
-        _mm_storeu_si128(s, last); // First 4 words = original key
-
-        __m128i keygen = _mm_aeskeygenassist_si128(last, 0x01);
-        uint32_t next_case = 0;
-
-        rcon_cases_loop:
-        // key expansion part || 4 words at a time (1 round key)
-        AES_KEY_EXP_ITER_FIRST4(last, keygen)
-        _mm_storeu_si128(++s, last); // move pointer before store
-
-        switch (next_case) {
-            #define case_block(THIS_CASE, NEXT_CASE, rcon)          \
-                case THIS_CASE: next_case = NEXT_CASE;              \
-                    keygen = _mm_aeskeygenassist_si128(last, rcon); \
-                    goto rcon_cases_loop;
-            case_block(0, 1, 0x02)
-            case_block(1, 2, 0x04)
-            case_block(2, 3, 0x08)
-            case_block(3, 4, 0x10)
-            case_block(4, 5, 0x20)
-            case_block(5, 6, 0x40)
-            case_block(6, 7, 0x80)
-            case_block(7, 8, 0x1B)
-            case_block(8, 9, 0x36)
-            #undef case_block
-            case 9: break;
-        }
+/* Key expansion lane appliers: run lane macro M(l, arg, E) over each key in flight
+ * (l is pasted onto the lane's state: a##l, b##l working words, s##l output pointer, E is the engine) */
+#define AES_KEY_LANES_X1(M, arg, E) M(0, arg, E)
+#define AES_KEY_LANES_X4(M, arg, E) M(0, arg, E) M(1, arg, E) M(2, arg, E) M(3, arg, E)
+#define AES_KEY_LANES_X8(M, arg, E) AES_KEY_LANES_X4(M, arg, E) M(4, arg, E) M(5, arg, E) M(6, arg, E) M(7, arg, E)
+
+/* Key expansion engines: SubWord/RotWord terms broadcast to all 4 words (rcon is a const int)
+ *   ROT3 - RotWord(SubWord(w3)) ^ rcon | ROT1 - RotWord(SubWord(w1)) ^ rcon | SUB3 - SubWord(w3)
+ * kga:     aeskeygenassist + pshufd (microcoded on many CPUs, needs imm8 rcon)
+ * enclast: pshufb broadcast (+ RotWord) + aesenclast (ShiftRows is a no-op on equal columns, so it is
+ *          just SubBytes ^ rcon, 2 simple uops) */
+#define AES_KEY_ROT3_kga(w, rcon) _mm_shuffle_epi32(_mm_aeskeygenassist_si128(w, rcon), _MM_SHUFFLE(3, 3, 3, 3))
+#define AES_KEY_ROT1_kga(w, rcon) _mm_shuffle_epi32(_mm_aeskeygenassist_si128(w, rcon), _MM_SHUFFLE(1, 1, 1, 1))
+#define AES_KEY_SUB3_kga(w)       _mm_shuffle_epi32(_mm_aeskeygenassist_si128(w, 0x00), _MM_SHUFFLE(2, 2, 2, 2))
+#define AES_KEY_ROT3_enclast(w, rcon) _mm_aesenclast_si128(_mm_shuffle_epi8(w, _mm_set1_epi32(0x0c0f0e0d)), _mm_set1_epi32(rcon))
+#define AES_KEY_ROT1_enclast(w, rcon) _mm_aesenclast_si128(_mm_shuffle_epi8(w, _mm_set1_epi32(0x04070605)), _mm_set1_epi32(rcon))
+#define AES_KEY_SUB3_enclast(w)       _mm_aesenclast_si128(_mm_shuffle_epi8(w, _mm_set1_epi32(0x0f0e0d0c)), _mm_setzero_si128())
+
+/* Next 4 words from the previous 4 (w) & the broadcast SubWord/RotWord term (t) */
+#define AES_KEY_EXP_MIX(w, t)                                                    \
+    w = _mm_xor_si128(w, _mm_slli_si128(w, 4)); /* xor's of: 0, 1       offsets */ \
+    w = _mm_xor_si128(w, _mm_slli_si128(w, 8)); /* xor's of: 0, 1, 2, 3 offsets */ \
+    w = _mm_xor_si128(w, t);
 
-        if (full) {
-            __m128i *ks = schedule->bytes;
-            ks[11] = _mm_aesimc_si128(ks[9]);
-            ks[12] = _mm_aesimc_si128(ks[8]);
-            ks[13] = _mm_aesimc_si128(ks[7]);
-            ks[14] = _mm_aesimc_si128(ks[6]);
-            ks[15] = _mm_aesimc_si128(ks[5]);
-            ks[16] = _mm_aesimc_si128(ks[4]);
-            ks[17] = _mm_aesimc_si128(ks[3]);
-            ks[18] = _mm_aesimc_si128(ks[2]);
-            ks[19] = _mm_aesimc_si128(ks[1]);
+/* Lane steps (rounds are unrolled below so rcon stays a constant)
+ * 128: a = last round key
+ * 192: a = words 0-3, b = words 4-5 (low half) of the last 6, s is a byte pointer (6 word stride)
+ * 256: a, b = last two round keys */
+#define AES128_KEY_LANE_INIT(l, _, E)                                                                  \
+    __m128i a##l = _mm_loadu_si128((const __m128i*) (key + l * 16));                                  \
+    __m128i* s##l = (__m128i*) (schedule + l * stride);                                                \
+    _mm_storeu_si128(s##l, a##l);
+#define AES128_KEY_LANE_STEP(l, rcon, E) {                                                             \
+    __m128i t##l = AES_KEY_ROT3_##E(a##l, rcon);                                                       \
+    AES_KEY_EXP_MIX(a##l, t##l)                                                                        \
+    _mm_storeu_si128(++s##l, a##l);                                                                    \
+}
+#define AES192_KEY_LANE_INIT(l, _, E)                                                                  \
+    __m128i a##l = _mm_loadu_si128((const __m128i*) (key + l * 24));                                  \
+    __m128i b##l = _mm_loadl_epi64((const __m128i*) (key + l * 24 + 16));                             \
+    uint8_t* s##l = schedule + l * stride;                                                             \
+    _mm_storeu_si128((__m128i*) s##l, a##l);                                                           \
+    _mm_storel_epi64((__m128i*) (s##l + 16), b##l); s##l += 24;
+#define AES192_KEY_LANE_STEP(l, rcon, E) {                                                             \
+    __m128i t##l = AES_KEY_ROT1_##E(b##l, rcon);                                                       \
+    AES_KEY_EXP_MIX(a##l, t##l)                                                                        \
+    b##l = _mm_xor_si128(b##l, _mm_slli_si128(b##l, 4)); /* xor's of: 0, 1 offsets */                 \
+    b##l = _mm_xor_si128(b##l, _mm_shuffle_epi32(a##l, _MM_SHUFFLE(3, 3, 3, 3)));                     \
+    _mm_storeu_si128((__m128i*) s##l, a##l);                                                           \
+    _mm_storel_epi64((__m128i*) (s##l + 16), b##l); s##l += 24;                                        \
+}
+#define AES192_KEY_LANE_LAST(l, rcon, E) { /* last iteration only needs 4 words */                     \
+    __m128i t##l = AES_KEY_ROT1_##E(b##l, rcon);                                                       \
+    AES_KEY_EXP_MIX(a##l, t##l)                                                                        \
+    _mm_storeu_si128((__m128i*) s##l, a##l);                                                           \
+}
+#define AES256_KEY_LANE_INIT(l, _, E)                                                                  \
+    __m128i a##l = _mm_loadu_si128((const __m128i*) (key + l * 32));                                  \
+    __m128i b##l = _mm_loadu_si128((const __m128i*) (key + l * 32 + 16));                             \
+    __m128i* s##l = (__m128i*) (schedule + l * stride);                                                \
+    _mm_storeu_si128(s##l, a##l);                                                                      \
+    _mm_storeu_si128(++s##l, b##l);
+#define AES256_KEY_LANE_STEP(l, rcon, E) { /* even round key: SubWord(RotWord(b3)) ^ rcon */           \
+    __m128i t##l = AES_KEY_ROT3_##E(b##l, rcon);                                                       \
+    AES_KEY_EXP_MIX(a##l, t##l)                                                                        \
+    _mm_storeu_si128(++s##l, a##l);                                                                    \
+}
+#define AES256_KEY_LANE_STEP_ODD(l, _, E) { /* odd round key: SubWord(a3) */                           \
+    __m128i t##l = AES_KEY_SUB3_##E(a##l);                                                             \
+    AES_KEY_EXP_MIX(b##l, t##l)                                                                        \
+    _mm_storeu_si128(++s##l, b##l);                                                                    \
+}
+
+/* Expand X (lane applier) keys from key into schedules stride bytes apart (encryption round keys only) */
+#define AES128_KEY_EXPAND_AMD64(X, E) {                                                                 \
+    X(AES128_KEY_LANE_INIT, 0, E)                                                                       \
+    X(AES128_KEY_LANE_STEP, 0x01, E) X(AES128_KEY_LANE_STEP, 0x02, E) X(AES128_KEY_LANE_STEP, 0x04, E) \
+    X(AES128_KEY_LANE_STEP, 0x08, E) X(AES128_KEY_LANE_STEP, 0x10, E) X(AES128_KEY_LANE_STEP, 0x20, E) \
+    X(AES128_KEY_LANE_STEP, 0x40, E) X(AES128_KEY_LANE_STEP, 0x80, E) X(AES128_KEY_LANE_STEP, 0x1B, E) \
+    X(AES128_KEY_LANE_STEP, 0x36, E)                                                                    \
+}
+#define AES192_KEY_EXPAND_AMD64(X, E) {                                                                 \
+    X(AES192_KEY_LANE_INIT, 0, E)                                                                       \
+    X(AES192_KEY_LANE_STEP, 0x01, E) X(AES192_KEY_LANE_STEP, 0x02, E) X(AES192_KEY_LANE_STEP, 0x04, E) \
+    X(AES192_KEY_LANE_STEP, 0x08, E) X(AES192_KEY_LANE_STEP, 0x10, E) X(AES192_KEY_LANE_STEP, 0x20, E) \
+    X(AES192_KEY_LANE_STEP, 0x40, E) X(AES192_KEY_LANE_LAST, 0x80, E)                                   \
+}
+#define AES256_KEY_EXPAND_AMD64(X, E) {                                                                 \
+    X(AES256_KEY_LANE_INIT, 0, E)                                                                       \
+    X(AES256_KEY_LANE_STEP, 0x01, E) X(AES256_KEY_LANE_STEP_ODD, 0, E)                                  \
+    X(AES256_KEY_LANE_STEP, 0x02, E) X(AES256_KEY_LANE_STEP_ODD, 0, E)                                  \
+    X(AES256_KEY_LANE_STEP, 0x04, E) X(AES256_KEY_LANE_STEP_ODD, 0, E)                                  \
+    X(AES256_KEY_LANE_STEP, 0x08, E) X(AES256_KEY_LANE_STEP_ODD, 0, E)                                  \
+    X(AES256_KEY_LANE_STEP, 0x10, E) X(AES256_KEY_LANE_STEP_ODD, 0, E)                                  \
+    X(AES256_KEY_LANE_STEP, 0x20, E) X(AES256_KEY_LANE_STEP_ODD, 0, E)                                  \
+    X(AES256_KEY_LANE_STEP, 0x40, E)                                                                    \
+}
+
+/* Bytes per schedule of the given layout (full: 2R round keys, enc & dec: R + 1) */
+#define AES_SCHED_BYTES(rounds, type) ((size_t) ((type) == AES_SCHED_FULL ? 2 * (rounds) : (rounds) + 1) << 4)
+
+/* Finish num_keys expanded enc schedules (stride bytes apart) into the requested layout */
+TARGET("aes") static inline void aes_invert_keys_aesni(uint8_t* schedule, size_t stride, size_t num_keys, uint32_t rounds, aes_sched_type_t type) {
+    if (type == AES_SCHED_ENC) return;
+    for (; num_keys--; schedule += stride) {
+        __m128i *ks = (__m128i *) schedule;
+        if (type == AES_SCHED_FULL) { // append inverted intermediates in usage order
+            for (uint32_t i = 1; i < rounds; i++) _mm_storeu_si128(ks + 2 * rounds - i, _mm_aesimc_si128(_mm_loadu_si128(ks + i)));
+        } else {                      // invert intermediates in place
+            for (uint32_t i = 1; i < rounds; i++) _mm_storeu_si128(ks + i, _mm_aesimc_si128(_mm_loadu_si128(ks + i)));
         }
-        return;
     }
-    /* C implementation */
-}
-
-void aes192_load_key_internal(const aes192_key_t* key, aes192_sched_full_t* schedule, bool full) {
-    if (_hardware.aes) {
-        uint32_t *s = (uint32_t*) (schedule->bytes);
-        __m128i last_f4 = _mm_loadu_si128((const __m128i*) (key->bytes));
-        __m128i last_56 = _mm_loadl_epi64(((const __m128i*) (key->bytes)) + 1);
-        _mm_storeu_si128((const __m128i*) s, last_f4); s += 4; // First 6 words = original key
-        _mm_storel_epi64((const __m128i*) s, last_56); s += 2;
-
-        __m128i keygen = _mm_aeskeygenassist_si128(last_56, 0x01);
-        __m128i subword;
-        uint32_t next_case = 0;
-        goto first_four;
-
-        rcon_cases_loop:
-        // key expansion part || 6 words at a time || here for last two (5-6)
-        subword = _mm_aeskeygenassist_si128(last_f4, 0x00);
-        subword = _mm_shuffle_epi32(subword, _MM_SHUFFLE(2, 2, 2, 2)); // Copy 3rd word to all 4 words of subword
-        last_56 = _mm_xor_si128(last_56, _mm_slli_si128(last_56, 4)); // xor's of: 0, 1 offsets
-        last_56 =  _mm_xor_si128(last_56, subword);
-        _mm_storel_epi64((__m128i*)s, last_56); s += 2;
-        first_four:
-        AES_KEY_EXP_ITER_FIRST4(last_f4, keygen)
-        _mm_storeu_si128((const __m128i*) s, last_f4); s += 4;
-
-        switch (next_case) {
-            #define case_block(THIS_CASE, NEXT_CASE, rcon)             \
-                case THIS_CASE: next_case = NEXT_CASE;                 \
-                    keygen = _mm_aeskeygenassist_si128(last_56, rcon); \
-                    goto rcon_cases_loop;
-            case_block(0, 1, 0x02)
-            case_block(1, 2, 0x04)
-            case_block(2, 3, 0x08)
-            case_block(3, 4, 0x10)
-            case_block(4, 5, 0x20)
-            case_block(5, 6, 0x40)
-            #undef case_block
-            case 6: next_case = 7; // last iteration only needs 4 words
-                keygen = _mm_aeskeygenassist_si128(last_56, 0x80);
-                goto first_four;
-            case 7: break;
-        }
+}
 
-        if (full) {
-            __m128i *ks = schedule->bytes;
-            ks[13] = _mm_aesimc_si128(ks[11]);
-            ks[14] = _mm_aesimc_si128(ks[10]);
-            ks[15] = _mm_aesimc_si128(ks[9]);
-            ks[16] = _mm_aesimc_si128(ks[8]);
-            ks[17] = _mm_aesimc_si128(ks[7]);
-            ks[18] = _mm_aesimc_si128(ks[6]);
-            ks[19] = _mm_aesimc_si128(ks[5]);
-            ks[20] = _mm_aesimc_si128(ks[4]);
-            ks[21] = _mm_aesimc_si128(ks[3]);
-            ks[22] = _mm_aesimc_si128(ks[2]);
-            ks[23] = _mm_aesimc_si128(ks[1]);
-        }
-        return;
+/* Single & batched AES-NI key schedule generators for engine E (keys are contiguous key types, schedules contiguous of the layout)
+ * Batches run 8 (then 4) independent expansions interleaved, hiding the SubWord latency chain */
+#define AES_LOAD_KEY_AESNI_FN(bits, rounds, key_bytes, E, isa)                                                         \
+    TARGET(isa) static void aes##bits##_load_key_##E(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type) {   \
+        const size_t stride = 0;                                                                                       \
+        AES##bits##_KEY_EXPAND_AMD64(AES_KEY_LANES_X1, E)                                                              \
+        aes_invert_keys_aesni(schedule, stride, 1, rounds, type);                                                      \
+    }                                                                                                                  \
+    TARGET(isa) static void aes##bits##_load_keys_##E(const uint8_t* key, uint8_t* schedule, size_t num_keys, aes_sched_type_t type) { \
+        const size_t stride = AES_SCHED_BYTES(rounds, type);                                                           \
+        for (; num_keys >= 8; num_keys -= 8, key += 8 * key_bytes, schedule += 8 * stride) {                          \
+            AES##bits##_KEY_EXPAND_AMD64(AES_KEY_LANES_X8, E)                                                          \
+            aes_invert_keys_aesni(schedule, stride, 8, rounds, type);                                                  \
+        }                                                                                                              \
+        if (num_keys >= 4) {                                                                                           \
+            AES##bits##_KEY_EXPAND_AMD64(AES_KEY_LANES_X4, E)                                                          \
+            aes_invert_keys_aesni(schedule, stride, 4, rounds, type);                                                  \
+            num_keys -= 4; key += 4 * key_bytes; schedule += 4 * stride;                                               \
+        }                                                                                                              \
+        for (; num_keys; num_keys--, key += key_bytes, schedule += stride) aes##bits##_load_key_##E(key, schedule, type); \
     }
-    /* C implementation */
-}
-
-void aes256_load_key_internal(const aes256_key_t* key, aes256_sched_full_t* schedule, bool full) {
-    if (_hardware.aes) {
-        __m128i *s = (__m128i * ) (schedule->bytes);
-        __m128i a = _mm_loadu_si128((const __m128i*) (key->bytes));
-        __m128i b = _mm_loadu_si128(((const __m128i*) (key->bytes)) + 1);
-        _mm_storeu_si128(s++, a); // First 8 words = original key
-        _mm_storeu_si128(s, b);
-
-        __m128i keygen = _mm_aeskeygenassist_si128(b, 0x01);
-        __m128i subword;
-        uint32_t next_case = 0;
-        goto first_four;
-
-        rcon_cases_loop:
-        // key expansion part || 8 words at a time (2 round keys)
-        // last four (5-8)
-        subword = _mm_aeskeygenassist_si128(a, 0x00);
-        subword = _mm_shuffle_epi32(subword, _MM_SHUFFLE(2, 2, 2, 2));
-        b = _mm_xor_si128(b, _mm_slli_si128(b, 4)); // xor's of: 0, 1 offsets
-        b = _mm_xor_si128(b, _mm_slli_si128(b, 8)); // xor's of: 0, 1, 2, 3 offsets
-        b = _mm_xor_si128(b, subword);
-        _mm_storeu_si128(++s, b);
-        first_four:
-        AES_KEY_EXP_ITER_FIRST4(a, keygen)
-        _mm_storeu_si128(++s, a);
-
-        switch (next_case) {
-            #define case_block(THIS_CASE, NEXT_CASE, rcon)       \
-                case THIS_CASE: next_case = NEXT_CASE;           \
-                    keygen = _mm_aeskeygenassist_si128(b, rcon); \
-                    goto rcon_cases_loop;
-            case_block(0, 1, 0x02)
-            case_block(1, 2, 0x04)
-            case_block(2, 3, 0x08)
-            case_block(3, 4, 0x10)
-            case_block(4, 5, 0x20)
-            #undef case_block
-            case 5: next_case = 6; // last iteration only needs 4 words (1 round keys)
-                keygen = _mm_aeskeygenassist_si128(b, 0x40);
-                goto first_four;
-            case 6: break;
-        }
+AES_LOAD_KEY_AESNI_FN(128, 10, 16, kga, "aes")
+AES_LOAD_KEY_AESNI_FN(192, 12, 24, kga, "aes")
+AES_LOAD_KEY_AESNI_FN(256, 14, 32, kga, "aes")
+AES_LOAD_KEY_AESNI_FN(128, 10, 16, enclast, "aes,ssse3")
+AES_LOAD_KEY_AESNI_FN(192, 12, 24, enclast, "aes,ssse3")
+AES_LOAD_KEY_AESNI_FN(256, 14, 32, enclast, "aes,ssse3")
+#undef AES_LOAD_KEY_AESNI_FN
 
-        if (full) {
-            __m128i *ks = schedule->bytes;
-            ks[15] = _mm_aesimc_si128(ks[13]);
-            ks[16] = _mm_aesimc_si128(ks[12]);
-            ks[17] = _mm_aesimc_si128(ks[11]);
-            ks[18] = _mm_aesimc_si128(ks[10]);
-            ks[19] = _mm_aesimc_si128(ks[9]);
-            ks[20] = _mm_aesimc_si128(ks[8]);
-            ks[21] = _mm_aesimc_si128(ks[7]);
-            ks[22] = _mm_aesimc_si128(ks[6]);
-            ks[23] = _mm_aesimc_si128(ks[5]);
-            ks[24] = _mm_aesimc_si128(ks[4]);
-            ks[25] = _mm_aesimc_si128(ks[3]);
-            ks[26] = _mm_aesimc_si128(ks[2]);
-            ks[27] = _mm_aesimc_si128(ks[1]);
-        }
-        return;
+/* Same signature key schedule generators for the other tiers (batches expand one key at a time) */
+#define AES_LOAD_KEY_TIERS_FN(bits, key_words)                                                                   \
+    static void aes##bits##_load_key_c(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type) {       \
+        aes_load_key_c((const uint32_t*) key, (uint32_t*) schedule, (AES_SCHED_CODE) (AES##bits##_SCHED_FULL_CODE + type)); \
+    }                                                                                                        \
+    static void aes##bits##_load_key_ssse3(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type) {   \
+        aes_vp_load_key(key, schedule, key_words, type);                                                     \
+    }                                                                                                        \
+    static void aes##bits##_load_keys_c(const uint8_t* key, uint8_t* schedule, size_t num_keys, aes_sched_type_t type) { \
+        const size_t stride = AES_SCHED_BYTES(key_words + 6, type);                                          \
+        for (; num_keys; num_keys--, key += key_words << 2, schedule += stride) aes##bits##_load_key_c(key, schedule, type); \
+    }                                                                                                        \
+    static void aes##bits##_load_keys_ssse3(const uint8_t* key, uint8_t* schedule, size_t num_keys, aes_sched_type_t type) { \
+        const size_t stride = AES_SCHED_BYTES(key_words + 6, type);                                          \
+        for (; num_keys; num_keys--, key += key_words << 2, schedule += stride) aes##bits##_load_key_ssse3(key, schedule, type); \
     }
-    /* C implementation*/
-}
+AES_LOAD_KEY_TIERS_FN(128, 4)
+AES_LOAD_KEY_TIERS_FN(192, 6)
+AES_LOAD_KEY_TIERS_FN(256, 8)
+#undef AES_LOAD_KEY_TIERS_FN
 
 /* --- Transform rounds internal --- */
+/* Round macros, key getters & key lists shared with the modes live in hidden_aes.h */
 
-/* Agnostic internal shared round operations */
-/* This define concats arg token k with 0-9 for k0-k9 */
-#define AES_AGNOS_ENC_ROUNDS_0_9_AMD64(m, k) \
-    m = _mm_xor_si128   (m, k##0); \
-    m = _mm_aesenc_si128(m, k##1); \
-    m = _mm_aesenc_si128(m, k##2); \
-    m = _mm_aesenc_si128(m, k##3); \
-    m = _mm_aesenc_si128(m, k##4); \
-    m = _mm_aesenc_si128(m, k##5); \
-    m = _mm_aesenc_si128(m, k##6); \
-    m = _mm_aesenc_si128(m, k##7); \
-    m = _mm_aesenc_si128(m, k##8); \
-    m = _mm_aesenc_si128(m, k##9);
-/* This define concats arg token k with i0-i9 (int literals - not macros themselves) for ki0-ki9 */
-#define AES_AGNOS_DEC_ROUNDS_0_9_AMD64(m, k, i_0, i_1, i_2, i_3, i_4, i_5, i_6, i_7, i_8, i_9) \
-    m = _mm_xor_si128   (m, k##i_0); \
-    m = _mm_aesdec_si128(m, k##i_1); \
-    m = _mm_aesdec_si128(m, k##i_2); \
-    m = _mm_aesdec_si128(m, k##i_3); \
-    m = _mm_aesdec_si128(m, k##i_4); \
-    m = _mm_aesdec_si128(m, k##i_5); \
-    m = _mm_aesdec_si128(m, k##i_6); \
-    m = _mm_aesdec_si128(m, k##i_7); \
-    m = _mm_aesdec_si128(m, k##i_8); \
-    m = _mm_aesdec_si128(m, k##i_9);
-
-/* Main work operations for encryption/decryption -> define for inling */
-/* Expects k0-k10 as existing round keys in scope, m and round keys are __m128i */
-#define AES128_ENC_BLOCK_AMD64(m, k) {   \
-    AES_AGNOS_ENC_ROUNDS_0_9_AMD64(m, k) \
-    m = _mm_aesenclast_si128(m, k##10);  \
-}
-/* Expects k0-k12 as existing round keys in scope, m and round keys are __m128i */
-#define AES192_ENC_BLOCK_AMD64(m, k) {   \
-    AES_AGNOS_ENC_ROUNDS_0_9_AMD64(m, k) \
-    m = _mm_aesenc_si128   (m, k##10);   \
-    m = _mm_aesenc_si128   (m, k##11);   \
-    m= _mm_aesenclast_si128(m, k##12);   \
-}
-/* Expects k0-k14 as existing round keys in scope, m and round keys are __m128i */
-#define AES256_ENC_BLOCK_AMD64(m, k) {   \
-    AES_AGNOS_ENC_ROUNDS_0_9_AMD64(m, k) \
-    m = _mm_aesenc_si128    (m, k##10);  \
-    m = _mm_aesenc_si128    (m, k##11);  \
-    m = _mm_aesenc_si128    (m, k##12);  \
-    m = _mm_aesenc_si128    (m, k##13);  \
-    m = _mm_aesenclast_si128(m, k##14);  \
-}
-/* Expects k0, k10-k19 as existing round keys in scope, m and round keys are __m128i */
-#define AES128_DEC_BLOCK_AMD64(m, k) { \
-    AES_AGNOS_DEC_ROUNDS_0_9_AMD64(m, k, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19) \
-    m = _mm_aesdeclast_si128(m, k##0); \
-}
-/* Expects k0, k12-k23 as existing round keys in scope, m and round keys are __m128i */
-#define AES192_DEC_BLOCK_AMD64(m, k) { \
-    AES_AGNOS_DEC_ROUNDS_0_9_AMD64(m, k, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21) \
-    m = _mm_aesdec_si128    (m, k##22); \
-    m = _mm_aesdec_si128    (m, k##23); \
-    m = _mm_aesdeclast_si128(m, k##0);  \
-}
-/* Expects k0, k14-k27 as existing round keys in scope, m and round keys are __m128i */
-#define AES256_DEC_BLOCK_AMD64(m, k) { \
-    AES_AGNOS_DEC_ROUNDS_0_9_AMD64(m, k, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23) \
-    m = _mm_aesdec_si128    (m, k##24); \
-    m = _mm_aesdec_si128    (m, k##25); \
-    m = _mm_aesdec_si128    (m, k##26); \
-    m = _mm_aesdec_si128    (m, k##27); \
-    m = _mm_aesdeclast_si128(m, k##0);  \
-}
-
-
-/* Helper macros for keys */
-#define get_key(k, i, schedule_ptr) __m128i k##i = _mm_loadu_si128(((__m128i *) schedule_ptr) + i)
-#define get_11_keys(k, schedule_ptr, i_0, i_1, i_2, i_3, i_4, i_5, i_6, i_7, i_8, i_9, i_10) \
-    get_key(k,  i_0, schedule_ptr); \
-    get_key(k,  i_1, schedule_ptr); \
-    get_key(k,  i_2, schedule_ptr); \
-    get_key(k,  i_3, schedule_ptr); \
-    get_key(k,  i_4, schedule_ptr); \
-    get_key(k,  i_5, schedule_ptr); \
-    get_key(k,  i_6, schedule_ptr); \
-    get_key(k,  i_7, schedule_ptr); \
-    get_key(k,  i_8, schedule_ptr); \
-    get_key(k,  i_9, schedule_ptr); \
-    get_key(k, i_10, schedule_ptr);
-#define get_keys_0_10(k, schedule_ptr) get_11_keys(k, schedule_ptr, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
+/* Pipelined blocks loop (BLOCK is a *_BLOCK_AMD64 macro, its round keys k in scope)
+ * Keeps 8 independent blocks in flight so throughput is bound by the AES units rather than aesenc latency.
+ * Tail: 2-7 leftover blocks go through 4-wide passes (fall through partial loads/stores), a lone block runs alone.
+ * All loads of a pass happen before its stores (in-place operation allowed). Consumes src, dst & num_blocks. */
+#define AES_BLOCKS_PIPELINE_AMD64(BLOCK, k, src, dst, num_blocks) {                                          \
+    __m128i m0, m1, m2, m3, m4, m5, m6, m7;                                                                   \
+    for (; num_blocks >= 8; num_blocks -= 8, src += 8, dst += 8) {                                            \
+        m0 = _mm_loadu_si128((const __m128i *) (src + 0)); m1 = _mm_loadu_si128((const __m128i *) (src + 1)); \
+        m2 = _mm_loadu_si128((const __m128i *) (src + 2)); m3 = _mm_loadu_si128((const __m128i *) (src + 3)); \
+        m4 = _mm_loadu_si128((const __m128i *) (src + 4)); m5 = _mm_loadu_si128((const __m128i *) (src + 5)); \
+        m6 = _mm_loadu_si128((const __m128i *) (src + 6)); m7 = _mm_loadu_si128((const __m128i *) (src + 7)); \
+        BLOCK(AES_X8_AMD64, m, k)                                                                             \
+        _mm_storeu_si128((__m128i *) (dst + 0), m0); _mm_storeu_si128((__m128i *) (dst + 1), m1);             \
+        _mm_storeu_si128((__m128i *) (dst + 2), m2); _mm_storeu_si128((__m128i *) (dst + 3), m3);             \
+        _mm_storeu_si128((__m128i *) (dst + 4), m4); _mm_storeu_si128((__m128i *) (dst + 5), m5);             \
+        _mm_storeu_si128((__m128i *) (dst + 6), m6); _mm_storeu_si128((__m128i *) (dst + 7), m7);             \
+    }                                                                                                         \
+    m2 = m3 = _mm_setzero_si128(); /* unused lanes of partial passes */                                       \
+    while (num_blocks > 1) {                                                                                  \
+        const size_t _n = num_blocks < 4 ? num_blocks : 4;                                                    \
+        switch (_n) {                                                                                         \
+            case 4: m3 = _mm_loadu_si128((const __m128i *) (src + 3)); FALLTHROUGH;                           \
+            case 3: m2 = _mm_loadu_si128((const __m128i *) (src + 2)); FALLTHROUGH;                           \
+            default: m1 = _mm_loadu_si128((const __m128i *) (src + 1));                                       \
+                     m0 = _mm_loadu_si128((const __m128i *) (src + 0));                                       \
+        }                                                                                                     \
+        BLOCK(AES_X4_AMD64, m, k)                                                                             \
+        switch (_n) {                                                                                         \
+            case 4: _mm_storeu_si128((__m128i *) (dst + 3), m3); FALLTHROUGH;                                 \
+            case 3: _mm_storeu_si128((__m128i *) (dst + 2), m2); FALLTHROUGH;                                 \
+            default: _mm_storeu_si128((__m128i *) (dst + 1), m1);                                             \
+                     _mm_storeu_si128((__m128i *) (dst + 0), m0);                                             \
+        }                                                                                                     \
+        num_blocks -= _n; src += _n; dst += _n;                                                               \
+    }                                                                                                         \
+    if (num_blocks) {                                                                                         \
+        m0 = _mm_loadu_si128((const __m128i *) src);                                                          \
+        BLOCK(AES_X1_AMD64, m0, k)                                                                            \
+        _mm_storeu_si128((__m128i *) dst, m0);                                                                \
+    }                                                                                                         \
+}
 
-/* --- Encrypt blocks transforms --- (in-place operation allowed) */
-void aes128_encrypt_blocks(const aes128_sched_enc_t* schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks) {
-    const uint8_t* s = schedule->bytes;
-    if (_hardware.aes) {
-        get_keys_0_10(k, s)
-
-        const uint8_t (*stop)[16] = plain + num_blocks;
-        while (plain < stop) {
-            __m128i m = _mm_loadu_si128((__m128i *) plain++);
-            AES128_ENC_BLOCK_AMD64(m, k)
-            _mm_storeu_si128((__m128i *) cipher++, m);
-        }
-        return;
+/* Generates an AES-NI blocks transform (KEYS is a *_KEYS macro matching BLOCK) */
+#define AES_AESNI_BLOCKS_FN(name, KEYS, BLOCK)                                                                      \
+    TARGET("aes") static void name(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        KEYS(get_key, k, s)                                                                                         \
+        AES_BLOCKS_PIPELINE_AMD64(BLOCK, k, src, dst, num_blocks)                                                   \
     }
-    /* C implementation */
-}
-void aes192_encrypt_blocks(const aes192_sched_enc_t* schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks) {
-    const uint8_t* s = schedule->bytes;
-    if (_hardware.aes) {
-        get_keys_0_10(k, s)
-        get_key(k, 11, s);
-        get_key(k, 12, s);
-
-        const uint8_t (*stop)[16] = plain + num_blocks;
-        while (plain < stop) {
-            __m128i m = _mm_loadu_si128((__m128i *) plain++);
-            AES192_ENC_BLOCK_AMD64(m, k)
-            _mm_storeu_si128((__m128i *) cipher++, m);
-        }
-        return;
-    }
-    /* C implementation */
-}
-void aes256_encrypt_blocks(const aes256_sched_enc_t* schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks) {
-    const uint8_t* s = schedule->bytes;
-    if (_hardware.aes) {
-        get_keys_0_10(k, s)
-        get_key(k, 11, s);
-        get_key(k, 12, s);
-        get_key(k, 13, s);
-        get_key(k, 14, s);
-
-        const uint8_t (*stop)[16] = plain + num_blocks;
-        while (plain < stop) {
-            __m128i m = _mm_loadu_si128((__m128i *) plain++);
-            AES256_ENC_BLOCK_AMD64(m, k)
-            _mm_storeu_si128((__m128i *) cipher++, m);
-        }
-        return;
+AES_AESNI_BLOCKS_FN(aes128_encrypt_blocks_aesni, AES128_ENC_KEYS, AES128_ENC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes192_encrypt_blocks_aesni, AES192_ENC_KEYS, AES192_ENC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes256_encrypt_blocks_aesni, AES256_ENC_KEYS, AES256_ENC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes128_decrypt_blocks_aesni, AES128_DEC_KEYS, AES128_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes192_decrypt_blocks_aesni, AES192_DEC_KEYS, AES192_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes256_decrypt_blocks_aesni, AES256_DEC_KEYS, AES256_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes128_decrypt_dec_blocks_aesni, AES128_DEC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes192_decrypt_dec_blocks_aesni, AES192_DEC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes256_decrypt_dec_blocks_aesni, AES256_DEC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes128_decrypt_enc_blocks_aesni, AES128_DEC_ENC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes192_decrypt_enc_blocks_aesni, AES192_DEC_ENC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64)
+AES_AESNI_BLOCKS_FN(aes256_decrypt_enc_blocks_aesni, AES256_DEC_ENC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64)
+
+/* VAES + AVX2 backend: 2 blocks per ymm register (op mapping & broadcast getters in hidden_aes.h) */
+/* Pipelined pairs loop (BLOCK is a *_BLOCK_AMD64 macro, its broadcast round keys k in scope)
+ * Keeps 16 blocks (8 registers) in flight, leftover pairs go through 4 register passes. Consumes num_pairs. */
+#define AES_PAIRS_PIPELINE_VAES256(BLOCK, k, src, dst, num_pairs) {                                                \
+    __m256i m0, m1, m2, m3, m4, m5, m6, m7;                                                                         \
+    for (; num_pairs >= 8; num_pairs -= 8, src += 16, dst += 16) {                                                  \
+        m0 = _mm256_loadu_si256((const __m256i *) (src + 0));  m1 = _mm256_loadu_si256((const __m256i *) (src + 2)); \
+        m2 = _mm256_loadu_si256((const __m256i *) (src + 4));  m3 = _mm256_loadu_si256((const __m256i *) (src + 6)); \
+        m4 = _mm256_loadu_si256((const __m256i *) (src + 8));  m5 = _mm256_loadu_si256((const __m256i *) (src + 10)); \
+        m6 = _mm256_loadu_si256((const __m256i *) (src + 12)); m7 = _mm256_loadu_si256((const __m256i *) (src + 14)); \
+        BLOCK(AES_X8_VAES256, m, k)                                                                                 \
+        _mm256_storeu_si256((__m256i *) (dst + 0), m0);  _mm256_storeu_si256((__m256i *) (dst + 2), m1);            \
+        _mm256_storeu_si256((__m256i *) (dst + 4), m2);  _mm256_storeu_si256((__m256i *) (dst + 6), m3);            \
+        _mm256_storeu_si256((__m256i *) (dst + 8), m4);  _mm256_storeu_si256((__m256i *) (dst + 10), m5);           \
+        _mm256_storeu_si256((__m256i *) (dst + 12), m6); _mm256_storeu_si256((__m256i *) (dst + 14), m7);           \
+    }                                                                                                               \
+    m1 = m2 = m3 = _mm256_setzero_si256(); /* unused registers of partial passes */                                 \
+    while (num_pairs) {                                                                                             \
+        const size_t _n = num_pairs < 4 ? num_pairs : 4;                                                            \
+        switch (_n) {                                                                                               \
+            case 4: m3 = _mm256_loadu_si256((const __m256i *) (src + 6)); FALLTHROUGH;                              \
+            case 3: m2 = _mm256_loadu_si256((const __m256i *) (src + 4)); FALLTHROUGH;                              \
+            case 2: m1 = _mm256_loadu_si256((const __m256i *) (src + 2)); FALLTHROUGH;                              \
+            default: m0 = _mm256_loadu_si256((const __m256i *) (src + 0));                                          \
+        }                                                                                                           \
+        BLOCK(AES_X4_VAES256, m, k)                                                                                 \
+        switch (_n) {                                                                                               \
+            case 4: _mm256_storeu_si256((__m256i *) (dst + 6), m3); FALLTHROUGH;                                    \
+            case 3: _mm256_storeu_si256((__m256i *) (dst + 4), m2); FALLTHROUGH;                                    \
+            case 2: _mm256_storeu_si256((__m256i *) (dst + 2), m1); FALLTHROUGH;                                    \
+            default: _mm256_storeu_si256((__m256i *) (dst + 0), m0);                                                \
+        }                                                                                                           \
+        num_pairs -= _n; src += _n << 1; dst += _n << 1;                                                            \
+    }                                                                                                               \
+}
+
+/* Generates a VAES blocks transform (KEYS is a *_KEYS macro matching BLOCK), a lone block goes to tail_fn.
+ * An odd block after the pairs runs in a low lane on the broadcast keys (no reload, no second aesimc pass). */
+#define AES_VAES256_BLOCKS_FN(name, KEYS, BLOCK, tail_fn)                                                           \
+    TARGET("aes,vaes,avx2") static void name(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        size_t num_pairs = num_blocks >> 1;                                                                         \
+        if (!num_pairs) {                                                                                           \
+            if (num_blocks) tail_fn(s, src, dst, 1);                                                                \
+            return;                                                                                                 \
+        }                                                                                                           \
+        KEYS(get_key_vaes256, k, s)                                                                                 \
+        AES_PAIRS_PIPELINE_VAES256(BLOCK, k, src, dst, num_pairs)                                                   \
+        if (num_blocks & 1) {                                                                                       \
+            __m256i m = _mm256_zextsi128_si256(_mm_loadu_si128((const __m128i *) src));                              \
+            BLOCK(AES_X1_VAES256, m, k)                                                                             \
+            _mm_storeu_si128((__m128i *) dst, _mm256_castsi256_si128(m));                                           \
+        }                                                                                                           \
     }
-    /* C implementation */
+AES_VAES256_BLOCKS_FN(aes128_encrypt_blocks_vaes256, AES128_ENC_KEYS, AES128_ENC_BLOCK_AMD64, aes128_encrypt_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes192_encrypt_blocks_vaes256, AES192_ENC_KEYS, AES192_ENC_BLOCK_AMD64, aes192_encrypt_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes256_encrypt_blocks_vaes256, AES256_ENC_KEYS, AES256_ENC_BLOCK_AMD64, aes256_encrypt_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes128_decrypt_blocks_vaes256, AES128_DEC_KEYS, AES128_DEC_BLOCK_AMD64, aes128_decrypt_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes192_decrypt_blocks_vaes256, AES192_DEC_KEYS, AES192_DEC_BLOCK_AMD64, aes192_decrypt_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes256_decrypt_blocks_vaes256, AES256_DEC_KEYS, AES256_DEC_BLOCK_AMD64, aes256_decrypt_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes128_decrypt_dec_blocks_vaes256, AES128_DEC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64, aes128_decrypt_dec_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes192_decrypt_dec_blocks_vaes256, AES192_DEC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64, aes192_decrypt_dec_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes256_decrypt_dec_blocks_vaes256, AES256_DEC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64, aes256_decrypt_dec_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes128_decrypt_enc_blocks_vaes256, AES128_DEC_ENC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64, aes128_decrypt_enc_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes192_decrypt_enc_blocks_vaes256, AES192_DEC_ENC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64, aes192_decrypt_enc_blocks_aesni)
+AES_VAES256_BLOCKS_FN(aes256_decrypt_enc_blocks_vaes256, AES256_DEC_ENC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64, aes256_decrypt_enc_blocks_aesni)
+
+/* VAES + AVX-512F backend: 4 blocks per zmm register (op mapping & broadcast getters in hidden_aes.h) */
+/* Qword mask covering the blocks of register j (blocks 4j..4j+3) in a pass of n blocks (branchless clamp to 0-4) */
+#define VAES512_LANE_MASK(n, j) ({                                            \
+    const int64_t _c = (int64_t)(n) - 4 * (j);                                \
+    const int64_t _cc = _c < 0 ? 0 : (_c > 4 ? 4 : _c);                      \
+    (__mmask8)((1U << (_cc << 1)) - 1);                                       \
+})
+
+/* Pipelined blocks loop (BLOCK is a *_BLOCK_AMD64 macro, its broadcast round keys k in scope)
+ * Keeps 32 blocks (8 registers) in flight, leftovers go through 4 register passes of masked loads/stores
+ * (no scalar tail - masked out lanes are never read or written). Consumes num_blocks. */
+#define AES_BLOCKS_PIPELINE_VAES512(BLOCK, k, src, dst, num_blocks) {                                                  \
+    __m512i m0, m1, m2, m3, m4, m5, m6, m7;                                                                             \
+    for (; num_blocks >= 32; num_blocks -= 32, src += 32, dst += 32) {                                                  \
+        m0 = _mm512_loadu_si512(src + 0);  m1 = _mm512_loadu_si512(src + 4);                                            \
+        m2 = _mm512_loadu_si512(src + 8);  m3 = _mm512_loadu_si512(src + 12);                                           \
+        m4 = _mm512_loadu_si512(src + 16); m5 = _mm512_loadu_si512(src + 20);                                           \
+        m6 = _mm512_loadu_si512(src + 24); m7 = _mm512_loadu_si512(src + 28);                                           \
+        BLOCK(AES_X8_VAES512, m, k)                                                                                     \
+        _mm512_storeu_si512(dst + 0, m0);  _mm512_storeu_si512(dst + 4, m1);                                            \
+        _mm512_storeu_si512(dst + 8, m2);  _mm512_storeu_si512(dst + 12, m3);                                           \
+        _mm512_storeu_si512(dst + 16, m4); _mm512_storeu_si512(dst + 20, m5);                                           \
+        _mm512_storeu_si512(dst + 24, m6); _mm512_storeu_si512(dst + 28, m7);                                           \
+    }                                                                                                                   \
+    while (num_blocks) {                                                                                                \
+        const size_t _n = num_blocks < 16 ? num_blocks : 16;                                                            \
+        const __mmask8 _k0 = VAES512_LANE_MASK(_n, 0), _k1 = VAES512_LANE_MASK(_n, 1);                                  \
+        const __mmask8 _k2 = VAES512_LANE_MASK(_n, 2), _k3 = VAES512_LANE_MASK(_n, 3);                                  \
+        m0 = _mm512_maskz_loadu_epi64(_k0, src + 0); m1 = _mm512_maskz_loadu_epi64(_k1, src + 4);                       \
+        m2 = _mm512_maskz_loadu_epi64(_k2, src + 8); m3 = _mm512_maskz_loadu_epi64(_k3, src + 12);                      \
+        BLOCK(AES_X4_VAES512, m, k)                                                                                     \
+        _mm512_mask_storeu_epi64(dst + 0, _k0, m0); _mm512_mask_storeu_epi64(dst + 4, _k1, m1);                         \
+        _mm512_mask_storeu_epi64(dst + 8, _k2, m2); _mm512_mask_storeu_epi64(dst + 12, _k3, m3);                        \
+        num_blocks -= _n; src += _n; dst += _n;                                                                         \
+    }                                                                                                                   \
 }
-/* --- Decrypt blocks transforms --- (in-place operation allowed) */
-void aes128_decrypt_blocks(const aes128_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks) {
-    const uint8_t* s = schedule->bytes;
-    if (_hardware.aes) {
-        get_11_keys(k, s, 0, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19)
-
-        const uint8_t (*stop)[16] = plain + num_blocks;
-        while (plain < stop) {
-            __m128i m = _mm_loadu_si128((__m128i *) cipher++);
-            AES128_DEC_BLOCK_AMD64(m, k)
-            _mm_storeu_si128((__m128i *) plain++, m);
-        }
-        return;
+
+/* Generates a VAES-512 blocks transform (KEYS is a *_KEYS macro matching BLOCK), a lone block goes to tail_fn
+ * (skips the zmm key broadcasts) */
+#define AES_VAES512_BLOCKS_FN(name, KEYS, BLOCK, tail_fn)                                                               \
+    TARGET("aes,vaes,avx512f") static void name(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        if (num_blocks == 1) { tail_fn(s, src, dst, 1); return; }                                                       \
+        KEYS(get_key_vaes512, k, s)                                                                                     \
+        AES_BLOCKS_PIPELINE_VAES512(BLOCK, k, src, dst, num_blocks)                                                     \
     }
-    /* C implementation */
-}
-void aes192_decrypt_blocks(const aes192_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks) {
-    const uint8_t* s = schedule->bytes;
-    if (_hardware.aes) {
-        get_11_keys(k, s, 0, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21)
-        get_key(k, 22, s);
-        get_key(k, 23, s);
-
-        const uint8_t (*stop)[16] = plain + num_blocks;
-        while (plain < stop) {
-            __m128i m = _mm_loadu_si128((__m128i *) cipher++);
-            AES192_DEC_BLOCK_AMD64(m, k)
-            _mm_storeu_si128((__m128i *) plain++, m);
-        }
-        return;
+AES_VAES512_BLOCKS_FN(aes128_encrypt_blocks_vaes512, AES128_ENC_KEYS, AES128_ENC_BLOCK_AMD64, aes128_encrypt_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes192_encrypt_blocks_vaes512, AES192_ENC_KEYS, AES192_ENC_BLOCK_AMD64, aes192_encrypt_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes256_encrypt_blocks_vaes512, AES256_ENC_KEYS, AES256_ENC_BLOCK_AMD64, aes256_encrypt_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes128_decrypt_blocks_vaes512, AES128_DEC_KEYS, AES128_DEC_BLOCK_AMD64, aes128_decrypt_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes192_decrypt_blocks_vaes512, AES192_DEC_KEYS, AES192_DEC_BLOCK_AMD64, aes192_decrypt_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes256_decrypt_blocks_vaes512, AES256_DEC_KEYS, AES256_DEC_BLOCK_AMD64, aes256_decrypt_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes128_decrypt_dec_blocks_vaes512, AES128_DEC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64, aes128_decrypt_dec_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes192_decrypt_dec_blocks_vaes512, AES192_DEC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64, aes192_decrypt_dec_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes256_decrypt_dec_blocks_vaes512, AES256_DEC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64, aes256_decrypt_dec_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes128_decrypt_enc_blocks_vaes512, AES128_DEC_ENC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64, aes128_decrypt_enc_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes192_decrypt_enc_blocks_vaes512, AES192_DEC_ENC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64, aes192_decrypt_enc_blocks_aesni)
+AES_VAES512_BLOCKS_FN(aes256_decrypt_enc_blocks_vaes512, AES256_DEC_ENC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64, aes256_decrypt_enc_blocks_aesni)
+
+/* Generates the SSSE3 & pure c blocks transforms of one key size (rounds) */
+#define AES_BLOCKS_TIERS_FN(bits, rounds)                                                                               \
+    static void aes##bits##_encrypt_blocks_ssse3(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        aes_vp_encrypt_blocks(s, rounds, src, dst, num_blocks);                                                         \
+    }                                                                                                                   \
+    static void aes##bits##_decrypt_blocks_ssse3(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        aes_vp_decrypt_blocks(s, rounds, 1, src, dst, num_blocks);                                                      \
+    }                                                                                                                   \
+    static void aes##bits##_decrypt_dec_blocks_ssse3(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        aes_vp_decrypt_blocks(s, rounds, -1, src, dst, num_blocks);                                                     \
+    }                                                                                                                   \
+    static void aes##bits##_decrypt_enc_blocks_ssse3(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        uint8_t d[(rounds + 1) << 4]; /* inverted once per call */                                                      \
+        aes_vp_invert_keys(s, d, rounds);                                                                               \
+        aes_vp_decrypt_blocks(d, rounds, -1, src, dst, num_blocks);                                                     \
+    }                                                                                                                   \
+    static void aes##bits##_encrypt_blocks_c(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        uint64_t sk[(rounds + 1) << 3];                                                                                 \
+        aes_ct64_load_keys(s, rounds, 0, sk);                                                                           \
+        aes_ct64_encrypt_blocks(sk, rounds, src, dst, num_blocks);                                                      \
+    }                                                                                                                   \
+    static void aes##bits##_decrypt_blocks_c(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        uint64_t sk[(rounds + 1) << 3];                                                                                 \
+        aes_ct64_load_keys(s, rounds, 1, sk);                                                                           \
+        aes_ct64_decrypt_blocks(sk, rounds, src, dst, num_blocks);                                                      \
+    }                                                                                                                   \
+    static void aes##bits##_decrypt_dec_blocks_c(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        uint64_t sk[(rounds + 1) << 3];                                                                                 \
+        aes_ct64_load_keys(s, rounds, -1, sk);                                                                          \
+        aes_ct64_decrypt_blocks(sk, rounds, src, dst, num_blocks);                                                      \
+    }                                                                                                                   \
+    static void aes##bits##_decrypt_enc_blocks_c(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) { \
+        uint64_t sk[(rounds + 1) << 3];                                                                                 \
+        aes_ct64_load_keys(s, rounds, -1, sk);                                                                          \
+        for (uint32_t r = 1; r < rounds; r++) aes_ct64_inv_mix_columns(sk + (r << 3)); /* bitsliced InvMixColumns */    \
+        aes_ct64_decrypt_blocks(sk, rounds, src, dst, num_blocks);                                                      \
     }
-    /* C implementation */
-}
-void aes256_decrypt_blocks(const aes256_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks) {
-    const uint8_t* s = schedule->bytes;
-    if (_hardware.aes) {
-        get_11_keys(k, s, 0, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23)
-        get_key(k, 24, s);
-        get_key(k, 25, s);
-        get_key(k, 26, s);
-        get_key(k, 27, s);
-
-        const uint8_t (*stop)[16] = plain + num_blocks;
-        while (plain < stop) {
-            __m128i m = _mm_loadu_si128((__m128i *) cipher++);
-            AES256_DEC_BLOCK_AMD64(m, k)
-            _mm_storeu_si128((__m128i *) plain++, m);
+AES_BLOCKS_TIERS_FN(128, 10)
+AES_BLOCKS_TIERS_FN(192, 12)
+AES_BLOCKS_TIERS_FN(256, 14)
+#undef AES_BLOCKS_TIERS_FN
+
+/* --- Backend dispatch --- (one tier per process, picked once)
+ * GNU ifunc in shared builds (resolved by the loader), else a pointer table filled by a startup constructor
+ * (follows _hardware toggles through aes_dispatch_update), or fixed at compile-time by CRYPTOCORE_ASSUME_*.
+ */
+typedef void (*aes_load_key_fn)(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type);
+typedef void (*aes_load_keys_fn)(const uint8_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type);
+typedef void (*aes_blocks_fn)(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks);
+typedef struct {
+    aes_load_key_fn load_key128, load_key192, load_key256;
+    aes_load_keys_fn load_keys128, load_keys192, load_keys256;
+    aes_blocks_fn   encrypt128,  encrypt192,  encrypt256;
+    aes_blocks_fn   decrypt128,  decrypt192,  decrypt256;
+    aes_blocks_fn   decrypt_dec128, decrypt_dec192, decrypt_dec256;
+    aes_blocks_fn   decrypt_enc128, decrypt_enc192, decrypt_enc256;
+} aes_tier_t;
+
+/* Tier tables (VAES tiers share the AES-NI key schedule generators, in either engine) */
+#define AES_TIER(KEYS, BLOCKS) {                                                                      \
+    aes128_load_key_##KEYS,        aes192_load_key_##KEYS,        aes256_load_key_##KEYS,             \
+    aes128_load_keys_##KEYS,       aes192_load_keys_##KEYS,       aes256_load_keys_##KEYS,            \
+    aes128_encrypt_blocks_##BLOCKS, aes192_encrypt_blocks_##BLOCKS, aes256_encrypt_blocks_##BLOCKS,   \
+    aes128_decrypt_blocks_##BLOCKS, aes192_decrypt_blocks_##BLOCKS, aes256_decrypt_blocks_##BLOCKS,   \
+    aes128_decrypt_dec_blocks_##BLOCKS, aes192_decrypt_dec_blocks_##BLOCKS, aes256_decrypt_dec_blocks_##BLOCKS, \
+    aes128_decrypt_enc_blocks_##BLOCKS, aes192_decrypt_enc_blocks_##BLOCKS, aes256_decrypt_enc_blocks_##BLOCKS  \
+}
+static const aes_tier_t aes_tier_vaes512     = AES_TIER(enclast, vaes512);
+static const aes_tier_t aes_tier_vaes256     = AES_TIER(enclast, vaes256);
+static const aes_tier_t aes_tier_aesni       = AES_TIER(enclast, aesni);
+static const aes_tier_t aes_tier_vaes512_kga = AES_TIER(kga, vaes512);
+static const aes_tier_t aes_tier_vaes256_kga = AES_TIER(kga, vaes256);
+static const aes_tier_t aes_tier_aesni_kga   = AES_TIER(kga, aesni);
+static const aes_tier_t aes_tier_ssse3       = AES_TIER(ssse3, ssse3);
+static const aes_tier_t aes_tier_c           = AES_TIER(c, c);
+#undef AES_TIER
+
+/* Best tier for the given hardware */
+static inline const aes_tier_t* aes_select_tier(const hardware_t* hw) {
+    if (hw->aes) { // key schedules via aesenclast unless aeskeygenassist is fast (or pshufb is missing)
+        if (hw->aeskga || !hw->ssse3) {
+            if (hw->vaes512) return &aes_tier_vaes512_kga;
+            if (hw->vaes)    return &aes_tier_vaes256_kga;
+            return &aes_tier_aesni_kga;
         }
-        return;
+        if (hw->vaes512) return &aes_tier_vaes512;
+        if (hw->vaes)    return &aes_tier_vaes256;
+        return &aes_tier_aesni;
     }
-    /* C implementation */
+    return hw->ssse3 ? &aes_tier_ssse3 : &aes_tier_c;
 }
 
-#undef get_key
+#if defined(CRYPTOCORE_ASSUME)
+    /* Constant hardware: the tier folds away & public functions become direct calls */
+    static const hardware_t aes_assumed_hardware = HARDWARE_ASSUMED;
+    #define AES_PUBLIC_FN(name, field, params, args) \
+        void name params { aes_select_tier(&aes_assumed_hardware)->field args; }
+    void aes_dispatch_update(void) {}
+#elif defined(CRYPTOCORE_IFUNC)
+    /* Shared library: the loader binds each symbol straight to its tier function (resolvers run before
+     * constructors, so they detect hardware themselves) */
+    #define AES_PUBLIC_FN(name, field, params, args)                                                  \
+        static void (*name##_resolve(void)) params {                                                  \
+            hardware_t hw;                                                                            \
+            hardware_detect(&hw);                                                                     \
+            return (void (*) params) aes_select_tier(&hw)->field;                                     \
+        }                                                                                             \
+        void name params __attribute__((ifunc(#name "_resolve")));
+    void aes_dispatch_update(void) {}
+#else
+    /* Pointer table: picked by a startup constructor, before main & any threads (no per call feature checks).
+     * Starts on stubs that pick & forward, for calls from constructors that run earlier (static link order) */
+    static const aes_tier_t* aes_tier; /* set below, after its stubs */
+    void aes_dispatch_update(void) {
+        hardware_init();
+        aes_tier = aes_select_tier(&_hardware);
+    }
+    static void aes_unresolved_load_key128(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type) { aes_dispatch_update(); aes_tier->load_key128(key, schedule, type); }
+    static void aes_unresolved_load_key192(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type) { aes_dispatch_update(); aes_tier->load_key192(key, schedule, type); }
+    static void aes_unresolved_load_key256(const uint8_t* key, uint8_t* schedule, aes_sched_type_t type) { aes_dispatch_update(); aes_tier->load_key256(key, schedule, type); }
+    static void aes_unresolved_load_keys128(const uint8_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type) { aes_dispatch_update(); aes_tier->load_keys128(keys, schedules, num_keys, type); }
+    static void aes_unresolved_load_keys192(const uint8_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type) { aes_dispatch_update(); aes_tier->load_keys192(keys, schedules, num_keys, type); }
+    static void aes_unresolved_load_keys256(const uint8_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type) { aes_dispatch_update(); aes_tier->load_keys256(keys, schedules, num_keys, type); }
+    #define AES_UNRESOLVED_BLOCKS_FN(field)                                                                                           \
+        static void aes_unresolved_##field(const uint8_t* s, const uint8_t (*src)[16], uint8_t (*dst)[16], size_t num_blocks) {       \
+            aes_dispatch_update();                                                                                                    \
+            aes_tier->field(s, src, dst, num_blocks);                                                                                 \
+        }
+    AES_UNRESOLVED_BLOCKS_FN(encrypt128) AES_UNRESOLVED_BLOCKS_FN(encrypt192) AES_UNRESOLVED_BLOCKS_FN(encrypt256)
+    AES_UNRESOLVED_BLOCKS_FN(decrypt128) AES_UNRESOLVED_BLOCKS_FN(decrypt192) AES_UNRESOLVED_BLOCKS_FN(decrypt256)
+    AES_UNRESOLVED_BLOCKS_FN(decrypt_dec128) AES_UNRESOLVED_BLOCKS_FN(decrypt_dec192) AES_UNRESOLVED_BLOCKS_FN(decrypt_dec256)
+    AES_UNRESOLVED_BLOCKS_FN(decrypt_enc128) AES_UNRESOLVED_BLOCKS_FN(decrypt_enc192) AES_UNRESOLVED_BLOCKS_FN(decrypt_enc256)
+    #undef AES_UNRESOLVED_BLOCKS_FN
+    static const aes_tier_t aes_tier_unresolved = {
+        aes_unresolved_load_key128, aes_unresolved_load_key192, aes_unresolved_load_key256,
+        aes_unresolved_load_keys128, aes_unresolved_load_keys192, aes_unresolved_load_keys256,
+        aes_unresolved_encrypt128,  aes_unresolved_encrypt192,  aes_unresolved_encrypt256,
+        aes_unresolved_decrypt128,  aes_unresolved_decrypt192,  aes_unresolved_decrypt256,
+        aes_unresolved_decrypt_dec128, aes_unresolved_decrypt_dec192, aes_unresolved_decrypt_dec256,
+        aes_unresolved_decrypt_enc128, aes_unresolved_decrypt_enc192, aes_unresolved_decrypt_enc256
+    };
+    static const aes_tier_t* aes_tier = &aes_tier_unresolved;
+    INITIALIZER(aes_dispatch_startup) { aes_dispatch_update(); }
+    #define AES_PUBLIC_FN(name, field, params, args) \
+        void name params { aes_tier->field args; }
+#endif
+
+/* --- Public key schedule generators --- */
+AES_PUBLIC_FN(aes128_load_key_internal, load_key128, (const aes128_key_t* key, uint8_t* schedule, aes_sched_type_t type), (key->bytes, schedule, type))
+AES_PUBLIC_FN(aes192_load_key_internal, load_key192, (const aes192_key_t* key, uint8_t* schedule, aes_sched_type_t type), (key->bytes, schedule, type))
+AES_PUBLIC_FN(aes256_load_key_internal, load_key256, (const aes256_key_t* key, uint8_t* schedule, aes_sched_type_t type), (key->bytes, schedule, type))
+AES_PUBLIC_FN(aes128_load_keys_internal, load_keys128, (const aes128_key_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type), (keys->bytes, schedules, num_keys, type))
+AES_PUBLIC_FN(aes192_load_keys_internal, load_keys192, (const aes192_key_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type), (keys->bytes, schedules, num_keys, type))
+AES_PUBLIC_FN(aes256_load_keys_internal, load_keys256, (const aes256_key_t* keys, uint8_t* schedules, size_t num_keys, aes_sched_type_t type), (keys->bytes, schedules, num_keys, type))
+
+/* --- Encrypt blocks transforms --- (in-place operation allowed) */
+AES_PUBLIC_FN(aes128_encrypt_blocks, encrypt128, (const aes128_sched_enc_t* schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks), (schedule->bytes, plain, cipher, num_blocks))
+AES_PUBLIC_FN(aes192_encrypt_blocks, encrypt192, (const aes192_sched_enc_t* schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks), (schedule->bytes, plain, cipher, num_blocks))
+AES_PUBLIC_FN(aes256_encrypt_blocks, encrypt256, (const aes256_sched_enc_t* schedule, const uint8_t (*plain)[16], uint8_t (*cipher)[16], size_t num_blocks), (schedule->bytes, plain, cipher, num_blocks))
+/* --- Decrypt blocks transforms --- (in-place operation allowed) */
+AES_PUBLIC_FN(aes128_decrypt_blocks, decrypt128, (const aes128_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes192_decrypt_blocks, decrypt192, (const aes192_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes256_decrypt_blocks, decrypt256, (const aes256_sched_full_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes128_decrypt_blocks_dec, decrypt_dec128, (const aes128_sched_dec_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes192_decrypt_blocks_dec, decrypt_dec192, (const aes192_sched_dec_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes256_decrypt_blocks_dec, decrypt_dec256, (const aes256_sched_dec_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes128_decrypt_blocks_enc, decrypt_enc128, (const aes128_sched_enc_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes192_decrypt_blocks_enc, decrypt_enc192, (const aes192_sched_enc_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+AES_PUBLIC_FN(aes256_decrypt_blocks_enc, decrypt_enc256, (const aes256_sched_enc_t* schedule, const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, cipher, plain, num_blocks))
+#undef AES_PUBLIC_FN
+
+#undef AES_SCHED_BYTES
 #undef get_11_keys
-#undef get_keys_0_10
@@ -0,0 +1,333 @@
+/* AEGIS-128L & AEGIS-256 (draft-irtf-cfrg-aegis-aead)
+ * AES-NI: the state blocks stay in xmm registers, one AESENC each per update (8 or 6 independent rounds),
+ * VAES (AEGIS-128L): pairs of state blocks per ymm register, 4 VAESENC per update instead of 8 AESENC,
+ * other CPUs run the update as one bitsliced round over all the state blocks (aes.c, constant-time).
+ * Features:
+ *  - AEGIS-128L / AEGIS-256 seal / open
+ */
+
+/* Table of Contents
+ *  --- AEGIS internal ---
+ *  --- Backend dispatch --- (one tier per process, picked once)
+ *  --- Public AEGIS ---
+ */
+
+#include "aes_aegis.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memset */
+
+/* --- AEGIS internal ---
+ * AESRound(in, rk) is AESENC. AEGIS-128L: state S0 - S7, Update(M0, M1): S'i = AESRound(S(i-1 mod 8), Si) with M0
+ * xored into S0 & M1 into S4 first; 32 byte blocks, keystream Z0 = S1 ^ S6 ^ (S2 & S3), Z1 = S2 ^ S5 ^ (S6 & S7).
+ * AEGIS-256: state S0 - S5, Update(M) xors M into S0; 16 byte blocks, keystream Z = S1 ^ S4 ^ S5 ^ (S2 & S3).
+ * Both: init from key & nonce (10 / 4 x 4 updates), absorb the zero padded aad, encrypt blocks (keystream taken before
+ * the update, which absorbs the plaintext), then 7 updates with the bit lengths folded into S2 (128L) / S3 (256).
+ * 128 bit tags xor all state blocks (128L: S0 - S6), 256 bit tags xor each half of the state.
+ * VAES layout (128L): pairs (S0, S4), (S1, S5), (S2, S6), (S3, S7), so only the first pair needs its rotated input
+ * from a lane swap of the last one. AEGIS-256 stays on AES-NI: its 6 AESENC per update already issue within one round
+ * latency, so pairing saves nothing & the lane extracts of its keystream lengthen the decrypt chain (~2x slower open).
+ */
+#define AEGIS_LEN_MAX ((uint64_t) 1 << 61) /* aad & message lengths in bits fit 64 bits */
+
+static const uint8_t aegis_c[2][16] = {
+    { 0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x08, 0x0d, 0x15, 0x22, 0x37, 0x59, 0x90, 0xe9, 0x79, 0x62 },
+    { 0xdb, 0x3d, 0x18, 0x55, 0x6d, 0xc2, 0x2f, 0xf1, 0x20, 0x11, 0x31, 0x42, 0x73, 0xb5, 0x28, 0xdd }
+};
+
+/* tag 16 or 32 bytes, lengths below 2^61 bytes */
+static inline bool aegis_params_ok(size_t aad_len, size_t len, size_t tag_len) {
+    return (tag_len == 16 || tag_len == 32) && (uint64_t) aad_len < AEGIS_LEN_MAX && (uint64_t) len < AEGIS_LEN_MAX;
+}
+
+#define AEGIS_LOAD(p)     _mm_loadu_si128((const __m128i*) (p))
+#define AEGIS_STORE(p, x) _mm_storeu_si128((__m128i*) (p), x)
+#define AEGIS_XOR         _mm_xor_si128
+#define AEGIS_AND         _mm_and_si128
+
+/* Pure C update of an n block state (s[i] = AESRound(s[i - 1 mod n], s[i]), m0 into s[0], m1 into s[j]):
+ * every round of the update in one bitsliced call */
+static void aegis_update_generic(__m128i* s, size_t n, __m128i m0, size_t j, __m128i m1) {
+    uint8_t in[8][16], rk[8][16];
+    for (size_t i = 0; i < n; i++) {
+        AEGIS_STORE(in[i], s[(i + n - 1) % n]);
+        AEGIS_STORE(rk[i], i == 0 ? AEGIS_XOR(s[0], m0) : i == j ? AEGIS_XOR(s[i], m1) : s[i]);
+    }
+    aes_ct64_enc_round8((const uint8_t (*)[16]) in, (const uint8_t (*)[16]) rk, in, n);
+    for (size_t i = 0; i < n; i++) s[i] = AEGIS_LOAD(in[i]);
+}
+
+/* State updates on xmm registers (s: __m128i array, constant indices: kept in registers) */
+#define AEGIS128L_UPDATE_aesni(m0, m1) {                                                                          \
+    const __m128i _t = s[7];                                                                                      \
+    s[7] = _mm_aesenc_si128(s[6], s[7]); s[6] = _mm_aesenc_si128(s[5], s[6]); s[5] = _mm_aesenc_si128(s[4], s[5]); \
+    s[4] = _mm_aesenc_si128(s[3], AEGIS_XOR(s[4], m1)); s[3] = _mm_aesenc_si128(s[2], s[3]);                      \
+    s[2] = _mm_aesenc_si128(s[1], s[2]); s[1] = _mm_aesenc_si128(s[0], s[1]);                                     \
+    s[0] = _mm_aesenc_si128(_t, AEGIS_XOR(s[0], m0));                                                             \
+}
+#define AEGIS256_UPDATE_aesni(m) {                                                                                \
+    const __m128i _t = s[5];                                                                                      \
+    s[5] = _mm_aesenc_si128(s[4], s[5]); s[4] = _mm_aesenc_si128(s[3], s[4]); s[3] = _mm_aesenc_si128(s[2], s[3]); \
+    s[2] = _mm_aesenc_si128(s[1], s[2]); s[1] = _mm_aesenc_si128(s[0], s[1]);                                     \
+    s[0] = _mm_aesenc_si128(_t, AEGIS_XOR(s[0], m));                                                              \
+}
+#define AEGIS128L_UPDATE_generic(m0, m1) aegis_update_generic(s, 8, m0, 4, m1);
+#define AEGIS256_UPDATE_generic(m)       aegis_update_generic(s, 6, m, 6, _mm_setzero_si128());
+
+/* xmm state ops shared by the AES-NI & pure C tiers (U: the tier's update): state, init, absorb a block, keystream,
+ * en/decrypt a block (loads before the stores: in-place safe), final (tag_len bytes of tag) */
+#define AEGIS128L_STATE_SSE __m128i s[8];
+#define AEGIS128L_INIT_SSE(U, key, nonce) {                                                                       \
+    const __m128i k = AEGIS_LOAD(key), n = AEGIS_LOAD(nonce), c0 = AEGIS_LOAD(aegis_c[0]), c1 = AEGIS_LOAD(aegis_c[1]); \
+    s[0] = AEGIS_XOR(k, n); s[1] = c1; s[2] = c0; s[3] = c1;                                                      \
+    s[4] = AEGIS_XOR(k, n); s[5] = AEGIS_XOR(k, c0); s[6] = AEGIS_XOR(k, c1); s[7] = AEGIS_XOR(k, c0);            \
+    for (int r = 0; r < 10; r++) U(n, k)                                                                          \
+}
+#define AEGIS128L_ABSORB_SSE(U, p) U(AEGIS_LOAD(p), AEGIS_LOAD((p) + 16))
+#define AEGIS128L_Z0_SSE AEGIS_XOR(AEGIS_XOR(s[6], s[1]), AEGIS_AND(s[2], s[3]))
+#define AEGIS128L_Z1_SSE AEGIS_XOR(AEGIS_XOR(s[2], s[5]), AEGIS_AND(s[6], s[7]))
+#define AEGIS128L_KEYSTREAM_SSE(U, z) { AEGIS_STORE(z, AEGIS128L_Z0_SSE); AEGIS_STORE((z) + 16, AEGIS128L_Z1_SSE); }
+#define AEGIS128L_CRYPT_SSE(U, in, out, enc) {                                                                    \
+    const __m128i x0 = AEGIS_LOAD(in), x1 = AEGIS_LOAD((in) + 16);                                                \
+    const __m128i y0 = AEGIS_XOR(x0, AEGIS128L_Z0_SSE), y1 = AEGIS_XOR(x1, AEGIS128L_Z1_SSE);                     \
+    AEGIS_STORE(out, y0); AEGIS_STORE((out) + 16, y1);                                                            \
+    if (enc) U(x0, x1) else U(y0, y1)                                                                             \
+}
+#define AEGIS128L_FINAL_SSE(U, ad_bits, msg_bits, tag, tag_len) {                                                 \
+    const __m128i t = AEGIS_XOR(s[2], _mm_set_epi64x((long long) (msg_bits), (long long) (ad_bits)));             \
+    for (int r = 0; r < 7; r++) U(t, t)                                                                           \
+    const __m128i lo = AEGIS_XOR(AEGIS_XOR(s[0], s[1]), AEGIS_XOR(s[2], s[3]));                                   \
+    const __m128i hi = AEGIS_XOR(AEGIS_XOR(s[4], s[5]), s[6]);                                                    \
+    if (tag_len == 16) AEGIS_STORE(tag, AEGIS_XOR(lo, hi));                                                       \
+    else { AEGIS_STORE(tag, lo); AEGIS_STORE((tag) + 16, AEGIS_XOR(hi, s[7])); }                                  \
+}
+#define AEGIS256_STATE_SSE __m128i s[6];
+#define AEGIS256_INIT_SSE(U, key, nonce) {                                                                        \
+    const __m128i k0 = AEGIS_LOAD(key), k1 = AEGIS_LOAD((key) + 16), n0 = AEGIS_LOAD(nonce), n1 = AEGIS_LOAD((nonce) + 16); \
+    const __m128i c0 = AEGIS_LOAD(aegis_c[0]), c1 = AEGIS_LOAD(aegis_c[1]), kn0 = AEGIS_XOR(k0, n0), kn1 = AEGIS_XOR(k1, n1); \
+    s[0] = kn0; s[1] = kn1; s[2] = c1; s[3] = c0; s[4] = AEGIS_XOR(k0, c0); s[5] = AEGIS_XOR(k1, c1);             \
+    for (int r = 0; r < 4; r++) { U(k0) U(k1) U(kn0) U(kn1) }                                                     \
+}
+#define AEGIS256_ABSORB_SSE(U, p) U(AEGIS_LOAD(p))
+#define AEGIS256_Z_SSE AEGIS_XOR(AEGIS_XOR(AEGIS_XOR(s[1], s[4]), s[5]), AEGIS_AND(s[2], s[3]))
+#define AEGIS256_KEYSTREAM_SSE(U, z) AEGIS_STORE(z, AEGIS256_Z_SSE);
+#define AEGIS256_CRYPT_SSE(U, in, out, enc) {                                                                     \
+    const __m128i x = AEGIS_LOAD(in), y = AEGIS_XOR(x, AEGIS256_Z_SSE);                                           \
+    AEGIS_STORE(out, y);                                                                                          \
+    if (enc) U(x) else U(y)                                                                                       \
+}
+#define AEGIS256_FINAL_SSE(U, ad_bits, msg_bits, tag, tag_len) {                                                  \
+    const __m128i t = AEGIS_XOR(s[3], _mm_set_epi64x((long long) (msg_bits), (long long) (ad_bits)));             \
+    for (int r = 0; r < 7; r++) U(t)                                                                              \
+    const __m128i lo = AEGIS_XOR(AEGIS_XOR(s[0], s[1]), s[2]), hi = AEGIS_XOR(AEGIS_XOR(s[3], s[4]), s[5]);       \
+    if (tag_len == 16) AEGIS_STORE(tag, AEGIS_XOR(lo, hi));                                                       \
+    else { AEGIS_STORE(tag, lo); AEGIS_STORE((tag) + 16, hi); }                                                   \
+}
+/* Tier T ops: the shared xmm ops with T's update */
+#define AEGIS128L_STATE_aesni                      AEGIS128L_STATE_SSE
+#define AEGIS128L_INIT_aesni(key, nonce)           AEGIS128L_INIT_SSE(AEGIS128L_UPDATE_aesni, key, nonce)
+#define AEGIS128L_ABSORB_aesni(p)                  AEGIS128L_ABSORB_SSE(AEGIS128L_UPDATE_aesni, p)
+#define AEGIS128L_KEYSTREAM_aesni(z)               AEGIS128L_KEYSTREAM_SSE(AEGIS128L_UPDATE_aesni, z)
+#define AEGIS128L_CRYPT_aesni(in, out, enc)        AEGIS128L_CRYPT_SSE(AEGIS128L_UPDATE_aesni, in, out, enc)
+#define AEGIS128L_FINAL_aesni(a, m, tag, tag_len)  AEGIS128L_FINAL_SSE(AEGIS128L_UPDATE_aesni, a, m, tag, tag_len)
+#define AEGIS256_STATE_aesni                       AEGIS256_STATE_SSE
+#define AEGIS256_INIT_aesni(key, nonce)            AEGIS256_INIT_SSE(AEGIS256_UPDATE_aesni, key, nonce)
+#define AEGIS256_ABSORB_aesni(p)                   AEGIS256_ABSORB_SSE(AEGIS256_UPDATE_aesni, p)
+#define AEGIS256_KEYSTREAM_aesni(z)                AEGIS256_KEYSTREAM_SSE(AEGIS256_UPDATE_aesni, z)
+#define AEGIS256_CRYPT_aesni(in, out, enc)         AEGIS256_CRYPT_SSE(AEGIS256_UPDATE_aesni, in, out, enc)
+#define AEGIS256_FINAL_aesni(a, m, tag, tag_len)   AEGIS256_FINAL_SSE(AEGIS256_UPDATE_aesni, a, m, tag, tag_len)
+#define AEGIS128L_STATE_generic                    AEGIS128L_STATE_SSE
+#define AEGIS128L_INIT_generic(key, nonce)         AEGIS128L_INIT_SSE(AEGIS128L_UPDATE_generic, key, nonce)
+#define AEGIS128L_ABSORB_generic(p)                AEGIS128L_ABSORB_SSE(AEGIS128L_UPDATE_generic, p)
+#define AEGIS128L_KEYSTREAM_generic(z)             AEGIS128L_KEYSTREAM_SSE(AEGIS128L_UPDATE_generic, z)
+#define AEGIS128L_CRYPT_generic(in, out, enc)      AEGIS128L_CRYPT_SSE(AEGIS128L_UPDATE_generic, in, out, enc)
+#define AEGIS128L_FINAL_generic(a, m, tag, tag_len) AEGIS128L_FINAL_SSE(AEGIS128L_UPDATE_generic, a, m, tag, tag_len)
+#define AEGIS256_STATE_generic                     AEGIS256_STATE_SSE
+#define AEGIS256_INIT_generic(key, nonce)          AEGIS256_INIT_SSE(AEGIS256_UPDATE_generic, key, nonce)
+#define AEGIS256_ABSORB_generic(p)                 AEGIS256_ABSORB_SSE(AEGIS256_UPDATE_generic, p)
+#define AEGIS256_KEYSTREAM_generic(z)              AEGIS256_KEYSTREAM_SSE(AEGIS256_UPDATE_generic, z)
+#define AEGIS256_CRYPT_generic(in, out, enc)       AEGIS256_CRYPT_SSE(AEGIS256_UPDATE_generic, in, out, enc)
+#define AEGIS256_FINAL_generic(a, m, tag, tag_len) AEGIS256_FINAL_SSE(AEGIS256_UPDATE_generic, a, m, tag, tag_len)
+
+/* VAES ops (128L): pairs of state blocks per ymm (p: __m256i array, layout above), lane swap (S0, S4) -> (S4, S0) */
+#define AEGIS_SWAP(x)      _mm256_permute4x64_epi64(x, 0x4E)
+#define AEGIS_LO(x)        _mm256_castsi256_si128(x)
+#define AEGIS_HI(x)        _mm256_extracti128_si256(x, 1)
+#define AEGIS_PAIR(lo, hi) _mm256_set_m128i(hi, lo)
+#define AEGIS128L_UPDATE_vaes256(m) {                                                                             \
+    const __m256i _t = AEGIS_SWAP(p[3]); /* (S7, S3) */                                                           \
+    p[3] = _mm256_aesenc_epi128(p[2], p[3]); p[2] = _mm256_aesenc_epi128(p[1], p[2]);                             \
+    p[1] = _mm256_aesenc_epi128(p[0], p[1]); p[0] = _mm256_aesenc_epi128(_t, _mm256_xor_si256(p[0], m));          \
+}
+#define AEGIS128L_STATE_vaes256 __m256i p[4];
+#define AEGIS128L_INIT_vaes256(key, nonce) {                                                                      \
+    const __m128i k = AEGIS_LOAD(key), n = AEGIS_LOAD(nonce), c0 = AEGIS_LOAD(aegis_c[0]), c1 = AEGIS_LOAD(aegis_c[1]); \
+    const __m256i m = AEGIS_PAIR(n, k);                                                                           \
+    p[0] = _mm256_broadcastsi128_si256(AEGIS_XOR(k, n)); p[1] = AEGIS_PAIR(c1, AEGIS_XOR(k, c0));                 \
+    p[2] = AEGIS_PAIR(c0, AEGIS_XOR(k, c1)); p[3] = p[1];                                                         \
+    for (int r = 0; r < 10; r++) AEGIS128L_UPDATE_vaes256(m)                                                      \
+}
+#define AEGIS128L_ABSORB_vaes256(ptr) AEGIS128L_UPDATE_vaes256(_mm256_loadu_si256((const __m256i*) (ptr)))
+#define AEGIS128L_Z_vaes256 _mm256_xor_si256(_mm256_xor_si256(p[1], AEGIS_SWAP(p[2])), _mm256_and_si256(p[2], p[3]))
+#define AEGIS128L_KEYSTREAM_vaes256(z) _mm256_storeu_si256((__m256i*) (z), AEGIS128L_Z_vaes256);
+#define AEGIS128L_CRYPT_vaes256(in, out, enc) {                                                                   \
+    const __m256i x = _mm256_loadu_si256((const __m256i*) (in)), y = _mm256_xor_si256(x, AEGIS128L_Z_vaes256);    \
+    _mm256_storeu_si256((__m256i*) (out), y);                                                                     \
+    AEGIS128L_UPDATE_vaes256(enc ? x : y)                                                                         \
+}
+#define AEGIS128L_FINAL_vaes256(ad_bits, msg_bits, tag, tag_len) {                                                \
+    const __m256i t = _mm256_broadcastsi128_si256(                                                                \
+        AEGIS_XOR(AEGIS_LO(p[2]), _mm_set_epi64x((long long) (msg_bits), (long long) (ad_bits))));                \
+    for (int r = 0; r < 7; r++) AEGIS128L_UPDATE_vaes256(t)                                                       \
+    const __m256i x = _mm256_xor_si256(_mm256_xor_si256(p[0], p[1]), _mm256_xor_si256(p[2], p[3]));               \
+    if (tag_len == 16) AEGIS_STORE(tag, AEGIS_XOR(AEGIS_XOR(AEGIS_LO(x), AEGIS_HI(x)), AEGIS_HI(p[3])));          \
+    else _mm256_storeu_si256((__m256i*) (tag), x);                                                                \
+}
+/* Generates a tier's AEGIS pass (V: 128L, 256; B: block bytes; isa: the tier's TARGET or nothing)
+ * crypt: init, aad (zero padded last block), payload (the last partial block through a zero padded copy: opening
+ * absorbs the decrypted bytes only), final. tag gets tag_len (16 or 32) bytes */
+#define AEGIS_CRYPT_FN(V, T, B, isa)                                                                              \
+    isa static void aegis##V##_crypt_##T(const uint8_t* key, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* in, uint8_t* out, size_t len, bool enc, uint8_t* tag, size_t tag_len) { \
+        AEGIS##V##_STATE_##T                                                                                      \
+        uint8_t t[B], z[B];                                                                                       \
+        size_t i;                                                                                                 \
+        AEGIS##V##_INIT_##T(key, nonce)                                                                           \
+        for (i = 0; i + B <= aad_len; i += B) AEGIS##V##_ABSORB_##T(aad + i)                                      \
+        if (i < aad_len) {                                                                                        \
+            memset(t, 0, B); memcpy(t, aad + i, aad_len - i);                                                     \
+            AEGIS##V##_ABSORB_##T(t)                                                                              \
+        }                                                                                                         \
+        for (i = 0; i + B <= len; i += B) AEGIS##V##_CRYPT_##T(in + i, out + i, enc)                              \
+        if (i < len) {                                                                                            \
+            memset(t, 0, B); memcpy(t, in + i, len - i);                                                          \
+            if (enc) AEGIS##V##_CRYPT_##T(t, t, true)                                                             \
+            else {                                                                                                \
+                AEGIS##V##_KEYSTREAM_##T(z)                                                                       \
+                xor_bytes(t, t, z, len - i); /* the padding stays zero */                                         \
+                AEGIS##V##_ABSORB_##T(t)                                                                          \
+            }                                                                                                     \
+            memcpy(out + i, t, len - i);                                                                          \
+        }                                                                                                         \
+        AEGIS##V##_FINAL_##T((uint64_t) aad_len * 8, (uint64_t) len * 8, tag, tag_len)                            \
+    }
+AEGIS_CRYPT_FN(128L, vaes256, 32, TARGET("aes,vaes,avx2"))
+AEGIS_CRYPT_FN(128L, aesni, 32, TARGET("aes"))
+AEGIS_CRYPT_FN(256, aesni, 16, TARGET("aes"))
+AEGIS_CRYPT_FN(128L, generic, 32, )
+AEGIS_CRYPT_FN(256, generic, 16, )
+#undef AEGIS_CRYPT_FN
+
+/* Generates a tier's seal / open for one variant (v: 128l, 256 for names; bits: key type) */
+#define AEGIS_FN(v, V, bits, T)                                                                                   \
+    static bool aegis##v##_seal_##T(const aes##bits##_key_t* key, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                    const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len) { \
+        uint8_t full[32];                                                                                         \
+        if (!aegis_params_ok(aad_len, len, tag_len)) return false;                                                \
+        aegis##V##_crypt_##T(key->bytes, nonce, aad, aad_len, plain, cipher, len, true, full, tag_len);           \
+        memcpy(tag, full, tag_len);                                                                               \
+        return true;                                                                                              \
+    }                                                                                                             \
+    static bool aegis##v##_open_##T(const aes##bits##_key_t* key, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                    const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len) { \
+        uint8_t full[32], diff = 0;                                                                               \
+        if (!aegis_params_ok(aad_len, len, tag_len)) { memset(plain, 0, len); return false; }                     \
+        aegis##V##_crypt_##T(key->bytes, nonce, aad, aad_len, cipher, plain, len, false, full, tag_len);          \
+        for (size_t i = 0; i < tag_len; i++) diff |= full[i] ^ tag[i]; /* constant-time compare */                \
+        if (diff) { memset(plain, 0, len); return false; }                                                        \
+        return true;                                                                                              \
+    }
+AEGIS_FN(128l, 128L, 128, vaes256)
+AEGIS_FN(128l, 128L, 128, aesni)
+AEGIS_FN(256, 256, 256, aesni)
+AEGIS_FN(128l, 128L, 128, generic)
+AEGIS_FN(256, 256, 256, generic)
+#undef AEGIS_FN
+
+/* --- Backend dispatch --- (one tier per process, picked once, same flavors as aes.c) */
+typedef struct {
+    bool (*seal128l)(const aes128_key_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*seal256)(const aes256_key_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*open128l)(const aes128_key_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+    bool (*open256)(const aes256_key_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+} aes_aegis_tier_t;
+
+#define AES_AEGIS_TIER(T) {                                                 \
+    aegis128l_seal_##T, aegis256_seal_##T,                                  \
+    aegis128l_open_##T, aegis256_open_##T                                   \
+}
+static const aes_aegis_tier_t aes_aegis_tier_vaes256 = { /* AEGIS-256 keeps AES-NI (see AEGIS internal) */
+    aegis128l_seal_vaes256, aegis256_seal_aesni,
+    aegis128l_open_vaes256, aegis256_open_aesni
+};
+static const aes_aegis_tier_t aes_aegis_tier_aesni   = AES_AEGIS_TIER(aesni);
+static const aes_aegis_tier_t aes_aegis_tier_generic = AES_AEGIS_TIER(generic);
+#undef AES_AEGIS_TIER
+
+/* Best tier for the given hardware (VAES on ymm, any AVX-512 CPU has it too) */
+static inline const aes_aegis_tier_t* aes_aegis_select_tier(const hardware_t* hw) {
+    if (hw->vaes) return &aes_aegis_tier_vaes256;
+    if (hw->aes)  return &aes_aegis_tier_aesni;
+    return &aes_aegis_tier_generic;
+}
+
+/* ret: return for value returning ops, empty for void ones */
+#if defined(CRYPTOCORE_ASSUME)
+    static const hardware_t aes_aegis_assumed_hardware = HARDWARE_ASSUMED;
+    #define AES_AEGIS_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_aegis_select_tier(&aes_aegis_assumed_hardware)->field args; }
+    void aes_aegis_dispatch_update(void) {}
+#elif defined(CRYPTOCORE_IFUNC)
+    #define AES_AEGIS_PUBLIC_FN(type, ret, name, field, params, args)                                 \
+        static type (*name##_resolve(void)) params {                                                  \
+            hardware_t hw;                                                                            \
+            hardware_detect(&hw);                                                                     \
+            return aes_aegis_select_tier(&hw)->field;                                                 \
+        }                                                                                             \
+        type name params __attribute__((ifunc(#name "_resolve")));
+    void aes_aegis_dispatch_update(void) {}
+#else
+    static const aes_aegis_tier_t* aes_aegis_tier; /* set below, after its stubs */
+    void aes_aegis_dispatch_update(void) {
+        hardware_init();
+        aes_aegis_tier = aes_aegis_select_tier(&_hardware);
+    }
+    #define AES_AEGIS_UNRESOLVED_FN(type, ret, field, params, args) \
+        static type aes_aegis_unresolved_##field params { aes_aegis_dispatch_update(); ret aes_aegis_tier->field args; }
+    #define AES_AEGIS_SEAL_PARAMS(bits) (const aes##bits##_key_t* key, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* in, uint8_t* out, size_t len, uint8_t* tag, size_t tag_len)
+    #define AES_AEGIS_OPEN_PARAMS(bits) (const aes##bits##_key_t* key, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* in, uint8_t* out, size_t len, const uint8_t* tag, size_t tag_len)
+    #define AES_AEGIS_CRYPT_ARGS (key, nonce, aad, aad_len, in, out, len, tag, tag_len)
+    AES_AEGIS_UNRESOLVED_FN(bool, return, seal128l, AES_AEGIS_SEAL_PARAMS(128), AES_AEGIS_CRYPT_ARGS)
+    AES_AEGIS_UNRESOLVED_FN(bool, return, seal256, AES_AEGIS_SEAL_PARAMS(256), AES_AEGIS_CRYPT_ARGS)
+    AES_AEGIS_UNRESOLVED_FN(bool, return, open128l, AES_AEGIS_OPEN_PARAMS(128), AES_AEGIS_CRYPT_ARGS)
+    AES_AEGIS_UNRESOLVED_FN(bool, return, open256, AES_AEGIS_OPEN_PARAMS(256), AES_AEGIS_CRYPT_ARGS)
+    #undef AES_AEGIS_SEAL_PARAMS
+    #undef AES_AEGIS_OPEN_PARAMS
+    #undef AES_AEGIS_CRYPT_ARGS
+    #undef AES_AEGIS_UNRESOLVED_FN
+    static const aes_aegis_tier_t aes_aegis_tier_unresolved = {
+        aes_aegis_unresolved_seal128l, aes_aegis_unresolved_seal256,
+        aes_aegis_unresolved_open128l, aes_aegis_unresolved_open256
+    };
+    static const aes_aegis_tier_t* aes_aegis_tier = &aes_aegis_tier_unresolved;
+    INITIALIZER(aes_aegis_dispatch_startup) { aes_aegis_dispatch_update(); }
+    #define AES_AEGIS_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_aegis_tier->field args; }
+#endif
+
+/* --- Public AEGIS --- */
+#define AES_AEGIS_PUBLIC_FNS(v, bits, nonce_bytes)                                                                \
+    AES_AEGIS_PUBLIC_FN(bool, return, aegis##v##_seal, seal##v,                                                   \
+                        (const aes##bits##_key_t* key, const uint8_t nonce[nonce_bytes], const uint8_t* aad, size_t aad_len, \
+                         const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len),        \
+                        (key, nonce, aad, aad_len, plain, cipher, len, tag, tag_len))                             \
+    AES_AEGIS_PUBLIC_FN(bool, return, aegis##v##_open, open##v,                                                   \
+                        (const aes##bits##_key_t* key, const uint8_t nonce[nonce_bytes], const uint8_t* aad, size_t aad_len, \
+                         const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len),  \
+                        (key, nonce, aad, aad_len, cipher, plain, len, tag, tag_len))
+AES_AEGIS_PUBLIC_FNS(128l, 128, 16)
+AES_AEGIS_PUBLIC_FNS(256, 256, 32)
+#undef AES_AEGIS_PUBLIC_FNS
+#undef AES_AEGIS_PUBLIC_FN
@@ -0,0 +1,281 @@
+/* AES-CCM for 128, 192 & 256 bits keys (RFC 3610, NIST SP 800-38C)
+ * AES-NI: the serial CBC-MAC block & the next CTR block run as 2 independent chains through the same rounds
+ * (the keystream fills the latency gaps of the MAC chain, one pass over the data),
+ * other CPUs run the CBC-MAC block by block & CTR through aes_modes.h.
+ * Features:
+ *  - CCM seal / open
+ */
+
+/* Table of Contents
+ *  --- CCM internal ---
+ *  --- Backend dispatch --- (one tier per process, picked once)
+ *  --- Public CCM ---
+ */
+
+#include "aes_ccm.h"
+#include "aes_modes.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memset */
+
+/* --- CCM internal ---
+ * q = 15 - nonce_len byte length field. B0 = flags (aad present, (tag_len - 2) / 2, q - 1) || nonce || [len]_q,
+ * then the aad with its 2, 6 or 10 byte length prefix & the payload, each zero padded to whole blocks, run through
+ * the CBC-MAC (y). Counter block j = (q - 1) || nonce || [j]_q: block 0 masks the tag, the payload starts at 1.
+ * [j]_q never passes 2^(8q) for valid lengths, so a 64 bit counter increment (q <= 8) stays inside the field.
+ */
+#define AES_CCM_NONCE_MIN 7
+#define AES_CCM_NONCE_MAX 13
+
+/* nonce 7 - 13 bytes, tag 4 - 16 bytes & even, len < 2^(8q) */
+static inline bool aes_ccm_params_ok(size_t nonce_len, size_t tag_len, size_t len) {
+    if (nonce_len - AES_CCM_NONCE_MIN > AES_CCM_NONCE_MAX - AES_CCM_NONCE_MIN || tag_len - 4 > 12 || (tag_len & 1)) return false;
+    const size_t q = 15 - nonce_len;
+    return q >= 8 || ((uint64_t) len >> (8 * q)) == 0;
+}
+
+/* B0 & counter block 0 */
+static void aes_ccm_b0(const uint8_t* nonce, size_t nonce_len, size_t aad_len, size_t len, size_t tag_len, uint8_t b0[16], uint8_t ctr0[16]) {
+    const size_t q = 15 - nonce_len;
+    memset(b0, 0, 16); memset(ctr0, 0, 16);
+    b0[0] = (uint8_t) ((aad_len ? 0x40 : 0) | ((tag_len - 2) / 2) << 3 | (q - 1));
+    ctr0[0] = (uint8_t) (q - 1);
+    memcpy(b0 + 1, nonce, nonce_len); memcpy(ctr0 + 1, nonce, nonce_len);
+    for (size_t i = 0; i < q && i < 8; i++) b0[15 - i] = (uint8_t) ((uint64_t) len >> (8 * i));
+}
+
+/* aad length prefix into p (aad_len > 0), returns its size */
+static size_t aes_ccm_aad_prefix(uint8_t* p, size_t aad_len) {
+    if (aad_len < 0xFF00) { p[0] = (uint8_t) (aad_len >> 8); p[1] = (uint8_t) aad_len; return 2; }
+    if (((uint64_t) aad_len >> 32) == 0) { store_be64(p + 2, (uint64_t) aad_len << 32); p[0] = 0xFF; p[1] = 0xFE; return 6; }
+    store_be64(p + 2, (uint64_t) aad_len); p[0] = 0xFF; p[1] = 0xFF;
+    return 10;
+}
+
+/* Generates the AES-NI CBC-MAC (y absorbs n whole blocks) & payload kernel
+ * Payload: out = in ^ keystream from counter, y absorbs the plaintext (a partial last block zero padded).
+ * Sealing runs MAC(P_i) with counter i, opening runs MAC(P_i) with counter i + 1 (the MAC needs the plaintext first),
+ * loads happen before the stores: in-place safe. */
+#define AES_CCM_AESNI_FN(bits)                                                                                    \
+    TARGET("aes") static void aes##bits##_ccm_mac_aesni(const uint8_t* s, uint8_t y_bytes[16], const uint8_t* in, size_t n) { \
+        AES##bits##_ENC_KEYS(get_key, k, s)                                                                       \
+        __m128i y = _mm_loadu_si128((const __m128i*) y_bytes);                                                    \
+        for (; n; n--, in += 16) {                                                                                \
+            y = _mm_xor_si128(y, _mm_loadu_si128((const __m128i*) in));                                           \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X1_AMD64, y, k)                                                       \
+        }                                                                                                         \
+        _mm_storeu_si128((__m128i*) y_bytes, y);                                                                  \
+    }                                                                                                             \
+    TARGET("aes,ssse3") static void aes##bits##_ccm_ctr_aesni(const uint8_t* s, uint8_t y_bytes[16], uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t len, bool enc) { \
+        AES##bits##_ENC_KEYS(get_key, k, s)                                                                       \
+        const __m128i bswap = BSWAP128_MASK, one = _mm_set_epi32(0, 0, 0, 1);                                     \
+        __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) counter), bswap);                           \
+        __m128i y = _mm_loadu_si128((const __m128i*) y_bytes), m0, m1, ks = _mm_setzero_si128();                  \
+        if (!enc && len) {                                                                                        \
+            ks = _mm_shuffle_epi8(c, bswap); c = _mm_add_epi64(c, one);                                           \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X1_AMD64, ks, k)                                                      \
+        }                                                                                                         \
+        for (; len >= 16; len -= 16, in += 16, out += 16) {                                                       \
+            __m128i p = _mm_loadu_si128((const __m128i*) in);                                                     \
+            if (!enc) { p = _mm_xor_si128(p, ks); _mm_storeu_si128((__m128i*) out, p); }                          \
+            m0 = _mm_xor_si128(y, p);                                                                             \
+            m1 = _mm_shuffle_epi8(c, bswap); c = _mm_add_epi64(c, one);                                           \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X2_AMD64, m, k)                                                       \
+            y = m0;                                                                                               \
+            if (enc) _mm_storeu_si128((__m128i*) out, _mm_xor_si128(p, m1));                                      \
+            else ks = m1;                                                                                         \
+        }                                                                                                         \
+        if (len) {                                                                                                \
+            uint8_t t[16] = { 0 }, kb[16];                                                                        \
+            if (enc) {                                                                                            \
+                memcpy(t, in, len);                                                                               \
+                m0 = _mm_xor_si128(y, _mm_loadu_si128((const __m128i*) t));                                       \
+                m1 = _mm_shuffle_epi8(c, bswap); c = _mm_add_epi64(c, one);                                       \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X2_AMD64, m, k)                                                   \
+                _mm_storeu_si128((__m128i*) kb, m1);                                                              \
+                xor_bytes(out, in, kb, len);                                                                      \
+            } else {                                                                                              \
+                _mm_storeu_si128((__m128i*) kb, ks);                                                              \
+                xor_bytes(t, in, kb, len);                                                                        \
+                memcpy(out, t, len);                                                                              \
+                m0 = _mm_xor_si128(y, _mm_loadu_si128((const __m128i*) t));                                       \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X1_AMD64, m0, k)                                                  \
+            }                                                                                                     \
+            y = m0;                                                                                               \
+        }                                                                                                         \
+        _mm_storeu_si128((__m128i*) counter, _mm_shuffle_epi8(c, bswap));                                         \
+        _mm_storeu_si128((__m128i*) y_bytes, y);                                                                  \
+    }
+AES_CCM_AESNI_FN(128)
+AES_CCM_AESNI_FN(192)
+AES_CCM_AESNI_FN(256)
+#undef AES_CCM_AESNI_FN
+
+/* Generates the generic CBC-MAC (block by block) & payload kernel (MAC pass & CTR64 through aes_modes.h, in cache sized chunks) */
+#define AES_CCM_GENERIC_FN(bits)                                                                                  \
+    static void aes##bits##_ccm_mac_generic(const uint8_t* s, uint8_t y[16], const uint8_t* in, size_t n) {       \
+        for (; n; n--, in += 16) {                                                                                \
+            xor_bytes(y, y, in, 16);                                                                              \
+            aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) s, y, y);                                  \
+        }                                                                                                         \
+    }                                                                                                             \
+    static void aes##bits##_ccm_ctr_generic(const uint8_t* s, uint8_t y[16], uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t len, bool enc) { \
+        while (len) {                                                                                             \
+            const size_t used = len < 4096 ? len : 4096;                                                          \
+            const uint8_t* p = enc ? in : out; /* plaintext of this chunk */                                      \
+            if (!enc) aes##bits##_ctr_xor((const aes##bits##_sched_enc_t*) s, counter, AES_CTR64, in, out, used); \
+            aes##bits##_ccm_mac_generic(s, y, p, used >> 4);                                                      \
+            if (used & 15) {                                                                                      \
+                uint8_t t[16] = { 0 };                                                                            \
+                memcpy(t, p + (used & ~(size_t) 15), used & 15);                                                  \
+                aes##bits##_ccm_mac_generic(s, y, t, 1);                                                          \
+            }                                                                                                     \
+            if (enc) aes##bits##_ctr_xor((const aes##bits##_sched_enc_t*) s, counter, AES_CTR64, in, out, used);  \
+            len -= used; in += used; out += used;                                                                 \
+        }                                                                                                         \
+    }
+AES_CCM_GENERIC_FN(128)
+AES_CCM_GENERIC_FN(192)
+AES_CCM_GENERIC_FN(256)
+#undef AES_CCM_GENERIC_FN
+
+/* Generates a tier's CCM for one key size
+ * crypt: MAC(B0), MAC(prefixed aad), payload from counter 1, then tag = MAC ^ E(counter 0) */
+#define AES_CCM_FN(bits, T)                                                                                       \
+    static void aes##bits##_ccm_aad_##T(const uint8_t* s, uint8_t y[16], const uint8_t* aad, size_t aad_len) {    \
+        uint8_t b[16] = { 0 };                                                                                    \
+        const size_t h = aes_ccm_aad_prefix(b, aad_len), first = aad_len < 16 - h ? aad_len : 16 - h;             \
+        memcpy(b + h, aad, first);                                                                                \
+        aes##bits##_ccm_mac_##T(s, y, b, 1);                                                                      \
+        aad += first; aad_len -= first;                                                                           \
+        aes##bits##_ccm_mac_##T(s, y, aad, aad_len >> 4);                                                         \
+        if (aad_len & 15) {                                                                                       \
+            memset(b, 0, 16);                                                                                     \
+            memcpy(b, aad + (aad_len & ~(size_t) 15), aad_len & 15);                                              \
+            aes##bits##_ccm_mac_##T(s, y, b, 1);                                                                  \
+        }                                                                                                         \
+    }                                                                                                             \
+    static void aes##bits##_ccm_crypt_##T(const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                                          const uint8_t* in, uint8_t* out, size_t len, bool enc, size_t tag_len, uint8_t tag[16]) { \
+        uint8_t b0[16], ctr0[16], counter[16], y[16] = { 0 };                                                     \
+        aes_ccm_b0(nonce, nonce_len, aad_len, len, tag_len, b0, ctr0);                                            \
+        aes##bits##_ccm_mac_##T(schedule->bytes, y, b0, 1);                                                       \
+        if (aad_len) aes##bits##_ccm_aad_##T(schedule->bytes, y, aad, aad_len);                                   \
+        memcpy(counter, ctr0, 16);                                                                                \
+        counter[15] = 1;                                                                                          \
+        aes##bits##_ccm_ctr_##T(schedule->bytes, y, counter, in, out, len, enc);                                  \
+        aes##bits##_encrypt_block(schedule, ctr0, tag);                                                           \
+        xor_bytes(tag, tag, y, 16);                                                                               \
+    }                                                                                                             \
+    static bool aes##bits##_ccm_seal_##T(const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len) { \
+        uint8_t full[16];                                                                                         \
+        if (!aes_ccm_params_ok(nonce_len, tag_len, len)) return false;                                            \
+        aes##bits##_ccm_crypt_##T(schedule, nonce, nonce_len, aad, aad_len, plain, cipher, len, true, tag_len, full); \
+        memcpy(tag, full, tag_len);                                                                               \
+        return true;                                                                                              \
+    }                                                                                                             \
+    static bool aes##bits##_ccm_open_##T(const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len) { \
+        uint8_t full[16], diff = 0;                                                                               \
+        if (!aes_ccm_params_ok(nonce_len, tag_len, len)) { memset(plain, 0, len); return false; }                 \
+        aes##bits##_ccm_crypt_##T(schedule, nonce, nonce_len, aad, aad_len, cipher, plain, len, false, tag_len, full); \
+        for (size_t i = 0; i < tag_len; i++) diff |= full[i] ^ tag[i]; /* constant-time compare */                \
+        if (diff) { memset(plain, 0, len); return false; }                                                        \
+        return true;                                                                                              \
+    }
+AES_CCM_FN(128, aesni)
+AES_CCM_FN(192, aesni)
+AES_CCM_FN(256, aesni)
+AES_CCM_FN(128, generic)
+AES_CCM_FN(192, generic)
+AES_CCM_FN(256, generic)
+#undef AES_CCM_FN
+
+/* --- Backend dispatch --- (one tier per process, picked once, same flavors as aes.c) */
+typedef struct {
+    bool (*seal128)(const aes128_sched_enc_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*seal192)(const aes192_sched_enc_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*seal256)(const aes256_sched_enc_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*open128)(const aes128_sched_enc_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+    bool (*open192)(const aes192_sched_enc_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+    bool (*open256)(const aes256_sched_enc_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+} aes_ccm_tier_t;
+
+#define AES_CCM_TIER(T) {                                                   \
+    aes128_ccm_seal_##T, aes192_ccm_seal_##T, aes256_ccm_seal_##T,          \
+    aes128_ccm_open_##T, aes192_ccm_open_##T, aes256_ccm_open_##T           \
+}
+static const aes_ccm_tier_t aes_ccm_tier_aesni   = AES_CCM_TIER(aesni);
+static const aes_ccm_tier_t aes_ccm_tier_generic = AES_CCM_TIER(generic);
+#undef AES_CCM_TIER
+
+/* Best tier for the given hardware (the stitched kernel needs AES-NI & pshufb for the counter) */
+static inline const aes_ccm_tier_t* aes_ccm_select_tier(const hardware_t* hw) {
+    if (hw->aes && hw->ssse3) return &aes_ccm_tier_aesni;
+    return &aes_ccm_tier_generic;
+}
+
+/* ret: return for value returning ops, empty for void ones */
+#if defined(CRYPTOCORE_ASSUME)
+    static const hardware_t aes_ccm_assumed_hardware = HARDWARE_ASSUMED;
+    #define AES_CCM_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_ccm_select_tier(&aes_ccm_assumed_hardware)->field args; }
+    void aes_ccm_dispatch_update(void) {}
+#elif defined(CRYPTOCORE_IFUNC)
+    #define AES_CCM_PUBLIC_FN(type, ret, name, field, params, args)                                   \
+        static type (*name##_resolve(void)) params {                                                  \
+            hardware_t hw;                                                                            \
+            hardware_detect(&hw);                                                                     \
+            return aes_ccm_select_tier(&hw)->field;                                                   \
+        }                                                                                             \
+        type name params __attribute__((ifunc(#name "_resolve")));
+    void aes_ccm_dispatch_update(void) {}
+#else
+    static const aes_ccm_tier_t* aes_ccm_tier; /* set below, after its stubs */
+    void aes_ccm_dispatch_update(void) {
+        hardware_init();
+        aes_ccm_tier = aes_ccm_select_tier(&_hardware);
+    }
+    #define AES_CCM_UNRESOLVED_FN(type, ret, field, params, args) \
+        static type aes_ccm_unresolved_##field params { aes_ccm_dispatch_update(); ret aes_ccm_tier->field args; }
+    #define AES_CCM_SEAL_PARAMS(bits) (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                                       const uint8_t* in, uint8_t* out, size_t len, uint8_t* tag, size_t tag_len)
+    #define AES_CCM_OPEN_PARAMS(bits) (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                                       const uint8_t* in, uint8_t* out, size_t len, const uint8_t* tag, size_t tag_len)
+    #define AES_CCM_CRYPT_ARGS (schedule, nonce, nonce_len, aad, aad_len, in, out, len, tag, tag_len)
+    AES_CCM_UNRESOLVED_FN(bool, return, seal128, AES_CCM_SEAL_PARAMS(128), AES_CCM_CRYPT_ARGS)
+    AES_CCM_UNRESOLVED_FN(bool, return, seal192, AES_CCM_SEAL_PARAMS(192), AES_CCM_CRYPT_ARGS)
+    AES_CCM_UNRESOLVED_FN(bool, return, seal256, AES_CCM_SEAL_PARAMS(256), AES_CCM_CRYPT_ARGS)
+    AES_CCM_UNRESOLVED_FN(bool, return, open128, AES_CCM_OPEN_PARAMS(128), AES_CCM_CRYPT_ARGS)
+    AES_CCM_UNRESOLVED_FN(bool, return, open192, AES_CCM_OPEN_PARAMS(192), AES_CCM_CRYPT_ARGS)
+    AES_CCM_UNRESOLVED_FN(bool, return, open256, AES_CCM_OPEN_PARAMS(256), AES_CCM_CRYPT_ARGS)
+    #undef AES_CCM_SEAL_PARAMS
+    #undef AES_CCM_OPEN_PARAMS
+    #undef AES_CCM_CRYPT_ARGS
+    #undef AES_CCM_UNRESOLVED_FN
+    static const aes_ccm_tier_t aes_ccm_tier_unresolved = {
+        aes_ccm_unresolved_seal128, aes_ccm_unresolved_seal192, aes_ccm_unresolved_seal256,
+        aes_ccm_unresolved_open128, aes_ccm_unresolved_open192, aes_ccm_unresolved_open256
+    };
+    static const aes_ccm_tier_t* aes_ccm_tier = &aes_ccm_tier_unresolved;
+    INITIALIZER(aes_ccm_dispatch_startup) { aes_ccm_dispatch_update(); }
+    #define AES_CCM_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_ccm_tier->field args; }
+#endif
+
+/* --- Public CCM --- */
+#define AES_CCM_PUBLIC_FNS(bits)                                                                                  \
+    AES_CCM_PUBLIC_FN(bool, return, aes##bits##_ccm_seal, seal##bits,                                            \
+                      (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                       const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len),          \
+                      (schedule, nonce, nonce_len, aad, aad_len, plain, cipher, len, tag, tag_len))               \
+    AES_CCM_PUBLIC_FN(bool, return, aes##bits##_ccm_open, open##bits,                                            \
+                      (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                       const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len),    \
+                      (schedule, nonce, nonce_len, aad, aad_len, cipher, plain, len, tag, tag_len))
+AES_CCM_PUBLIC_FNS(128)
+AES_CCM_PUBLIC_FNS(192)
+AES_CCM_PUBLIC_FNS(256)
+#undef AES_CCM_PUBLIC_FNS
+#undef AES_CCM_PUBLIC_FN
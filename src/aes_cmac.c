@@ -0,0 +1,140 @@
+/* AES-CMAC for 128, 192 & 256 bits keys (NIST SP 800-38B)
+ * Messages of a group run their chains as one multi-buffer CBC-MAC call (aes_modes.h picks the AES-NI / VAES lanes or
+ * the fallback), then their last blocks as a second call of 1 block streams from the chain values; one key groups of
+ * short messages step their chains together through the batched block transform instead.
+ * A single message chains through the block transform (its blocks are serial either way).
+ * Features:
+ *  - CMAC tag / verify (single messages & multi-buffer)
+ */
+
+/* Table of Contents
+ *  --- CMAC internal ---
+ *  --- Public CMAC ---
+ */
+
+#include "aes_cmac.h"
+#include "aes_modes.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memset */
+
+/* --- CMAC internal ---
+ * CMAC(M) = CBC-MAC of M with the last block xored with K1 (whole) or padded with 10* & xored with K2 (partial or empty).
+ * The chain covers every block but the last, the second call's streams start from the chain value (iv) & take the
+ * adjusted last block as their one block: both calls keep every lane of a group busy.
+ * A group of short messages under one key skips the lanes: block j of every message goes through one batched
+ * *_encrypt_blocks call (pipelined 8 wide, 16+ on VAES), so a step costs about one block per message.
+ */
+#define AES_CMAC_GROUP 64 /* messages per pair of multi-buffer calls */
+#define AES_CMAC_SHORT 128 /* longest message of a one key group that steps through the batched transform */
+#define AES_CMAC_TAG_MIN 8
+
+/* Chain length: all blocks but the last (an empty message is one padded block) */
+static inline size_t aes_cmac_chain(size_t len) { return len ? (len - 1) & ~(size_t) 15 : 0; }
+
+/* Constant-time compare of n bytes */
+static inline bool aes_cmac_equal(const uint8_t* a, const uint8_t* b, size_t n) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < n; i++) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+/* Generates CMAC for one key size
+ * group: tags t of n messages (up to AES_CMAC_GROUP), ctxs[i] keys msgs[i]. Short messages under one key step their
+ * chains together instead: step j encrypts block j of every message still running in one batched transform call
+ * (lanes of the multi-buffer engine pay a setup per step, which 1 - 4 block messages can't amortize) */
+#define AES_CMAC_FN(bits)                                                                                         \
+    static void aes##bits##_cmac_steps(const aes##bits##_cmac_ctx_t* ctx, const aes_cmac_msg_t* msgs, size_t n, uint8_t (*t)[16]) { \
+        uint8_t x[AES_CMAC_GROUP][16];                                                                            \
+        size_t idx[AES_CMAC_GROUP], m = n;                                                                        \
+        memset(t, 0, n * 16);                                                                                     \
+        for (size_t i = 0; i < n; i++) idx[i] = i;                                                                \
+        for (size_t o = 0; m; o += 16) {                                                                          \
+            size_t k = 0;                                                                                         \
+            for (size_t j = 0; j < m; j++) {                                                                      \
+                const size_t i = idx[j];                                                                          \
+                if (o < aes_cmac_chain(msgs[i].len)) xor_bytes(x[j], t[i], msgs[i].msg + o, 16);                  \
+                else { aes_cmac_last(x[j], msgs[i].msg + o, msgs[i].len - o, ctx->k1, ctx->k2); xor_bytes(x[j], x[j], t[i], 16); } \
+            }                                                                                                     \
+            aes##bits##_encrypt_blocks(&ctx->schedule, (const uint8_t (*)[16]) x, x, m);                          \
+            for (size_t j = 0; j < m; j++) {                                                                      \
+                memcpy(t[idx[j]], x[j], 16);                                                                      \
+                if (o < aes_cmac_chain(msgs[idx[j]].len)) idx[k++] = idx[j]; /* still running */                 \
+            }                                                                                                     \
+            m = k;                                                                                                \
+        }                                                                                                         \
+    }                                                                                                             \
+    static void aes##bits##_cmac_group(const aes##bits##_cmac_ctx_t* const* ctxs, const aes_cmac_msg_t* msgs, size_t n, uint8_t (*t)[16]) { \
+        aes_mb_stream_t streams[AES_CMAC_GROUP];                                                                  \
+        const aes##bits##_sched_enc_t* schedules[AES_CMAC_GROUP];                                                 \
+        uint8_t x[AES_CMAC_GROUP][16];                                                                            \
+        bool steps = true;                                                                                        \
+        for (size_t i = 0; i < n; i++) steps &= ctxs[i] == ctxs[0] && msgs[i].len <= AES_CMAC_SHORT;              \
+        if (steps) { aes##bits##_cmac_steps(ctxs[0], msgs, n, t); return; }                                      \
+        for (size_t i = 0; i < AES_CMAC_GROUP; i++) schedules[i] = &ctxs[i < n ? i : 0]->schedule;                \
+        for (size_t i = 0; i < n; i++) streams[i] = (aes_mb_stream_t) { msgs[i].msg, NULL, aes_cmac_chain(msgs[i].len), { 0 } }; \
+        aes##bits##_cbc_mac_mb(schedules, streams, n);                                                            \
+        for (size_t i = 0; i < n; i++) {                                                                          \
+            aes_cmac_last(x[i], msgs[i].msg + streams[i].len, msgs[i].len - streams[i].len, ctxs[i]->k1, ctxs[i]->k2); \
+            streams[i].in = x[i]; streams[i].len = 16;                                                            \
+        }                                                                                                         \
+        aes##bits##_cbc_mac_mb(schedules, streams, n);                                                            \
+        for (size_t i = 0; i < n; i++) memcpy(t[i], streams[i].iv, 16);                                           \
+    }
+AES_CMAC_FN(128)
+AES_CMAC_FN(192)
+AES_CMAC_FN(256)
+#undef AES_CMAC_FN
+
+/* --- Public CMAC --- (init: schedule, L = E(0^128), K1 = dbl(L), K2 = dbl(K1)) */
+#define AES_CMAC_PUBLIC_FNS(bits)                                                                                 \
+    void aes##bits##_cmac_init(aes##bits##_cmac_ctx_t* ctx, const aes##bits##_key_t* key) {                       \
+        aes##bits##_load_key_enc(key, &ctx->schedule);                                                            \
+        memset(ctx->k1, 0, 16);                                                                                   \
+        aes##bits##_encrypt_block(&ctx->schedule, ctx->k1, ctx->k1);                                              \
+        gf128_dbl(ctx->k1, ctx->k1);                                                                              \
+        gf128_dbl(ctx->k2, ctx->k1);                                                                              \
+    }                                                                                                             \
+    void aes##bits##_cmac(const aes##bits##_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, uint8_t tag[16]) {   \
+        uint8_t y[16] = { 0 }, x[16];                                                                             \
+        const size_t chain = aes_cmac_chain(len);                                                                 \
+        for (size_t i = 0; i < chain; i += 16) { /* serial anyway: no lane setup */                              \
+            xor_bytes(y, y, msg + i, 16);                                                                         \
+            aes##bits##_encrypt_block(&ctx->schedule, y, y);                                                      \
+        }                                                                                                         \
+        aes_cmac_last(x, msg + chain, len - chain, ctx->k1, ctx->k2);                                             \
+        xor_bytes(y, y, x, 16);                                                                                   \
+        aes##bits##_encrypt_block(&ctx->schedule, y, tag);                                                        \
+    }                                                                                                             \
+    bool aes##bits##_cmac_verify(const aes##bits##_cmac_ctx_t* ctx, const uint8_t* msg, size_t len, const uint8_t* tag, size_t tag_len) { \
+        uint8_t t[16];                                                                                            \
+        if (tag_len < AES_CMAC_TAG_MIN || tag_len > 16) return false;                                             \
+        aes##bits##_cmac(ctx, msg, len, t);                                                                       \
+        return aes_cmac_equal(t, tag, tag_len);                                                                   \
+    }                                                                                                             \
+    void aes##bits##_cmac_mb(const aes##bits##_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs) {  \
+        uint8_t t[AES_CMAC_GROUP][16];                                                                            \
+        for (size_t g = 0; g < num_msgs; g += AES_CMAC_GROUP) {                                                   \
+            const size_t n = num_msgs - g < AES_CMAC_GROUP ? num_msgs - g : AES_CMAC_GROUP;                       \
+            aes##bits##_cmac_group(ctxs + g, msgs + g, n, t);                                                     \
+            for (size_t i = 0; i < n; i++) memcpy(msgs[g + i].tag, t[i], 16);                                     \
+        }                                                                                                         \
+    }                                                                                                             \
+    bool aes##bits##_cmac_verify_mb(const aes##bits##_cmac_ctx_t* const* ctxs, aes_cmac_msg_t* msgs, size_t num_msgs, size_t tag_len) { \
+        uint8_t t[AES_CMAC_GROUP][16];                                                                            \
+        bool all = true;                                                                                          \
+        if (tag_len < AES_CMAC_TAG_MIN || tag_len > 16) {                                                         \
+            for (size_t i = 0; i < num_msgs; i++) msgs[i].valid = false;                                          \
+            return false;                                                                                         \
+        }                                                                                                         \
+        for (size_t g = 0; g < num_msgs; g += AES_CMAC_GROUP) {                                                   \
+            const size_t n = num_msgs - g < AES_CMAC_GROUP ? num_msgs - g : AES_CMAC_GROUP;                       \
+            aes##bits##_cmac_group(ctxs + g, msgs + g, n, t);                                                     \
+            for (size_t i = 0; i < n; i++) all &= msgs[g + i].valid = aes_cmac_equal(t[i], msgs[g + i].tag, tag_len); \
+        }                                                                                                         \
+        return all;                                                                                               \
+    }
+AES_CMAC_PUBLIC_FNS(128)
+AES_CMAC_PUBLIC_FNS(192)
+AES_CMAC_PUBLIC_FNS(256)
+#undef AES_CMAC_PUBLIC_FNS
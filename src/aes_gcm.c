@@ -0,0 +1,972 @@
+/* AES-GCM for 128, 192 & 256 bits keys (NIST SP 800-38D)
+ * AES-NI + PCLMULQDQ: 8 counter blocks in flight stitched with GHASH of 8 blocks (one reduction per 8 blocks),
+ * VAES + VPCLMULQDQ (AVX-512): 16 blocks in flight stitched with GHASH of 16 blocks (4 lanes per zmm, one reduction),
+ * other CPUs run CTR through aes_modes.h & GHASH in constant-time pure c.
+ * AES-GCM-SIV (RFC 8452) shares the GHASH code as POLYVAL (8 or 16 blocks per reduction) with its own CTR kernels.
+ * GMAC & the raw GHASH / POLYVAL streams run the same aggregated updates on whole blocks of each update.
+ * Features:
+ *  - GCM seal / open
+ *  - GCM-SIV seal / open (128 & 256 bits keys)
+ *  - GMAC (one shot & streams), GHASH / POLYVAL streams
+ */
+
+/* Table of Contents
+ *  --- GHASH internal ---
+ *  --- GCM internal ---
+ *  --- GCM-SIV internal ---
+ *  --- Hash streams internal ---
+ *  --- Backend dispatch --- (one tier per process, picked once)
+ *  --- Public GCM ---
+ *  --- Public GCM-SIV ---
+ *  --- Public GMAC & hash streams ---
+ */
+
+#include "aes_gcm.h"
+#include "aes_modes.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memset */
+
+/* --- GHASH internal ---
+ * Runs in the POLYVAL domain (RFC 8452 appendix A): blocks are byte reversed & the hash key is H * x,
+ * so products need no bit reflection shift: dot(a, b) = a * b * x^-128 mod x^128 + x^127 + x^126 + x^121 + 1.
+ * State (y) & table entries are field elements as 16 bytes little-endian (low qword first).
+ * Table: [0-15] H^16 ... H^1 (dot powers of H * x, descending so 4 consecutive entries fill a zmm for blocks j ... j + 3),
+ *        [16-31] each power's qword halves xored (Karatsuba middle term, both qwords).
+ * n blocks aggregate as y' = (y ^ x0) H^n ^ x1 H^n-1 ^ ... ^ xn-1 H^1: the 256 bit products sum up, then one reduction.
+ */
+#define GHASH_POLY_HI 0xC200000000000000ULL /* x^127 + x^126 + x^121 (high qword), x^0 sits in the low qword */
+#define GHASH_POWERS 16
+#define GHASH_H(p) (GHASH_POWERS - (p)) /* table entry of H^p */
+#define GHASH_TABLE_BYTES (2 * GHASH_POWERS * 16) /* the powers, then their Karatsuba halves */
+_Static_assert(sizeof(((aes128_gcm_ctx_t*) 0)->htable) == GHASH_TABLE_BYTES, "GCM context tables hold GHASH_POWERS powers");
+_Static_assert(sizeof(((aes_ghash_ctx_t*) 0)->htable) == GHASH_TABLE_BYTES, "GHASH context tables hold GHASH_POWERS powers");
+
+/* Pure c: carry-less multiply from integer multiplies on every 4th bit (the holes absorb the carries, constant-time) */
+static inline uint64_t bmul64(uint64_t x, uint64_t y) {
+    const uint64_t m0 = 0x1111111111111111ULL, m1 = m0 << 1, m2 = m0 << 2, m3 = m0 << 3;
+    const uint64_t x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+    const uint64_t y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+    const uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    const uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    const uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    const uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+static inline uint64_t rev64(uint64_t x) {
+    x = ((x & 0x5555555555555555ULL) << 1) | ((x >> 1) & 0x5555555555555555ULL);
+    x = ((x & 0x3333333333333333ULL) << 2) | ((x >> 2) & 0x3333333333333333ULL);
+    x = ((x & 0x0F0F0F0F0F0F0F0FULL) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+    return BSWAP64(x);
+}
+/* 64x64 -> 128 bit carry-less product (high half from the bit reversed operands) */
+static inline void clmul64(uint64_t x, uint64_t y, uint64_t* lo, uint64_t* hi) {
+    *lo = bmul64(x, y);
+    *hi = rev64(bmul64(rev64(x), rev64(y))) >> 1;
+}
+/* r = dot(a, b) (Karatsuba product, then two folds of the low qword by x^63 + x^62 + x^57) */
+static void polyval_dot_c(uint64_t r[2], const uint64_t a[2], const uint64_t b[2]) {
+    uint64_t p0, p1, p2, p3, m0, m1;
+    clmul64(a[0], b[0], &p0, &p1);
+    clmul64(a[1], b[1], &p2, &p3);
+    clmul64(a[0] ^ a[1], b[0] ^ b[1], &m0, &m1);
+    m0 ^= p0 ^ p2; m1 ^= p1 ^ p3;
+    p1 ^= m0; p2 ^= m1;
+    for (int i = 0; i < 2; i++) { /* (p0, p1) = (p1, p0) ^ p0 * x^-64 folded back */
+        const uint64_t t0 = (p0 << 63) ^ (p0 << 62) ^ (p0 << 57), t1 = (p0 >> 1) ^ (p0 >> 2) ^ (p0 >> 7);
+        const uint64_t n0 = p1 ^ t0, n1 = p0 ^ t1;
+        p0 = n0; p1 = n1;
+    }
+    r[0] = p2 ^ p0; r[1] = p3 ^ p1;
+}
+/* Byte reversed GHASH block -> field element */
+static inline void polyval_load_block(uint64_t v[2], const uint8_t b[16]) { v[0] = load_be64(b + 8); v[1] = load_be64(b); }
+
+/* Table entries of the first n dot powers of h */
+static void polyval_htable_c(uint8_t* ht, const uint64_t h[2], int n) {
+    uint64_t p[2] = { h[0], h[1] };
+    for (int i = 1; i <= n; i++) {
+        if (i > 1) polyval_dot_c(p, p, h);
+        const uint64_t kara[2] = { p[0] ^ p[1], p[0] ^ p[1] };
+        memcpy(ht + 16 * GHASH_H(i), p, 16);
+        memcpy(ht + 16 * (GHASH_POWERS + GHASH_H(i)), kara, 16);
+    }
+}
+/* y absorbs len bytes (last block zero padded), ghash: blocks byte reversed, else POLYVAL blocks as they are */
+static void polyval_update_c(const uint8_t* ht, uint8_t y_bytes[16], const uint8_t* in, size_t len, bool ghash) {
+    uint64_t y[2], h[2], x[2];
+    memcpy(y, y_bytes, 16);
+    memcpy(h, ht + 16 * GHASH_H(1), 16);
+    for (; len; ) {
+        uint8_t t[16] = { 0 };
+        const size_t used = len < 16 ? len : 16;
+        memcpy(t, in, used);
+        if (ghash) polyval_load_block(x, t);
+        else memcpy(x, t, 16);
+        y[0] ^= x[0]; y[1] ^= x[1];
+        polyval_dot_c(y, y, h);
+        in += used; len -= used;
+    }
+    memcpy(y_bytes, y, 16);
+}
+
+static void aes_gcm_htable_generic(uint8_t* ht, const uint8_t h[16]) {
+    uint64_t hx[2];
+    polyval_load_block(hx, h);
+    const uint64_t carry = hx[1] >> 63; /* H * x */
+    hx[1] = (hx[1] << 1) | (hx[0] >> 63);
+    hx[0] = (hx[0] << 1) ^ (carry & 1);
+    hx[1] ^= (0 - carry) & GHASH_POLY_HI;
+    polyval_htable_c(ht, hx, GHASH_POWERS);
+}
+static void aes_gcm_ghash_generic(const uint8_t* ht, uint8_t y[16], const uint8_t* in, size_t len) { polyval_update_c(ht, y, in, len, true); }
+
+/* AES-NI: 128x128 bit carry-less product of x & table entry i accumulated into lo, mid (Karatsuba, unfolded) & hi */
+#define GHASH_MUL_ACC_AMD64(x, ht, i, lo, mid, hi) {                                                         \
+    const __m128i _h = _mm_loadu_si128((const __m128i*) (ht) + (i));                                         \
+    lo  = _mm_xor_si128(lo, _mm_clmulepi64_si128(x, _h, 0x00));                                              \
+    hi  = _mm_xor_si128(hi, _mm_clmulepi64_si128(x, _h, 0x11));                                              \
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(_mm_xor_si128(x, _mm_shuffle_epi32(x, 0x4E)),              \
+                                                  _mm_loadu_si128((const __m128i*) (ht) + GHASH_POWERS + (i)), 0x00)); \
+}
+/* y = reduction of the accumulated 256 bit sum (mid folded into lo & hi, then two folds of lo's low qword) */
+#define GHASH_REDUCE_AMD64(y, lo, mid, hi) {                                                                 \
+    const __m128i _poly = _mm_set_epi64x((long long) GHASH_POLY_HI, 1);                                      \
+    mid = _mm_xor_si128(mid, _mm_xor_si128(lo, hi));                                                         \
+    lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));                                                         \
+    hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));                                                         \
+    lo  = _mm_xor_si128(_mm_shuffle_epi32(lo, 0x4E), _mm_clmulepi64_si128(lo, _poly, 0x10));                 \
+    lo  = _mm_xor_si128(_mm_shuffle_epi32(lo, 0x4E), _mm_clmulepi64_si128(lo, _poly, 0x10));                 \
+    y   = _mm_xor_si128(hi, lo);                                                                             \
+}
+/* Block loaders: GHASH blocks are byte reversed, POLYVAL blocks are field elements already (expects bswap in scope) */
+#define GHASH_LOAD_AMD64(p) _mm_shuffle_epi8(_mm_loadu_si128(p), bswap)
+#define POLYVAL_LOAD_AMD64(p) _mm_loadu_si128(p)
+/* Block j of the n blocks at gx (block 0 takes in the running state y) times H^(n-j)
+ * Expects y, ht & the accumulators lo, mid, hi in scope */
+#define GHASH_ACC_BLOCK_AMD64(load, gx, j, n) {                                                              \
+    __m128i _x = load((const __m128i*) (gx) + (j));                                                          \
+    if ((j) == 0) _x = _mm_xor_si128(_x, y);                                                                 \
+    GHASH_MUL_ACC_AMD64(_x, ht, GHASH_H((n) - (j)), lo, mid, hi)                                             \
+}
+
+/* Table entries of the first n dot powers of p */
+TARGET("pclmul,ssse3") static void polyval_htable_aesni(uint8_t* ht, __m128i p, int n) {
+    __m128i lo, mid, hi;
+    for (int i = 1; i <= n; i++) {
+        if (i > 1) { /* p = dot(p, H^1), H^1 stored by the first pass */
+            lo = mid = hi = _mm_setzero_si128();
+            GHASH_MUL_ACC_AMD64(p, ht, GHASH_H(1), lo, mid, hi)
+            GHASH_REDUCE_AMD64(p, lo, mid, hi)
+        }
+        _mm_storeu_si128((__m128i*) ht + GHASH_H(i), p);
+        _mm_storeu_si128((__m128i*) ht + GHASH_POWERS + GHASH_H(i), _mm_xor_si128(p, _mm_shuffle_epi32(p, 0x4E)));
+    }
+}
+TARGET("pclmul,ssse3") static void aes_gcm_htable_aesni(uint8_t* ht, const uint8_t h[16]) {
+    const __m128i poly = _mm_set_epi64x((long long) GHASH_POLY_HI, 1);
+    __m128i hx = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) h), BSWAP128_MASK);
+    const __m128i carry = _mm_srai_epi32(_mm_shuffle_epi32(hx, 0xFF), 31); /* H * x */
+    hx = _mm_or_si128(_mm_slli_epi64(hx, 1), _mm_slli_si128(_mm_srli_epi64(hx, 63), 8));
+    hx = _mm_xor_si128(hx, _mm_and_si128(carry, poly));
+    polyval_htable_aesni(ht, hx, GHASH_POWERS);
+}
+/* Generates an AES-NI update: full 8 block groups aggregated, the rest (up to 8 blocks, last one zero padded) aggregated
+ * into one more reduction */
+#define POLYVAL_UPDATE_AESNI_FN(name, load)                                                                       \
+    TARGET("pclmul,ssse3") static inline __m128i name(const uint8_t* ht, __m128i y, const uint8_t* in, size_t len) { \
+        const __m128i bswap = BSWAP128_MASK;                                                                      \
+        __m128i lo, mid, hi;                                                                                      \
+        (void) bswap;                                                                                             \
+        for (; len >= 128; len -= 128, in += 128) {                                                               \
+            lo = mid = hi = _mm_setzero_si128();                                                                  \
+            GHASH_ACC_BLOCK_AMD64(load, in, 1, 8) GHASH_ACC_BLOCK_AMD64(load, in, 2, 8)                           \
+            GHASH_ACC_BLOCK_AMD64(load, in, 3, 8) GHASH_ACC_BLOCK_AMD64(load, in, 4, 8)                           \
+            GHASH_ACC_BLOCK_AMD64(load, in, 5, 8) GHASH_ACC_BLOCK_AMD64(load, in, 6, 8)                           \
+            GHASH_ACC_BLOCK_AMD64(load, in, 7, 8) GHASH_ACC_BLOCK_AMD64(load, in, 0, 8) /* y last */              \
+            GHASH_REDUCE_AMD64(y, lo, mid, hi)                                                                    \
+        }                                                                                                         \
+        if (len) {                                                                                                \
+            uint8_t t[128];                                                                                       \
+            const uint8_t* src = in; /* whole blocks load in place, a partial one from a zero padded copy */      \
+            const size_t n = (len + 15) >> 4;                                                                     \
+            if (len & 15) { memset(t, 0, 128); memcpy(t, in, len); src = t; }                                     \
+            lo = mid = hi = _mm_setzero_si128();                                                                  \
+            for (size_t j = n; j--; ) GHASH_ACC_BLOCK_AMD64(load, src, j, n)                                      \
+            GHASH_REDUCE_AMD64(y, lo, mid, hi)                                                                    \
+        }                                                                                                         \
+        return y;                                                                                                 \
+    }
+POLYVAL_UPDATE_AESNI_FN(aes_ghash_update_aesni, GHASH_LOAD_AMD64)
+POLYVAL_UPDATE_AESNI_FN(aes_polyval_update_aesni, POLYVAL_LOAD_AMD64)
+#undef POLYVAL_UPDATE_AESNI_FN
+TARGET("pclmul,ssse3") static void aes_gcm_ghash_aesni(const uint8_t* ht, uint8_t y[16], const uint8_t* in, size_t len) {
+    _mm_storeu_si128((__m128i*) y, aes_ghash_update_aesni(ht, _mm_loadu_si128((const __m128i*) y), in, len));
+}
+
+/* VPCLMULQDQ (AVX-512F): 16 blocks per reduction as 4 zmm, each lane multiplied by its own power (4 lane accumulation)
+ * zmm j of the 16 blocks at gx (block 0 takes in y) times H^16-4j ... H^13-4j, accumulated per lane into lo4, mid4 & hi4 */
+#define GHASH_LOAD_VAES512(p) AES_BSWAP128_VAES512(_mm512_loadu_si512(p))
+#define POLYVAL_LOAD_VAES512(p) _mm512_loadu_si512(p)
+#define GHASH_ACC_X4_VAES512(load, gx, j) {                                                                  \
+    __m512i _x = load((const __m512i*) (gx) + (j));                                                          \
+    if ((j) == 0) _x = _mm512_xor_si512(_x, _mm512_inserti32x4(_mm512_setzero_si512(), y, 0));               \
+    const __m512i _h = _mm512_loadu_si512((const __m512i*) (ht) + (j));                                      \
+    lo4  = _mm512_xor_si512(lo4, _mm512_clmulepi64_epi128(_x, _h, 0x00));                                    \
+    hi4  = _mm512_xor_si512(hi4, _mm512_clmulepi64_epi128(_x, _h, 0x11));                                    \
+    mid4 = _mm512_xor_si512(mid4, _mm512_clmulepi64_epi128(_mm512_xor_si512(_x, _mm512_shuffle_epi32(_x, _MM_PERM_BADC)), \
+                                                           _mm512_loadu_si512((const __m512i*) (ht) + 4 + (j)), 0x00)); \
+}
+/* Lanes xored down to one 256 bit sum (the reduction is linear), then the 128-bit reduction into y */
+#define GHASH_XOR_LANES_VAES512(v) _mm_xor_si128(_mm_xor_si128(_mm512_castsi512_si128(v), _mm512_extracti32x4_epi32(v, 1)), \
+                                                 _mm_xor_si128(_mm512_extracti32x4_epi32(v, 2), _mm512_extracti32x4_epi32(v, 3)))
+#define GHASH_REDUCE_X4_VAES512(y) {                                                                         \
+    __m128i _lo = GHASH_XOR_LANES_VAES512(lo4), _mid = GHASH_XOR_LANES_VAES512(mid4), _hi = GHASH_XOR_LANES_VAES512(hi4); \
+    GHASH_REDUCE_AMD64(y, _lo, _mid, _hi)                                                                    \
+}
+
+/* Generates a VPCLMULQDQ update: full 16 block groups on zmm, the rest through the matching AES-NI update */
+#define POLYVAL_UPDATE_VAES512_FN(name, load, rest)                                                               \
+    TARGET("avx512f,vpclmulqdq,pclmul,ssse3") static inline __m128i name(const uint8_t* ht, __m128i y, const uint8_t* in, size_t len) { \
+        __m512i lo4, mid4, hi4;                                                                                   \
+        for (; len >= 256; len -= 256, in += 256) {                                                               \
+            lo4 = mid4 = hi4 = _mm512_setzero_si512();                                                            \
+            GHASH_ACC_X4_VAES512(load, in, 1) GHASH_ACC_X4_VAES512(load, in, 2)                                   \
+            GHASH_ACC_X4_VAES512(load, in, 3) GHASH_ACC_X4_VAES512(load, in, 0) /* y last */                      \
+            GHASH_REDUCE_X4_VAES512(y)                                                                            \
+        }                                                                                                         \
+        return len ? rest(ht, y, in, len) : y;                                                                    \
+    }
+POLYVAL_UPDATE_VAES512_FN(aes_ghash_update_vaes512, GHASH_LOAD_VAES512, aes_ghash_update_aesni)
+POLYVAL_UPDATE_VAES512_FN(aes_polyval_update_vaes512, POLYVAL_LOAD_VAES512, aes_polyval_update_aesni)
+#undef POLYVAL_UPDATE_VAES512_FN
+TARGET("avx512f,vpclmulqdq,pclmul,ssse3") static void aes_gcm_ghash_vaes512(const uint8_t* ht, uint8_t y[16], const uint8_t* in, size_t len) {
+    _mm_storeu_si128((__m128i*) y, aes_ghash_update_vaes512(ht, _mm_loadu_si128((const __m128i*) y), in, len));
+}
+static void aes_gcm_htable_vaes512(uint8_t* ht, const uint8_t h[16]) { aes_gcm_htable_aesni(ht, h); }
+
+/* --- GCM internal ---
+ * Counter blocks use 32 bit increments (inc32), counters are kept byte reversed (low word in the low lane).
+ * Stitched loop: every AES round also runs one step of GHASH over 8 other blocks (the previous 8 ciphertext blocks
+ * when sealing, the current 8 when opening), so aesenc & pclmulqdq work interleave instead of running as two passes.
+ */
+/* Stitched round applier: AES round on m0-m7, then the GHASH step tied to the round key (AES_GCM_GHASH_STEP_<key>)
+ * Rounds 1-8 multiply-accumulate one of the 8 hashed blocks, round 9 reduces (every key size has rounds 1-9).
+ * Block 0 (the one taking in y from the previous reduction) goes last to keep the loop carried chain short. */
+#define AES_X8_GHASH_AMD64(op, m, rk) AES_X8_AMD64(op, m, rk) AES_GCM_GHASH_STEP_##rk
+#define AES_GCM_GHASH_STEP_k0
+#define AES_GCM_GHASH_STEP_k1  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 1, 8)
+#define AES_GCM_GHASH_STEP_k2  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 2, 8)
+#define AES_GCM_GHASH_STEP_k3  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 3, 8)
+#define AES_GCM_GHASH_STEP_k4  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 4, 8)
+#define AES_GCM_GHASH_STEP_k5  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 5, 8)
+#define AES_GCM_GHASH_STEP_k6  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 6, 8)
+#define AES_GCM_GHASH_STEP_k7  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 7, 8)
+#define AES_GCM_GHASH_STEP_k8  GHASH_ACC_BLOCK_AMD64(GHASH_LOAD_AMD64, gx, 0, 8)
+#define AES_GCM_GHASH_STEP_k9  GHASH_REDUCE_AMD64(y, lo, mid, hi)
+#define AES_GCM_GHASH_STEP_k10
+#define AES_GCM_GHASH_STEP_k11
+#define AES_GCM_GHASH_STEP_k12
+#define AES_GCM_GHASH_STEP_k13
+#define AES_GCM_GHASH_STEP_k14
+
+/* Counter block i after byte reversed base c */
+#define AES_GCM_CTR_BLOCK_AMD64(c, i) _mm_shuffle_epi8(_mm_add_epi32(c, _mm_set_epi32(0, 0, 0, i)), bswap)
+#define AES_GCM_CTR_BLOCKS_X8(m, c)                                                                          \
+    m##0 = AES_GCM_CTR_BLOCK_AMD64(c, 0); m##1 = AES_GCM_CTR_BLOCK_AMD64(c, 1);                              \
+    m##2 = AES_GCM_CTR_BLOCK_AMD64(c, 2); m##3 = AES_GCM_CTR_BLOCK_AMD64(c, 3);                              \
+    m##4 = AES_GCM_CTR_BLOCK_AMD64(c, 4); m##5 = AES_GCM_CTR_BLOCK_AMD64(c, 5);                              \
+    m##6 = AES_GCM_CTR_BLOCK_AMD64(c, 6); m##7 = AES_GCM_CTR_BLOCK_AMD64(c, 7);                              \
+    c = _mm_add_epi32(c, _mm_set_epi32(0, 0, 0, 8));
+
+/* Generates the AES-NI GCM payload kernel: out = in ^ keystream from counter, y absorbs the ciphertext (enc: out, else in)
+ * Sealing hashes each 8 block group during the next group's rounds (first group plain CTR, last group hashed after the loop),
+ * opening hashes each group during its own rounds (loads happen before the stores: in-place safe).
+ * The tail (< 8 blocks) is one keystream pass & an aggregated GHASH. */
+#define AES_GCM_AESNI_FN(bits)                                                                                    \
+    TARGET("aes,ssse3,pclmul") static void aes##bits##_gcm_ctr_aesni(const uint8_t* s, const uint8_t* ht, uint8_t counter[16], uint8_t y_bytes[16], const uint8_t* in, uint8_t* out, size_t len, bool enc) { \
+        AES##bits##_ENC_KEYS(get_key, k, s)                                                                       \
+        const __m128i bswap = BSWAP128_MASK;                                                                      \
+        __m128i c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) counter), bswap);                           \
+        __m128i y = _mm_loadu_si128((const __m128i*) y_bytes);                                                    \
+        __m128i m0, m1, m2, m3, m4, m5, m6, m7, lo, mid, hi;                                                      \
+        const uint8_t* gx = NULL; /* 8 ciphertext blocks the next stitched pass hashes */                         \
+        if (enc && len >= 128) {                                                                                  \
+            AES_GCM_CTR_BLOCKS_X8(m, c)                                                                           \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X8_AMD64, m, k)                                                       \
+            AES_CTR_XOR_X8(__m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_xor_si128, m, in, out)              \
+            gx = out; len -= 128; in += 128; out += 128;                                                          \
+        }                                                                                                         \
+        for (; len >= 128; len -= 128, in += 128, out += 128) {                                                   \
+            if (!enc) gx = in;                                                                                    \
+            lo = mid = hi = _mm_setzero_si128();                                                                  \
+            AES_GCM_CTR_BLOCKS_X8(m, c)                                                                           \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X8_GHASH_AMD64, m, k)                                                 \
+            AES_CTR_XOR_X8(__m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_xor_si128, m, in, out)              \
+            if (enc) gx = out;                                                                                    \
+        }                                                                                                         \
+        if (enc && gx) y = aes_ghash_update_aesni(ht, y, gx, 128);                                                \
+        if (len) {                                                                                                \
+            __m128i ks[8];                                                                                        \
+            if (!enc) y = aes_ghash_update_aesni(ht, y, in, len);                                                 \
+            if (len > 16) {                                                                                       \
+                AES_GCM_CTR_BLOCKS_X8(m, c)                                                                       \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X8_AMD64, m, k)                                                   \
+                ks[0] = m0; ks[1] = m1; ks[2] = m2; ks[3] = m3; ks[4] = m4; ks[5] = m5; ks[6] = m6; ks[7] = m7;   \
+                c = _mm_sub_epi32(c, _mm_set_epi32(0, 0, 0, (int) (8 - ((len + 15) >> 4))));                     \
+            } else {                                                                                              \
+                m0 = AES_GCM_CTR_BLOCK_AMD64(c, 0);                                                               \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X1_AMD64, m0, k)                                                  \
+                ks[0] = m0;                                                                                       \
+                c = _mm_add_epi32(c, _mm_set_epi32(0, 0, 0, 1));                                                  \
+            }                                                                                                     \
+            xor_bytes(out, in, (const uint8_t*) ks, len);                                                         \
+            if (enc) y = aes_ghash_update_aesni(ht, y, out, len);                                                 \
+        }                                                                                                         \
+        _mm_storeu_si128((__m128i*) counter, _mm_shuffle_epi8(c, bswap));                                         \
+        _mm_storeu_si128((__m128i*) y_bytes, y);                                                                  \
+    }
+AES_GCM_AESNI_FN(128)
+AES_GCM_AESNI_FN(192)
+AES_GCM_AESNI_FN(256)
+#undef AES_GCM_AESNI_FN
+
+/* VAES512 stitched round applier: AES round on 4 zmm (16 blocks), GHASH of 16 other blocks on rounds 1-4, reduction on round 5 */
+#define AES_X4_GHASH_VAES512(op, m, rk) AES_X4_VAES512(op, m, rk) AES_GCM_GHASH16_STEP_##rk
+#define AES_GCM_GHASH16_STEP_k0
+#define AES_GCM_GHASH16_STEP_k1  GHASH_ACC_X4_VAES512(GHASH_LOAD_VAES512, gx, 1)
+#define AES_GCM_GHASH16_STEP_k2  GHASH_ACC_X4_VAES512(GHASH_LOAD_VAES512, gx, 2)
+#define AES_GCM_GHASH16_STEP_k3  GHASH_ACC_X4_VAES512(GHASH_LOAD_VAES512, gx, 3)
+#define AES_GCM_GHASH16_STEP_k4  GHASH_ACC_X4_VAES512(GHASH_LOAD_VAES512, gx, 0)
+#define AES_GCM_GHASH16_STEP_k5  GHASH_REDUCE_X4_VAES512(y)
+#define AES_GCM_GHASH16_STEP_k6
+#define AES_GCM_GHASH16_STEP_k7
+#define AES_GCM_GHASH16_STEP_k8
+#define AES_GCM_GHASH16_STEP_k9
+#define AES_GCM_GHASH16_STEP_k10
+#define AES_GCM_GHASH16_STEP_k11
+#define AES_GCM_GHASH16_STEP_k12
+#define AES_GCM_GHASH16_STEP_k13
+#define AES_GCM_GHASH16_STEP_k14
+
+/* 4 zmm of counter blocks (16 blocks) from the byte reversed per lane bases c4 (lane l holds block l), then c4 += 16 */
+#define AES_GCM_CTR_BLOCKS_X4_VAES512(m, c4)                                                                 \
+    m##0 = AES_BSWAP128_VAES512(c4);                             c4 = _mm512_add_epi32(c4, four);            \
+    m##1 = AES_BSWAP128_VAES512(c4);                             c4 = _mm512_add_epi32(c4, four);            \
+    m##2 = AES_BSWAP128_VAES512(c4);                             c4 = _mm512_add_epi32(c4, four);            \
+    m##3 = AES_BSWAP128_VAES512(c4);                             c4 = _mm512_add_epi32(c4, four);
+#define AES_GCM_XOR_X4_VAES512(m, in, out)                                                                   \
+    _mm512_storeu_si512((__m512i*) (out) + 0, _mm512_xor_si512(m##0, _mm512_loadu_si512((const __m512i*) (in) + 0))); \
+    _mm512_storeu_si512((__m512i*) (out) + 1, _mm512_xor_si512(m##1, _mm512_loadu_si512((const __m512i*) (in) + 1))); \
+    _mm512_storeu_si512((__m512i*) (out) + 2, _mm512_xor_si512(m##2, _mm512_loadu_si512((const __m512i*) (in) + 2))); \
+    _mm512_storeu_si512((__m512i*) (out) + 3, _mm512_xor_si512(m##3, _mm512_loadu_si512((const __m512i*) (in) + 3)));
+
+/* Generates the VAES512 GCM payload kernel: 16 blocks per pass, same seal / open hashing order as the AES-NI kernel,
+ * leftovers (< 16 blocks) go to the AES-NI kernel */
+#define AES_GCM_VAES512_FN(bits)                                                                                  \
+    TARGET("aes,vaes,avx512f,vpclmulqdq,pclmul,ssse3") static void aes##bits##_gcm_ctr_vaes512(const uint8_t* s, const uint8_t* ht, uint8_t counter[16], uint8_t y_bytes[16], const uint8_t* in, uint8_t* out, size_t len, bool enc) { \
+        if (len >= 256) {                                                                                         \
+            AES##bits##_ENC_KEYS(get_key_vaes512, k, s)                                                           \
+            const __m512i four = _mm512_broadcast_i32x4(_mm_set_epi32(0, 0, 0, 4));                              \
+            __m512i c4 = _mm512_broadcast_i32x4(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) counter), BSWAP128_MASK)); \
+            __m128i y = _mm_loadu_si128((const __m128i*) y_bytes);                                                \
+            __m512i m0, m1, m2, m3, lo4, mid4, hi4;                                                               \
+            const uint8_t* gx = NULL; /* 16 ciphertext blocks the next stitched pass hashes */                    \
+            c4 = _mm512_add_epi32(c4, _mm512_set_epi32(0, 0, 0, 3, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 0));          \
+            if (enc) {                                                                                            \
+                AES_GCM_CTR_BLOCKS_X4_VAES512(m, c4)                                                              \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X4_VAES512, m, k)                                                 \
+                AES_GCM_XOR_X4_VAES512(m, in, out)                                                                \
+                gx = out; len -= 256; in += 256; out += 256;                                                      \
+            }                                                                                                     \
+            for (; len >= 256; len -= 256, in += 256, out += 256) {                                               \
+                if (!enc) gx = in;                                                                                \
+                lo4 = mid4 = hi4 = _mm512_setzero_si512();                                                        \
+                AES_GCM_CTR_BLOCKS_X4_VAES512(m, c4)                                                              \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X4_GHASH_VAES512, m, k)                                           \
+                AES_GCM_XOR_X4_VAES512(m, in, out)                                                                \
+                if (enc) gx = out;                                                                                \
+            }                                                                                                     \
+            if (enc) y = aes_ghash_update_vaes512(ht, y, gx, 256);                                                \
+            _mm_storeu_si128((__m128i*) counter, _mm_shuffle_epi8(_mm512_castsi512_si128(c4), BSWAP128_MASK));    \
+            _mm_storeu_si128((__m128i*) y_bytes, y);                                                              \
+        }                                                                                                         \
+        if (len) aes##bits##_gcm_ctr_aesni(s, ht, counter, y_bytes, in, out, len, enc);                           \
+    }
+AES_GCM_VAES512_FN(128)
+AES_GCM_VAES512_FN(192)
+AES_GCM_VAES512_FN(256)
+#undef AES_GCM_VAES512_FN
+
+/* Generates the generic GCM payload kernel (CTR32 through aes_modes.h & pure c GHASH, in cache sized chunks) */
+#define AES_GCM_GENERIC_FN(bits)                                                                                  \
+    static void aes##bits##_gcm_ctr_generic(const uint8_t* s, const uint8_t* ht, uint8_t counter[16], uint8_t y[16], const uint8_t* in, uint8_t* out, size_t len, bool enc) { \
+        while (len) {                                                                                             \
+            const size_t used = len < 4096 ? len : 4096;                                                          \
+            if (!enc) aes_gcm_ghash_generic(ht, y, in, used);                                                     \
+            aes##bits##_ctr_xor((const aes##bits##_sched_enc_t*) s, counter, AES_CTR32, in, out, used);           \
+            if (enc) aes_gcm_ghash_generic(ht, y, out, used);                                                     \
+            len -= used; in += used; out += used;                                                                 \
+        }                                                                                                         \
+    }
+AES_GCM_GENERIC_FN(128)
+AES_GCM_GENERIC_FN(192)
+AES_GCM_GENERIC_FN(256)
+#undef AES_GCM_GENERIC_FN
+
+/* Low 32 bits of the big-endian counter block + 1 (mod 2^32) */
+static inline void aes_gcm_inc32(uint8_t counter[16]) {
+    const uint64_t lo = load_be64(counter + 8);
+    store_be64(counter + 8, (lo & 0xFFFFFFFF00000000ULL) | (uint32_t) (lo + 1));
+}
+
+/* Generates a tier's J0 (96 bit iv: iv || 0^31 || 1, else GHASH(iv zero padded || 0^64 || [bit length of iv]_64))
+ * SP 800-38D needs a non-empty iv: callers reject iv_len 0 before this */
+#define AES_GCM_J0_FN(T)                                                                                          \
+    static void aes_gcm_j0_##T(const uint8_t* ht, const uint8_t* iv, size_t iv_len, uint8_t j0[16]) {             \
+        if (iv_len == 12) {                                                                                       \
+            memcpy(j0, iv, 12);                                                                                   \
+            j0[12] = 0; j0[13] = 0; j0[14] = 0; j0[15] = 1;                                                       \
+            return;                                                                                               \
+        }                                                                                                         \
+        uint8_t y[16] = { 0 }, lens[16] = { 0 };                                                                  \
+        aes_gcm_ghash_##T(ht, y, iv, iv_len);                                                                     \
+        store_be64(lens + 8, (uint64_t) iv_len << 3);                                                             \
+        aes_gcm_ghash_##T(ht, y, lens, 16);                                                                       \
+        for (int i = 0; i < 16; i++) j0[i] = y[15 - i];                                                           \
+    }
+AES_GCM_J0_FN(vaes512)
+AES_GCM_J0_FN(aesni)
+AES_GCM_J0_FN(generic)
+#undef AES_GCM_J0_FN
+
+/* SP 800-38D limits: payload at most 2^39 - 256 bits, aad at most 2^64 - 1 bits (whole bytes here) */
+#define AES_GCM_MAX_LEN ((1ULL << 36) - 32)
+#define AES_GCM_MAX_AAD ((1ULL << 61) - 1)
+#define AES_GCM_TOO_LONG(aad_len, len) ((uint64_t) (aad_len) > AES_GCM_MAX_AAD || (uint64_t) (len) > AES_GCM_MAX_LEN)
+/* SP 800-38D tag lengths: 128, 120, 112, 104, 96 bits, or 64 & 32 bits for short-lived keys */
+#define AES_GCM_TAG_OK(tag_len) ((tag_len) == 4 || (tag_len) == 8 || ((tag_len) >= 12 && (tag_len) <= 16))
+
+/* Generates a tier's GCM for one key size
+ * init: schedule, H = E(K, 0^128) & its table; seal / open: J0, GHASH(aad), payload from inc32(J0),
+ * then tag = E(K, J0) ^ GHASH(... || [bit length of aad]_64 || [bit length of payload]_64);
+ * gmac start: a stream on the context's table with E(K, J0) kept for its tag (false on an empty iv) */
+#define AES_GCM_FN(bits, T)                                                                                       \
+    static void aes##bits##_gcm_init_##T(aes##bits##_gcm_ctx_t* ctx, const aes##bits##_key_t* key) {              \
+        uint8_t h[16] = { 0 };                                                                                    \
+        aes##bits##_load_key_enc(key, &ctx->schedule);                                                            \
+        aes##bits##_encrypt_block(&ctx->schedule, h, h);                                                          \
+        aes_gcm_htable_##T(ctx->htable, h);                                                                       \
+    }                                                                                                             \
+    static void aes##bits##_gcm_crypt_##T(const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                                          const uint8_t* in, uint8_t* out, size_t len, bool enc, uint8_t tag[16]) { \
+        uint8_t j0[16], counter[16], y[16] = { 0 }, lens[16];                                                     \
+        aes_gcm_j0_##T(ctx->htable, iv, iv_len, j0);                                                              \
+        aes_gcm_ghash_##T(ctx->htable, y, aad, aad_len);                                                          \
+        memcpy(counter, j0, 16);                                                                                  \
+        aes_gcm_inc32(counter);                                                                                   \
+        aes##bits##_gcm_ctr_##T(ctx->schedule.bytes, ctx->htable, counter, y, in, out, len, enc);                 \
+        store_be64(lens, (uint64_t) aad_len << 3); store_be64(lens + 8, (uint64_t) len << 3);                     \
+        aes_gcm_ghash_##T(ctx->htable, y, lens, 16);                                                              \
+        aes##bits##_encrypt_block(&ctx->schedule, j0, tag);                                                       \
+        for (int i = 0; i < 16; i++) tag[i] ^= y[15 - i];                                                         \
+    }                                                                                                             \
+    static bool aes##bits##_gcm_seal_##T(const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len) { \
+        uint8_t full[16];                                                                                         \
+        if (iv_len == 0 || !AES_GCM_TAG_OK(tag_len) || AES_GCM_TOO_LONG(aad_len, len)) return false;              \
+        aes##bits##_gcm_crypt_##T(ctx, iv, iv_len, aad, aad_len, plain, cipher, len, true, full);                 \
+        memcpy(tag, full, tag_len);                                                                               \
+        return true;                                                                                              \
+    }                                                                                                             \
+    static bool aes##bits##_gcm_open_##T(const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                                         const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len) { \
+        uint8_t full[16], diff = 0;                                                                               \
+        if (iv_len == 0 || !AES_GCM_TAG_OK(tag_len) || AES_GCM_TOO_LONG(aad_len, len)) return false;              \
+        aes##bits##_gcm_crypt_##T(ctx, iv, iv_len, aad, aad_len, cipher, plain, len, false, full);                \
+        for (size_t i = 0; i < tag_len; i++) diff |= full[i] ^ tag[i]; /* constant-time compare */                \
+        if (diff) { memset(plain, 0, len); return false; }                                                        \
+        return true;                                                                                              \
+    }                                                                                                             \
+    static bool aes##bits##_gmac_start_##T(const aes##bits##_gcm_ctx_t* ctx, aes_gmac_stream_t* stream, const uint8_t* iv, size_t iv_len) { \
+        uint8_t j0[16] = { 0 };                                                                                   \
+        if (iv_len) aes_gcm_j0_##T(ctx->htable, iv, iv_len, j0);                                                  \
+        aes##bits##_encrypt_block(&ctx->schedule, j0, stream->ek_j0);                                             \
+        stream->htable = ctx->htable;                                                                             \
+        memset(stream->y, 0, 16);                                                                                 \
+        stream->buf_len = 0;                                                                                      \
+        stream->aad_len = iv_len ? 0 : AES_GCM_MAX_AAD + 1; /* empty iv: updates stay harmless, final fails */    \
+        return iv_len != 0;                                                                                       \
+    }
+AES_GCM_FN(128, vaes512)
+AES_GCM_FN(192, vaes512)
+AES_GCM_FN(256, vaes512)
+AES_GCM_FN(128, aesni)
+AES_GCM_FN(192, aesni)
+AES_GCM_FN(256, aesni)
+AES_GCM_FN(128, generic)
+AES_GCM_FN(192, generic)
+AES_GCM_FN(256, generic)
+#undef AES_GCM_FN
+
+/* --- GCM-SIV internal ---
+ * Per nonce: E(K, [i]_32le || nonce) for i = 0 ... 3 (AES-256: 0 ... 5) in one batched call, the first 8 bytes of each
+ * make the message authentication key (i = 0, 1) & the message encryption key (the rest).
+ * S = POLYVAL(auth key, aad zero padded || payload zero padded || [bit length of aad]_64le || [bit length of payload]_64le),
+ * tag = E(enc key, (S ^ nonce) with bit 7 of byte 15 cleared), payload = CTR from the tag with that bit set
+ * (32 bit little-endian counter in bytes 0 - 3, no byte reversal anywhere).
+ * POLYVAL reuses the GHASH table & updates on unreversed blocks with dot powers of the auth key itself, only as many
+ * powers as the longest input needs (short messages skip most of the table).
+ */
+#define AES_GCM_SIV_MAX_LEN (1ULL << 36) /* aad & payload limit (RFC 8452) */
+
+static void aes_polyval_htable_generic(uint8_t* ht, const uint8_t h[16], int n) {
+    uint64_t v[2];
+    memcpy(v, h, 16);
+    polyval_htable_c(ht, v, 1); /* serial update: H^1 only */
+    (void) n;
+}
+static void aes_polyval_generic(const uint8_t* ht, uint8_t y[16], const uint8_t* in, size_t len) { polyval_update_c(ht, y, in, len, false); }
+TARGET("pclmul,ssse3") static void aes_polyval_htable_aesni(uint8_t* ht, const uint8_t h[16], int n) {
+    polyval_htable_aesni(ht, _mm_loadu_si128((const __m128i*) h), n < 8 ? n : 8);
+}
+TARGET("pclmul,ssse3") static void aes_polyval_aesni(const uint8_t* ht, uint8_t y[16], const uint8_t* in, size_t len) {
+    _mm_storeu_si128((__m128i*) y, aes_polyval_update_aesni(ht, _mm_loadu_si128((const __m128i*) y), in, len));
+}
+TARGET("pclmul,ssse3") static void aes_polyval_htable_vaes512(uint8_t* ht, const uint8_t h[16], int n) {
+    polyval_htable_aesni(ht, _mm_loadu_si128((const __m128i*) h), n < 16 ? n : 16);
+}
+TARGET("avx512f,vpclmulqdq,pclmul,ssse3") static void aes_polyval_vaes512(const uint8_t* ht, uint8_t y[16], const uint8_t* in, size_t len) {
+    _mm_storeu_si128((__m128i*) y, aes_polyval_update_vaes512(ht, _mm_loadu_si128((const __m128i*) y), in, len));
+}
+
+/* Counter block i after base c (little-endian low word in lane 0, as loaded) */
+#define AES_GCM_SIV_CTR_BLOCK_AMD64(c, i) _mm_add_epi32(c, _mm_set_epi32(0, 0, 0, i))
+#define AES_GCM_SIV_CTR_BLOCK_VAES512(c, i) _mm512_add_epi32(c, _mm512_set_epi32(0, 0, 0, i + 3, 0, 0, 0, i + 2, 0, 0, 0, i + 1, 0, 0, 0, i))
+
+/* Generates the AES-NI GCM-SIV CTR kernel: 8 counter blocks in flight, leftovers as one 8 block keystream pass (or a lone block) */
+#define AES_GCM_SIV_CTR_AESNI_FN(bits)                                                                            \
+    TARGET("aes") static void aes##bits##_gcm_siv_ctr_aesni(const uint8_t* s, const uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t len) { \
+        AES##bits##_ENC_KEYS(get_key, k, s)                                                                       \
+        __m128i c = _mm_loadu_si128((const __m128i*) counter);                                                    \
+        __m128i m0, m1, m2, m3, m4, m5, m6, m7;                                                                   \
+        for (; len >= 128; len -= 128, in += 128, out += 128) {                                                   \
+            AES_CTR_BLOCKS_X8(AES_GCM_SIV_CTR_BLOCK_AMD64, m, c, 1)                                               \
+            c = AES_GCM_SIV_CTR_BLOCK_AMD64(c, 8);                                                                \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X8_AMD64, m, k)                                                       \
+            AES_CTR_XOR_X8(__m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_xor_si128, m, in, out)              \
+        }                                                                                                         \
+        if (len) {                                                                                                \
+            __m128i ks[8];                                                                                        \
+            if (len > 16) {                                                                                       \
+                AES_CTR_BLOCKS_X8(AES_GCM_SIV_CTR_BLOCK_AMD64, m, c, 1)                                           \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X8_AMD64, m, k)                                                   \
+                ks[0] = m0; ks[1] = m1; ks[2] = m2; ks[3] = m3; ks[4] = m4; ks[5] = m5; ks[6] = m6; ks[7] = m7;   \
+            } else {                                                                                              \
+                m0 = c;                                                                                           \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X1_AMD64, m0, k)                                                  \
+                ks[0] = m0;                                                                                       \
+            }                                                                                                     \
+            xor_bytes(out, in, (const uint8_t*) ks, len);                                                         \
+        }                                                                                                         \
+    }
+AES_GCM_SIV_CTR_AESNI_FN(128)
+AES_GCM_SIV_CTR_AESNI_FN(256)
+#undef AES_GCM_SIV_CTR_AESNI_FN
+
+/* Generates the VAES512 GCM-SIV CTR kernel: 32 blocks in flight (8 zmm), leftovers go to the AES-NI kernel */
+#define AES_GCM_SIV_CTR_VAES512_FN(bits)                                                                          \
+    TARGET("aes,vaes,avx512f") static void aes##bits##_gcm_siv_ctr_vaes512(const uint8_t* s, const uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t len) { \
+        uint8_t c_bytes[16];                                                                                      \
+        memcpy(c_bytes, counter, 16);                                                                             \
+        if (len >= 512) {                                                                                         \
+            AES##bits##_ENC_KEYS(get_key_vaes512, k, s)                                                           \
+            __m512i c = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*) counter));                        \
+            __m512i m0, m1, m2, m3, m4, m5, m6, m7;                                                               \
+            for (; len >= 512; len -= 512, in += 512, out += 512) {                                               \
+                AES_CTR_BLOCKS_X8(AES_GCM_SIV_CTR_BLOCK_VAES512, m, c, 4)                                         \
+                c = _mm512_add_epi32(c, _mm512_broadcast_i32x4(_mm_set_epi32(0, 0, 0, 32)));                      \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X8_VAES512, m, k)                                                 \
+                AES_CTR_XOR_X8(__m512i, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_xor_si512, m, in, out)    \
+            }                                                                                                     \
+            _mm_storeu_si128((__m128i*) c_bytes, _mm512_castsi512_si128(c));                                      \
+        }                                                                                                         \
+        if (len) aes##bits##_gcm_siv_ctr_aesni(s, c_bytes, in, out, len);                                         \
+    }
+AES_GCM_SIV_CTR_VAES512_FN(128)
+AES_GCM_SIV_CTR_VAES512_FN(256)
+#undef AES_GCM_SIV_CTR_VAES512_FN
+
+/* Generates the generic GCM-SIV CTR (counter blocks of up to 32 at a time through the dispatched encrypt transform) */
+#define AES_GCM_SIV_CTR_GENERIC_FN(bits)                                                                          \
+    static void aes##bits##_gcm_siv_ctr_generic(const uint8_t* s, const uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t len) { \
+        uint8_t ks[32][16];                                                                                       \
+        uint32_t ctr = (uint32_t) counter[0] | (uint32_t) counter[1] << 8 | (uint32_t) counter[2] << 16 | (uint32_t) counter[3] << 24; \
+        while (len) {                                                                                             \
+            const size_t n = len < sizeof(ks) ? (len + 15) >> 4 : 32;                                             \
+            const size_t used = len < sizeof(ks) ? len : sizeof(ks);                                              \
+            for (size_t i = 0; i < n; i++, ctr++) {                                                               \
+                ks[i][0] = (uint8_t) ctr; ks[i][1] = (uint8_t) (ctr >> 8);                                        \
+                ks[i][2] = (uint8_t) (ctr >> 16); ks[i][3] = (uint8_t) (ctr >> 24);                               \
+                memcpy(ks[i] + 4, counter + 4, 12);                                                               \
+            }                                                                                                     \
+            aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) s, (const uint8_t (*)[16]) ks, ks, n);    \
+            xor_bytes(out, in, ks[0], used);                                                                      \
+            len -= used; in += used; out += used;                                                                 \
+        }                                                                                                         \
+    }
+AES_GCM_SIV_CTR_GENERIC_FN(128)
+AES_GCM_SIV_CTR_GENERIC_FN(256)
+#undef AES_GCM_SIV_CTR_GENERIC_FN
+
+/* Generates a tier's GCM-SIV for one key size (nk: derived blocks, 4 or 6)
+ * keys: per-nonce key derivation (one batched encrypt call), enc schedule & the POLYVAL table for n blocks at most;
+ * tag: S from the payload plaintext, then tag = E(enc key, S); seal: tag first, then CTR; open: CTR first, then tag */
+#define AES_GCM_SIV_FN(bits, T, nk)                                                                               \
+    static void aes##bits##_gcm_siv_keys_##T(const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, size_t n, \
+                                             uint8_t* ht, aes##bits##_sched_enc_t* enc) {                          \
+        uint8_t b[nk][16], h[16];                                                                                 \
+        aes##bits##_key_t key;                                                                                    \
+        for (uint8_t i = 0; i < nk; i++) {                                                                        \
+            b[i][0] = i; b[i][1] = 0; b[i][2] = 0; b[i][3] = 0;                                                   \
+            memcpy(b[i] + 4, nonce, 12);                                                                          \
+        }                                                                                                         \
+        aes##bits##_encrypt_blocks(schedule, (const uint8_t (*)[16]) b, b, nk);                                   \
+        memcpy(h, b[0], 8); memcpy(h + 8, b[1], 8);                                                               \
+        for (int i = 2; i < nk; i++) memcpy(key.bytes + 8 * (i - 2), b[i], 8);                                    \
+        aes##bits##_load_key_enc(&key, enc);                                                                      \
+        aes_polyval_htable_##T(ht, h, n < 1 ? 1 : n > GHASH_POWERS ? GHASH_POWERS : (int) n);                     \
+    }                                                                                                             \
+    static void aes##bits##_gcm_siv_tag_##T(const uint8_t* ht, const aes##bits##_sched_enc_t* enc, const uint8_t* nonce, \
+                                            const uint8_t* aad, size_t aad_len, const uint8_t* plain, size_t len, uint8_t tag[16]) { \
+        uint8_t s[16] = { 0 }, lens[16];                                                                          \
+        aes_polyval_##T(ht, s, aad, aad_len);                                                                     \
+        aes_polyval_##T(ht, s, plain, len);                                                                       \
+        for (int i = 0; i < 8; i++) {                                                                             \
+            lens[i] = (uint8_t) (((uint64_t) aad_len << 3) >> (8 * i));                                           \
+            lens[8 + i] = (uint8_t) (((uint64_t) len << 3) >> (8 * i));                                           \
+        }                                                                                                         \
+        aes_polyval_##T(ht, s, lens, 16);                                                                         \
+        for (int i = 0; i < 12; i++) s[i] ^= nonce[i];                                                            \
+        s[15] &= 0x7F;                                                                                            \
+        aes##bits##_encrypt_block(enc, s, tag);                                                                   \
+    }                                                                                                             \
+    static bool aes##bits##_gcm_siv_seal_##T(const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                             const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag) {   \
+        uint8_t ht[GHASH_TABLE_BYTES], counter[16];                                                               \
+        aes##bits##_sched_enc_t enc;                                                                              \
+        if ((uint64_t) aad_len > AES_GCM_SIV_MAX_LEN || (uint64_t) len > AES_GCM_SIV_MAX_LEN) return false;       \
+        aes##bits##_gcm_siv_keys_##T(schedule, nonce, ((aad_len > len ? aad_len : len) + 15) >> 4, ht, &enc);     \
+        aes##bits##_gcm_siv_tag_##T(ht, &enc, nonce, aad, aad_len, plain, len, counter);                          \
+        memcpy(tag, counter, 16);                                                                                 \
+        counter[15] |= 0x80;                                                                                      \
+        aes##bits##_gcm_siv_ctr_##T(enc.bytes, counter, plain, cipher, len);                                      \
+        return true;                                                                                              \
+    }                                                                                                             \
+    static bool aes##bits##_gcm_siv_open_##T(const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                             const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag) { \
+        uint8_t ht[GHASH_TABLE_BYTES], counter[16], full[16], diff = 0;                                           \
+        aes##bits##_sched_enc_t enc;                                                                              \
+        if ((uint64_t) aad_len > AES_GCM_SIV_MAX_LEN || (uint64_t) len > AES_GCM_SIV_MAX_LEN) return false;       \
+        aes##bits##_gcm_siv_keys_##T(schedule, nonce, ((aad_len > len ? aad_len : len) + 15) >> 4, ht, &enc);     \
+        memcpy(counter, tag, 16);                                                                                 \
+        counter[15] |= 0x80;                                                                                      \
+        aes##bits##_gcm_siv_ctr_##T(enc.bytes, counter, cipher, plain, len);                                      \
+        aes##bits##_gcm_siv_tag_##T(ht, &enc, nonce, aad, aad_len, plain, len, full);                             \
+        for (int i = 0; i < 16; i++) diff |= full[i] ^ tag[i]; /* constant-time compare */                        \
+        if (diff) { memset(plain, 0, len); return false; }                                                        \
+        return true;                                                                                              \
+    }
+AES_GCM_SIV_FN(128, vaes512, 4)
+AES_GCM_SIV_FN(256, vaes512, 6)
+AES_GCM_SIV_FN(128, aesni, 4)
+AES_GCM_SIV_FN(256, aesni, 6)
+AES_GCM_SIV_FN(128, generic, 4)
+AES_GCM_SIV_FN(256, generic, 6)
+#undef AES_GCM_SIV_FN
+
+/* --- Hash streams internal ---
+ * Whole blocks of an update go straight to the tier's aggregated update (8 or 16 blocks per reduction), a partial block
+ * waits in buf until the next update fills it or final pads it with zeros. GHASH outputs are the byte reversed state.
+ * GMAC streams absorb their aad the same way on the context's table & end with GCM's length block (empty payload).
+ */
+#define AES_GCM_STREAM_FN(T)                                                                                      \
+    static void aes_gcm_absorb_##T(const uint8_t* ht, uint8_t y[16], uint8_t buf[16], size_t* buf_len,             \
+                                   const uint8_t* in, size_t len, bool ghash) {                                   \
+        void (*const update)(const uint8_t*, uint8_t*, const uint8_t*, size_t) = ghash ? aes_gcm_ghash_##T : aes_polyval_##T; \
+        if (*buf_len) {                                                                                           \
+            const size_t take = len < 16 - *buf_len ? len : 16 - *buf_len;                                        \
+            memcpy(buf + *buf_len, in, take);                                                                     \
+            *buf_len += take; in += take; len -= take;                                                            \
+            if (*buf_len < 16) return;                                                                            \
+            update(ht, y, buf, 16);                                                                               \
+        }                                                                                                         \
+        const size_t whole = len & ~(size_t) 15;                                                                  \
+        if (whole) update(ht, y, in, whole);                                                                      \
+        memcpy(buf, in + whole, len - whole);                                                                     \
+        *buf_len = len - whole;                                                                                   \
+    }                                                                                                             \
+    static void aes_gcm_flush_##T(const uint8_t* ht, uint8_t y[16], const uint8_t buf[16], size_t* buf_len, bool ghash) { \
+        if (*buf_len) (ghash ? aes_gcm_ghash_##T : aes_polyval_##T)(ht, y, buf, *buf_len);                        \
+        *buf_len = 0;                                                                                             \
+    }                                                                                                             \
+    static void aes_ghash_ctx_init_##T(aes_ghash_ctx_t* ctx, const uint8_t h[16]) {                                   \
+        aes_gcm_htable_##T(ctx->htable, h);                                                                       \
+        memset(ctx->y, 0, 16);                                                                                    \
+        ctx->buf_len = 0;                                                                                         \
+    }                                                                                                             \
+    static void aes_ghash_ctx_update_##T(aes_ghash_ctx_t* ctx, const uint8_t* in, size_t len) {                       \
+        aes_gcm_absorb_##T(ctx->htable, ctx->y, ctx->buf, &ctx->buf_len, in, len, true);                          \
+    }                                                                                                             \
+    static void aes_ghash_ctx_final_##T(aes_ghash_ctx_t* ctx, uint8_t out[16]) {                                      \
+        aes_gcm_flush_##T(ctx->htable, ctx->y, ctx->buf, &ctx->buf_len, true);                                    \
+        for (int i = 0; i < 16; i++) out[i] = ctx->y[15 - i];                                                     \
+        memset(ctx->y, 0, 16);                                                                                    \
+    }                                                                                                             \
+    static void aes_polyval_ctx_init_##T(aes_polyval_ctx_t* ctx, const uint8_t h[16]) {                               \
+        aes_polyval_htable_##T(ctx->htable, h, GHASH_POWERS);                                                     \
+        memset(ctx->y, 0, 16);                                                                                    \
+        ctx->buf_len = 0;                                                                                         \
+    }                                                                                                             \
+    static void aes_polyval_ctx_update_##T(aes_polyval_ctx_t* ctx, const uint8_t* in, size_t len) {                   \
+        aes_gcm_absorb_##T(ctx->htable, ctx->y, ctx->buf, &ctx->buf_len, in, len, false);                         \
+    }                                                                                                             \
+    static void aes_polyval_ctx_final_##T(aes_polyval_ctx_t* ctx, uint8_t out[16]) {                                  \
+        aes_gcm_flush_##T(ctx->htable, ctx->y, ctx->buf, &ctx->buf_len, false);                                   \
+        memcpy(out, ctx->y, 16);                                                                                  \
+        memset(ctx->y, 0, 16);                                                                                    \
+    }                                                                                                             \
+    static void aes_gmac_update_##T(aes_gmac_stream_t* stream, const uint8_t* aad, size_t len) {                  \
+        aes_gcm_absorb_##T(stream->htable, stream->y, stream->buf, &stream->buf_len, aad, len, true);             \
+        stream->aad_len += len;                                                                                   \
+    }                                                                                                             \
+    static bool aes_gmac_tag_##T(aes_gmac_stream_t* stream, uint8_t tag[16]) {                                    \
+        uint8_t lens[16] = { 0 };                                                                                 \
+        const bool ok = stream->aad_len <= AES_GCM_MAX_AAD;                                                       \
+        aes_gcm_flush_##T(stream->htable, stream->y, stream->buf, &stream->buf_len, true);                        \
+        store_be64(lens, stream->aad_len << 3);                                                                   \
+        aes_gcm_ghash_##T(stream->htable, stream->y, lens, 16);                                                   \
+        for (int i = 0; i < 16; i++) tag[i] = stream->ek_j0[i] ^ stream->y[15 - i];                               \
+        memset(stream, 0, sizeof(*stream));                                                                       \
+        return ok;                                                                                                \
+    }                                                                                                             \
+    static bool aes_gmac_final_##T(aes_gmac_stream_t* stream, uint8_t* tag, size_t tag_len) {                     \
+        uint8_t full[16];                                                                                         \
+        if (!aes_gmac_tag_##T(stream, full) || !AES_GCM_TAG_OK(tag_len)) return false; /* the stream ends either way */ \
+        memcpy(tag, full, tag_len);                                                                               \
+        return true;                                                                                              \
+    }                                                                                                             \
+    static bool aes_gmac_final_verify_##T(aes_gmac_stream_t* stream, const uint8_t* tag, size_t tag_len) {        \
+        uint8_t full[16], diff = 0;                                                                               \
+        const bool ok = aes_gmac_tag_##T(stream, full);                                                           \
+        for (size_t i = 0; i < tag_len && i < 16; i++) diff |= full[i] ^ tag[i]; /* constant-time compare */      \
+        return ok && !diff && AES_GCM_TAG_OK(tag_len);                                                            \
+    }
+AES_GCM_STREAM_FN(vaes512)
+AES_GCM_STREAM_FN(aesni)
+AES_GCM_STREAM_FN(generic)
+#undef AES_GCM_STREAM_FN
+
+/* --- Backend dispatch --- (one tier per process, picked once, same flavors as aes.c) */
+typedef struct {
+    void (*init128)(aes128_gcm_ctx_t*, const aes128_key_t*);
+    void (*init192)(aes192_gcm_ctx_t*, const aes192_key_t*);
+    void (*init256)(aes256_gcm_ctx_t*, const aes256_key_t*);
+    bool (*seal128)(const aes128_gcm_ctx_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*seal192)(const aes192_gcm_ctx_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*seal256)(const aes256_gcm_ctx_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*, size_t);
+    bool (*open128)(const aes128_gcm_ctx_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+    bool (*open192)(const aes192_gcm_ctx_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+    bool (*open256)(const aes256_gcm_ctx_t*, const uint8_t*, size_t, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*, size_t);
+    bool (*siv_seal128)(const aes128_sched_enc_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*);
+    bool (*siv_seal256)(const aes256_sched_enc_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, uint8_t*);
+    bool (*siv_open128)(const aes128_sched_enc_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*);
+    bool (*siv_open256)(const aes256_sched_enc_t*, const uint8_t*, const uint8_t*, size_t, const uint8_t*, uint8_t*, size_t, const uint8_t*);
+    bool (*gmac_start128)(const aes128_gcm_ctx_t*, aes_gmac_stream_t*, const uint8_t*, size_t);
+    bool (*gmac_start192)(const aes192_gcm_ctx_t*, aes_gmac_stream_t*, const uint8_t*, size_t);
+    bool (*gmac_start256)(const aes256_gcm_ctx_t*, aes_gmac_stream_t*, const uint8_t*, size_t);
+    void (*gmac_update)(aes_gmac_stream_t*, const uint8_t*, size_t);
+    bool (*gmac_final)(aes_gmac_stream_t*, uint8_t*, size_t);
+    bool (*gmac_final_verify)(aes_gmac_stream_t*, const uint8_t*, size_t);
+    void (*ghash_init)(aes_ghash_ctx_t*, const uint8_t*);
+    void (*ghash_update)(aes_ghash_ctx_t*, const uint8_t*, size_t);
+    void (*ghash_final)(aes_ghash_ctx_t*, uint8_t*);
+    void (*polyval_init)(aes_polyval_ctx_t*, const uint8_t*);
+    void (*polyval_update)(aes_polyval_ctx_t*, const uint8_t*, size_t);
+    void (*polyval_final)(aes_polyval_ctx_t*, uint8_t*);
+} aes_gcm_tier_t;
+
+#define AES_GCM_TIER(T) {                                                   \
+    aes128_gcm_init_##T, aes192_gcm_init_##T, aes256_gcm_init_##T,          \
+    aes128_gcm_seal_##T, aes192_gcm_seal_##T, aes256_gcm_seal_##T,          \
+    aes128_gcm_open_##T, aes192_gcm_open_##T, aes256_gcm_open_##T,          \
+    aes128_gcm_siv_seal_##T, aes256_gcm_siv_seal_##T,                       \
+    aes128_gcm_siv_open_##T, aes256_gcm_siv_open_##T,                       \
+    aes128_gmac_start_##T, aes192_gmac_start_##T, aes256_gmac_start_##T,    \
+    aes_gmac_update_##T, aes_gmac_final_##T, aes_gmac_final_verify_##T,     \
+    aes_ghash_ctx_init_##T, aes_ghash_ctx_update_##T,                       \
+    aes_ghash_ctx_final_##T, aes_polyval_ctx_init_##T,                      \
+    aes_polyval_ctx_update_##T, aes_polyval_ctx_final_##T                   \
+}
+static const aes_gcm_tier_t aes_gcm_tier_vaes512 = AES_GCM_TIER(vaes512);
+static const aes_gcm_tier_t aes_gcm_tier_aesni   = AES_GCM_TIER(aesni);
+static const aes_gcm_tier_t aes_gcm_tier_generic = AES_GCM_TIER(generic);
+#undef AES_GCM_TIER
+
+/* Best tier for the given hardware (the stitched kernels need AES-NI, PCLMULQDQ & pshufb, + VAES & VPCLMULQDQ on zmm) */
+static inline const aes_gcm_tier_t* aes_gcm_select_tier(const hardware_t* hw) {
+    if (hw->aes && hw->pclmul && hw->ssse3) {
+        if (hw->vaes512 && hw->vpclmul) return &aes_gcm_tier_vaes512;
+        return &aes_gcm_tier_aesni;
+    }
+    return &aes_gcm_tier_generic;
+}
+
+/* ret: return for value returning ops, empty for void ones */
+#if defined(CRYPTOCORE_ASSUME)
+    static const hardware_t aes_gcm_assumed_hardware = HARDWARE_ASSUMED;
+    #define AES_GCM_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_gcm_select_tier(&aes_gcm_assumed_hardware)->field args; }
+    void aes_gcm_dispatch_update(void) {}
+#elif defined(CRYPTOCORE_IFUNC)
+    #define AES_GCM_PUBLIC_FN(type, ret, name, field, params, args)                                   \
+        static type (*name##_resolve(void)) params {                                                  \
+            hardware_t hw;                                                                            \
+            hardware_detect(&hw);                                                                     \
+            return aes_gcm_select_tier(&hw)->field;                                                   \
+        }                                                                                             \
+        type name params __attribute__((ifunc(#name "_resolve")));
+    void aes_gcm_dispatch_update(void) {}
+#else
+    static const aes_gcm_tier_t* aes_gcm_tier; /* set below, after its stubs */
+    void aes_gcm_dispatch_update(void) {
+        hardware_init();
+        aes_gcm_tier = aes_gcm_select_tier(&_hardware);
+    }
+    #define AES_GCM_UNRESOLVED_FN(type, ret, field, params, args) \
+        static type aes_gcm_unresolved_##field params { aes_gcm_dispatch_update(); ret aes_gcm_tier->field args; }
+    #define AES_GCM_INIT_PARAMS(bits) (aes##bits##_gcm_ctx_t* ctx, const aes##bits##_key_t* key)
+    #define AES_GCM_SEAL_PARAMS(bits) (const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                                       const uint8_t* in, uint8_t* out, size_t len, uint8_t* tag, size_t tag_len)
+    #define AES_GCM_OPEN_PARAMS(bits) (const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                                       const uint8_t* in, uint8_t* out, size_t len, const uint8_t* tag, size_t tag_len)
+    #define AES_GCM_SIV_SEAL_PARAMS(bits) (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                           const uint8_t* in, uint8_t* out, size_t len, uint8_t* tag)
+    #define AES_GCM_SIV_OPEN_PARAMS(bits) (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                                           const uint8_t* in, uint8_t* out, size_t len, const uint8_t* tag)
+    #define AES_GMAC_START_PARAMS(bits) (const aes##bits##_gcm_ctx_t* ctx, aes_gmac_stream_t* stream, const uint8_t* iv, size_t iv_len)
+    #define AES_GCM_INIT_ARGS (ctx, key)
+    #define AES_GCM_CRYPT_ARGS (ctx, iv, iv_len, aad, aad_len, in, out, len, tag, tag_len)
+    #define AES_GCM_SIV_ARGS (schedule, nonce, aad, aad_len, in, out, len, tag)
+    AES_GCM_UNRESOLVED_FN(void, , init128, AES_GCM_INIT_PARAMS(128), AES_GCM_INIT_ARGS)
+    AES_GCM_UNRESOLVED_FN(void, , init192, AES_GCM_INIT_PARAMS(192), AES_GCM_INIT_ARGS)
+    AES_GCM_UNRESOLVED_FN(void, , init256, AES_GCM_INIT_PARAMS(256), AES_GCM_INIT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, seal128, AES_GCM_SEAL_PARAMS(128), AES_GCM_CRYPT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, seal192, AES_GCM_SEAL_PARAMS(192), AES_GCM_CRYPT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, seal256, AES_GCM_SEAL_PARAMS(256), AES_GCM_CRYPT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, open128, AES_GCM_OPEN_PARAMS(128), AES_GCM_CRYPT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, open192, AES_GCM_OPEN_PARAMS(192), AES_GCM_CRYPT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, open256, AES_GCM_OPEN_PARAMS(256), AES_GCM_CRYPT_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, siv_seal128, AES_GCM_SIV_SEAL_PARAMS(128), AES_GCM_SIV_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, siv_seal256, AES_GCM_SIV_SEAL_PARAMS(256), AES_GCM_SIV_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, siv_open128, AES_GCM_SIV_OPEN_PARAMS(128), AES_GCM_SIV_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, siv_open256, AES_GCM_SIV_OPEN_PARAMS(256), AES_GCM_SIV_ARGS)
+    AES_GCM_UNRESOLVED_FN(bool, return, gmac_start128, AES_GMAC_START_PARAMS(128), (ctx, stream, iv, iv_len))
+    AES_GCM_UNRESOLVED_FN(bool, return, gmac_start192, AES_GMAC_START_PARAMS(192), (ctx, stream, iv, iv_len))
+    AES_GCM_UNRESOLVED_FN(bool, return, gmac_start256, AES_GMAC_START_PARAMS(256), (ctx, stream, iv, iv_len))
+    AES_GCM_UNRESOLVED_FN(void, , gmac_update, (aes_gmac_stream_t* stream, const uint8_t* aad, size_t len), (stream, aad, len))
+    AES_GCM_UNRESOLVED_FN(bool, return, gmac_final, (aes_gmac_stream_t* stream, uint8_t* tag, size_t tag_len), (stream, tag, tag_len))
+    AES_GCM_UNRESOLVED_FN(bool, return, gmac_final_verify, (aes_gmac_stream_t* stream, const uint8_t* tag, size_t tag_len), (stream, tag, tag_len))
+    AES_GCM_UNRESOLVED_FN(void, , ghash_init, (aes_ghash_ctx_t* ctx, const uint8_t* h), (ctx, h))
+    AES_GCM_UNRESOLVED_FN(void, , ghash_update, (aes_ghash_ctx_t* ctx, const uint8_t* in, size_t len), (ctx, in, len))
+    AES_GCM_UNRESOLVED_FN(void, , ghash_final, (aes_ghash_ctx_t* ctx, uint8_t* out), (ctx, out))
+    AES_GCM_UNRESOLVED_FN(void, , polyval_init, (aes_polyval_ctx_t* ctx, const uint8_t* h), (ctx, h))
+    AES_GCM_UNRESOLVED_FN(void, , polyval_update, (aes_polyval_ctx_t* ctx, const uint8_t* in, size_t len), (ctx, in, len))
+    AES_GCM_UNRESOLVED_FN(void, , polyval_final, (aes_polyval_ctx_t* ctx, uint8_t* out), (ctx, out))
+    #undef AES_GCM_INIT_PARAMS
+    #undef AES_GCM_SEAL_PARAMS
+    #undef AES_GCM_OPEN_PARAMS
+    #undef AES_GCM_SIV_SEAL_PARAMS
+    #undef AES_GCM_SIV_OPEN_PARAMS
+    #undef AES_GMAC_START_PARAMS
+    #undef AES_GCM_INIT_ARGS
+    #undef AES_GCM_CRYPT_ARGS
+    #undef AES_GCM_SIV_ARGS
+    #undef AES_GCM_UNRESOLVED_FN
+    static const aes_gcm_tier_t aes_gcm_tier_unresolved = {
+        aes_gcm_unresolved_init128, aes_gcm_unresolved_init192, aes_gcm_unresolved_init256,
+        aes_gcm_unresolved_seal128, aes_gcm_unresolved_seal192, aes_gcm_unresolved_seal256,
+        aes_gcm_unresolved_open128, aes_gcm_unresolved_open192, aes_gcm_unresolved_open256,
+        aes_gcm_unresolved_siv_seal128, aes_gcm_unresolved_siv_seal256,
+        aes_gcm_unresolved_siv_open128, aes_gcm_unresolved_siv_open256,
+        aes_gcm_unresolved_gmac_start128, aes_gcm_unresolved_gmac_start192, aes_gcm_unresolved_gmac_start256,
+        aes_gcm_unresolved_gmac_update, aes_gcm_unresolved_gmac_final, aes_gcm_unresolved_gmac_final_verify,
+        aes_gcm_unresolved_ghash_init, aes_gcm_unresolved_ghash_update, aes_gcm_unresolved_ghash_final,
+        aes_gcm_unresolved_polyval_init, aes_gcm_unresolved_polyval_update, aes_gcm_unresolved_polyval_final
+    };
+    static const aes_gcm_tier_t* aes_gcm_tier = &aes_gcm_tier_unresolved;
+    INITIALIZER(aes_gcm_dispatch_startup) { aes_gcm_dispatch_update(); }
+    #define AES_GCM_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_gcm_tier->field args; }
+#endif
+
+/* --- Public GCM --- */
+#define AES_GCM_PUBLIC_FNS(bits)                                                                                  \
+    AES_GCM_PUBLIC_FN(void, , aes##bits##_gcm_init, init##bits, (aes##bits##_gcm_ctx_t* ctx, const aes##bits##_key_t* key), (ctx, key)) \
+    AES_GCM_PUBLIC_FN(bool, return, aes##bits##_gcm_seal, seal##bits,                                             \
+                      (const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                       const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len),          \
+                      (ctx, iv, iv_len, aad, aad_len, plain, cipher, len, tag, tag_len))                          \
+    AES_GCM_PUBLIC_FN(bool, return, aes##bits##_gcm_open, open##bits,                                            \
+                      (const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                       const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len),    \
+                      (ctx, iv, iv_len, aad, aad_len, cipher, plain, len, tag, tag_len))
+AES_GCM_PUBLIC_FNS(128)
+AES_GCM_PUBLIC_FNS(192)
+AES_GCM_PUBLIC_FNS(256)
+#undef AES_GCM_PUBLIC_FNS
+
+/* --- Public GCM-SIV --- */
+#define AES_GCM_SIV_PUBLIC_FNS(bits)                                                                              \
+    AES_GCM_PUBLIC_FN(bool, return, aes##bits##_gcm_siv_seal, siv_seal##bits,                                    \
+                      (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                       const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag),                          \
+                      (schedule, nonce, aad, aad_len, plain, cipher, len, tag))                                   \
+    AES_GCM_PUBLIC_FN(bool, return, aes##bits##_gcm_siv_open, siv_open##bits,                                    \
+                      (const aes##bits##_sched_enc_t* schedule, const uint8_t* nonce, const uint8_t* aad, size_t aad_len, \
+                       const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag),                    \
+                      (schedule, nonce, aad, aad_len, cipher, plain, len, tag))
+AES_GCM_SIV_PUBLIC_FNS(128)
+AES_GCM_SIV_PUBLIC_FNS(256)
+#undef AES_GCM_SIV_PUBLIC_FNS
+
+/* --- Public GMAC & hash streams --- (one shot GMAC: GCM seal / open with an empty payload) */
+#define AES_GMAC_PUBLIC_FNS(bits)                                                                                 \
+    bool aes##bits##_gmac(const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                          uint8_t* tag, size_t tag_len) {                                                         \
+        uint8_t none[1] = { 0 };                                                                                  \
+        return aes##bits##_gcm_seal(ctx, iv, iv_len, aad, aad_len, none, none, 0, tag, tag_len);                  \
+    }                                                                                                             \
+    bool aes##bits##_gmac_verify(const aes##bits##_gcm_ctx_t* ctx, const uint8_t* iv, size_t iv_len, const uint8_t* aad, size_t aad_len, \
+                                 const uint8_t* tag, size_t tag_len) {                                            \
+        uint8_t none[1] = { 0 };                                                                                  \
+        return aes##bits##_gcm_open(ctx, iv, iv_len, aad, aad_len, none, none, 0, tag, tag_len);                  \
+    }                                                                                                             \
+    AES_GCM_PUBLIC_FN(bool, return, aes##bits##_gmac_start, gmac_start##bits,                                     \
+                      (const aes##bits##_gcm_ctx_t* ctx, aes_gmac_stream_t* stream, const uint8_t* iv, size_t iv_len), \
+                      (ctx, stream, iv, iv_len))
+AES_GMAC_PUBLIC_FNS(128)
+AES_GMAC_PUBLIC_FNS(192)
+AES_GMAC_PUBLIC_FNS(256)
+#undef AES_GMAC_PUBLIC_FNS
+AES_GCM_PUBLIC_FN(void, , aes_gmac_update, gmac_update, (aes_gmac_stream_t* stream, const uint8_t* aad, size_t len), (stream, aad, len))
+AES_GCM_PUBLIC_FN(bool, return, aes_gmac_final, gmac_final, (aes_gmac_stream_t* stream, uint8_t* tag, size_t tag_len), (stream, tag, tag_len))
+AES_GCM_PUBLIC_FN(bool, return, aes_gmac_final_verify, gmac_final_verify, (aes_gmac_stream_t* stream, const uint8_t* tag, size_t tag_len),
+                  (stream, tag, tag_len))
+AES_GCM_PUBLIC_FN(void, , aes_ghash_init, ghash_init, (aes_ghash_ctx_t* ctx, const uint8_t h[16]), (ctx, h))
+AES_GCM_PUBLIC_FN(void, , aes_ghash_update, ghash_update, (aes_ghash_ctx_t* ctx, const uint8_t* in, size_t len), (ctx, in, len))
+AES_GCM_PUBLIC_FN(void, , aes_ghash_final, ghash_final, (aes_ghash_ctx_t* ctx, uint8_t out[16]), (ctx, out))
+AES_GCM_PUBLIC_FN(void, , aes_polyval_init, polyval_init, (aes_polyval_ctx_t* ctx, const uint8_t h[16]), (ctx, h))
+AES_GCM_PUBLIC_FN(void, , aes_polyval_update, polyval_update, (aes_polyval_ctx_t* ctx, const uint8_t* in, size_t len), (ctx, in, len))
+AES_GCM_PUBLIC_FN(void, , aes_polyval_final, polyval_final, (aes_polyval_ctx_t* ctx, uint8_t out[16]), (ctx, out))
+#undef AES_GCM_PUBLIC_FN
@@ -0,0 +1,180 @@
+/* AES Key Wrap & Key Wrap with Padding for 128, 192 & 256 bits keys (RFC 3394, RFC 5649, NIST SP 800-38F)
+ * Wraps run as lanes of one batch: each step gathers one block per running wrap, pushes them through one batched
+ * *_encrypt_blocks / *_decrypt_blocks call (aes.c dispatches VAES, AES-NI or the fallback) & scatters the halves back.
+ * A single wrap is a batch of one (its steps go through the single block transform).
+ * Features:
+ *  - KW & KWP wrap / unwrap (single keys & batches under one key encryption key)
+ */
+
+/* Table of Contents
+ *  --- Key wrap internal ---
+ *  --- Public key wrap ---
+ */
+
+#include "aes_kw.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memmove, memset */
+
+/* --- Key wrap internal ---
+ * W (index form, RFC 3394 2.2.1): A = IV, R[0 .. n-1] = the key data in 8 byte halves, then for t = 1 .. 6n:
+ *   B = E(A | R[i]), A = MSB64(B) ^ t, R[i] = LSB64(B), i = (t - 1) mod n. Output A | R.
+ * Unwrap walks t = 6n .. 1 with B = D((A ^ t) | R[i]), then checks A.
+ * KWP (RFC 5649): A = A65959A6 | 32 bit key length, data zero padded to 8 bytes; one half (n = 1) is a single
+ * E(A | P), which runs as a one step lane with no t.
+ * The 6n steps of one wrap are serial, so a step of a batch takes one block from each of up to AES_KW_LANES wraps:
+ * short keys (n = 2 - 4) would otherwise leave the 8 - 16 deep pipeline of the block transforms mostly empty.
+ */
+#define AES_KW_LANES 64 /* wraps in flight (blocks per transform call) */
+#define AES_KW_IV  0xA6A6A6A6A6A6A6A6ULL
+#define AES_KWP_IV 0xA65959A6ULL /* high half of the KWP A, the key length is the low half */
+
+/* One wrap in flight: A, the halves R (in the job's out), its step counter t & index i, steps left */
+typedef struct {
+    aes_kw_job_t* job;
+    uint8_t*      r;
+    uint64_t      a, t;
+    size_t        n, i, left;
+} aes_kw_lane_t;
+
+/* Checks the job's length & moves its data in place (out), false (nothing written) on a bad length */
+static bool aes_kw_start(aes_kw_job_t* job, aes_kw_lane_t* lane, bool unwrap, bool pad) {
+    const size_t len = job->len;
+    job->out_len = 0;
+    job->valid = false;
+    if (unwrap) {
+        if (len % 8 || len < (pad ? 16 : 24)) return false;
+        lane->a = load_be64(job->in);
+        memmove(job->out, job->in + 8, len - 8);
+        lane->r = job->out;
+        lane->n = len / 8 - 1;
+    } else {
+        if (pad ? len == 0 || len > 0xFFFFFFFFULL : len % 8 || len < 16) return false;
+        lane->n = (len + 7) / 8;
+        memmove(job->out + 8, job->in, len);
+        memset(job->out + 8 + len, 0, lane->n * 8 - len);
+        lane->r = job->out + 8;
+        lane->a = pad ? (AES_KWP_IV << 32) | len : AES_KW_IV;
+    }
+    lane->job = job;
+    lane->left = lane->n > 1 ? 6 * lane->n : 1;
+    lane->t = unwrap ? lane->left : 1;
+    lane->i = unwrap ? lane->n - 1 : 0;
+    return true;
+}
+
+/* Done: wrap writes A in front of R; unwrap checks A (KWP: length in range & zero padding), zeroes R on failure */
+static bool aes_kw_finish(const aes_kw_lane_t* lane, bool unwrap, bool pad) {
+    aes_kw_job_t* job = lane->job;
+    const size_t bytes = lane->n * 8;
+    if (!unwrap) {
+        store_be64(job->out, lane->a);
+        job->out_len = bytes + 8;
+        return job->valid = true;
+    }
+    size_t len = bytes;
+    bool ok = lane->a == AES_KW_IV;
+    if (pad) {
+        uint8_t diff = 0;
+        len = (size_t) (lane->a & 0xFFFFFFFF);
+        ok = (lane->a >> 32) == AES_KWP_IV && len > bytes - 8 && len <= bytes;
+        for (size_t j = ok ? len : bytes; j < bytes; j++) diff |= lane->r[j];
+        ok &= diff == 0;
+    }
+    if (!ok) memset(lane->r, 0, bytes);
+    job->out_len = ok ? len : 0;
+    return job->valid = ok;
+}
+
+/* Step input of every lane: A | R[i] (unwrap: (A ^ t) | R[i]) */
+static void aes_kw_gather(const aes_kw_lane_t* lanes, size_t m, uint8_t (*x)[16], bool unwrap) {
+    for (size_t k = 0; k < m; k++) {
+        const aes_kw_lane_t* l = &lanes[k];
+        store_be64(x[k], unwrap && l->n > 1 ? l->a ^ l->t : l->a);
+        memcpy(x[k] + 8, l->r + l->i * 8, 8);
+    }
+}
+
+/* Step output of every lane back into A & R[i] (wrap: A ^= t), finished lanes close their job, the rest are
+ * compacted to the front: returns how many still run */
+static size_t aes_kw_scatter(aes_kw_lane_t* lanes, size_t m, const uint8_t (*x)[16], bool unwrap, bool pad, bool* all) {
+    size_t keep = 0;
+    for (size_t k = 0; k < m; k++) {
+        aes_kw_lane_t* l = &lanes[k];
+        l->a = load_be64(x[k]);
+        if (!unwrap && l->n > 1) l->a ^= l->t;
+        memcpy(l->r + l->i * 8, x[k] + 8, 8);
+        if (unwrap) { l->t--; l->i = l->i ? l->i - 1 : l->n - 1; }
+        else        { l->t++; l->i = l->i + 1 < l->n ? l->i + 1 : 0; }
+        if (--l->left) { if (keep != k) lanes[keep] = *l; keep++; }
+        else *all &= aes_kw_finish(l, unwrap, pad);
+    }
+    return keep;
+}
+
+/* Generates the batch engine for one key size: lanes refill from the job list as wraps finish, so long & short
+ * keys mix without draining the pipeline */
+#define AES_KW_FN(bits)                                                                                           \
+    static bool aes##bits##_kw_run(const aes##bits##_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs, bool unwrap, bool pad) { \
+        aes_kw_lane_t lanes[AES_KW_LANES];                                                                        \
+        uint8_t x[AES_KW_LANES][16];                                                                              \
+        size_t m = 0, next = 0;                                                                                   \
+        bool all = true;                                                                                          \
+        for (;;) {                                                                                                \
+            for (; m < AES_KW_LANES && next < num_jobs; next++) {                                                 \
+                if (aes_kw_start(&jobs[next], &lanes[m], unwrap, pad)) m++;                                       \
+                else all = false;                                                                                 \
+            }                                                                                                     \
+            if (!m) return all;                                                                                   \
+            aes_kw_gather(lanes, m, x, unwrap);                                                                   \
+            if (m == 1 && unwrap) aes##bits##_decrypt_block(&ctx->schedule, x[0], x[0]); /* single wrap or tail */ \
+            else if (m == 1)      aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) &ctx->schedule, x[0], x[0]); \
+            else if (unwrap)      aes##bits##_decrypt_blocks(&ctx->schedule, (const uint8_t (*)[16]) x, x, m);    \
+            else                  aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) &ctx->schedule, (const uint8_t (*)[16]) x, x, m); \
+            m = aes_kw_scatter(lanes, m, (const uint8_t (*)[16]) x, unwrap, pad, &all);                           \
+        }                                                                                                         \
+    }
+AES_KW_FN(128)
+AES_KW_FN(192)
+AES_KW_FN(256)
+#undef AES_KW_FN
+
+/* --- Public key wrap --- */
+#define AES_KW_PUBLIC_FNS(bits)                                                                                   \
+    void aes##bits##_kw_init(aes##bits##_kw_ctx_t* ctx, const aes##bits##_key_t* key) {                           \
+        aes##bits##_load_key(key, &ctx->schedule);                                                                \
+    }                                                                                                             \
+    bool aes##bits##_kw_wrap(const aes##bits##_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out) {      \
+        aes_kw_job_t job = { in, len, out, 0, false };                                                            \
+        return aes##bits##_kw_run(ctx, &job, 1, false, false);                                                    \
+    }                                                                                                             \
+    bool aes##bits##_kw_unwrap(const aes##bits##_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out) {    \
+        aes_kw_job_t job = { in, len, out, 0, false };                                                            \
+        return aes##bits##_kw_run(ctx, &job, 1, true, false);                                                     \
+    }                                                                                                             \
+    bool aes##bits##_kwp_wrap(const aes##bits##_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out) {     \
+        aes_kw_job_t job = { in, len, out, 0, false };                                                            \
+        return aes##bits##_kw_run(ctx, &job, 1, false, true);                                                     \
+    }                                                                                                             \
+    bool aes##bits##_kwp_unwrap(const aes##bits##_kw_ctx_t* ctx, const uint8_t* in, size_t len, uint8_t* out, size_t* out_len) { \
+        aes_kw_job_t job = { in, len, out, 0, false };                                                            \
+        const bool ok = aes##bits##_kw_run(ctx, &job, 1, true, true);                                             \
+        *out_len = job.out_len;                                                                                   \
+        return ok;                                                                                                \
+    }                                                                                                             \
+    bool aes##bits##_kw_wrap_batch(const aes##bits##_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs) {        \
+        return aes##bits##_kw_run(ctx, jobs, num_jobs, false, false);                                             \
+    }                                                                                                             \
+    bool aes##bits##_kw_unwrap_batch(const aes##bits##_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs) {      \
+        return aes##bits##_kw_run(ctx, jobs, num_jobs, true, false);                                              \
+    }                                                                                                             \
+    bool aes##bits##_kwp_wrap_batch(const aes##bits##_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs) {       \
+        return aes##bits##_kw_run(ctx, jobs, num_jobs, false, true);                                              \
+    }                                                                                                             \
+    bool aes##bits##_kwp_unwrap_batch(const aes##bits##_kw_ctx_t* ctx, aes_kw_job_t* jobs, size_t num_jobs) {     \
+        return aes##bits##_kw_run(ctx, jobs, num_jobs, true, true);                                               \
+    }
+AES_KW_PUBLIC_FNS(128)
+AES_KW_PUBLIC_FNS(192)
+AES_KW_PUBLIC_FNS(256)
+#undef AES_KW_PUBLIC_FNS
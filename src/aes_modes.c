@@ -0,0 +1,860 @@
+/* Block cipher modes for 128, 192 & 256 bits keys
+ * AES-NI / VAES kernels keep 8 registers of blocks in flight (8, 16 or 32 blocks),
+ * other CPUs run the modes on top of the dispatched *_blocks transforms (SSSE3 / pure c).
+ * Features:
+ *  - CTR keystream xor
+ *  - CBC decryption (8 registers of blocks in flight, in-place safe)
+ *  - Multi-buffer CBC / CFB encryption, OFB & CBC-MAC (independent streams side by side, 8 or 16 lanes)
+ *  - XTS (tweaks for 8 registers of blocks from parallel multiplications by alpha, sector batches)
+ */
+
+/* Table of Contents
+ *  --- CTR internal ---
+ *  --- CBC internal ---
+ *  --- Multi-buffer internal ---
+ *  --- XTS internal ---
+ *  --- Backend dispatch --- (one tier per process, picked once)
+ *  --- Public CTR ---
+ *  --- Public CBC ---
+ *  --- Public multi-buffer ---
+ *  --- Public XTS ---
+ */
+
+#include "aes_modes.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy */
+
+/* --- CTR internal ---
+ * Counter block kept as host integers: hi = bytes 0-7, lo = bytes 8-15 of the big-endian block.
+ * Vector counters are built little-endian (lo in the low qword of each lane) then byte reversed into blocks.
+ * Block offsets are added with 32 bit lanes for CTR32 (wraps inside the low word) or 64 bit lanes otherwise
+ * (wraps inside the low qword). Only CTR128 carries into hi: passes that would carry run one block at a time.
+ */
+#define AES_CTR_WRAPS(width, lo, n) ((width) == AES_CTR128 && (lo) + ((n) - 1) < (lo))
+#define AES_CTR_ADD(add32, add64, c, inc) (width == AES_CTR32 ? add32(c, inc) : add64(c, inc))
+
+/* Advances the counter by n blocks */
+static inline void aes_ctr_advance(uint64_t* hi, uint64_t* lo, aes_ctr_width_t width, uint64_t n) {
+    if (width == AES_CTR32) { *lo = (*lo & 0xFFFFFFFF00000000ULL) | (uint32_t) (*lo + n); return; }
+    *lo += n;
+    if (width == AES_CTR128 && *lo < n) (*hi)++;
+}
+
+/* Counter block i after little-endian base c (xmm: 1 block, ymm: 2 blocks, zmm: 4 blocks per register) */
+#define AES_CTR_BLOCK_AMD64(c, i) \
+    _mm_shuffle_epi8(AES_CTR_ADD(_mm_add_epi32, _mm_add_epi64, c, _mm_set_epi64x(0, i)), bswap)
+#define AES_CTR_BLOCK_VAES256(c, i) \
+    _mm256_shuffle_epi8(AES_CTR_ADD(_mm256_add_epi32, _mm256_add_epi64, c, _mm256_set_epi64x(0, i + 1, 0, i)), bswap)
+#define AES_CTR_BLOCK_VAES512(c, i) \
+    AES_BSWAP128_VAES512(AES_CTR_ADD(_mm512_add_epi32, _mm512_add_epi64, c, _mm512_set_epi64(0, i + 3, 0, i + 2, 0, i + 1, 0, i)))
+
+/* Generates an AES-NI CTR kernel: 8 counter blocks in flight, leftovers as one 8 block keystream pass
+ * (or a lone block when at most 16 bytes remain or CTR128 is about to carry) */
+#define AES_CTR_AESNI_FN(bits)                                                                                    \
+    TARGET("aes,ssse3") static void aes##bits##_ctr_xor_aesni(const uint8_t* s, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len) { \
+        AES##bits##_ENC_KEYS(get_key, k, s)                                                                       \
+        const __m128i bswap = BSWAP128_MASK;                                                                      \
+        uint64_t hi = load_be64(counter), lo = load_be64(counter + 8);                                            \
+        __m128i m0, m1, m2, m3, m4, m5, m6, m7;                                                                   \
+        for (; len >= 128 && !AES_CTR_WRAPS(width, lo, 8); len -= 128, in += 128, out += 128) {                   \
+            const __m128i c = _mm_set_epi64x(hi, lo);                                                             \
+            AES_CTR_BLOCKS_X8(AES_CTR_BLOCK_AMD64, m, c, 1)                                                       \
+            AES##bits##_ENC_BLOCK_AMD64(AES_X8_AMD64, m, k)                                                       \
+            AES_CTR_XOR_X8(__m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_xor_si128, m, in, out)              \
+            aes_ctr_advance(&hi, &lo, width, 8);                                                                  \
+        }                                                                                                         \
+        while (len) {                                                                                             \
+            __m128i ks[8];                                                                                        \
+            const __m128i c = _mm_set_epi64x(hi, lo);                                                             \
+            size_t used = 16;                                                                                     \
+            if (len > 16 && !AES_CTR_WRAPS(width, lo, 8)) {                                                       \
+                AES_CTR_BLOCKS_X8(AES_CTR_BLOCK_AMD64, m, c, 1)                                                   \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X8_AMD64, m, k)                                                   \
+                ks[0] = m0; ks[1] = m1; ks[2] = m2; ks[3] = m3; ks[4] = m4; ks[5] = m5; ks[6] = m6; ks[7] = m7;   \
+                used = 128;                                                                                       \
+            } else {                                                                                              \
+                m0 = AES_CTR_BLOCK_AMD64(c, 0);                                                                   \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X1_AMD64, m0, k)                                                  \
+                ks[0] = m0;                                                                                       \
+            }                                                                                                     \
+            if (used > len) used = len;                                                                           \
+            xor_bytes(out, in, (const uint8_t*) ks, used);                                                        \
+            aes_ctr_advance(&hi, &lo, width, (used + 15) >> 4);                                                   \
+            len -= used; in += used; out += used;                                                                 \
+        }                                                                                                         \
+        store_be64(counter, hi); store_be64(counter + 8, lo);                                                     \
+    }
+AES_CTR_AESNI_FN(128)
+AES_CTR_AESNI_FN(192)
+AES_CTR_AESNI_FN(256)
+#undef AES_CTR_AESNI_FN
+
+/* Generates a VAES CTR kernel (256: 16 blocks in flight, 512: 32 blocks in flight), leftovers go to the AES-NI kernel */
+#define AES_CTR_VAES_FN(bits, W, isa, T, w, broadcast, load, store, xor)                                          \
+    TARGET(isa) static void aes##bits##_ctr_xor_vaes##W(const uint8_t* s, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len) { \
+        if (len >= 128 * w) {                                                                                     \
+            AES##bits##_ENC_KEYS(get_key_vaes##W, k, s)                                                           \
+            const T bswap = broadcast(BSWAP128_MASK);                                                             \
+            uint64_t hi = load_be64(counter), lo = load_be64(counter + 8);                                        \
+            T m0, m1, m2, m3, m4, m5, m6, m7;                                                                     \
+            (void) bswap;                                                                                         \
+            for (; len >= 128 * w && !AES_CTR_WRAPS(width, lo, 8 * w); len -= 128 * w, in += 128 * w, out += 128 * w) { \
+                const T c = broadcast(_mm_set_epi64x(hi, lo));                                                    \
+                AES_CTR_BLOCKS_X8(AES_CTR_BLOCK_VAES##W, m, c, w)                                                 \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X8_VAES##W, m, k)                                                 \
+                AES_CTR_XOR_X8(T, load, store, xor, m, in, out)                                                   \
+                aes_ctr_advance(&hi, &lo, width, 8 * w);                                                          \
+            }                                                                                                     \
+            store_be64(counter, hi); store_be64(counter + 8, lo);                                                 \
+        }                                                                                                         \
+        if (len) aes##bits##_ctr_xor_aesni(s, counter, width, in, out, len);                                      \
+    }
+#define AES_CTR_VAES256_FN(bits) AES_CTR_VAES_FN(bits, 256, "aes,vaes,avx2", __m256i, 2, _mm256_broadcastsi128_si256, \
+                                                 _mm256_loadu_si256, _mm256_storeu_si256, _mm256_xor_si256)
+#define AES_CTR_VAES512_FN(bits) AES_CTR_VAES_FN(bits, 512, "aes,vaes,avx512f", __m512i, 4, _mm512_broadcast_i32x4, \
+                                                 _mm512_loadu_si512, _mm512_storeu_si512, _mm512_xor_si512)
+AES_CTR_VAES256_FN(128)
+AES_CTR_VAES256_FN(192)
+AES_CTR_VAES256_FN(256)
+AES_CTR_VAES512_FN(128)
+AES_CTR_VAES512_FN(192)
+AES_CTR_VAES512_FN(256)
+#undef AES_CTR_VAES256_FN
+#undef AES_CTR_VAES512_FN
+#undef AES_CTR_VAES_FN
+
+/* Generates the generic CTR (counter blocks of up to 32 at a time through the dispatched encrypt transform) */
+#define AES_CTR_GENERIC_FN(bits)                                                                                  \
+    static void aes##bits##_ctr_xor_generic(const uint8_t* s, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len) { \
+        uint8_t ks[32][16];                                                                                       \
+        uint64_t hi = load_be64(counter), lo = load_be64(counter + 8);                                            \
+        while (len) {                                                                                             \
+            size_t n = (len + 15) >> 4;                                                                           \
+            if (n > 32) n = 32;                                                                                   \
+            for (size_t i = 0; i < n; i++) {                                                                      \
+                store_be64(ks[i], hi); store_be64(ks[i] + 8, lo);                                                 \
+                aes_ctr_advance(&hi, &lo, width, 1);                                                              \
+            }                                                                                                     \
+            aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) s, (const uint8_t (*)[16]) ks, ks, n);    \
+            const size_t used = len < (n << 4) ? len : (n << 4);                                                  \
+            xor_bytes(out, in, ks[0], used);                                                                      \
+            len -= used; in += used; out += used;                                                                 \
+        }                                                                                                         \
+        store_be64(counter, hi); store_be64(counter + 8, lo);                                                     \
+    }
+AES_CTR_GENERIC_FN(128)
+AES_CTR_GENERIC_FN(192)
+AES_CTR_GENERIC_FN(256)
+#undef AES_CTR_GENERIC_FN
+
+/* --- CBC internal ---
+ * Decryption: plain[i] = D(cipher[i]) ^ cipher[i - 1], every block independent. A pass decrypts 8 registers of blocks,
+ * then xors them back to front, reading each chaining block from the input before its own block is overwritten
+ * (in == out safe), the pass's last ciphertext block is kept in a register as the next chaining value.
+ * Kernels are generated per schedule type (full, dec & enc: KEYS picks the round key loads).
+ */
+/* Stores m7 ... m0 xored with the preceding ciphertext, register j holds blocks j * w ..., prev0 chains register 0 */
+#define AES_CBC_XOR_X8(T, load, store, xor, m, in, out, w, prev0)                                              \
+    store((T*) ((out) + 7 * w), xor(m##7, load((const T*) ((in) + 7 * w - 1))));                                \
+    store((T*) ((out) + 6 * w), xor(m##6, load((const T*) ((in) + 6 * w - 1))));                                \
+    store((T*) ((out) + 5 * w), xor(m##5, load((const T*) ((in) + 5 * w - 1))));                                \
+    store((T*) ((out) + 4 * w), xor(m##4, load((const T*) ((in) + 4 * w - 1))));                                \
+    store((T*) ((out) + 3 * w), xor(m##3, load((const T*) ((in) + 3 * w - 1))));                                \
+    store((T*) ((out) + 2 * w), xor(m##2, load((const T*) ((in) + 2 * w - 1))));                                \
+    store((T*) ((out) + 1 * w), xor(m##1, load((const T*) ((in) + 1 * w - 1))));                                \
+    store((T*) (out), xor(m##0, prev0));
+/* 8 registers of blocks from in, register j holds blocks j * w ... */
+#define AES_LOAD_X8(T, load, m, in, w)                                                                       \
+    m##0 = load((const T*) ((in) + 0 * w)); m##1 = load((const T*) ((in) + 1 * w));                             \
+    m##2 = load((const T*) ((in) + 2 * w)); m##3 = load((const T*) ((in) + 3 * w));                             \
+    m##4 = load((const T*) ((in) + 4 * w)); m##5 = load((const T*) ((in) + 5 * w));                             \
+    m##6 = load((const T*) ((in) + 6 * w)); m##7 = load((const T*) ((in) + 7 * w));
+
+/* Generates an AES-NI CBC decryption kernel: 8 blocks in flight, leftovers one block at a time */
+#define AES_CBC_DEC_AESNI_FN(name, KEYS, BLOCK)                                                                   \
+    TARGET("aes") static void name(const uint8_t* s, uint8_t iv[16], const uint8_t (*in)[16], uint8_t (*out)[16], size_t n) { \
+        KEYS(get_key, k, s)                                                                                       \
+        __m128i chain = _mm_loadu_si128((const __m128i*) iv), m0, m1, m2, m3, m4, m5, m6, m7;                     \
+        for (; n >= 8; n -= 8, in += 8, out += 8) {                                                               \
+            AES_LOAD_X8(__m128i, _mm_loadu_si128, m, in, 1)                                                       \
+            const __m128i last = m7;                                                                              \
+            BLOCK(AES_X8_AMD64, m, k)                                                                             \
+            AES_CBC_XOR_X8(__m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_xor_si128, m, in, out, 1, chain)       \
+            chain = last;                                                                                         \
+        }                                                                                                         \
+        for (; n; n--, in++, out++) {                                                                             \
+            m0 = _mm_loadu_si128((const __m128i*) in);                                                            \
+            const __m128i last = m0;                                                                              \
+            BLOCK(AES_X1_AMD64, m0, k)                                                                            \
+            _mm_storeu_si128((__m128i*) out, _mm_xor_si128(m0, chain));                                           \
+            chain = last;                                                                                         \
+        }                                                                                                         \
+        _mm_storeu_si128((__m128i*) iv, chain);                                                                   \
+    }
+AES_CBC_DEC_AESNI_FN(aes128_cbc_decrypt_aesni, AES128_DEC_KEYS, AES128_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes192_cbc_decrypt_aesni, AES192_DEC_KEYS, AES192_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes256_cbc_decrypt_aesni, AES256_DEC_KEYS, AES256_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes128_cbc_decrypt_dec_aesni, AES128_DEC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes192_cbc_decrypt_dec_aesni, AES192_DEC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes256_cbc_decrypt_dec_aesni, AES256_DEC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes128_cbc_decrypt_enc_aesni, AES128_DEC_ENC_SCHED_KEYS, AES128_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes192_cbc_decrypt_enc_aesni, AES192_DEC_ENC_SCHED_KEYS, AES192_DEC_BLOCK_AMD64)
+AES_CBC_DEC_AESNI_FN(aes256_cbc_decrypt_enc_aesni, AES256_DEC_ENC_SCHED_KEYS, AES256_DEC_BLOCK_AMD64)
+#undef AES_CBC_DEC_AESNI_FN
+
+/* Generates a VAES CBC decryption kernel (256: 16 blocks in flight, 512: 32 blocks in flight), leftovers go to the AES-NI kernel.
+ * chain keeps the previous ciphertext block in its top lane, SHIFT(chain, c) = [chain top lane, c minus its top lane] */
+#define AES_CBC_DEC_VAES_FN(name, KEYS, BLOCK, tail_fn, W, isa, T, w, broadcast, load, store, xor, SHIFT, TOP)  \
+    TARGET(isa) static void name(const uint8_t* s, uint8_t iv[16], const uint8_t (*in)[16], uint8_t (*out)[16], size_t n) { \
+        if (n >= 8 * w) {                                                                                         \
+            KEYS(get_key_vaes##W, k, s)                                                                           \
+            T chain = broadcast(_mm_loadu_si128((const __m128i*) iv)), m0, m1, m2, m3, m4, m5, m6, m7;            \
+            for (; n >= 8 * w; n -= 8 * w, in += 8 * w, out += 8 * w) {                                           \
+                AES_LOAD_X8(T, load, m, in, w)                                                                    \
+                const T last = m7;                                                                                \
+                BLOCK(AES_X8_VAES##W, m, k)                                                                       \
+                AES_CBC_XOR_X8(T, load, store, xor, m, in, out, w, SHIFT(chain, load((const T*) in)))             \
+                chain = last;                                                                                     \
+            }                                                                                                     \
+            _mm_storeu_si128((__m128i*) iv, TOP(chain));                                                          \
+        }                                                                                                         \
+        if (n) tail_fn(s, iv, in, out, n);                                                                        \
+    }
+#define AES_CBC_SHIFT_VAES256(chain, c) _mm256_permute2x128_si256(chain, c, 0x21)
+#define AES_CBC_SHIFT_VAES512(chain, c) _mm512_alignr_epi64(c, chain, 6)
+#define AES_CBC_TOP_VAES256(chain) _mm256_extracti128_si256(chain, 1)
+#define AES_CBC_TOP_VAES512(chain) _mm512_extracti32x4_epi32(chain, 3)
+#define AES_CBC_DEC_VAES256_FN(name, KEYS, BLOCK, tail_fn) AES_CBC_DEC_VAES_FN(name, KEYS, BLOCK, tail_fn, 256, "aes,vaes,avx2", \
+    __m256i, 2, _mm256_broadcastsi128_si256, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_xor_si256, AES_CBC_SHIFT_VAES256, AES_CBC_TOP_VAES256)
+#define AES_CBC_DEC_VAES512_FN(name, KEYS, BLOCK, tail_fn) AES_CBC_DEC_VAES_FN(name, KEYS, BLOCK, tail_fn, 512, "aes,vaes,avx512f", \
+    __m512i, 4, _mm512_broadcast_i32x4, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_xor_si512, AES_CBC_SHIFT_VAES512, AES_CBC_TOP_VAES512)
+/* One kernel per schedule type & width */
+#define AES_CBC_DEC_VAES_FNS(bits, W)                                                                             \
+    AES_CBC_DEC_VAES##W##_FN(aes##bits##_cbc_decrypt_vaes##W, AES##bits##_DEC_KEYS, AES##bits##_DEC_BLOCK_AMD64, aes##bits##_cbc_decrypt_aesni) \
+    AES_CBC_DEC_VAES##W##_FN(aes##bits##_cbc_decrypt_dec_vaes##W, AES##bits##_DEC_SCHED_KEYS, AES##bits##_DEC_BLOCK_AMD64, aes##bits##_cbc_decrypt_dec_aesni) \
+    AES_CBC_DEC_VAES##W##_FN(aes##bits##_cbc_decrypt_enc_vaes##W, AES##bits##_DEC_ENC_SCHED_KEYS, AES##bits##_DEC_BLOCK_AMD64, aes##bits##_cbc_decrypt_enc_aesni)
+AES_CBC_DEC_VAES_FNS(128, 256)
+AES_CBC_DEC_VAES_FNS(192, 256)
+AES_CBC_DEC_VAES_FNS(256, 256)
+AES_CBC_DEC_VAES_FNS(128, 512)
+AES_CBC_DEC_VAES_FNS(192, 512)
+AES_CBC_DEC_VAES_FNS(256, 512)
+#undef AES_CBC_DEC_VAES_FNS
+#undef AES_CBC_DEC_VAES256_FN
+#undef AES_CBC_DEC_VAES512_FN
+#undef AES_CBC_DEC_VAES_FN
+
+/* Generates the generic CBC decryption (up to 32 blocks at a time through the dispatched decrypt transform,
+ * ciphertext copied aside first so in-place calls keep their chaining blocks) */
+#define AES_CBC_DEC_GENERIC_FN(name, blocks_fn, sched_t)                                                          \
+    static void name(const uint8_t* s, uint8_t iv[16], const uint8_t (*in)[16], uint8_t (*out)[16], size_t n) { \
+        uint8_t c[33][16];                                                                                        \
+        memcpy(c[0], iv, 16);                                                                                     \
+        while (n) {                                                                                               \
+            const size_t used = n < 32 ? n : 32;                                                                  \
+            memcpy(c[1], in, used << 4);                                                                          \
+            blocks_fn((const sched_t*) s, (const uint8_t (*)[16]) c + 1, out, used);                              \
+            for (size_t i = 0; i < used; i++) xor_bytes(out[i], out[i], c[i], 16);                                \
+            memcpy(c[0], c[used], 16);                                                                            \
+            n -= used; in += used; out += used;                                                                   \
+        }                                                                                                         \
+        memcpy(iv, c[0], 16);                                                                                     \
+    }
+#define AES_CBC_DEC_GENERIC_FNS(bits)                                                                             \
+    AES_CBC_DEC_GENERIC_FN(aes##bits##_cbc_decrypt_generic, aes##bits##_decrypt_blocks, aes##bits##_sched_full_t) \
+    AES_CBC_DEC_GENERIC_FN(aes##bits##_cbc_decrypt_dec_generic, aes##bits##_decrypt_blocks_dec, aes##bits##_sched_dec_t) \
+    AES_CBC_DEC_GENERIC_FN(aes##bits##_cbc_decrypt_enc_generic, aes##bits##_decrypt_blocks_enc, aes##bits##_sched_enc_t)
+AES_CBC_DEC_GENERIC_FNS(128)
+AES_CBC_DEC_GENERIC_FNS(192)
+AES_CBC_DEC_GENERIC_FNS(256)
+#undef AES_CBC_DEC_GENERIC_FNS
+#undef AES_CBC_DEC_GENERIC_FN
+
+/* --- Multi-buffer internal ---
+ * Serial modes run one block per stream per pass, streams side by side: lane l of the registers (8 xmm, 8 ymm or 4 zmm)
+ * carries one stream. A stream taking a lane copies its round keys into column l of rk[round][lane], so every register
+ * loads its round key with one vector load (shared or different schedules alike), its chaining value sits in st[l].
+ * A step runs all lanes for as many blocks as the shortest active stream has left (at most AES_MB_STEP), idle lanes
+ * read & write the scratch area. Streams done (or with only a partial block left) hand their lane to the next waiting one.
+ */
+#define AES_MB_CBC 0
+#define AES_MB_CFB 1
+#define AES_MB_OFB 2
+#define AES_MB_MAC 3 /* CBC without the output */
+#define AES_MB_STEP  32
+#define AES_MB_LANES 16 /* most lanes of any kernel */
+#define AES_MB_KEYS(bits) ((bits) / 32 + 7) /* 11, 13, 15 round keys */
+#define AES_MB_IDLE ((size_t) -1)
+
+/* Round key names for the *_ENC_BLOCK_AMD64 macros: k##i becomes the round index the appliers below read from rk */
+#define AES_MB_RK_0  0
+#define AES_MB_RK_1  1
+#define AES_MB_RK_2  2
+#define AES_MB_RK_3  3
+#define AES_MB_RK_4  4
+#define AES_MB_RK_5  5
+#define AES_MB_RK_6  6
+#define AES_MB_RK_7  7
+#define AES_MB_RK_8  8
+#define AES_MB_RK_9  9
+#define AES_MB_RK_10 10
+#define AES_MB_RK_11 11
+#define AES_MB_RK_12 12
+#define AES_MB_RK_13 13
+#define AES_MB_RK_14 14
+
+/* Per tier register ops (V: aesni - 1 lane per xmm, vaes256 - 2 per ymm, vaes512 - 4 per zmm) */
+#define AES_MB_T_aesni       __m128i
+#define AES_MB_LOAD_aesni    _mm_loadu_si128
+#define AES_MB_STORE_aesni   _mm_storeu_si128
+#define AES_MB_XOR_aesni     _mm_xor_si128
+#define AES_MB_T_vaes256     __m256i
+#define AES_MB_LOAD_vaes256  _mm256_loadu_si256
+#define AES_MB_STORE_vaes256 _mm256_storeu_si256
+#define AES_MB_XOR_vaes256   _mm256_xor_si256
+#define AES_MB_T_vaes512     __m512i
+#define AES_MB_LOAD_vaes512  _mm512_loadu_si512
+#define AES_MB_STORE_vaes512 _mm512_storeu_si512
+#define AES_MB_XOR_vaes512   _mm512_xor_si512
+
+/* Block at offset o of each lane's buffer as one register (gather) & back (scatter), p points at the register's first lane */
+static inline __m128i aes_mb_gather_aesni(const uint8_t* const* p, size_t o) { return _mm_loadu_si128((const __m128i*) (p[0] + o)); }
+static inline void aes_mb_scatter_aesni(uint8_t* const* p, size_t o, __m128i x) { _mm_storeu_si128((__m128i*) (p[0] + o), x); }
+TARGET("avx2") static inline __m256i aes_mb_gather_vaes256(const uint8_t* const* p, size_t o) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) (p[0] + o))), _mm_loadu_si128((const __m128i*) (p[1] + o)), 1);
+}
+TARGET("avx2") static inline void aes_mb_scatter_vaes256(uint8_t* const* p, size_t o, __m256i x) {
+    _mm_storeu_si128((__m128i*) (p[0] + o), _mm256_castsi256_si128(x));
+    _mm_storeu_si128((__m128i*) (p[1] + o), _mm256_extracti128_si256(x, 1));
+}
+TARGET("avx512f") static inline __m512i aes_mb_gather_vaes512(const uint8_t* const* p, size_t o) {
+    __m512i x = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*) (p[0] + o)));
+    x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*) (p[1] + o)), 1);
+    x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*) (p[2] + o)), 2);
+    return _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*) (p[3] + o)), 3);
+}
+TARGET("avx512f") static inline void aes_mb_scatter_vaes512(uint8_t* const* p, size_t o, __m512i x) {
+    _mm_storeu_si128((__m128i*) (p[0] + o), _mm512_castsi512_si128(x));
+    _mm_storeu_si128((__m128i*) (p[1] + o), _mm512_extracti32x4_epi32(x, 1));
+    _mm_storeu_si128((__m128i*) (p[2] + o), _mm512_extracti32x4_epi32(x, 2));
+    _mm_storeu_si128((__m128i*) (p[3] + o), _mm512_extracti32x4_epi32(x, 3));
+}
+
+/* Round appliers: register j takes lanes j * w ... of round r from rk */
+#define AES_X8_MB_aesni(op, m, r)   AES_MB_EACH_X8(AES_MB_ROUND, op, r, aesni, 1)
+#define AES_X8_MB_vaes256(op, m, r) AES_MB_EACH_X8(AES_MB_ROUND, VAES256_##op, r, vaes256, 2)
+#define AES_X4_MB_vaes512(op, m, r) AES_MB_EACH_X4(AES_MB_ROUND, VAES512_##op, r, vaes512, 4)
+#define AES_MB_ROUND(m, j, op, r, V, w) m = op(m, AES_MB_LOAD_##V((const AES_MB_T_##V*) rk[r] + (j)));
+/* F(register, index, a, b, V, w) over the kernel's registers */
+#define AES_MB_EACH_X4(F, a, b, V, w) F(m0, 0, a, b, V, w) F(m1, 1, a, b, V, w) F(m2, 2, a, b, V, w) F(m3, 3, a, b, V, w)
+#define AES_MB_EACH_X8(F, a, b, V, w) AES_MB_EACH_X4(F, a, b, V, w) \
+    F(m4, 4, a, b, V, w) F(m5, 5, a, b, V, w) F(m6, 6, a, b, V, w) F(m7, 7, a, b, V, w)
+
+/* Per register steps: declare, chaining values in & out of st, mode work before & after the block cipher
+ * (CBC: E(st ^ P) = C = st | CFB: E(st) ^ P = C = st | OFB: E(st) = st, C = P ^ st | MAC: E(st ^ P) = st) */
+#define AES_MB_DECL(m, j, a, b, V, w)     AES_MB_T_##V m;
+#define AES_MB_LOAD_ST(m, j, a, b, V, w)  m = AES_MB_LOAD_##V((const AES_MB_T_##V*) st + (j));
+#define AES_MB_STORE_ST(m, j, a, b, V, w) AES_MB_STORE_##V((AES_MB_T_##V*) st + (j), m);
+#define AES_MB_PRE(m, j, mode, b, V, w)                                                                    \
+    if (mode == AES_MB_CBC || mode == AES_MB_MAC) m = AES_MB_XOR_##V(m, aes_mb_gather_##V(src + (j) * (w), o));
+#define AES_MB_POST(m, j, mode, b, V, w)                                                                   \
+    if (mode == AES_MB_CBC) aes_mb_scatter_##V(dst + (j) * (w), o, m);                                      \
+    if (mode == AES_MB_CFB) { m = AES_MB_XOR_##V(m, aes_mb_gather_##V(src + (j) * (w), o)); aes_mb_scatter_##V(dst + (j) * (w), o, m); } \
+    if (mode == AES_MB_OFB) aes_mb_scatter_##V(dst + (j) * (w), o, AES_MB_XOR_##V(m, aes_mb_gather_##V(src + (j) * (w), o)));
+
+/* Generates the stream epilogue: iv = chaining value, a partial last block (CFB / OFB) xored with E(chaining value)
+ * (st is the stream's own iv for streams shorter than a block) */
+#define AES_MB_FINISH_FN(bits)                                                                                    \
+    static void aes##bits##_mb_finish(const aes##bits##_sched_enc_t* s, int mode, aes_mb_stream_t* x, const uint8_t* in, uint8_t* out, size_t left, const uint8_t st[16]) { \
+        if (st != x->iv) memcpy(x->iv, st, 16);                                                                   \
+        if ((mode == AES_MB_CFB || mode == AES_MB_OFB) && left) {                                                 \
+            uint8_t ks[16];                                                                                       \
+            aes##bits##_encrypt_blocks(s, (const uint8_t (*)[16]) st, (uint8_t (*)[16]) ks, 1);                  \
+            xor_bytes(out, in, ks, left);                                                                         \
+        }                                                                                                         \
+    }
+AES_MB_FINISH_FN(128)
+AES_MB_FINISH_FN(192)
+AES_MB_FINISH_FN(256)
+#undef AES_MB_FINISH_FN
+
+/* Generates a multi-buffer kernel: R registers of w lanes (V tier) for mode (AES_MB_*) */
+#define AES_MB_FN(name, bits, mode, V, R, w, isa)                                                                  \
+    TARGET(isa) static void name(const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num) { \
+        uint8_t rk[AES_MB_KEYS(bits)][R * w][16] = {{{ 0 }}}, st[R * w][16] = {{ 0 }}, scratch[AES_MB_STEP][16] = {{ 0 }}; \
+        size_t idx[R * w], left[R * w], next = 0;                                                                 \
+        const uint8_t* in[R * w]; uint8_t* out[R * w];                                                            \
+        const uint8_t* src[R * w]; uint8_t* dst[R * w];                                                           \
+        AES_MB_EACH_X##R(AES_MB_DECL, 0, 0, V, w)                                                                 \
+        for (size_t l = 0; l < R * w; l++) idx[l] = AES_MB_IDLE;                                                  \
+        for (;;) {                                                                                                \
+            size_t step = AES_MB_STEP, active = 0;                                                                \
+            for (size_t l = 0; l < R * w; l++) {                                                                  \
+                if (idx[l] != AES_MB_IDLE && left[l] < 16) {                                                      \
+                    aes##bits##_mb_finish(schedules[idx[l]], mode, streams + idx[l], in[l], out[l], left[l], st[l]); \
+                    idx[l] = AES_MB_IDLE;                                                                         \
+                }                                                                                                 \
+                for (; idx[l] == AES_MB_IDLE && next < num; next++) {                                             \
+                    aes_mb_stream_t* x = streams + next;                                                          \
+                    if (x->len < 16) { aes##bits##_mb_finish(schedules[next], mode, x, x->in, x->out, x->len, x->iv); continue; } \
+                    idx[l] = next; in[l] = x->in; out[l] = mode == AES_MB_MAC ? scratch[0] : x->out; left[l] = x->len; \
+                    memcpy(st[l], x->iv, 16);                                                                     \
+                    for (size_t r = 0; r < AES_MB_KEYS(bits); r++) memcpy(rk[r][l], schedules[next]->bytes + 16 * r, 16); \
+                }                                                                                                 \
+                if (idx[l] == AES_MB_IDLE) { src[l] = dst[l] = scratch[0]; continue; }                            \
+                if (left[l] >> 4 < step) step = left[l] >> 4;                                                     \
+                src[l] = in[l]; dst[l] = out[l]; active++;                                                        \
+            }                                                                                                     \
+            if (!active) break;                                                                                   \
+            AES_MB_EACH_X##R(AES_MB_LOAD_ST, 0, 0, V, w)                                                          \
+            for (size_t o = 0; o < step << 4; o += 16) {                                                          \
+                AES_MB_EACH_X##R(AES_MB_PRE, mode, 0, V, w)                                                       \
+                AES##bits##_ENC_BLOCK_AMD64(AES_X##R##_MB_##V, m, AES_MB_RK_)                                     \
+                AES_MB_EACH_X##R(AES_MB_POST, mode, 0, V, w)                                                      \
+            }                                                                                                     \
+            AES_MB_EACH_X##R(AES_MB_STORE_ST, 0, 0, V, w)                                                         \
+            for (size_t l = 0; l < R * w; l++)                                                                    \
+                if (idx[l] != AES_MB_IDLE) { in[l] += step << 4; out[l] += mode == AES_MB_MAC ? 0 : step << 4; left[l] -= step << 4; } \
+        }                                                                                                         \
+    }
+/* All four modes for one key size & tier */
+#define AES_MB_FNS(bits, V, R, w, isa)                                                                            \
+    AES_MB_FN(aes##bits##_cbc_encrypt_mb_##V, bits, AES_MB_CBC, V, R, w, isa)                                     \
+    AES_MB_FN(aes##bits##_cfb_encrypt_mb_##V, bits, AES_MB_CFB, V, R, w, isa)                                     \
+    AES_MB_FN(aes##bits##_ofb_xor_mb_##V, bits, AES_MB_OFB, V, R, w, isa)                                         \
+    AES_MB_FN(aes##bits##_cbc_mac_mb_##V, bits, AES_MB_MAC, V, R, w, isa)
+AES_MB_FNS(128, aesni, 8, 1, "aes")
+AES_MB_FNS(192, aesni, 8, 1, "aes")
+AES_MB_FNS(256, aesni, 8, 1, "aes")
+AES_MB_FNS(128, vaes256, 8, 2, "aes,vaes,avx2")
+AES_MB_FNS(192, vaes256, 8, 2, "aes,vaes,avx2")
+AES_MB_FNS(256, vaes256, 8, 2, "aes,vaes,avx2")
+AES_MB_FNS(128, vaes512, 4, 4, "aes,vaes,avx512f")
+AES_MB_FNS(192, vaes512, 4, 4, "aes,vaes,avx512f")
+AES_MB_FNS(256, vaes512, 4, 4, "aes,vaes,avx512f")
+#undef AES_MB_FNS
+#undef AES_MB_FN
+
+/* Generates the generic multi-buffer modes (one stream after the other, one block per dispatched encrypt call) */
+#define AES_MB_GENERIC_FN(name, bits, mode)                                                                       \
+    static void name(const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num) {     \
+        for (size_t i = 0; i < num; i++) {                                                                        \
+            aes_mb_stream_t* x = streams + i;                                                                     \
+            const uint8_t* in = x->in; uint8_t* out = x->out;                                                     \
+            size_t left = x->len;                                                                                 \
+            uint8_t st[16], ks[16];                                                                               \
+            memcpy(st, x->iv, 16);                                                                                \
+            for (; left >= 16; left -= 16, in += 16, out += mode == AES_MB_MAC ? 0 : 16) {                        \
+                if (mode == AES_MB_CBC || mode == AES_MB_MAC) xor_bytes(st, st, in, 16);                          \
+                aes##bits##_encrypt_blocks(schedules[i], (const uint8_t (*)[16]) st, (uint8_t (*)[16]) ks, 1);     \
+                if (mode == AES_MB_MAC) memcpy(st, ks, 16);                                                       \
+                else if (mode == AES_MB_OFB) { memcpy(st, ks, 16); xor_bytes(out, in, ks, 16); }                  \
+                else { if (mode == AES_MB_CFB) xor_bytes(ks, ks, in, 16); memcpy(st, ks, 16); memcpy(out, ks, 16); } \
+            }                                                                                                     \
+            aes##bits##_mb_finish(schedules[i], mode, x, in, out, left, st);                                      \
+        }                                                                                                         \
+    }
+#define AES_MB_GENERIC_FNS(bits)                                                                                  \
+    AES_MB_GENERIC_FN(aes##bits##_cbc_encrypt_mb_generic, bits, AES_MB_CBC)                                       \
+    AES_MB_GENERIC_FN(aes##bits##_cfb_encrypt_mb_generic, bits, AES_MB_CFB)                                       \
+    AES_MB_GENERIC_FN(aes##bits##_ofb_xor_mb_generic, bits, AES_MB_OFB)                                           \
+    AES_MB_GENERIC_FN(aes##bits##_cbc_mac_mb_generic, bits, AES_MB_MAC)
+AES_MB_GENERIC_FNS(128)
+AES_MB_GENERIC_FNS(192)
+AES_MB_GENERIC_FNS(256)
+#undef AES_MB_GENERIC_FNS
+#undef AES_MB_GENERIC_FN
+
+/* --- XTS internal ---
+ * Block j of a data unit (sector) uses tweak T_j = E2(iv) * alpha^j in GF(2^128), with the tweak read as a 128 bit
+ * little-endian integer (alpha = x: shift left by one, the bit out of the top folds back as 0x87).
+ * A pass keeps the tweaks of 8 registers of blocks and moves each one by alpha^(blocks per pass) independently,
+ * so there is no serial doubling chain. The units of a call take their E2(iv) 8 at a time.
+ * A partial last block steals the tail of the last whole block's output (ciphertext stealing). Decryption uses
+ * the last two tweaks in swapped order.
+ */
+#define AES_XTS_MIN_LEN 16
+
+/* Generates t * alpha^n on each 128-bit lane, 1 <= n <= 56 (the n bits out of the top, times 0x87, stay in the low qword)
+ * up / down move the low / high qword of each lane to the other half & zero the rest */
+#define AES_XTS_MUL_ALPHA_FN(name, isa, T, sll, srl, up, down, xor, or)                                            \
+    TARGET(isa) static inline T name(T t, int n) {                                                                \
+        const __m128i l = _mm_cvtsi32_si128(n), r = _mm_cvtsi32_si128(64 - n);                                    \
+        const T c = srl(down(t), r); /* top n bits */                                                             \
+        t = or(sll(t, l), srl(up(t), r));                                                                         \
+        return xor(xor(t, c), xor(sll(c, _mm_cvtsi32_si128(1)), xor(sll(c, _mm_cvtsi32_si128(2)), sll(c, _mm_cvtsi32_si128(7))))); \
+    }
+#define AES_XTS_UP(t)          _mm_slli_si128(t, 8)
+#define AES_XTS_DOWN(t)        _mm_srli_si128(t, 8)
+#define AES_XTS_UP_VAES256(t)   _mm256_slli_si256(t, 8)
+#define AES_XTS_DOWN_VAES256(t) _mm256_srli_si256(t, 8)
+#define AES_XTS_UP_VAES512(t)   _mm512_maskz_shuffle_epi32(0xCCCC, t, _MM_PERM_BADC) /* AVX512F (no BW byte shifts) */
+#define AES_XTS_DOWN_VAES512(t) _mm512_maskz_shuffle_epi32(0x3333, t, _MM_PERM_BADC)
+AES_XTS_MUL_ALPHA_FN(aes_xts_mul_alpha, "sse2", __m128i, _mm_sll_epi64, _mm_srl_epi64, AES_XTS_UP, AES_XTS_DOWN, _mm_xor_si128, _mm_or_si128)
+AES_XTS_MUL_ALPHA_FN(aes_xts_mul_alpha_vaes256, "avx2", __m256i, _mm256_sll_epi64, _mm256_srl_epi64, AES_XTS_UP_VAES256, AES_XTS_DOWN_VAES256,
+                     _mm256_xor_si256, _mm256_or_si256)
+AES_XTS_MUL_ALPHA_FN(aes_xts_mul_alpha_vaes512, "avx512f", __m512i, _mm512_sll_epi64, _mm512_srl_epi64, AES_XTS_UP_VAES512, AES_XTS_DOWN_VAES512,
+                     _mm512_xor_si512, _mm512_or_si512)
+#undef AES_XTS_MUL_ALPHA_FN
+
+/* Ciphertext stealing on the last whole block & the r byte partial block after it (at in / out): tweak a on the first
+ * transform, b on the second (encryption: T_n then T_n+1, decryption: swapped), ONE(x, arg) transforms block x in place */
+#define AES_XTS_STEAL(ONE, arg, a, b, in, out, r) {                                                               \
+    uint8_t _x[16], _last[16];                                                                                    \
+    xor_bytes(_x, in, a, 16); ONE(_x, arg) xor_bytes(_x, _x, a, 16);                                              \
+    memcpy(_last, _x, 16); memcpy(_last, (in) + 16, r); memcpy((out) + 16, _x, r); /* partial input read first */ \
+    xor_bytes(_last, _last, b, 16); ONE(_last, arg) xor_bytes(out, _last, b, 16);                                  \
+}
+#define AES_XTS_ONE_AMD64(x, BLOCK) { __m128i _m = _mm_loadu_si128((const __m128i*) (x)); BLOCK(AES_X1_AMD64, _m, k) _mm_storeu_si128((__m128i*) (x), _m); }
+#define AES_XTS_ONE_GENERIC(x, fn) fn(s, (uint8_t (*)[16]) (x), 1);
+
+/* 8 registers of w blocks: m = in ^ t, out = m ^ t, t *= alpha^(8 * w) */
+#define AES_XTS_PRE_X8(T, load, xor, m, t, in, w)                                                                 \
+    m##0 = xor(load((const T*) (in) + 0), t##0); m##1 = xor(load((const T*) (in) + 1), t##1);                    \
+    m##2 = xor(load((const T*) (in) + 2), t##2); m##3 = xor(load((const T*) (in) + 3), t##3);                    \
+    m##4 = xor(load((const T*) (in) + 4), t##4); m##5 = xor(load((const T*) (in) + 5), t##5);                    \
+    m##6 = xor(load((const T*) (in) + 6), t##6); m##7 = xor(load((const T*) (in) + 7), t##7);
+#define AES_XTS_POST_X8(T, store, xor, m, t, out, w)                                                              \
+    store((T*) (out) + 0, xor(m##0, t##0)); store((T*) (out) + 1, xor(m##1, t##1));                              \
+    store((T*) (out) + 2, xor(m##2, t##2)); store((T*) (out) + 3, xor(m##3, t##3));                              \
+    store((T*) (out) + 4, xor(m##4, t##4)); store((T*) (out) + 5, xor(m##5, t##5));                              \
+    store((T*) (out) + 6, xor(m##6, t##6)); store((T*) (out) + 7, xor(m##7, t##7));
+#define AES_XTS_NEXT_X8(mul, t, w)                                                                                \
+    t##0 = mul(t##0, 8 * w); t##1 = mul(t##1, 8 * w); t##2 = mul(t##2, 8 * w); t##3 = mul(t##3, 8 * w);         \
+    t##4 = mul(t##4, 8 * w); t##5 = mul(t##5, 8 * w); t##6 = mul(t##6, 8 * w); t##7 = mul(t##7, 8 * w);
+
+/* Generates an AES-NI XTS data unit kernel (tweak = E2(iv), len >= 16): 8 blocks in flight, leftovers one at a time */
+#define AES_XTS_AESNI_FN(name, KEYS, BLOCK, enc)                                                                  \
+    TARGET("aes") static void name(const uint8_t* s, const uint8_t tweak[16], const uint8_t* in, uint8_t* out, size_t len) { \
+        KEYS(get_key, k, s)                                                                                       \
+        size_t n = (len >> 4) - ((len & 15) != 0); /* whole blocks before the stealing pair */                    \
+        __m128i t = _mm_loadu_si128((const __m128i*) tweak), m0, m1, m2, m3, m4, m5, m6, m7;                      \
+        if (n >= 8) {                                                                                             \
+            __m128i t0 = t, t1 = aes_xts_mul_alpha(t, 1), t2 = aes_xts_mul_alpha(t, 2), t3 = aes_xts_mul_alpha(t, 3), \
+                    t4 = aes_xts_mul_alpha(t, 4), t5 = aes_xts_mul_alpha(t, 5), t6 = aes_xts_mul_alpha(t, 6), t7 = aes_xts_mul_alpha(t, 7); \
+            for (; n >= 8; n -= 8, in += 128, out += 128) {                                                       \
+                AES_XTS_PRE_X8(__m128i, _mm_loadu_si128, _mm_xor_si128, m, t, in, 1)                              \
+                BLOCK(AES_X8_AMD64, m, k)                                                                         \
+                AES_XTS_POST_X8(__m128i, _mm_storeu_si128, _mm_xor_si128, m, t, out, 1)                           \
+                AES_XTS_NEXT_X8(aes_xts_mul_alpha, t, 1)                                                          \
+            }                                                                                                     \
+            t = t0;                                                                                               \
+        }                                                                                                         \
+        for (; n; n--, in += 16, out += 16, t = aes_xts_mul_alpha(t, 1)) {                                        \
+            m0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*) in), t);                                          \
+            BLOCK(AES_X1_AMD64, m0, k)                                                                            \
+            _mm_storeu_si128((__m128i*) out, _mm_xor_si128(m0, t));                                               \
+        }                                                                                                         \
+        if (len & 15) {                                                                                           \
+            uint8_t tn[16], tn1[16];                                                                              \
+            _mm_storeu_si128((__m128i*) tn, t); _mm_storeu_si128((__m128i*) tn1, aes_xts_mul_alpha(t, 1));       \
+            AES_XTS_STEAL(AES_XTS_ONE_AMD64, BLOCK, (enc ? tn : tn1), (enc ? tn1 : tn), in, out, len & 15)        \
+        }                                                                                                         \
+    }
+AES_XTS_AESNI_FN(aes128_xts_enc_unit_aesni, AES128_ENC_KEYS, AES128_ENC_BLOCK_AMD64, true)
+AES_XTS_AESNI_FN(aes256_xts_enc_unit_aesni, AES256_ENC_KEYS, AES256_ENC_BLOCK_AMD64, true)
+AES_XTS_AESNI_FN(aes128_xts_dec_unit_aesni, AES128_DEC_KEYS, AES128_DEC_BLOCK_AMD64, false)
+AES_XTS_AESNI_FN(aes256_xts_dec_unit_aesni, AES256_DEC_KEYS, AES256_DEC_BLOCK_AMD64, false)
+#undef AES_XTS_AESNI_FN
+
+/* Generates a VAES XTS data unit kernel (256: 16 blocks in flight, 512: 32 blocks in flight), the rest goes to the AES-NI kernel.
+ * Register j holds the tweaks of blocks j * w ... from LANES(t) = (t, t * alpha ...) */
+#define AES_XTS_VAES_FN(name, KEYS, BLOCK, tail_fn, W, isa, T, w, load, store, xor, LANES, LOW)                   \
+    TARGET(isa) static void name(const uint8_t* s, const uint8_t tweak[16], const uint8_t* in, uint8_t* out, size_t len) { \
+        size_t n = (len >> 4) - ((len & 15) != 0);                                                               \
+        uint8_t t_next[16];                                                                                       \
+        if (n >= 8 * w) {                                                                                         \
+            KEYS(get_key_vaes##W, k, s)                                                                           \
+            const __m128i t = _mm_loadu_si128((const __m128i*) tweak);                                            \
+            T m0, m1, m2, m3, m4, m5, m6, m7, t0 = LANES(t), t1 = aes_xts_mul_alpha_vaes##W(t0, 1 * w),           \
+              t2 = aes_xts_mul_alpha_vaes##W(t0, 2 * w), t3 = aes_xts_mul_alpha_vaes##W(t0, 3 * w),               \
+              t4 = aes_xts_mul_alpha_vaes##W(t0, 4 * w), t5 = aes_xts_mul_alpha_vaes##W(t0, 5 * w),               \
+              t6 = aes_xts_mul_alpha_vaes##W(t0, 6 * w), t7 = aes_xts_mul_alpha_vaes##W(t0, 7 * w);               \
+            for (; n >= 8 * w; n -= 8 * w, len -= 128 * w, in += 128 * w, out += 128 * w) {                       \
+                AES_XTS_PRE_X8(T, load, xor, m, t, in, w)                                                         \
+                BLOCK(AES_X8_VAES##W, m, k)                                                                       \
+                AES_XTS_POST_X8(T, store, xor, m, t, out, w)                                                      \
+                AES_XTS_NEXT_X8(aes_xts_mul_alpha_vaes##W, t, w)                                                  \
+            }                                                                                                     \
+            _mm_storeu_si128((__m128i*) t_next, LOW(t0));                                                         \
+            tweak = t_next;                                                                                       \
+        }                                                                                                         \
+        if (len) tail_fn(s, tweak, in, out, len);                                                                 \
+    }
+TARGET("avx2") static inline __m256i aes_xts_lanes_vaes256(__m128i t) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(t), aes_xts_mul_alpha(t, 1), 1);
+}
+TARGET("avx512f") static inline __m512i aes_xts_lanes_vaes512(__m128i t) {
+    const __m512i z = _mm512_inserti32x4(_mm512_castsi128_si512(t), aes_xts_mul_alpha(t, 1), 1);
+    return _mm512_inserti32x4(_mm512_inserti32x4(z, aes_xts_mul_alpha(t, 2), 2), aes_xts_mul_alpha(t, 3), 3);
+}
+#define AES_XTS_VAES256_FN(name, KEYS, BLOCK, tail_fn) AES_XTS_VAES_FN(name, KEYS, BLOCK, tail_fn, 256, "aes,vaes,avx2", __m256i, 2, \
+    _mm256_loadu_si256, _mm256_storeu_si256, _mm256_xor_si256, aes_xts_lanes_vaes256, _mm256_castsi256_si128)
+#define AES_XTS_VAES512_FN(name, KEYS, BLOCK, tail_fn) AES_XTS_VAES_FN(name, KEYS, BLOCK, tail_fn, 512, "aes,vaes,avx512f", __m512i, 4, \
+    _mm512_loadu_si512, _mm512_storeu_si512, _mm512_xor_si512, aes_xts_lanes_vaes512, _mm512_castsi512_si128)
+#define AES_XTS_VAES_FNS(bits, W)                                                                                 \
+    AES_XTS_VAES##W##_FN(aes##bits##_xts_enc_unit_vaes##W, AES##bits##_ENC_KEYS, AES##bits##_ENC_BLOCK_AMD64, aes##bits##_xts_enc_unit_aesni) \
+    AES_XTS_VAES##W##_FN(aes##bits##_xts_dec_unit_vaes##W, AES##bits##_DEC_KEYS, AES##bits##_DEC_BLOCK_AMD64, aes##bits##_xts_dec_unit_aesni)
+AES_XTS_VAES_FNS(128, 256)
+AES_XTS_VAES_FNS(256, 256)
+AES_XTS_VAES_FNS(128, 512)
+AES_XTS_VAES_FNS(256, 512)
+#undef AES_XTS_VAES_FNS
+#undef AES_XTS_VAES256_FN
+#undef AES_XTS_VAES512_FN
+#undef AES_XTS_VAES_FN
+
+/* Generates the generic XTS data unit (up to 32 blocks at a time through the dispatched transform fn, tweaks doubled in c) */
+#define AES_XTS_DOUBLE(lo, hi) { const uint64_t _c = (hi) >> 63; hi = ((hi) << 1) | ((lo) >> 63); lo = ((lo) << 1) ^ (0x87 & (0 - _c)); }
+#define AES_XTS_GENERIC_FN(name, fn, enc)                                                                         \
+    static void name(const uint8_t* s, const uint8_t tweak[16], const uint8_t* in, uint8_t* out, size_t len) {   \
+        uint8_t t[32][16], x[32][16], tn[16], tn1[16];                                                            \
+        uint64_t lo, hi;                                                                                          \
+        size_t n = (len >> 4) - ((len & 15) != 0);                                                                \
+        memcpy(&lo, tweak, 8); memcpy(&hi, tweak + 8, 8);                                                         \
+        while (n) {                                                                                               \
+            const size_t c = n < 32 ? n : 32;                                                                     \
+            for (size_t i = 0; i < c; i++) { memcpy(t[i], &lo, 8); memcpy(t[i] + 8, &hi, 8); AES_XTS_DOUBLE(lo, hi) } \
+            xor_bytes(x[0], in, t[0], c << 4);                                                                    \
+            fn(s, x, c);                                                                                          \
+            xor_bytes(out, x[0], t[0], c << 4);                                                                   \
+            n -= c; in += c << 4; out += c << 4;                                                                  \
+        }                                                                                                         \
+        if (len & 15) {                                                                                           \
+            memcpy(tn, &lo, 8); memcpy(tn + 8, &hi, 8); AES_XTS_DOUBLE(lo, hi)                                    \
+            memcpy(tn1, &lo, 8); memcpy(tn1 + 8, &hi, 8);                                                         \
+            AES_XTS_STEAL(AES_XTS_ONE_GENERIC, fn, (enc ? tn : tn1), (enc ? tn1 : tn), in, out, len & 15)         \
+        }                                                                                                         \
+    }
+#define AES_XTS_GENERIC_FNS(bits)                                                                                 \
+    static void aes##bits##_xts_enc_blocks_generic(const uint8_t* s, uint8_t (*x)[16], size_t n) {                \
+        aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) s, (const uint8_t (*)[16]) x, x, n);          \
+    }                                                                                                             \
+    static void aes##bits##_xts_dec_blocks_generic(const uint8_t* s, uint8_t (*x)[16], size_t n) {                \
+        aes##bits##_decrypt_blocks((const aes##bits##_sched_full_t*) s, (const uint8_t (*)[16]) x, x, n);         \
+    }                                                                                                             \
+    AES_XTS_GENERIC_FN(aes##bits##_xts_enc_unit_generic, aes##bits##_xts_enc_blocks_generic, true)                \
+    AES_XTS_GENERIC_FN(aes##bits##_xts_dec_unit_generic, aes##bits##_xts_dec_blocks_generic, false)
+AES_XTS_GENERIC_FNS(128)
+AES_XTS_GENERIC_FNS(256)
+#undef AES_XTS_GENERIC_FNS
+#undef AES_XTS_GENERIC_FN
+#undef AES_XTS_DOUBLE
+
+/* Tweak input of unit u: iv for a single message, else the 128-bit little-endian unit number (IEEE 1619) */
+static inline void aes_xts_unit_iv(uint8_t dst[16], const uint8_t* iv, uint64_t unit, size_t u) {
+    if (iv) { memcpy(dst, iv, 16); return; }
+    const uint64_t lo = unit + u, hi = lo < unit; /* carry past 2^64 */
+    memcpy(dst, &lo, 8); memcpy(dst + 8, &hi, 8);
+}
+
+/* Generates an XTS call for one tier: units of unit_len bytes, their tweaks encrypted 8 at a time (batched encrypt call) */
+#define AES_XTS_FN(name, bits, unit_fn)                                                                           \
+    static bool name(const uint8_t* s, const uint8_t* ts, const uint8_t* iv, uint64_t unit, const uint8_t* in, uint8_t* out, size_t unit_len, size_t num_units) { \
+        uint8_t tw[8][16];                                                                                        \
+        if (unit_len < AES_XTS_MIN_LEN) return false;                                                             \
+        for (size_t u = 0; u < num_units; u += 8) {                                                               \
+            const size_t nu = num_units - u < 8 ? num_units - u : 8;                                              \
+            for (size_t i = 0; i < nu; i++) aes_xts_unit_iv(tw[i], iv, unit, u + i);                              \
+            aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) ts, (const uint8_t (*)[16]) tw, tw, nu);  \
+            for (size_t i = 0; i < nu; i++, in += unit_len, out += unit_len) unit_fn(s, tw[i], in, out, unit_len); \
+        }                                                                                                         \
+        return true;                                                                                              \
+    }
+#define AES_XTS_FNS(T)                                                                                            \
+    AES_XTS_FN(aes128_xts_enc_##T, 128, aes128_xts_enc_unit_##T)                                                  \
+    AES_XTS_FN(aes256_xts_enc_##T, 256, aes256_xts_enc_unit_##T)                                                  \
+    AES_XTS_FN(aes128_xts_dec_##T, 128, aes128_xts_dec_unit_##T)                                                  \
+    AES_XTS_FN(aes256_xts_dec_##T, 256, aes256_xts_dec_unit_##T)
+AES_XTS_FNS(vaes512)
+AES_XTS_FNS(vaes256)
+AES_XTS_FNS(aesni)
+AES_XTS_FNS(generic)
+#undef AES_XTS_FNS
+#undef AES_XTS_FN
+
+typedef void (*aes_ctr_fn)(const uint8_t* s, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len);
+typedef void (*aes_cbc_fn)(const uint8_t* s, uint8_t iv[16], const uint8_t (*in)[16], uint8_t (*out)[16], size_t n);
+typedef void (*aes128_mb_fn)(const aes128_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num);
+typedef void (*aes192_mb_fn)(const aes192_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num);
+typedef void (*aes256_mb_fn)(const aes256_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num);
+typedef bool (*aes_xts_fn)(const uint8_t* s, const uint8_t* ts, const uint8_t* iv, uint64_t unit, const uint8_t* in, uint8_t* out, size_t unit_len, size_t num_units);
+typedef struct {
+    aes_ctr_fn ctr128, ctr192, ctr256;
+    aes_cbc_fn cbc_decrypt128, cbc_decrypt192, cbc_decrypt256;
+    aes_cbc_fn cbc_decrypt_dec128, cbc_decrypt_dec192, cbc_decrypt_dec256;
+    aes_cbc_fn cbc_decrypt_enc128, cbc_decrypt_enc192, cbc_decrypt_enc256;
+    aes128_mb_fn cbc_mb128, cfb_mb128, ofb_mb128, mac_mb128;
+    aes192_mb_fn cbc_mb192, cfb_mb192, ofb_mb192, mac_mb192;
+    aes256_mb_fn cbc_mb256, cfb_mb256, ofb_mb256, mac_mb256;
+    aes_xts_fn xts_enc128, xts_enc256, xts_dec128, xts_dec256;
+} aes_modes_tier_t;
+
+#define AES_MODES_TIER(T) {                                                                                  \
+    aes128_ctr_xor_##T, aes192_ctr_xor_##T, aes256_ctr_xor_##T,                                              \
+    aes128_cbc_decrypt_##T, aes192_cbc_decrypt_##T, aes256_cbc_decrypt_##T,                                  \
+    aes128_cbc_decrypt_dec_##T, aes192_cbc_decrypt_dec_##T, aes256_cbc_decrypt_dec_##T,                      \
+    aes128_cbc_decrypt_enc_##T, aes192_cbc_decrypt_enc_##T, aes256_cbc_decrypt_enc_##T,                      \
+    aes128_cbc_encrypt_mb_##T, aes128_cfb_encrypt_mb_##T, aes128_ofb_xor_mb_##T, aes128_cbc_mac_mb_##T,     \
+    aes192_cbc_encrypt_mb_##T, aes192_cfb_encrypt_mb_##T, aes192_ofb_xor_mb_##T, aes192_cbc_mac_mb_##T,     \
+    aes256_cbc_encrypt_mb_##T, aes256_cfb_encrypt_mb_##T, aes256_ofb_xor_mb_##T, aes256_cbc_mac_mb_##T,     \
+    aes128_xts_enc_##T, aes256_xts_enc_##T, aes128_xts_dec_##T, aes256_xts_dec_##T                          \
+}
+static const aes_modes_tier_t aes_modes_tier_vaes512 = AES_MODES_TIER(vaes512);
+static const aes_modes_tier_t aes_modes_tier_vaes256 = AES_MODES_TIER(vaes256);
+static const aes_modes_tier_t aes_modes_tier_aesni   = AES_MODES_TIER(aesni);
+static const aes_modes_tier_t aes_modes_tier_generic = AES_MODES_TIER(generic);
+#undef AES_MODES_TIER
+
+/* Best tier for the given hardware (kernels byte swap with pshufb, so AES-NI alone goes generic) */
+static inline const aes_modes_tier_t* aes_modes_select_tier(const hardware_t* hw) {
+    if (hw->aes && hw->ssse3) {
+        if (hw->vaes512) return &aes_modes_tier_vaes512;
+        if (hw->vaes)    return &aes_modes_tier_vaes256;
+        return &aes_modes_tier_aesni;
+    }
+    return &aes_modes_tier_generic;
+}
+
+#if defined(CRYPTOCORE_ASSUME)
+    static const hardware_t aes_modes_assumed_hardware = HARDWARE_ASSUMED;
+    #define AES_MODES_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_modes_select_tier(&aes_modes_assumed_hardware)->field args; }
+    void aes_modes_dispatch_update(void) {}
+#elif defined(CRYPTOCORE_IFUNC)
+    #define AES_MODES_PUBLIC_FN(type, ret, name, field, params, args)                                 \
+        static type (*name##_resolve(void)) params {                                                  \
+            hardware_t hw;                                                                            \
+            hardware_detect(&hw);                                                                     \
+            return (type (*) params) aes_modes_select_tier(&hw)->field;                               \
+        }                                                                                             \
+        type name params __attribute__((ifunc(#name "_resolve")));
+    void aes_modes_dispatch_update(void) {}
+#else
+    static const aes_modes_tier_t* aes_modes_tier; /* set below, after its stubs */
+    void aes_modes_dispatch_update(void) {
+        hardware_init();
+        aes_modes_tier = aes_modes_select_tier(&_hardware);
+    }
+    #define AES_MODES_UNRESOLVED_FN(type, ret, field, params, args) \
+        static type aes_modes_unresolved_##field params { aes_modes_dispatch_update(); ret aes_modes_tier->field args; }
+    #define AES_CTR_PARAMS (const uint8_t* s, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len)
+    #define AES_CTR_ARGS   (s, counter, width, in, out, len)
+    AES_MODES_UNRESOLVED_FN(void, , ctr128, AES_CTR_PARAMS, AES_CTR_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , ctr192, AES_CTR_PARAMS, AES_CTR_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , ctr256, AES_CTR_PARAMS, AES_CTR_ARGS)
+    #define AES_CBC_PARAMS (const uint8_t* s, uint8_t iv[16], const uint8_t (*in)[16], uint8_t (*out)[16], size_t n)
+    #define AES_CBC_ARGS   (s, iv, in, out, n)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt128, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt192, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt256, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt_dec128, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt_dec192, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt_dec256, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt_enc128, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt_enc192, AES_CBC_PARAMS, AES_CBC_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_decrypt_enc256, AES_CBC_PARAMS, AES_CBC_ARGS)
+    #define AES_MB_PARAMS(bits) (const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num)
+    #define AES_MB_ARGS         (schedules, streams, num)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_mb128, AES_MB_PARAMS(128), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cfb_mb128, AES_MB_PARAMS(128), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , ofb_mb128, AES_MB_PARAMS(128), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , mac_mb128, AES_MB_PARAMS(128), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_mb192, AES_MB_PARAMS(192), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cfb_mb192, AES_MB_PARAMS(192), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , ofb_mb192, AES_MB_PARAMS(192), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , mac_mb192, AES_MB_PARAMS(192), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cbc_mb256, AES_MB_PARAMS(256), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , cfb_mb256, AES_MB_PARAMS(256), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , ofb_mb256, AES_MB_PARAMS(256), AES_MB_ARGS)
+    AES_MODES_UNRESOLVED_FN(void, , mac_mb256, AES_MB_PARAMS(256), AES_MB_ARGS)
+    #define AES_XTS_PARAMS (const uint8_t* s, const uint8_t* ts, const uint8_t* iv, uint64_t unit, const uint8_t* in, uint8_t* out, size_t unit_len, size_t num_units)
+    #define AES_XTS_ARGS   (s, ts, iv, unit, in, out, unit_len, num_units)
+    AES_MODES_UNRESOLVED_FN(bool, return, xts_enc128, AES_XTS_PARAMS, AES_XTS_ARGS)
+    AES_MODES_UNRESOLVED_FN(bool, return, xts_enc256, AES_XTS_PARAMS, AES_XTS_ARGS)
+    AES_MODES_UNRESOLVED_FN(bool, return, xts_dec128, AES_XTS_PARAMS, AES_XTS_ARGS)
+    AES_MODES_UNRESOLVED_FN(bool, return, xts_dec256, AES_XTS_PARAMS, AES_XTS_ARGS)
+    #undef AES_XTS_PARAMS
+    #undef AES_XTS_ARGS
+    #undef AES_CTR_PARAMS
+    #undef AES_CTR_ARGS
+    #undef AES_CBC_PARAMS
+    #undef AES_CBC_ARGS
+    #undef AES_MB_PARAMS
+    #undef AES_MB_ARGS
+    #undef AES_MODES_UNRESOLVED_FN
+    static const aes_modes_tier_t aes_modes_tier_unresolved = {
+        aes_modes_unresolved_ctr128, aes_modes_unresolved_ctr192, aes_modes_unresolved_ctr256,
+        aes_modes_unresolved_cbc_decrypt128, aes_modes_unresolved_cbc_decrypt192, aes_modes_unresolved_cbc_decrypt256,
+        aes_modes_unresolved_cbc_decrypt_dec128, aes_modes_unresolved_cbc_decrypt_dec192, aes_modes_unresolved_cbc_decrypt_dec256,
+        aes_modes_unresolved_cbc_decrypt_enc128, aes_modes_unresolved_cbc_decrypt_enc192, aes_modes_unresolved_cbc_decrypt_enc256,
+        aes_modes_unresolved_cbc_mb128, aes_modes_unresolved_cfb_mb128, aes_modes_unresolved_ofb_mb128, aes_modes_unresolved_mac_mb128,
+        aes_modes_unresolved_cbc_mb192, aes_modes_unresolved_cfb_mb192, aes_modes_unresolved_ofb_mb192, aes_modes_unresolved_mac_mb192,
+        aes_modes_unresolved_cbc_mb256, aes_modes_unresolved_cfb_mb256, aes_modes_unresolved_ofb_mb256, aes_modes_unresolved_mac_mb256,
+        aes_modes_unresolved_xts_enc128, aes_modes_unresolved_xts_enc256, aes_modes_unresolved_xts_dec128, aes_modes_unresolved_xts_dec256
+    };
+    static const aes_modes_tier_t* aes_modes_tier = &aes_modes_tier_unresolved;
+    INITIALIZER(aes_modes_dispatch_startup) { aes_modes_dispatch_update(); }
+    #define AES_MODES_PUBLIC_FN(type, ret, name, field, params, args) \
+        type name params { ret aes_modes_tier->field args; }
+#endif
+
+/* --- Public CTR --- */
+AES_MODES_PUBLIC_FN(void, , aes128_ctr_xor, ctr128, (const aes128_sched_enc_t* schedule, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len), (schedule->bytes, counter, width, in, out, len))
+AES_MODES_PUBLIC_FN(void, , aes192_ctr_xor, ctr192, (const aes192_sched_enc_t* schedule, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len), (schedule->bytes, counter, width, in, out, len))
+AES_MODES_PUBLIC_FN(void, , aes256_ctr_xor, ctr256, (const aes256_sched_enc_t* schedule, uint8_t counter[16], aes_ctr_width_t width, const uint8_t* in, uint8_t* out, size_t len), (schedule->bytes, counter, width, in, out, len))
+
+/* --- Public CBC --- */
+AES_MODES_PUBLIC_FN(void, , aes128_cbc_decrypt, cbc_decrypt128, (const aes128_sched_full_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes192_cbc_decrypt, cbc_decrypt192, (const aes192_sched_full_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes256_cbc_decrypt, cbc_decrypt256, (const aes256_sched_full_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes128_cbc_decrypt_dec, cbc_decrypt_dec128, (const aes128_sched_dec_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes192_cbc_decrypt_dec, cbc_decrypt_dec192, (const aes192_sched_dec_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes256_cbc_decrypt_dec, cbc_decrypt_dec256, (const aes256_sched_dec_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes128_cbc_decrypt_enc, cbc_decrypt_enc128, (const aes128_sched_enc_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes192_cbc_decrypt_enc, cbc_decrypt_enc192, (const aes192_sched_enc_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+AES_MODES_PUBLIC_FN(void, , aes256_cbc_decrypt_enc, cbc_decrypt_enc256, (const aes256_sched_enc_t* schedule, uint8_t iv[16], const uint8_t (*cipher)[16], uint8_t (*plain)[16], size_t num_blocks), (schedule->bytes, iv, cipher, plain, num_blocks))
+
+/* --- Public multi-buffer --- */
+#define AES_MB_PUBLIC_FNS(bits)                                                                                   \
+    AES_MODES_PUBLIC_FN(void, , aes##bits##_cbc_encrypt_mb, cbc_mb##bits, (const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams), (schedules, streams, num_streams)) \
+    AES_MODES_PUBLIC_FN(void, , aes##bits##_cfb_encrypt_mb, cfb_mb##bits, (const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams), (schedules, streams, num_streams)) \
+    AES_MODES_PUBLIC_FN(void, , aes##bits##_ofb_xor_mb, ofb_mb##bits, (const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams), (schedules, streams, num_streams)) \
+    AES_MODES_PUBLIC_FN(void, , aes##bits##_cbc_mac_mb, mac_mb##bits, (const aes##bits##_sched_enc_t* const* schedules, aes_mb_stream_t* streams, size_t num_streams), (schedules, streams, num_streams))
+AES_MB_PUBLIC_FNS(128)
+AES_MB_PUBLIC_FNS(192)
+AES_MB_PUBLIC_FNS(256)
+#undef AES_MB_PUBLIC_FNS
+
+/* --- Public XTS --- (dispatched with the tier signature, which ifunc needs, then wrapped per call shape) */
+#define AES_XTS_PARAMS (const uint8_t* s, const uint8_t* ts, const uint8_t* iv, uint64_t unit, const uint8_t* in, uint8_t* out, size_t unit_len, size_t num_units)
+#define AES_XTS_ARGS   (s, ts, iv, unit, in, out, unit_len, num_units)
+static bool aes128_xts_enc AES_XTS_PARAMS, aes256_xts_enc AES_XTS_PARAMS, aes128_xts_dec AES_XTS_PARAMS, aes256_xts_dec AES_XTS_PARAMS;
+AES_MODES_PUBLIC_FN(bool, return, aes128_xts_enc, xts_enc128, AES_XTS_PARAMS, AES_XTS_ARGS)
+AES_MODES_PUBLIC_FN(bool, return, aes256_xts_enc, xts_enc256, AES_XTS_PARAMS, AES_XTS_ARGS)
+AES_MODES_PUBLIC_FN(bool, return, aes128_xts_dec, xts_dec128, AES_XTS_PARAMS, AES_XTS_ARGS)
+AES_MODES_PUBLIC_FN(bool, return, aes256_xts_dec, xts_dec256, AES_XTS_PARAMS, AES_XTS_ARGS)
+#undef AES_XTS_PARAMS
+#undef AES_XTS_ARGS
+#define AES_XTS_PUBLIC_FNS(bits)                                                                                  \
+    bool aes##bits##_xts_encrypt(const aes##bits##_sched_enc_t* data, const aes##bits##_sched_enc_t* tweak,       \
+                                 const uint8_t iv[16], const uint8_t* plain, uint8_t* cipher, size_t len) {       \
+        return aes##bits##_xts_enc(data->bytes, tweak->bytes, iv, 0, plain, cipher, len, 1);                      \
+    }                                                                                                             \
+    bool aes##bits##_xts_decrypt(const aes##bits##_sched_full_t* data, const aes##bits##_sched_enc_t* tweak,      \
+                                 const uint8_t iv[16], const uint8_t* cipher, uint8_t* plain, size_t len) {       \
+        return aes##bits##_xts_dec(data->bytes, tweak->bytes, iv, 0, cipher, plain, len, 1);                      \
+    }                                                                                                             \
+    bool aes##bits##_xts_encrypt_sectors(const aes##bits##_sched_enc_t* data, const aes##bits##_sched_enc_t* tweak, uint64_t sector, \
+                                         size_t sector_size, const uint8_t* plain, uint8_t* cipher, size_t num_sectors) { \
+        return aes##bits##_xts_enc(data->bytes, tweak->bytes, NULL, sector, plain, cipher, sector_size, num_sectors); \
+    }                                                                                                             \
+    bool aes##bits##_xts_decrypt_sectors(const aes##bits##_sched_full_t* data, const aes##bits##_sched_enc_t* tweak, uint64_t sector, \
+                                         size_t sector_size, const uint8_t* cipher, uint8_t* plain, size_t num_sectors) { \
+        return aes##bits##_xts_dec(data->bytes, tweak->bytes, NULL, sector, cipher, plain, sector_size, num_sectors); \
+    }
+AES_XTS_PUBLIC_FNS(128)
+AES_XTS_PUBLIC_FNS(256)
+#undef AES_XTS_PUBLIC_FNS
+#undef AES_MODES_PUBLIC_FN
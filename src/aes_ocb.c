@@ -0,0 +1,161 @@
+/* AES-OCB3 for 128, 192 & 256 bits keys (RFC 7253)
+ * Blocks go through the batched *_encrypt_blocks / *_decrypt_blocks transforms (dispatched by aes.c: VAES, AES-NI,
+ * vector permute or pure c), with their offsets built 8 at a time & xored in before / out after each batch.
+ * Features:
+ *  - OCB seal / open
+ */
+
+/* Table of Contents
+ *  --- OCB internal ---
+ *  --- Public OCB ---
+ */
+
+#include "aes_ocb.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memset */
+
+/* --- OCB internal ---
+ * Block i (from 1) uses Offset_i = Offset_i-1 ^ L_ntz(i). With i = 8g + j (1 <= j <= 7), ntz(i) = ntz(j), so the 8 blocks
+ * after Offset_8g take Offset_8g ^ gray[j] & Offset_8g+8 = Offset_8g ^ gray[7] ^ L_ntz(8g+8): independent xors off one base
+ * instead of a serial chain. Batches are a multiple of 8 blocks except the last, so every batch starts on a group.
+ * Payload: C_i = Offset_i ^ E(P_i ^ Offset_i), Checksum ^= P_i; aad: Sum ^= E(A_i ^ Offset_i) from Offset_0 = 0.
+ * A partial last block uses Offset_* = Offset_m ^ L_* (payload: xored with E(Offset_*), aad: padded & encrypted)
+ * & pads its checksum / aad input with 10*.
+ */
+#define AES_OCB_BATCH 64 /* blocks per transform call (blocks & offsets: 2 KiB on the stack) */
+#define AES_OCB_NONCE_MAX 15
+
+/* Offsets of the n blocks after block i (a multiple of 8), *offset moves from Offset_i to Offset_i+n */
+static void aes_ocb_offsets(const uint8_t (*l)[16], const uint8_t (*gray)[16], __m128i* offset, uint64_t i, size_t n, __m128i* o) {
+    __m128i base = *offset, g[8];
+    for (int j = 1; j < 8; j++) g[j] = _mm_loadu_si128((const __m128i*) gray[j]);
+    for (; n >= 8; n -= 8, o += 8) {
+        i += 8;
+        o[0] = _mm_xor_si128(base, g[1]); o[1] = _mm_xor_si128(base, g[2]);
+        o[2] = _mm_xor_si128(base, g[3]); o[3] = _mm_xor_si128(base, g[4]);
+        o[4] = _mm_xor_si128(base, g[5]); o[5] = _mm_xor_si128(base, g[6]);
+        o[6] = _mm_xor_si128(base, g[7]);
+        o[7] = base = _mm_xor_si128(o[6], _mm_loadu_si128((const __m128i*) l[CTZ64(i)]));
+    }
+    for (size_t j = 0; j < n; j++) o[j] = _mm_xor_si128(base, g[j + 1]);
+    *offset = n ? o[n - 1] : base;
+}
+
+/* Partial last block padded with 10* (r < 16 bytes) */
+static inline __m128i aes_ocb_pad(const uint8_t* in, size_t r) {
+    uint8_t t[16] = { 0 };
+    memcpy(t, in, r);
+    t[r] = 0x80;
+    return _mm_loadu_si128((const __m128i*) t);
+}
+
+/* Generates OCB for one key size
+ * offset0: Offset_0 from the nonce block (tag length, 0*, 1, nonce) via Ktop & its stretch;
+ * crypt: HASH(aad), payload, then tag = E(Checksum ^ Offset ^ L_$) ^ HASH(aad) */
+#define AES_OCB_FN(bits)                                                                                          \
+    static __m128i aes##bits##_ocb_offset0(const aes##bits##_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, size_t tag_len) { \
+        uint8_t n[16] = { 0 }, stretch[24], o[16];                                                                \
+        memcpy(n + 16 - nonce_len, nonce, nonce_len);                                                             \
+        n[15 - nonce_len] |= 1;                                                                                   \
+        n[0] |= (uint8_t) (((tag_len * 8) & 127) << 1);                                                           \
+        const unsigned bottom = n[15] & 63;                                                                       \
+        n[15] &= 0xC0;                                                                                            \
+        aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) &ctx->schedule, n, stretch); /* Ktop */        \
+        for (int i = 0; i < 8; i++) stretch[16 + i] = stretch[i] ^ stretch[i + 1];                                \
+        const unsigned b = bottom >> 3, s = bottom & 7;                                                           \
+        for (int i = 0; i < 16; i++) o[i] = (uint8_t) ((stretch[i + b] << s) | ((stretch[i + b + 1] << s) >> 8)); \
+        return _mm_loadu_si128((const __m128i*) o);                                                               \
+    }                                                                                                             \
+    static __m128i aes##bits##_ocb_hash(const aes##bits##_ocb_ctx_t* ctx, const uint8_t* aad, size_t len) {      \
+        __m128i o[AES_OCB_BATCH], x[AES_OCB_BATCH], offset = _mm_setzero_si128(), sum = _mm_setzero_si128();      \
+        uint64_t i = 0;                                                                                           \
+        for (size_t m = len >> 4; m; ) {                                                                          \
+            const size_t c = m < AES_OCB_BATCH ? m : AES_OCB_BATCH;                                               \
+            aes_ocb_offsets(ctx->l, ctx->gray, &offset, i, c, o);                                                 \
+            for (size_t j = 0; j < c; j++) x[j] = _mm_xor_si128(_mm_loadu_si128((const __m128i*) aad + j), o[j]);  \
+            aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) &ctx->schedule, (const uint8_t (*)[16]) x, (uint8_t (*)[16]) x, c); \
+            for (size_t j = 0; j < c; j++) sum = _mm_xor_si128(sum, x[j]);                                        \
+            i += c; m -= c; aad += c << 4;                                                                        \
+        }                                                                                                         \
+        if (len & 15) {                                                                                           \
+            x[0] = _mm_xor_si128(aes_ocb_pad(aad, len & 15), _mm_xor_si128(offset, _mm_loadu_si128((const __m128i*) ctx->l_star))); \
+            aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) &ctx->schedule, (const uint8_t*) x, (uint8_t*) x); \
+            sum = _mm_xor_si128(sum, x[0]);                                                                       \
+        }                                                                                                         \
+        return sum;                                                                                               \
+    }                                                                                                             \
+    static void aes##bits##_ocb_crypt(const aes##bits##_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                                      const uint8_t* in, uint8_t* out, size_t len, bool enc, size_t tag_len, uint8_t tag[16]) { \
+        __m128i o[AES_OCB_BATCH], x[AES_OCB_BATCH], checksum = _mm_setzero_si128();                               \
+        __m128i offset = aes##bits##_ocb_offset0(ctx, nonce, nonce_len, tag_len);                                 \
+        uint64_t i = 0;                                                                                           \
+        for (size_t m = len >> 4; m; ) {                                                                          \
+            const size_t c = m < AES_OCB_BATCH ? m : AES_OCB_BATCH;                                               \
+            aes_ocb_offsets(ctx->l, ctx->gray, &offset, i, c, o);                                                 \
+            for (size_t j = 0; j < c; j++) {                                                                      \
+                const __m128i p = _mm_loadu_si128((const __m128i*) in + j);                                       \
+                if (enc) checksum = _mm_xor_si128(checksum, p);                                                   \
+                x[j] = _mm_xor_si128(p, o[j]);                                                                    \
+            }                                                                                                     \
+            if (enc) aes##bits##_encrypt_blocks((const aes##bits##_sched_enc_t*) &ctx->schedule, (const uint8_t (*)[16]) x, (uint8_t (*)[16]) x, c); \
+            else     aes##bits##_decrypt_blocks(&ctx->schedule, (const uint8_t (*)[16]) x, (uint8_t (*)[16]) x, c); \
+            for (size_t j = 0; j < c; j++) {                                                                      \
+                const __m128i r = _mm_xor_si128(x[j], o[j]);                                                      \
+                if (!enc) checksum = _mm_xor_si128(checksum, r);                                                  \
+                _mm_storeu_si128((__m128i*) out + j, r);                                                          \
+            }                                                                                                     \
+            i += c; m -= c; in += c << 4; out += c << 4;                                                          \
+        }                                                                                                         \
+        if (len & 15) {                                                                                           \
+            const size_t r = len & 15;                                                                            \
+            uint8_t pad[16], t[16];                                                                               \
+            offset = _mm_xor_si128(offset, _mm_loadu_si128((const __m128i*) ctx->l_star));                        \
+            _mm_storeu_si128((__m128i*) pad, offset);                                                             \
+            aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) &ctx->schedule, pad, pad);                 \
+            xor_bytes(t, in, pad, r); /* reads in before out is written */                                        \
+            checksum = _mm_xor_si128(checksum, aes_ocb_pad(enc ? in : t, r));                                     \
+            memcpy(out, t, r);                                                                                    \
+        }                                                                                                         \
+        x[0] = _mm_xor_si128(_mm_xor_si128(checksum, offset), _mm_loadu_si128((const __m128i*) ctx->l_dollar));  \
+        aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) &ctx->schedule, (const uint8_t*) x, (uint8_t*) x); \
+        _mm_storeu_si128((__m128i*) tag, _mm_xor_si128(x[0], aes##bits##_ocb_hash(ctx, aad, aad_len)));         \
+    }
+AES_OCB_FN(128)
+AES_OCB_FN(192)
+AES_OCB_FN(256)
+#undef AES_OCB_FN
+
+/* --- Public OCB --- (init: full schedule, L_* = E(0^128), L_$ = double(L_*), L_0 = double(L_$), L_i = double(L_i-1) & the gray offsets) */
+#define AES_OCB_PUBLIC_FNS(bits)                                                                                  \
+    void aes##bits##_ocb_init(aes##bits##_ocb_ctx_t* ctx, const aes##bits##_key_t* key) {                       \
+        aes##bits##_load_key(key, &ctx->schedule);                                                                \
+        memset(ctx->l_star, 0, 16);                                                                               \
+        aes##bits##_encrypt_block((const aes##bits##_sched_enc_t*) &ctx->schedule, ctx->l_star, ctx->l_star);     \
+        gf128_dbl(ctx->l_dollar, ctx->l_star);                                                                    \
+        gf128_dbl(ctx->l[0], ctx->l_dollar);                                                                      \
+        for (int i = 1; i < 64; i++) gf128_dbl(ctx->l[i], ctx->l[i - 1]);                                         \
+        memset(ctx->gray[0], 0, 16);                                                                              \
+        for (int j = 1; j < 8; j++) xor_bytes(ctx->gray[j], ctx->gray[j - 1], ctx->l[CTZ64(j)], 16);              \
+    }                                                                                                             \
+    bool aes##bits##_ocb_seal(const aes##bits##_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                              const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t* tag, size_t tag_len) {  \
+        uint8_t full[16];                                                                                         \
+        if (nonce_len - 1 >= AES_OCB_NONCE_MAX || tag_len - 1 >= 16) return false;                               \
+        aes##bits##_ocb_crypt(ctx, nonce, nonce_len, aad, aad_len, plain, cipher, len, true, tag_len, full);      \
+        memcpy(tag, full, tag_len);                                                                               \
+        return true;                                                                                              \
+    }                                                                                                             \
+    bool aes##bits##_ocb_open(const aes##bits##_ocb_ctx_t* ctx, const uint8_t* nonce, size_t nonce_len, const uint8_t* aad, size_t aad_len, \
+                              const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t* tag, size_t tag_len) { \
+        uint8_t full[16], diff = 0;                                                                               \
+        if (nonce_len - 1 >= AES_OCB_NONCE_MAX || tag_len - 1 >= 16) { memset(plain, 0, len); return false; }     \
+        aes##bits##_ocb_crypt(ctx, nonce, nonce_len, aad, aad_len, cipher, plain, len, false, tag_len, full);     \
+        for (size_t i = 0; i < tag_len; i++) diff |= full[i] ^ tag[i]; /* constant-time compare */                \
+        if (diff) { memset(plain, 0, len); return false; }                                                        \
+        return true;                                                                                              \
+    }
+AES_OCB_PUBLIC_FNS(128)
+AES_OCB_PUBLIC_FNS(192)
+AES_OCB_PUBLIC_FNS(256)
+#undef AES_OCB_PUBLIC_FNS
@@ -0,0 +1,190 @@
+/* AES-SIV for 128, 192 & 256 bits keys (RFC 5297)
+ * S2V: the CMAC chains of all components (aad & plaintext) of a group of messages run as one multi-buffer CBC-MAC call
+ * (aes_modes.h picks the AES-NI / VAES lanes or the fallback), their last blocks as one batched encrypt call.
+ * CTR: long messages through the pipelined aes_modes.h kernels, short ones from one batched keystream call per group.
+ * Features:
+ *  - SIV seal / open (single messages & batches)
+ */
+
+/* Table of Contents
+ *  --- SIV internal ---
+ *  --- Public SIV ---
+ */
+
+#include "aes_siv.h"
+#include "aes_modes.h"
+#include "hidden_common.h"
+#include "hidden_aes.h"
+#include <string.h> /* for memcpy, memset */
+
+/* --- SIV internal ---
+ * S2V(S1 ... Sn): D = CMAC(0^128), D = dbl(D) ^ CMAC(Si) for the aad, then CMAC(Sn xorend D) when the plaintext Sn has
+ * 16 bytes or more, else CMAC(dbl(D) ^ pad(Sn)). The xorend only reaches the last 16 bytes, so the plaintext chain up to
+ * its last 16 - 31 bytes runs beside the aad chains & only that tail waits for D.
+ * CMAC(M): CBC-MAC of all blocks but the last, which is xored with K1 (whole) or padded with 10* & xored with K2.
+ * CTR starts at the siv with bits 63 & 31 cleared (bytes 8 & 12), so a 64 bit counter never carries out.
+ */
+#define AES_SIV_MAX_AAD 126
+#define AES_SIV_STREAMS 128 /* CMAC chains per group (a message has at most 127) */
+#define AES_SIV_GROUP   16  /* messages per group */
+#define AES_SIV_SHORT   64  /* messages up to this size take their keystream from the group's batch */
+
+/* Chain length of a component: all blocks but the last (aad), all but the last 16 - 31 bytes (plaintext) */
+static inline size_t aes_siv_aad_chain(size_t len) { return len ? (len - 1) & ~(size_t) 15 : 0; }
+static inline size_t aes_siv_plain_chain(size_t len) { return len >= 16 ? (len - 16) & ~(size_t) 15 : 0; }
+
+/* Counter block from a siv */
+static inline void aes_siv_q(uint8_t q[16], const uint8_t siv[16]) {
+    memcpy(q, siv, 16);
+    q[8] &= 0x7F; q[12] &= 0x7F;
+}
+
+/* Generates SIV for one key size
+ * s2v: siv of n messages (plain[i]: msgs[i]'s plaintext) - one CBC-MAC call for every chain, one encrypt call for the
+ * aad last blocks, then the plaintext tails (a middle block batch when a tail spans 2 blocks, then the final batch);
+ * ctr: out = in ^ keystream of each message from its siv (short ones in one batch);
+ * seal / open group: n messages whose components fit AES_SIV_STREAMS; batch: the groups of a call */
+#define AES_SIV_FN(bits)                                                                                          \
+    static void aes##bits##_siv_s2v(const aes##bits##_siv_ctx_t* ctx, const aes_siv_msg_t* msgs, size_t n,        \
+                                    const uint8_t* const* plain, uint8_t (*v)[16]) {                              \
+        aes_mb_stream_t streams[AES_SIV_STREAMS];                                                                 \
+        const aes##bits##_sched_enc_t* schedules[AES_SIV_STREAMS];                                                \
+        uint8_t x[AES_SIV_STREAMS][16], t[AES_SIV_GROUP][32], mid[AES_SIV_GROUP][16], d[16];                      \
+        size_t s = 0, a = 0, m = 0, r[AES_SIV_GROUP];                                                             \
+        for (size_t i = 0; i < n; i++) {                                                                          \
+            for (size_t j = 0; j < msgs[i].num_aad; j++)                                                          \
+                streams[s++] = (aes_mb_stream_t) { msgs[i].aad[j], NULL, aes_siv_aad_chain(msgs[i].aad_lens[j]), { 0 } }; \
+            streams[s++] = (aes_mb_stream_t) { plain[i], NULL, aes_siv_plain_chain(msgs[i].len), { 0 } };         \
+        }                                                                                                         \
+        for (size_t j = 0; j < AES_SIV_STREAMS; j++) schedules[j] = &ctx->mac.schedule;                           \
+        aes##bits##_cbc_mac_mb(schedules, streams, s);                                                            \
+        s = 0;                                                                                                    \
+        for (size_t i = 0; i < n; i++, s++)                                                                       \
+            for (size_t j = 0; j < msgs[i].num_aad; j++, s++, a++) { /* CMAC last block on its chain value */     \
+                aes_cmac_last(x[a], msgs[i].aad[j] + streams[s].len, msgs[i].aad_lens[j] - streams[s].len, ctx->mac.k1, ctx->mac.k2); \
+                xor_bytes(x[a], x[a], streams[s].iv, 16);                                                         \
+            }                                                                                                     \
+        aes##bits##_encrypt_blocks(&ctx->mac.schedule, (const uint8_t (*)[16]) x, x, a);                          \
+        s = 0; a = 0;                                                                                             \
+        for (size_t i = 0; i < n; i++, s++) {                                                                     \
+            const size_t len = msgs[i].len, off = streams[s + msgs[i].num_aad].len;                               \
+            memcpy(d, ctx->d0, 16);                                                                               \
+            for (size_t j = 0; j < msgs[i].num_aad; j++, s++) { gf128_dbl(d, d); xor_bytes(d, d, x[a++], 16); }   \
+            if (len < 16) { /* T = dbl(D) ^ pad(Sn) is one whole block */                                         \
+                uint8_t p[16] = { 0 };                                                                            \
+                memcpy(p, plain[i], len); p[len] = 0x80;                                                          \
+                gf128_dbl(d, d);                                                                                  \
+                xor_bytes(v[i], p, d, 16); xor_bytes(v[i], v[i], ctx->mac.k1, 16);                                \
+                r[i] = 16;                                                                                        \
+                continue;                                                                                         \
+            }                                                                                                     \
+            r[i] = len - off;                                                                                     \
+            memcpy(t[i], plain[i] + off, r[i]);                                                                   \
+            xor_bytes(t[i] + r[i] - 16, t[i] + r[i] - 16, d, 16);                                                 \
+            if (r[i] == 16) {                                                                                     \
+                aes_cmac_last(v[i], t[i], 16, ctx->mac.k1, ctx->mac.k2);                                          \
+                xor_bytes(v[i], v[i], streams[s].iv, 16);                                                         \
+            } else xor_bytes(mid[m++], streams[s].iv, t[i], 16);                                                  \
+        }                                                                                                         \
+        aes##bits##_encrypt_blocks(&ctx->mac.schedule, (const uint8_t (*)[16]) mid, mid, m);                      \
+        m = 0;                                                                                                    \
+        for (size_t i = 0; i < n; i++) {                                                                          \
+            if (r[i] <= 16) continue;                                                                             \
+            aes_cmac_last(v[i], t[i] + 16, r[i] - 16, ctx->mac.k1, ctx->mac.k2);                                  \
+            xor_bytes(v[i], v[i], mid[m++], 16);                                                                  \
+        }                                                                                                         \
+        aes##bits##_encrypt_blocks(&ctx->mac.schedule, (const uint8_t (*)[16]) v, v, n);                          \
+    }                                                                                                             \
+    static void aes##bits##_siv_ctr(const aes##bits##_siv_ctx_t* ctx, const aes_siv_msg_t* msgs, size_t n, const uint8_t (*siv)[16]) { \
+        uint8_t ks[AES_SIV_GROUP * AES_SIV_SHORT / 16][16], q[16];                                                \
+        size_t b = 0;                                                                                             \
+        for (size_t i = 0; i < n; i++) {                                                                          \
+            aes_siv_q(q, siv[i]);                                                                                 \
+            if (msgs[i].len > AES_SIV_SHORT) { aes##bits##_ctr_xor(&ctx->ctr, q, AES_CTR64, msgs[i].in, msgs[i].out, msgs[i].len); continue; } \
+            const uint64_t lo = load_be64(q + 8);                                                                 \
+            for (size_t j = 0; j < msgs[i].len; j += 16, b++) { memcpy(ks[b], q, 8); store_be64(ks[b] + 8, lo + (j >> 4)); } \
+        }                                                                                                         \
+        aes##bits##_encrypt_blocks(&ctx->ctr, (const uint8_t (*)[16]) ks, ks, b);                                 \
+        b = 0;                                                                                                    \
+        for (size_t i = 0; i < n; i++)                                                                            \
+            if (msgs[i].len <= AES_SIV_SHORT) { xor_bytes(msgs[i].out, msgs[i].in, ks[b], msgs[i].len); b += (msgs[i].len + 15) >> 4; } \
+    }                                                                                                             \
+    static void aes##bits##_siv_seal_group(const aes##bits##_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t n) {     \
+        const uint8_t* plain[AES_SIV_GROUP] = { 0 };                                                              \
+        uint8_t v[AES_SIV_GROUP][16];                                                                             \
+        for (size_t i = 0; i < n; i++) plain[i] = msgs[i].in;                                                     \
+        aes##bits##_siv_s2v(ctx, msgs, n, plain, v);                                                              \
+        for (size_t i = 0; i < n; i++) memcpy(msgs[i].siv, v[i], 16);                                             \
+        aes##bits##_siv_ctr(ctx, msgs, n, (const uint8_t (*)[16]) v);                                             \
+    }                                                                                                             \
+    static void aes##bits##_siv_open_group(const aes##bits##_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t n) {     \
+        const uint8_t* plain[AES_SIV_GROUP] = { 0 };                                                              \
+        uint8_t v[AES_SIV_GROUP][16], siv[AES_SIV_GROUP][16];                                                     \
+        for (size_t i = 0; i < n; i++) { plain[i] = msgs[i].out; memcpy(siv[i], msgs[i].siv, 16); }               \
+        aes##bits##_siv_ctr(ctx, msgs, n, (const uint8_t (*)[16]) siv);                                           \
+        aes##bits##_siv_s2v(ctx, msgs, n, plain, v);                                                              \
+        for (size_t i = 0; i < n; i++) {                                                                          \
+            uint8_t diff = 0;                                                                                     \
+            for (int j = 0; j < 16; j++) diff |= v[i][j] ^ siv[i][j]; /* constant-time compare */                 \
+            msgs[i].valid = diff == 0;                                                                            \
+            if (diff) memset(msgs[i].out, 0, msgs[i].len);                                                        \
+        }                                                                                                         \
+    }                                                                                                             \
+    static void aes##bits##_siv_batch(const aes##bits##_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num, bool enc) { \
+        while (num) {                                                                                             \
+            size_t n = 0, s = 0;                                                                                  \
+            for (; n < num && n < AES_SIV_GROUP && s + msgs[n].num_aad + 1 <= AES_SIV_STREAMS; n++) s += msgs[n].num_aad + 1; \
+            if (enc) aes##bits##_siv_seal_group(ctx, msgs, n);                                                    \
+            else     aes##bits##_siv_open_group(ctx, msgs, n);                                                    \
+            msgs += n; num -= n;                                                                                  \
+        }                                                                                                         \
+    }
+AES_SIV_FN(128)
+AES_SIV_FN(192)
+AES_SIV_FN(256)
+#undef AES_SIV_FN
+
+/* --- Public SIV --- (init: CMAC context of the mac key, ctr schedule, D0 = CMAC(0^128)) */
+#define AES_SIV_PUBLIC_FNS(bits)                                                                                  \
+    void aes##bits##_siv_init(aes##bits##_siv_ctx_t* ctx, const aes##bits##_key_t* mac_key, const aes##bits##_key_t* ctr_key) { \
+        const uint8_t zero[16] = { 0 };                                                                           \
+        aes##bits##_cmac_init(&ctx->mac, mac_key);                                                                \
+        aes##bits##_load_key_enc(ctr_key, &ctx->ctr);                                                             \
+        aes##bits##_cmac(&ctx->mac, zero, 16, ctx->d0);                                                           \
+    }                                                                                                             \
+    bool aes##bits##_siv_seal(const aes##bits##_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad, \
+                              const uint8_t* plain, uint8_t* cipher, size_t len, uint8_t siv[16]) {               \
+        aes_siv_msg_t msg = { aad, aad_lens, num_aad, plain, cipher, len, { 0 }, false };                         \
+        if (num_aad > AES_SIV_MAX_AAD) return false;                                                              \
+        aes##bits##_siv_seal_group(ctx, &msg, 1);                                                                 \
+        memcpy(siv, msg.siv, 16);                                                                                 \
+        return true;                                                                                              \
+    }                                                                                                             \
+    bool aes##bits##_siv_open(const aes##bits##_siv_ctx_t* ctx, const uint8_t* const* aad, const size_t* aad_lens, size_t num_aad, \
+                              const uint8_t* cipher, uint8_t* plain, size_t len, const uint8_t siv[16]) {         \
+        aes_siv_msg_t msg = { aad, aad_lens, num_aad, cipher, plain, len, { 0 }, false };                         \
+        if (num_aad > AES_SIV_MAX_AAD) { memset(plain, 0, len); return false; }                                   \
+        memcpy(msg.siv, siv, 16);                                                                                 \
+        aes##bits##_siv_open_group(ctx, &msg, 1);                                                                 \
+        return msg.valid;                                                                                         \
+    }                                                                                                             \
+    bool aes##bits##_siv_seal_batch(const aes##bits##_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs) {     \
+        for (size_t i = 0; i < num_msgs; i++) if (msgs[i].num_aad > AES_SIV_MAX_AAD) return false;                \
+        aes##bits##_siv_batch(ctx, msgs, num_msgs, true);                                                         \
+        return true;                                                                                              \
+    }                                                                                                             \
+    bool aes##bits##_siv_open_batch(const aes##bits##_siv_ctx_t* ctx, aes_siv_msg_t* msgs, size_t num_msgs) {     \
+        bool all = true;                                                                                          \
+        for (size_t i = 0, start = 0; i <= num_msgs; i++) {                                                       \
+            if (i < num_msgs && msgs[i].num_aad <= AES_SIV_MAX_AAD) continue;                                     \
+            aes##bits##_siv_batch(ctx, msgs + start, i - start, false); /* the valid run before i */              \
+            if (i < num_msgs) { msgs[i].valid = false; memset(msgs[i].out, 0, msgs[i].len); }                     \
+            start = i + 1;                                                                                        \
+        }                                                                                                         \
+        for (size_t i = 0; i < num_msgs; i++) all &= msgs[i].valid;                                               \
+        return all;                                                                                               \
+    }
+AES_SIV_PUBLIC_FNS(128)
+AES_SIV_PUBLIC_FNS(192)
+AES_SIV_PUBLIC_FNS(256)
+#undef AES_SIV_PUBLIC_FNS
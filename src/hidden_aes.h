@@ -0,0 +1,222 @@
+#ifndef HIDDEN_AES_H
+#define HIDDEN_AES_H
+
+/* AES-NI / VAES round macros shared by the AES translation units (aes.c & the modes)
+ * Everything operates on __m128i (or the VAES register types) with round keys as named locals k0, k1 ... */
+
+#include <wmmintrin.h> /* for intrinsics for AES-NI & PCLMULQDQ */
+#include <immintrin.h> /* for intrinsics for AVX2 & VAES */
+#include <string.h> /* for memcpy */
+#include "hidden_common.h" /* for BSWAP64 */
+
+/* Block width appliers: run op with round key rk over each block in flight
+ * X1 - m is the block; X2, X4, X8 - m is a token prefix for blocks m0-m1 / m0-m3 / m0-m7 (independent chains) */
+#define AES_X1_AMD64(op, m, rk) m = op(m, rk);
+#define AES_X2_AMD64(op, m, rk) m##0 = op(m##0, rk); m##1 = op(m##1, rk);
+#define AES_X4_AMD64(op, m, rk) \
+    m##0 = op(m##0, rk); m##1 = op(m##1, rk); m##2 = op(m##2, rk); m##3 = op(m##3, rk);
+#define AES_X8_AMD64(op, m, rk) AES_X4_AMD64(op, m, rk) \
+    m##4 = op(m##4, rk); m##5 = op(m##5, rk); m##6 = op(m##6, rk); m##7 = op(m##7, rk);
+
+/* Agnostic internal shared round operations (X is a block width applier) */
+/* This define concats arg token k with 0-9 for k0-k9 */
+#define AES_AGNOS_ENC_ROUNDS_0_9_AMD64(X, m, k) \
+    X(_mm_xor_si128,    m, k##0) \
+    X(_mm_aesenc_si128, m, k##1) \
+    X(_mm_aesenc_si128, m, k##2) \
+    X(_mm_aesenc_si128, m, k##3) \
+    X(_mm_aesenc_si128, m, k##4) \
+    X(_mm_aesenc_si128, m, k##5) \
+    X(_mm_aesenc_si128, m, k##6) \
+    X(_mm_aesenc_si128, m, k##7) \
+    X(_mm_aesenc_si128, m, k##8) \
+    X(_mm_aesenc_si128, m, k##9)
+/* This define concats arg token k with i0-i9 (int literals - not macros themselves) for ki0-ki9 */
+#define AES_AGNOS_DEC_ROUNDS_0_9_AMD64(X, m, k, i_0, i_1, i_2, i_3, i_4, i_5, i_6, i_7, i_8, i_9) \
+    X(_mm_xor_si128,    m, k##i_0) \
+    X(_mm_aesdec_si128, m, k##i_1) \
+    X(_mm_aesdec_si128, m, k##i_2) \
+    X(_mm_aesdec_si128, m, k##i_3) \
+    X(_mm_aesdec_si128, m, k##i_4) \
+    X(_mm_aesdec_si128, m, k##i_5) \
+    X(_mm_aesdec_si128, m, k##i_6) \
+    X(_mm_aesdec_si128, m, k##i_7) \
+    X(_mm_aesdec_si128, m, k##i_8) \
+    X(_mm_aesdec_si128, m, k##i_9)
+
+/* Main work operations for encryption/decryption -> define for inling */
+/* Expects k0-k10 as existing round keys in scope, m (X width) and round keys are __m128i */
+#define AES128_ENC_BLOCK_AMD64(X, m, k) {       \
+    AES_AGNOS_ENC_ROUNDS_0_9_AMD64(X, m, k)     \
+    X(_mm_aesenclast_si128, m, k##10)           \
+}
+/* Expects k0-k12 as existing round keys in scope, m (X width) and round keys are __m128i */
+#define AES192_ENC_BLOCK_AMD64(X, m, k) {       \
+    AES_AGNOS_ENC_ROUNDS_0_9_AMD64(X, m, k)     \
+    X(_mm_aesenc_si128,     m, k##10)           \
+    X(_mm_aesenc_si128,     m, k##11)           \
+    X(_mm_aesenclast_si128, m, k##12)           \
+}
+/* Expects k0-k14 as existing round keys in scope, m (X width) and round keys are __m128i */
+#define AES256_ENC_BLOCK_AMD64(X, m, k) {       \
+    AES_AGNOS_ENC_ROUNDS_0_9_AMD64(X, m, k)     \
+    X(_mm_aesenc_si128,     m, k##10)           \
+    X(_mm_aesenc_si128,     m, k##11)           \
+    X(_mm_aesenc_si128,     m, k##12)           \
+    X(_mm_aesenc_si128,     m, k##13)           \
+    X(_mm_aesenclast_si128, m, k##14)           \
+}
+/* Expects k0, k10-k19 as existing round keys in scope, m (X width) and round keys are __m128i */
+#define AES128_DEC_BLOCK_AMD64(X, m, k) {                                            \
+    AES_AGNOS_DEC_ROUNDS_0_9_AMD64(X, m, k, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19) \
+    X(_mm_aesdeclast_si128, m, k##0)                                                \
+}
+/* Expects k0, k12-k23 as existing round keys in scope, m (X width) and round keys are __m128i */
+#define AES192_DEC_BLOCK_AMD64(X, m, k) {                                            \
+    AES_AGNOS_DEC_ROUNDS_0_9_AMD64(X, m, k, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21) \
+    X(_mm_aesdec_si128,     m, k##22)                                               \
+    X(_mm_aesdec_si128,     m, k##23)                                               \
+    X(_mm_aesdeclast_si128, m, k##0)                                                \
+}
+/* Expects k0, k14-k27 as existing round keys in scope, m (X width) and round keys are __m128i */
+#define AES256_DEC_BLOCK_AMD64(X, m, k) {                                            \
+    AES_AGNOS_DEC_ROUNDS_0_9_AMD64(X, m, k, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23) \
+    X(_mm_aesdec_si128,     m, k##24)                                               \
+    X(_mm_aesdec_si128,     m, k##25)                                               \
+    X(_mm_aesdec_si128,     m, k##26)                                               \
+    X(_mm_aesdec_si128,     m, k##27)                                               \
+    X(_mm_aesdeclast_si128, m, k##0)                                                \
+}
+
+
+/* Helper macros for keys (GET is a key getter: get_key, get_key_vaes256, get_key_vaes512)
+ * GET##_at variants name the key k##i but read schedule index j */
+#define get_key_at(k, i, j, schedule_ptr) __m128i k##i = _mm_loadu_si128(((__m128i *) schedule_ptr) + j)
+#define get_key(k, i, schedule_ptr) get_key_at(k, i, i, schedule_ptr)
+#define get_key_imc_at(k, i, j, schedule_ptr) __m128i k##i = _mm_aesimc_si128(_mm_loadu_si128(((__m128i *) schedule_ptr) + j))
+#define get_11_keys(GET, k, schedule_ptr, i_0, i_1, i_2, i_3, i_4, i_5, i_6, i_7, i_8, i_9, i_10) \
+    GET(k,  i_0, schedule_ptr); \
+    GET(k,  i_1, schedule_ptr); \
+    GET(k,  i_2, schedule_ptr); \
+    GET(k,  i_3, schedule_ptr); \
+    GET(k,  i_4, schedule_ptr); \
+    GET(k,  i_5, schedule_ptr); \
+    GET(k,  i_6, schedule_ptr); \
+    GET(k,  i_7, schedule_ptr); \
+    GET(k,  i_8, schedule_ptr); \
+    GET(k,  i_9, schedule_ptr); \
+    GET(k, i_10, schedule_ptr);
+/* Round keys each *_BLOCK_AMD64 macro expects in scope */
+#define AES128_ENC_KEYS(GET, k, s) get_11_keys(GET, k, s, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10)
+#define AES192_ENC_KEYS(GET, k, s) AES128_ENC_KEYS(GET, k, s) GET(k, 11, s); GET(k, 12, s);
+#define AES256_ENC_KEYS(GET, k, s) AES192_ENC_KEYS(GET, k, s) GET(k, 13, s); GET(k, 14, s);
+#define AES128_DEC_KEYS(GET, k, s) get_11_keys(GET, k, s, 0, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19)
+#define AES192_DEC_KEYS(GET, k, s) get_11_keys(GET, k, s, 0, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21) \
+    GET(k, 22, s); GET(k, 23, s);
+#define AES256_DEC_KEYS(GET, k, s) get_11_keys(GET, k, s, 0, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23) \
+    GET(k, 24, s); GET(k, 25, s); GET(k, 26, s); GET(k, 27, s);
+/* Back to front key lists under the names *_DEC_BLOCK_AMD64 expects (k[R+j] read from index R-j by GET_INNER) */
+#define AES128_DEC_REV_KEYS(GET, GET_INNER, k, s) GET(k, 0, 0, s); GET(k, 10, 10, s); \
+    GET_INNER(k, 11, 9, s); GET_INNER(k, 12, 8, s); GET_INNER(k, 13, 7, s); GET_INNER(k, 14, 6, s); GET_INNER(k, 15, 5, s); \
+    GET_INNER(k, 16, 4, s); GET_INNER(k, 17, 3, s); GET_INNER(k, 18, 2, s); GET_INNER(k, 19, 1, s);
+#define AES192_DEC_REV_KEYS(GET, GET_INNER, k, s) GET(k, 0, 0, s); GET(k, 12, 12, s); \
+    GET_INNER(k, 13, 11, s); GET_INNER(k, 14, 10, s); GET_INNER(k, 15, 9, s); GET_INNER(k, 16, 8, s); GET_INNER(k, 17, 7, s); GET_INNER(k, 18, 6, s); \
+    GET_INNER(k, 19, 5, s); GET_INNER(k, 20, 4, s); GET_INNER(k, 21, 3, s); GET_INNER(k, 22, 2, s); GET_INNER(k, 23, 1, s);
+#define AES256_DEC_REV_KEYS(GET, GET_INNER, k, s) GET(k, 0, 0, s); GET(k, 14, 14, s); \
+    GET_INNER(k, 15, 13, s); GET_INNER(k, 16, 12, s); GET_INNER(k, 17, 11, s); GET_INNER(k, 18, 10, s); GET_INNER(k, 19, 9, s); GET_INNER(k, 20, 8, s); GET_INNER(k, 21, 7, s); \
+    GET_INNER(k, 22, 6, s); GET_INNER(k, 23, 5, s); GET_INNER(k, 24, 4, s); GET_INNER(k, 25, 3, s); GET_INNER(k, 26, 2, s); GET_INNER(k, 27, 1, s);
+/* Dec schedule: intermediates already inverted. Enc schedule: intermediates inverted on load (GET##_imc_at) */
+#define AES128_DEC_SCHED_KEYS(GET, k, s) AES128_DEC_REV_KEYS(GET##_at, GET##_at, k, s)
+#define AES192_DEC_SCHED_KEYS(GET, k, s) AES192_DEC_REV_KEYS(GET##_at, GET##_at, k, s)
+#define AES256_DEC_SCHED_KEYS(GET, k, s) AES256_DEC_REV_KEYS(GET##_at, GET##_at, k, s)
+#define AES128_DEC_ENC_SCHED_KEYS(GET, k, s) AES128_DEC_REV_KEYS(GET##_at, GET##_imc_at, k, s)
+#define AES192_DEC_ENC_SCHED_KEYS(GET, k, s) AES192_DEC_REV_KEYS(GET##_at, GET##_imc_at, k, s)
+#define AES256_DEC_ENC_SCHED_KEYS(GET, k, s) AES256_DEC_REV_KEYS(GET##_at, GET##_imc_at, k, s)
+
+/* VAES + AVX2: 2 blocks per ymm register
+ * Reuses the *_BLOCK_AMD64 round macros, each 128-bit op maps to its 256-bit form (VAES256_ prefix + op name).
+ * Round keys are broadcast to both 128-bit lanes. */
+#define VAES256__mm_xor_si128        _mm256_xor_si256
+#define VAES256__mm_aesenc_si128     _mm256_aesenc_epi128
+#define VAES256__mm_aesenclast_si128 _mm256_aesenclast_epi128
+#define VAES256__mm_aesdec_si128     _mm256_aesdec_epi128
+#define VAES256__mm_aesdeclast_si128 _mm256_aesdeclast_epi128
+#define AES_X1_VAES256(op, m, rk) AES_X1_AMD64(VAES256_##op, m, rk)
+#define AES_X4_VAES256(op, m, rk) AES_X4_AMD64(VAES256_##op, m, rk)
+#define AES_X8_VAES256(op, m, rk) AES_X8_AMD64(VAES256_##op, m, rk)
+#define get_key_vaes256_at(k, i, j, schedule_ptr) \
+    __m256i k##i = _mm256_broadcastsi128_si256(_mm_loadu_si128(((__m128i *) schedule_ptr) + j))
+#define get_key_vaes256(k, i, schedule_ptr) get_key_vaes256_at(k, i, i, schedule_ptr)
+#define get_key_vaes256_imc_at(k, i, j, schedule_ptr) \
+    __m256i k##i = _mm256_broadcastsi128_si256(_mm_aesimc_si128(_mm_loadu_si128(((__m128i *) schedule_ptr) + j)))
+
+/* VAES + AVX-512F: 4 blocks per zmm register (same op mapping scheme as VAES256) */
+#define VAES512__mm_xor_si128        _mm512_xor_si512
+#define VAES512__mm_aesenc_si128     _mm512_aesenc_epi128
+#define VAES512__mm_aesenclast_si128 _mm512_aesenclast_epi128
+#define VAES512__mm_aesdec_si128     _mm512_aesdec_epi128
+#define VAES512__mm_aesdeclast_si128 _mm512_aesdeclast_epi128
+#define AES_X4_VAES512(op, m, rk) AES_X4_AMD64(VAES512_##op, m, rk)
+#define AES_X8_VAES512(op, m, rk) AES_X8_AMD64(VAES512_##op, m, rk)
+#define get_key_vaes512_at(k, i, j, schedule_ptr) \
+    __m512i k##i = _mm512_broadcast_i32x4(_mm_loadu_si128(((__m128i *) schedule_ptr) + j))
+#define get_key_vaes512(k, i, schedule_ptr) get_key_vaes512_at(k, i, i, schedule_ptr)
+#define get_key_vaes512_imc_at(k, i, j, schedule_ptr) \
+    __m512i k##i = _mm512_broadcast_i32x4(_mm_aesimc_si128(_mm_loadu_si128(((__m128i *) schedule_ptr) + j)))
+
+/* One AESENC round on up to 8 blocks with per-block round keys, bitsliced & constant-time (aes.c, for the pure C tier
+ * of aes_aegis.c: in-place operation allowed) */
+void aes_ct64_enc_round8(const uint8_t (*src)[16], const uint8_t (*rk)[16], uint8_t (*dst)[16], size_t n);
+
+/* Mode helpers (aes_modes.c & the AEAD modules) */
+static inline uint64_t load_be64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return BSWAP64(v); }
+static inline void store_be64(uint8_t* p, uint64_t v) { v = BSWAP64(v); memcpy(p, &v, 8); }
+
+/* out = in ^ ks for len bytes (full blocks as vectors, the tail through a zero padded block) */
+static inline void xor_bytes(uint8_t* out, const uint8_t* in, const uint8_t* ks, size_t len) {
+    for (; len >= 16; len -= 16, in += 16, out += 16, ks += 16)
+        _mm_storeu_si128((__m128i*) out, _mm_xor_si128(_mm_loadu_si128((const __m128i*) in), _mm_loadu_si128((const __m128i*) ks)));
+    if (len) {
+        uint8_t t[16] = { 0 };
+        memcpy(t, in, len);
+        _mm_storeu_si128((__m128i*) t, _mm_xor_si128(_mm_loadu_si128((const __m128i*) t), _mm_loadu_si128((const __m128i*) ks)));
+        memcpy(out, t, len);
+    }
+}
+
+/* dst = src * x in GF(2^128) (big-endian, x^128 = x^7 + x^2 + x + 1): CMAC subkeys, S2V, OCB's L table */
+static inline void gf128_dbl(uint8_t dst[16], const uint8_t src[16]) {
+    const uint64_t hi = load_be64(src), lo = load_be64(src + 8);
+    store_be64(dst, (hi << 1) | (lo >> 63));
+    store_be64(dst + 8, (lo << 1) ^ (0x87 & (0 - (hi >> 63))));
+}
+
+/* CMAC last block input: x = in ^ K1 for 16 bytes, else (in padded with 10*) ^ K2 (r < 16) - CMAC & S2V */
+static inline void aes_cmac_last(uint8_t x[16], const uint8_t* in, size_t r, const uint8_t k1[16], const uint8_t k2[16]) {
+    uint8_t b[16] = { 0 };
+    memcpy(b, in, r);
+    if (r < 16) b[r] = 0x80;
+    xor_bytes(x, b, r < 16 ? k2 : k1, 16);
+}
+
+/* Byte reversal of a whole block (big-endian counter <-> little-endian lanes) */
+#define BSWAP128_MASK _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)
+
+/* Byte reversal of each block in a zmm with AVX-512F only (no byte shuffle):
+ * bswap each dword (two rotates merged by a select), then reverse the dwords of each block */
+#define AES_BSWAP128_VAES512(x)                                                                                   \
+    _mm512_shuffle_epi32(_mm512_ternarylogic_epi32(_mm512_set1_epi32(0x00FF00FF), _mm512_rol_epi32(x, 8),         \
+                                                   _mm512_rol_epi32(x, 24), 0xCA /* a ? b : c */), _MM_PERM_ABCD)
+
+/* 8 registers of counter blocks: m0-m7 from base c, register j holds blocks j * w ... (w = blocks per register) */
+#define AES_CTR_BLOCKS_X8(BLOCK, m, c, w)                                                \
+    m##0 = BLOCK(c, 0 * w); m##1 = BLOCK(c, 1 * w); m##2 = BLOCK(c, 2 * w); m##3 = BLOCK(c, 3 * w); \
+    m##4 = BLOCK(c, 4 * w); m##5 = BLOCK(c, 5 * w); m##6 = BLOCK(c, 6 * w); m##7 = BLOCK(c, 7 * w);
+/* out = in ^ m0-m7 (T: register type, load/store/xor: the matching intrinsics) */
+#define AES_CTR_XOR_X8(T, load, store, xor, m, in, out)                                                           \
+    store((T*) (out) + 0, xor(m##0, load((const T*) (in) + 0))); store((T*) (out) + 1, xor(m##1, load((const T*) (in) + 1))); \
+    store((T*) (out) + 2, xor(m##2, load((const T*) (in) + 2))); store((T*) (out) + 3, xor(m##3, load((const T*) (in) + 3))); \
+    store((T*) (out) + 4, xor(m##4, load((const T*) (in) + 4))); store((T*) (out) + 5, xor(m##5, load((const T*) (in) + 5))); \
+    store((T*) (out) + 6, xor(m##6, load((const T*) (in) + 6))); store((T*) (out) + 7, xor(m##7, load((const T*) (in) + 7)));
+
+#endif // HIDDEN_AES_H
@@ -1,10 +1,12 @@
 #ifndef HIDDEN_COMMON_H
 #define HIDDEN_COMMON_H
 
-/* Rotate macros */
-#if defined(_MSC_VER) || true
+#include <stdint.h>
+#include "common.h"
+
+/* Rotate, byte swap & bit scan macros */
+#if defined(_MSC_VER)
     #include <intrin.h>
-    // MSVC Intrinsics also GCC/Clang?
     #define ROTL8(x, n) _rotl8((x), (n))
     #define ROTR8(x, n) _rotr8((x), (n))
     #define ROTL16(x, n) _rotl16((x), (n))
@@ -14,6 +16,159 @@
     #define ROTR32(x, n) _rotr((x), (n))
     #define ROTL64(x, n) _rotl64((x), (n))
     #define ROTR64(x, n) _rotr64((x), (n))
+    #define BSWAP64(x) _byteswap_uint64(x)
+    #define CTZ64(x) _tzcnt_u64(x) /* x != 0 (runs as bsf without BMI1) */
+#else
+    #include <x86intrin.h>
+    // GCC/Clang equivalents (ia32intrin.h)
+    #define ROTL8(x, n) __rolb((x), (n))
+    #define ROTR8(x, n) __rorb((x), (n))
+    #define ROTL16(x, n) __rolw((x), (n))
+    #define ROTR16(x, n) __rorw((x), (n))
+
+    #define ROTL32(x, n) __rold((x), (n))
+    #define ROTR32(x, n) __rord((x), (n))
+    #define ROTL64(x, n) __rolq((x), (n))
+    #define ROTR64(x, n) __rorq((x), (n))
+    #define BSWAP64(x) _bswap64(x)
+    #define CTZ64(x) __builtin_ctzll(x) /* x != 0 */
+#endif
+
+/* Enable an ISA extension for one function (runtime dispatched code paths) */
+#if defined(__GNUC__) || defined(__clang__)
+    #define TARGET(isa) __attribute__((target(isa)))
+#else
+    // MSVC allows any intrinsic without flags
+    #define TARGET(isa)
+#endif
+
+/* Mark an intended switch case fallthrough (-Wimplicit-fallthrough) */
+#if defined(__GNUC__) || defined(__clang__)
+    #define FALLTHROUGH __attribute__((fallthrough))
+#else
+    #define FALLTHROUGH
+#endif
+
+/* CPU info macros */
+#if !defined(CPUID) && !defined(CPUIDEX)
+#ifdef _MSC_VER
+    // Windows (MSVC) - Use <intrin.h>
+    #include <intrin.h>
+    #define CPUID(output, func)              __cpuid(output, func)
+    #define CPUIDEX(output, func, subfunc)    __cpuidex(output, func, subfunc)
+    #define XGETBV(xcr)                      _xgetbv(xcr)
+#elif defined(__GNUC__) || defined(__clang__)
+    // Linux/macOS (GCC/Clang) - Use <cpuid.h>
+    #include <cpuid.h>
+    #define CPUID(output, func)              __cpuid((func), (output)[0], (output)[1], (output)[2], (output)[3])
+    #define CPUIDEX(output, func, subfunc)   __cpuid_count((func), (subfunc), (output)[0], (output)[1], (output)[2], (output)[3])
+    #define XGETBV(xcr) ({ uint32_t _lo, _hi; __asm__ volatile("xgetbv" : "=a"(_lo), "=d"(_hi) : "c"(xcr)); ((uint64_t)_hi << 32) | _lo; })
+#else
+    #error "Unsupported compiler (only MSVC, GCC, and Clang are supported)"
+#endif
+#endif
+
+/* Reads CPU & OS support into hw
+ * Self-contained (no globals, no constructors) so ifunc resolvers can call it before relocations are done */
+static inline void hardware_detect(hardware_t* hw) {
+    uint32_t nIds_, eax, ecx, edx, ebx7, ecx7;
+    uint32_t cpui[4];
+
+    // Calling CPUID with 0x0 as the function_id argument
+    // gets the number of the highest valid function ID & the vendor string (ebx, edx, ecx).
+    CPUID(cpui, 0);
+    nIds_ = cpui[0];
+    _Bool amd = (cpui[1] == 0x68747541 && cpui[3] == 0x69746e65 && cpui[2] == 0x444d4163)  // "AuthenticAMD"
+             || (cpui[1] == 0x6f677948 && cpui[3] == 0x6e65476e && cpui[2] == 0x656e6975); // "HygonGenuine"
+
+    // load bitset with flags for function 0x00000001
+    if (nIds_ >= 1) {
+        CPUIDEX(cpui, 1, 0);
+        eax = cpui[0];
+        ecx = cpui[2];
+        edx = cpui[3];
+    } else {
+        eax = 0; ecx = 0; edx = 0;
+    }
+    // display family: base family, plus extended family when base is 0xF
+    uint32_t family = (eax >> 8) & 0xF;
+    if (family == 0xF) family += (eax >> 20) & 0xFF;
+
+    // load bitset with flags for function 0x00000007 (extended features)
+    if (nIds_ >= 7) {
+        CPUIDEX(cpui, 7, 0);
+        ebx7 = cpui[1];
+        ecx7 = cpui[2];
+    } else {
+        ebx7 = 0; ecx7 = 0;
+    }
+
+    _Bool aes    = (ecx >> 25) & 1;
+    _Bool pclmul = (ecx >> 1) & 1;
+    _Bool ssse3  = (ecx >> 9) & 1;
+    _Bool sse2   = (edx >> 26) & 1;
+
+    // Wide registers need OS support: OSXSAVE set & XCR0 saves XMM (bit 1) + YMM (bit 2) state,
+    // ZMM also needs opmask (bit 5) + upper ZMM0-15 (bit 6) + ZMM16-31 (bit 7) state
+    _Bool osxsave = (ecx >> 27) & 1;
+    uint64_t xcr0 = osxsave ? XGETBV(0) : 0;
+    _Bool os_ymm  = (xcr0 & 0x06) == 0x06;
+    _Bool os_zmm  = (xcr0 & 0xE6) == 0xE6;
+    _Bool avx2    = (ebx7 >> 5) & 1;
+    _Bool avx512f = (ebx7 >> 16) & 1;
+    _Bool vaes    = (ecx7 >> 9) & 1;
+    _Bool vpclmul = (ecx7 >> 10) & 1;
+
+    hw->aes     = aes && sse2;
+    hw->aeskga  = hw->aes && amd && family >= 0x17; // Zen & later: few uops, elsewhere microcoded
+    hw->pclmul  = pclmul && sse2;
+    hw->ssse3   = ssse3 && sse2;
+    hw->vaes    = hw->aes && os_ymm && avx2 && vaes;
+    hw->vaes512 = hw->aes && os_zmm && avx512f && vaes;
+    hw->vpclmul = os_zmm && avx512f && vpclmul;
+}
+
+/* Flags a CRYPTOCORE_ASSUME_* build runs with */
+#if defined(CRYPTOCORE_ASSUME_VAES512)
+    #define HARDWARE_ASSUMED { .aes = 1, .pclmul = 1, .ssse3 = 1, .vaes = 1, .vaes512 = 1, .vpclmul = 1 }
+#elif defined(CRYPTOCORE_ASSUME_VAES)
+    #define HARDWARE_ASSUMED { .aes = 1, .pclmul = 1, .ssse3 = 1, .vaes = 1 }
+#elif defined(CRYPTOCORE_ASSUME_AESNI)
+    #define HARDWARE_ASSUMED { .aes = 1, .pclmul = 1, .ssse3 = 1 }
+#elif defined(CRYPTOCORE_ASSUME_SSSE3)
+    #define HARDWARE_ASSUMED { .ssse3 = 1 }
+#elif defined(CRYPTOCORE_ASSUME_PORTABLE)
+    #define HARDWARE_ASSUMED { 0 }
+#endif
+
+/* Backend dispatch flavor of the modules (see aes.c): CRYPTOCORE_ASSUME_* fixes it at compile-time,
+ * else GNU ifunc in shared ELF builds on glibc, else pointer tables filled by a startup constructor */
+#if !defined(CRYPTOCORE_ASSUME) && (defined(__GNUC__) || defined(__clang__)) && defined(__ELF__) && defined(__PIC__) \
+    && !defined(__PIE__) && defined(__GLIBC__) && !defined(CRYPTOCORE_NO_IFUNC)
+    #define CRYPTOCORE_IFUNC
+#endif
+
+/* Fills _hardware once (first startup constructor or dispatch, whichever comes first) */
+void hardware_init(void);
+
+/* --- Multi-platform Startup Macro --- (runs before main, modules resolve their pointer tables in one) */
+#ifndef INITIALIZER
+#if defined(__GNUC__) || defined(__clang__)
+    // For GCC/Clang: Use the constructor attribute
+    #define INITIALIZER(f) \
+        static void f(void) __attribute__((constructor)); \
+        static void f(void)
+#elif defined(_MSC_VER)
+    // For MSVC: Use pragma section "magic"
+    // .CRT$XCU is the "User" initializer segment
+    #pragma section(".CRT$XCU", read)
+    #define INITIALIZER(f) \
+        static void f(void); \
+        __declspec(allocate(".CRT$XCU")) void (*f##_ptr)(void) = f; \
+        static void f(void)
+#else
+    #error "Unknown compiler. Please add a constructor implementation."
+#endif
 #endif
 
 /* Get byte from u32 & slide to specified byte index. Index is as u32 3(MSB) ... 0(LSB)} */
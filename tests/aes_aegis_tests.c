@@ -0,0 +1,106 @@
+/* AEGIS known answer tests (draft-irtf-cfrg-aegis-aead test vectors 1 - 4 of AEGIS-128L & AEGIS-256: 16 & 32 byte tags,
+ * empty message, aad with a 32 byte message, a partial last block), open with valid, tampered & truncated tags
+ * (plaintext zeroed), in-place seal & open, tag length limits.
+ * 0 - 99 byte messages with 0 - 32 byte aad round trip, their ciphertexts & tags must match across every backend tier
+ * the CPU has (the first tier run is the reference).
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_aegis_tests.c -o aes_aegis_tests (returns non-zero on failure)
+
+#include "aes_aegis.h"
+#include "test_common.h"
+
+typedef struct { const char *aad, *msg, *cipher, *tag16, *tag32; } aegis_vector_t;
+
+/* Key & nonce of every vector: 10 01 00 .. / 10 00 02 00 .. (16 bytes for 128L, 32 for 256) */
+static const aegis_vector_t aegis128l_vectors[] = {
+    { "", "00000000000000000000000000000000", "c1c0e58bd913006feba00f4b3cc3594e",
+      "abe0ece80c24868a226a35d16bdae37a", "25835bfbb21632176cf03840687cb968cace4617af1bd0f7d064c639a5c79ee4" },
+    { "", "", "", "c2b879a67def9d74e6c14f708bbcc9b4", "1360dc9db8ae42455f6e5b6a9d488ea4f2184c4e12120249335c4ee84bafe25d" },
+    { "0001020304050607", "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "79d94593d8c2119d7e8fd9b8fc77845c5c077a05b2528b6ac54b563aed8efe84",
+      "cc6f3372f6aa1bb82388d695c3962d9a", "022cb796fe7e0ae1197525ff67e309484cfbab6528ddef89f17d74ef8ecd82b3" },
+    { "0001020304050607", "000102030405060708090a0b0c0d", "79d94593d8c2119d7e8fd9b8fc77",
+      "5c04b3dba849b2701effbe32c7f0fab7", "86f1b80bfb463aba711d15405d094baf4a55a15dbfec81a76f35ed0b9c8b04ac" },
+};
+static const aegis_vector_t aegis256_vectors[] = {
+    { "", "00000000000000000000000000000000", "754fc3d8c973246dcc6d741412a4b236",
+      "3fe91994768b332ed7f570a19ec5896e", "1181a1d18091082bf0266f66297d167d2e68b845f61a3b0527d31fc7b7b89f13" },
+    { "", "", "", "e3def978a0f054afd1e761d7553afba3", "6a348c930adbd654896e1666aad67de989ea75ebaa2b82fb588977b1ffec864a" },
+    { "0001020304050607", "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "f373079ed84b2709faee373584585d60accd191db310ef5d8b11833df9dec711",
+      "8d86f91ee606e9ff26a01b64ccbdd91d", "b7d28d0c3c0ebd409fd22b44160503073a547412da0854bfb9723020dab8da1a" },
+    { "0001020304050607", "000102030405060708090a0b0c0d", "f373079ed84b2709faee37358458",
+      "c60b9c2d33ceb058f96e6dd03c215652", "8c1cc703c81281bee3f6d9966e14948b4a175b2efbdc31e61a98b4465235c2d9" },
+};
+
+/* Vectors of one variant (v: 128l, 256): seal & open with both tag lengths, tampered tag & cipher, in place */
+#define TEST_AEGIS_VECTORS(v, bits, nonce_bytes) {                                                                \
+    aes##bits##_key_t key = { { 0x10, 0x01 } };                                                                   \
+    const uint8_t nonce[nonce_bytes] = { 0x10, 0x00, 0x02 };                                                      \
+    for (size_t i = 0; i < sizeof(aegis##v##_vectors) / sizeof(aegis##v##_vectors[0]); i++) {                    \
+        const aegis_vector_t* vec = &aegis##v##_vectors[i];                                                       \
+        uint8_t aad[8], msg[32], cipher[32], out[32], tag[32], expect[32], zero[32] = { 0 };                      \
+        const size_t aad_len = unhex(vec->aad, aad), len = unhex(vec->msg, msg);                                  \
+        unhex(vec->cipher, cipher);                                                                               \
+        for (size_t tag_len = 16; tag_len <= 32; tag_len += 16) {                                                 \
+            unhex(tag_len == 16 ? vec->tag16 : vec->tag32, expect);                                               \
+            CHECK(aegis##v##_seal(&key, nonce, aad, aad_len, msg, out, len, tag, tag_len), "AEGIS-" #v " vector %zu: seal rejects", i); \
+            CHECK_MEM(out, cipher, len, "AEGIS-" #v " vector %zu: cipher", i);                                    \
+            CHECK_MEM(tag, expect, tag_len, "AEGIS-" #v " vector %zu: %zu byte tag", i, tag_len);                 \
+            CHECK(aegis##v##_open(&key, nonce, aad, aad_len, cipher, out, len, expect, tag_len) && memcmp(out, msg, len) == 0, \
+                  "AEGIS-" #v " vector %zu: open (%zu byte tag)", i, tag_len);                                    \
+            expect[tag_len - 1] ^= 1;                                                                             \
+            CHECK(!aegis##v##_open(&key, nonce, aad, aad_len, cipher, out, len, expect, tag_len),                 \
+                  "AEGIS-" #v " vector %zu: open accepts a tampered tag", i);                                     \
+            CHECK_MEM(out, zero, len, "AEGIS-" #v " vector %zu: failed open leaves plaintext", i);                \
+            expect[tag_len - 1] ^= 1;                                                                             \
+            CHECK(!aegis##v##_open(&key, nonce, aad, aad_len, cipher, out, len, expect, tag_len - 8),             \
+                  "AEGIS-" #v " vector %zu: open accepts a truncated tag", i);                                    \
+        }                                                                                                         \
+        if (len) {                                                                                                \
+            cipher[len - 1] ^= 0x40;                                                                              \
+            CHECK(!aegis##v##_open(&key, nonce, aad, aad_len, cipher, out, len, expect, 32), "AEGIS-" #v " vector %zu: open accepts a tampered cipher", i); \
+        }                                                                                                         \
+        memcpy(out, msg, len); /* in place */                                                                     \
+        CHECK(aegis##v##_seal(&key, nonce, aad, aad_len, out, out, len, tag, 16) && aegis##v##_open(&key, nonce, aad, aad_len, out, out, len, tag, 16) \
+              && memcmp(out, msg, len) == 0, "AEGIS-" #v " vector %zu: in-place round trip", i);                  \
+    }                                                                                                             \
+    uint8_t tag[32];                                                                                              \
+    CHECK(!aegis##v##_seal(&key, nonce, NULL, 0, NULL, NULL, 0, tag, 8), "AEGIS-" #v ": seal accepts an 8 byte tag"); \
+    CHECK(!aegis##v##_seal(&key, nonce, NULL, 0, NULL, NULL, 0, tag, 24), "AEGIS-" #v ": seal accepts a 24 byte tag"); \
+}
+
+#define AEGIS_LENS 100
+static uint8_t aegis_data[AEGIS_LENS + 32];
+static uint8_t aegis_ref[2][AEGIS_LENS][AEGIS_LENS + 32]; /* cipher & tag of each length, per variant */
+static bool aegis_have_ref = false;
+
+/* One variant (r: its row of aegis_ref): round trips of 0 - 99 byte messages against the reference tier */
+#define TEST_AEGIS_LENGTHS(v, bits, nonce_bytes, r) {                                                             \
+    aes##bits##_key_t key;                                                                                        \
+    uint8_t nonce[nonce_bytes], out[AEGIS_LENS + 32], back[AEGIS_LENS];                                           \
+    for (size_t i = 0; i < sizeof(key.bytes); i++) key.bytes[i] = (uint8_t) (i * 11 + bits);                      \
+    for (size_t i = 0; i < nonce_bytes; i++) nonce[i] = (uint8_t) (i * 5 + 1);                                    \
+    for (size_t len = 0; len < AEGIS_LENS; len++) {                                                               \
+        const size_t aad_len = len % 33;                                                                          \
+        aegis##v##_seal(&key, nonce, aegis_data + len, aad_len, aegis_data, out, len, out + len, 32);             \
+        if (!aegis_have_ref) memcpy(aegis_ref[r][len], out, len + 32);                                            \
+        CHECK_MEM(out, aegis_ref[r][len], len + 32, "AEGIS-" #v " %zu byte message: cipher & tag differ from the reference tier", len); \
+        CHECK(aegis##v##_open(&key, nonce, aegis_data + len, aad_len, out, back, len, out + len, 32) && memcmp(back, aegis_data, len) == 0, \
+              "AEGIS-" #v " %zu byte message: round trip", len);                                                  \
+    }                                                                                                             \
+}
+
+static void test_aegis(void) {
+    TEST_AEGIS_VECTORS(128l, 128, 16)
+    TEST_AEGIS_VECTORS(256, 256, 32)
+    for (size_t i = 0; i < sizeof(aegis_data); i++) aegis_data[i] = (uint8_t) (i * 7 + 3);
+    TEST_AEGIS_LENGTHS(128l, 128, 16, 0)
+    TEST_AEGIS_LENGTHS(256, 256, 32, 1)
+    aegis_have_ref = true;
+}
+
+int main(void) {
+    test_tiers(aes_aegis_dispatch_update, test_aegis);
+    return test_report("aes_aegis_tests");
+}
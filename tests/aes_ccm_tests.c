@@ -0,0 +1,174 @@
+/* AES-CCM known answer tests (RFC 3610 packet vectors #1-12, SP 800-38C Appendix C examples 1-4; the example
+ * inputs under 192 & 256 bit keys with 7 - 13 byte nonces & up to 64 byte payloads, results from OpenSSL)
+ * Covers 7 - 13 byte nonces (length fields of 2 - 8 bytes), 4 - 16 byte tags, a 64 KiB aad (2 + 4 byte length
+ * encoding), tag rejection (tampered tag, cipher & aad) with the output zeroed & parameter limits.
+ * Every backend tier the CPU has is forced in turn.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_ccm_tests.c -o aes_ccm_tests (returns non-zero on failure)
+
+#include "aes_ccm.h"
+#include "aes_modes.h"
+#include "test_common.h"
+
+/* aad: hex, or NULL for 65536 bytes of the 00 01 .. ff counting pattern (example 4) */
+typedef struct { const char *key, *nonce, *aad, *plain, *cipher, *tag; } ccm_vector_t;
+
+#define CCM_KEY_RFC "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+#define CCM_KEY_SP  "404142434445464748494a4b4c4d4e4f"
+static const ccm_vector_t ccm128_vectors[] = {
+    { CCM_KEY_RFC, "00000003020100a0a1a2a3a4a5", "0001020304050607", "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e",
+      "588c979a61c663d2f066d0c2c0f989806d5f6b61dac384", "17e8d12cfdf926e0" },
+    { CCM_KEY_RFC, "00000004030201a0a1a2a3a4a5", "0001020304050607", "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "72c91a36e135f8cf291ca894085c87e3cc15c439c9e43a3b", "a091d56e10400916" },
+    { CCM_KEY_RFC, "00000005040302a0a1a2a3a4a5", "0001020304050607", "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f20",
+      "51b1e5f44a197d1da46b0f8e2d282ae871e838bb64da859657", "4adaa76fbd9fb0c5" },
+    { CCM_KEY_RFC, "00000006050403a0a1a2a3a4a5", "000102030405060708090a0b", "0c0d0e0f101112131415161718191a1b1c1d1e",
+      "a28c6865939a9a79faaa5c4c2a9d4a91cdac8c", "96c861b9c9e61ef1" },
+    { CCM_KEY_RFC, "00000007060504a0a1a2a3a4a5", "000102030405060708090a0b", "0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "dcf1fb7b5d9e23fb9d4e131253658ad86ebdca3e", "51e83f077d9c2d93" },
+    { CCM_KEY_RFC, "00000008070605a0a1a2a3a4a5", "000102030405060708090a0b", "0c0d0e0f101112131415161718191a1b1c1d1e1f20",
+      "6fc1b011f006568b5171a42d953d469b2570a4bd87", "405a0443ac91cb94" },
+    { CCM_KEY_RFC, "00000009080706a0a1a2a3a4a5", "0001020304050607", "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e",
+      "0135d1b2c95f41d5d1d4fec185d166b8094e999dfed96c", "048c56602c97acbb7490" },
+    { CCM_KEY_RFC, "0000000a090807a0a1a2a3a4a5", "0001020304050607", "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "7b75399ac0831dd2f0bbd75879a2fd8f6cae6b6cd9b7db24", "c17b4433f434963f34b4" },
+    { CCM_KEY_RFC, "0000000b0a0908a0a1a2a3a4a5", "0001020304050607", "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f20",
+      "82531a60cc24945a4b8279181ab5c84df21ce7f9b73f42e197", "ea9c07e56b5eb17e5f4e" },
+    { CCM_KEY_RFC, "0000000c0b0a09a0a1a2a3a4a5", "000102030405060708090a0b", "0c0d0e0f101112131415161718191a1b1c1d1e",
+      "07342594157785152b074098330abb141b947b", "566aa9406b4d999988dd" },
+    { CCM_KEY_RFC, "0000000d0c0b0aa0a1a2a3a4a5", "000102030405060708090a0b", "0c0d0e0f101112131415161718191a1b1c1d1e1f",
+      "676bb20380b0e301e8ab79590a396da78b834934", "f53aa2e9107a8b6c022c" },
+    { CCM_KEY_RFC, "0000000e0d0c0ba0a1a2a3a4a5", "000102030405060708090a0b", "0c0d0e0f101112131415161718191a1b1c1d1e1f20",
+      "c0ffa0d6f05bdb67f24d43a4338d2aa4bed7b20e43", "cd1aa31662e7ad65d6db" },
+    { CCM_KEY_SP, "10111213141516", "0001020304050607", "20212223",
+      "7162015b", "4dac255d" },
+    { CCM_KEY_SP, "1011121314151617", "000102030405060708090a0b0c0d0e0f", "202122232425262728292a2b2c2d2e2f",
+      "d2a1f0e051ea5f62081a7792073d593d", "1fc64fbfaccd" },
+    { CCM_KEY_SP, "101112131415161718191a1b", "000102030405060708090a0b0c0d0e0f10111213", "202122232425262728292a2b2c2d2e2f3031323334353637",
+      "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5", "484392fbc1b09951" },
+    { CCM_KEY_SP, "101112131415161718191a1b1c", NULL, "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+      "69915dad1e84c6376a68c2967e4dab615ae0fd1faec44cc484828529463ccf72", "b4ac6bec93e8598e7f0dadbcea5b" },
+};
+
+#define CCM_KEY_SP192 "404142434445464748494a4b4c4d4e4f5051525354555657"
+static const ccm_vector_t ccm192_vectors[] = {
+    { CCM_KEY_SP192, "10111213141516", "0001020304050607",
+      "20212223",
+      "18ee1730", "c8c326d5" },
+    { CCM_KEY_SP192, "1011121314151617", "000102030405060708090a0b0c0d0e0f",
+      "202122232425262728292a2b2c2d2e2f",
+      "2232b6e0924148ae7239bcbd1a0f7ecb", "56e9cc28aa67" },
+    { CCM_KEY_SP192, "101112131415161718191a", "000102030405060708090a0b0c0d0e0f10111213",
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+      "4041424344454647",
+      "224fc6e63df4e666fe85eba9acf83af71391c7dfcaa17e6221a4378b7a68ac1d"
+      "25c6383ff04d7962", "e29fc6dc34e06fe1a0bfb735" },
+    { CCM_KEY_SP192, "101112131415161718191a1b", "000102030405060708090a0b0c0d0e0f10111213",
+      "202122232425262728292a2b2c2d2e2f3031323334353637",
+      "8081316fd89624d62ce7637fb94995b6631c50d61586de01", "42366952505f995a" },
+    { CCM_KEY_SP192, "101112131415161718191a1b1c", NULL,
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+      "92b98bd69ab9cab30d7aa6864805f7ae5445868717928b8df7b8b2094c02aa4f", "bba4e84f831ecd2f8b3dd96153dd" },
+    { CCM_KEY_SP192, "101112131415161718", "000102",
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+      "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f",
+      "01eb57e992e645d12c2bfcd85ab955a0d61eea30c8eb3f5c811967e6d70b24a2"
+      "1299ea32d4198e2033619a1bd290c820fbf67f397c790ccd316ef75e3010738c", "efb0230ffb50fcb8dc4fac872c7d4611" },
+};
+
+#define CCM_KEY_SP256 "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+static const ccm_vector_t ccm256_vectors[] = {
+    { CCM_KEY_SP256, "10111213141516", "0001020304050607",
+      "20212223",
+      "8ab1a874", "95fc0820" },
+    { CCM_KEY_SP256, "1011121314151617", "000102030405060708090a0b0c0d0e0f",
+      "202122232425262728292a2b2c2d2e2f",
+      "af1785fc0f5ea7d0cfba837246484497", "94b826c8849e" },
+    { CCM_KEY_SP256, "101112131415161718191a", "000102030405060708090a0b0c0d0e0f10111213",
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+      "4041424344454647",
+      "05be4fa985289932bcf824709a4950dd790fa62950bfbf50a8e8e4f98b598e51"
+      "dc5ffee1d264fd49", "ba7db4d26b6e2100fd1efbfe" },
+    { CCM_KEY_SP256, "101112131415161718191a1b", "000102030405060708090a0b0c0d0e0f10111213",
+      "202122232425262728292a2b2c2d2e2f3031323334353637",
+      "04f883aeb3bd0730eaf50bb6de4fa2212034e4e41b0e75e5", "2b48c8766f7e7649" },
+    { CCM_KEY_SP256, "101112131415161718191a1b1c", NULL,
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+      "40527dbf457197dcf6b47b20e974d1741c6ad6948f9f0e50e55923a959acf67c", "0288d51903e27756a804c0debdd8" },
+    { CCM_KEY_SP256, "101112131415161718", "000102",
+      "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+      "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f",
+      "c4c7666db308f89322f5bd45c3423fbe0eef9ac0371779a2230c677a57515623"
+      "b8e865d135845b781ae8657d51335b3dc34952fd931f9ba3d936dd7dc5887332", "e07eef4fa4b6a88319ce4abfebce2b17" },
+};
+
+#define CCM_AAD_MAX 65536
+static uint8_t aad[CCM_AAD_MAX];
+
+/* One key size: seal (separate & in-place), open, tampered tag / cipher / aad & another tag length per vector */
+#define TEST_CCM_VECTORS(bits) {                                                                                  \
+    for (size_t v = 0; v < sizeof(ccm##bits##_vectors) / sizeof(ccm##bits##_vectors[0]); v++) {                   \
+        const ccm_vector_t* tv = &ccm##bits##_vectors[v];                                                         \
+        aes##bits##_key_t key; aes##bits##_sched_enc_t schedule;                                                  \
+        uint8_t nonce[13], plain[64], cipher[64], tag[16], out[64], out_tag[16];                                  \
+        unhex(tv->key, key.bytes);                                                                                \
+        const size_t nonce_len = unhex(tv->nonce, nonce), len = unhex(tv->plain, plain);                          \
+        const size_t tag_len = unhex(tv->tag, tag);                                                               \
+        size_t aad_len = CCM_AAD_MAX;                                                                             \
+        if (tv->aad) aad_len = unhex(tv->aad, aad);                                                               \
+        else for (size_t i = 0; i < CCM_AAD_MAX; i++) aad[i] = (uint8_t) i;                                       \
+        unhex(tv->cipher, cipher);                                                                                \
+        aes##bits##_load_key_enc(&key, &schedule);                                                                \
+        CHECK(aes##bits##_ccm_seal(&schedule, nonce, nonce_len, aad, aad_len, plain, out, len, out_tag, tag_len), \
+              "CCM-%d vector %zu: seal fails", bits, v);                                                          \
+        CHECK_MEM(out, cipher, len, "CCM-%d vector %zu: seal cipher", bits, v);                                   \
+        CHECK_MEM(out_tag, tag, tag_len, "CCM-%d vector %zu: seal tag", bits, v);                                 \
+        memcpy(out, plain, len);                                                                                  \
+        aes##bits##_ccm_seal(&schedule, nonce, nonce_len, aad, aad_len, out, out, len, out_tag, tag_len);         \
+        CHECK_MEM(out, cipher, len, "CCM-%d vector %zu: in-place seal cipher", bits, v);                          \
+        CHECK(aes##bits##_ccm_open(&schedule, nonce, nonce_len, aad, aad_len, cipher, out, len, tag, tag_len),    \
+              "CCM-%d vector %zu: open rejects", bits, v);                                                        \
+        CHECK_MEM(out, plain, len, "CCM-%d vector %zu: open plain", bits, v);                                     \
+        for (int t = 0; t < 3; t++) {                                                                             \
+            uint8_t* target = t == 0 ? tag + tag_len - 1 : t == 1 ? cipher + len / 2 : aad + aad_len - 1;         \
+            *target ^= 0x80;                                                                                      \
+            memset(out, 0xAA, sizeof(out));                                                                       \
+            CHECK(!aes##bits##_ccm_open(&schedule, nonce, nonce_len, aad, aad_len, cipher, out, len, tag,         \
+                                        tag_len),                                                                 \
+                  "CCM-%d vector %zu: open accepts a tampered %s", bits, v,                                       \
+                  t == 0 ? "tag" : t == 1 ? "cipher" : "aad");                                                    \
+            for (size_t i = 0; i < len; i++)                                                                      \
+                CHECK(out[i] == 0, "CCM-%d vector %zu: rejected open leaks plain", bits, v);                      \
+            *target ^= 0x80;                                                                                      \
+        }                                                                                                         \
+        /* The tag length is encoded in B0: the right prefix under another length must not verify */              \
+        const size_t other_len = tag_len == 4 ? 6 : 4;                                                            \
+        CHECK(!aes##bits##_ccm_open(&schedule, nonce, nonce_len, aad, aad_len, cipher, out, len, tag, other_len), \
+              "CCM-%d vector %zu: open accepts another tag length", bits, v);                                     \
+    }                                                                                                             \
+}
+
+static void test_ccm(void) {
+    TEST_CCM_VECTORS(128)
+    TEST_CCM_VECTORS(192)
+    TEST_CCM_VECTORS(256)
+    aes128_key_t key; aes128_sched_enc_t schedule;
+    uint8_t nonce[14] = { 0 }, buf[16] = { 0 }, tag[16];
+    memset(key.bytes, 0x5C, sizeof(key.bytes));
+    aes128_load_key_enc(&key, &schedule);
+    CHECK(!aes128_ccm_seal(&schedule, nonce, 6, NULL, 0, buf, buf, 16, tag, 16), "CCM-128: seal accepts nonce_len 6");
+    CHECK(!aes128_ccm_seal(&schedule, nonce, 14, NULL, 0, buf, buf, 16, tag, 16), "CCM-128: seal accepts nonce_len 14");
+    CHECK(!aes128_ccm_seal(&schedule, nonce, 12, NULL, 0, buf, buf, 16, tag, 5), "CCM-128: seal accepts tag_len 5");
+    CHECK(!aes128_ccm_open(&schedule, nonce, 12, NULL, 0, buf, buf, 16, tag, 18), "CCM-128: open accepts tag_len 18");
+}
+
+static void ccm_dispatch_update(void) {
+    aes_dispatch_update();
+    aes_modes_dispatch_update();
+    aes_ccm_dispatch_update();
+}
+
+int main(void) {
+    test_tiers(ccm_dispatch_update, test_ccm);
+    return test_report("aes_ccm_tests");
+}
@@ -0,0 +1,116 @@
+/* AES-CMAC known answer tests (RFC 4493 / NIST SP 800-38B examples: 0, 16, 40 & 64 byte messages for every key size,
+ * RFC 4493 subkeys), truncated & tampered tag verification, tag length limits.
+ * Multi-buffer: 0 - 200 byte messages over 3 alternating keys (more than one group) against the single calls,
+ * then a batch verify with one tampered tag, then 0 - 128 byte messages under one key (stepped chains).
+ * Every backend tier the CPU has is forced in turn.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_cmac_tests.c -o aes_cmac_tests (returns non-zero on failure)
+
+#include "aes_cmac.h"
+#include "aes_modes.h"
+#include "test_common.h"
+
+static const char* const cmac_msg =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static const size_t cmac_lens[4] = { 0, 16, 40, 64 };
+
+typedef struct { const char *key, *tags[4]; } cmac_vector_t;
+
+static const cmac_vector_t cmac128_vector = { "2b7e151628aed2a6abf7158809cf4f3c",
+    { "bb1d6929e95937287fa37d129b756746", "070a16b46b4d4144f79bdd9dd04a287c", "dfa66747de9ae63030ca32611497c827", "51f0bebf7e3b9d92fc49741779363cfe" } };
+static const cmac_vector_t cmac192_vector = { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b",
+    { "d17ddf46adaacde531cac483de7a9367", "9e99a7bf31e710900662f65e617c5184", "8a1de5be2eb31aad089a82e6ee908b0e", "a1d5df0eed790f794d77589659f39a11" } };
+static const cmac_vector_t cmac256_vector = { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+    { "028962f61b7bf89efc6b551f4667d983", "28a7023f452e8f82bd4bf28d8c37c35c", "aaf3d8f1de5640c232f5b169b9c911e6", "e1992190549f6ed5696a2c056c315410" } };
+
+/* Vectors of one key size: tag, verify (full, truncated to 8, tampered, bad lengths), then all 4 as one batch */
+#define TEST_CMAC_VECTORS(bits) {                                                                                 \
+    aes##bits##_key_t key; static aes##bits##_cmac_ctx_t ctx;                                                     \
+    uint8_t msg[64], tag[16], out[16];                                                                            \
+    aes_cmac_msg_t msgs[4];                                                                                       \
+    const aes##bits##_cmac_ctx_t* ctxs[4] = { &ctx, &ctx, &ctx, &ctx };                                           \
+    unhex(cmac##bits##_vector.key, key.bytes); unhex(cmac_msg, msg);                                              \
+    aes##bits##_cmac_init(&ctx, &key);                                                                            \
+    for (int v = 0; v < 4; v++) {                                                                                 \
+        unhex(cmac##bits##_vector.tags[v], tag);                                                                  \
+        aes##bits##_cmac(&ctx, msg, cmac_lens[v], out);                                                           \
+        CHECK_MEM(out, tag, 16, "CMAC-%d %zu byte message: tag", bits, cmac_lens[v]);                             \
+        CHECK(aes##bits##_cmac_verify(&ctx, msg, cmac_lens[v], tag, 16), "CMAC-%d %zu byte message: verify rejects", bits, cmac_lens[v]); \
+        CHECK(aes##bits##_cmac_verify(&ctx, msg, cmac_lens[v], tag, 8), "CMAC-%d %zu byte message: verify rejects an 8 byte tag", bits, cmac_lens[v]); \
+        CHECK(!aes##bits##_cmac_verify(&ctx, msg, cmac_lens[v], tag, 7), "CMAC-%d: verify accepts a 7 byte tag", bits); \
+        CHECK(!aes##bits##_cmac_verify(&ctx, msg, cmac_lens[v], tag, 17), "CMAC-%d: verify accepts a 17 byte tag", bits); \
+        tag[7] ^= 1;                                                                                              \
+        CHECK(!aes##bits##_cmac_verify(&ctx, msg, cmac_lens[v], tag, 16), "CMAC-%d %zu byte message: verify accepts a tampered tag", bits, cmac_lens[v]); \
+        msgs[v] = (aes_cmac_msg_t) { msg, cmac_lens[v], { 0 }, false };                                          \
+    }                                                                                                             \
+    aes##bits##_cmac_mb(ctxs, msgs, 4);                                                                           \
+    for (int v = 0; v < 4; v++) {                                                                                 \
+        unhex(cmac##bits##_vector.tags[v], tag);                                                                  \
+        CHECK_MEM(msgs[v].tag, tag, 16, "CMAC-%d %zu byte message: multi-buffer tag", bits, cmac_lens[v]);        \
+    }                                                                                                             \
+}
+
+#define CMAC_MSGS 150 /* 2 full groups & a partial one */
+#define CMAC_MAX 200
+static uint8_t cmac_data[CMAC_MSGS][CMAC_MAX];
+
+/* One key size: a multi-buffer batch over 3 keys against the single calls, then verify it with a tampered tag */
+#define TEST_CMAC_MB(bits) {                                                                                      \
+    aes##bits##_key_t keys[3]; static aes##bits##_cmac_ctx_t ctx[3];                                              \
+    static aes_cmac_msg_t msgs[CMAC_MSGS];                                                                        \
+    const aes##bits##_cmac_ctx_t* ctxs[CMAC_MSGS];                                                                \
+    uint8_t tags[CMAC_MSGS][16];                                                                                  \
+    for (int k = 0; k < 3; k++) {                                                                                 \
+        for (size_t i = 0; i < sizeof(keys[k].bytes); i++) keys[k].bytes[i] = (uint8_t) (i * 7 + k * 41 + bits); \
+        aes##bits##_cmac_init(&ctx[k], &keys[k]);                                                                 \
+    }                                                                                                             \
+    for (size_t i = 0; i < CMAC_MSGS; i++) {                                                                      \
+        const size_t len = (i * 37) % (CMAC_MAX + 1);                                                             \
+        ctxs[i] = &ctx[i % 3];                                                                                    \
+        aes##bits##_cmac(ctxs[i], cmac_data[i], len, tags[i]);                                                    \
+        msgs[i] = (aes_cmac_msg_t) { cmac_data[i], len, { 0 }, false };                                           \
+    }                                                                                                             \
+    aes##bits##_cmac_mb(ctxs, msgs, CMAC_MSGS);                                                                   \
+    for (size_t i = 0; i < CMAC_MSGS; i++)                                                                        \
+        CHECK_MEM(msgs[i].tag, tags[i], 16, "CMAC-%d multi-buffer message %zu (%zu bytes): tag", bits, i, msgs[i].len); \
+    CHECK(aes##bits##_cmac_verify_mb(ctxs, msgs, CMAC_MSGS, 16), "CMAC-%d multi-buffer: verify rejects", bits);   \
+    msgs[70].tag[15] ^= 0x80;                                                                                     \
+    CHECK(!aes##bits##_cmac_verify_mb(ctxs, msgs, CMAC_MSGS, 16), "CMAC-%d multi-buffer: verify accepts a tampered tag", bits); \
+    for (size_t i = 0; i < CMAC_MSGS; i++) CHECK(msgs[i].valid == (i != 70), "CMAC-%d multi-buffer message %zu: validity", bits, i); \
+    CHECK(aes##bits##_cmac_verify_mb(ctxs, msgs, CMAC_MSGS, 12), "CMAC-%d multi-buffer: verify rejects 12 byte tags", bits); \
+    CHECK(!aes##bits##_cmac_verify_mb(ctxs, msgs, CMAC_MSGS, 4) && !msgs[0].valid, "CMAC-%d multi-buffer: verify accepts 4 byte tags", bits); \
+    for (size_t i = 0; i < CMAC_MSGS; i++) { /* one key, 0 - 128 bytes: chains stepped through the batched transform */ \
+        ctxs[i] = &ctx[0];                                                                                        \
+        msgs[i].len = i % 129;                                                                                    \
+        aes##bits##_cmac(ctxs[i], cmac_data[i], msgs[i].len, tags[i]);                                            \
+    }                                                                                                             \
+    aes##bits##_cmac_mb(ctxs, msgs, CMAC_MSGS);                                                                   \
+    for (size_t i = 0; i < CMAC_MSGS; i++)                                                                        \
+        CHECK_MEM(msgs[i].tag, tags[i], 16, "CMAC-%d one key multi-buffer message %zu (%zu bytes): tag", bits, i, msgs[i].len); \
+}
+
+static void test_cmac(void) {
+    TEST_CMAC_VECTORS(128)
+    TEST_CMAC_VECTORS(192)
+    TEST_CMAC_VECTORS(256)
+    /* RFC 4493 subkeys */
+    static aes128_cmac_ctx_t ctx; aes128_key_t key; uint8_t k[16];
+    unhex(cmac128_vector.key, key.bytes);
+    aes128_cmac_init(&ctx, &key);
+    unhex("fbeed618357133667c85e08f7236a8de", k); CHECK_MEM(ctx.k1, k, 16, "CMAC-128: K1");
+    unhex("f7ddac306ae266ccf90bc11ee46d513b", k); CHECK_MEM(ctx.k2, k, 16, "CMAC-128: K2");
+    for (size_t i = 0; i < CMAC_MSGS; i++) for (size_t j = 0; j < CMAC_MAX; j++) cmac_data[i][j] = (uint8_t) (i * 29 + j * 3);
+    TEST_CMAC_MB(128)
+    TEST_CMAC_MB(192)
+    TEST_CMAC_MB(256)
+}
+
+static void cmac_dispatch_update(void) {
+    aes_dispatch_update();
+    aes_modes_dispatch_update();
+}
+
+int main(void) {
+    test_tiers(cmac_dispatch_update, test_cmac);
+    return test_report("aes_cmac_tests");
+}
@@ -0,0 +1,415 @@
+/* AES-GCM known answer tests (GCM spec / NIST test cases 1-6, 7 & 10, 13, 14, 16 & 18)
+ * Covers the empty message, partial last blocks, 64 & 480 bit ivs, tag rejection (tampered tag, cipher & aad), tag_len 0 - 17,
+ * plus the SP 800-38D payload & aad length limits & the empty iv.
+ * AES-GCM-SIV: RFC 8452 Appendix C.1 & C.2 (AES-128 & AES-256, empty plaintext to 4 blocks, with & without aad)
+ * & the C.3 counter wrap vectors, with the same rejection checks.
+ * GMAC: a NIST aad-only vector (one shot & streamed, rejection, the stream's aad limit, empty ivs); raw GHASH (GCM spec test case 2)
+ * & POLYVAL (RFC 8452 Appendix A) in one update & in pieces, a 1000 byte GHASH stream against GMAC's tag.
+ * Every backend tier the CPU has is forced in turn, a 1000 byte message must seal alike on all of them, as must 256, 257,
+ * 511 & 4096 byte payloads & aad under each key size (the 16 block VAES512 loop, its tails & partial last blocks).
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_gcm_tests.c -o aes_gcm_tests (returns non-zero on failure)
+
+#include "aes_gcm.h"
+#include "aes_modes.h"
+#include "test_common.h"
+
+typedef struct { const char *key, *iv, *aad, *plain, *cipher, *tag; } gcm_vector_t;
+
+#define GCM_KEY_TC3 "feffe9928665731c6d6a8f9467308308"
+#define GCM_AAD_TC4 "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+#define GCM_IV_TC6  "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b"
+#define GCM_PLAIN_TC4 "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+static const gcm_vector_t gcm128_vectors[] = {
+    { "00000000000000000000000000000000", "000000000000000000000000", "", "", "", "58e2fccefa7e3061367f1d57a4e7455a" },
+    { "00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000",
+      "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf" },
+    { GCM_KEY_TC3, "cafebabefacedbaddecaf888", "", GCM_PLAIN_TC4 "1aafd255",
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+      "4d5c2af327cd64a62cf35abd2ba6fab4" },
+    { GCM_KEY_TC3, "cafebabefacedbaddecaf888", GCM_AAD_TC4, GCM_PLAIN_TC4,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+      "5bc94fbc3221a5db94fae95ae7121a47" },
+    { GCM_KEY_TC3, "cafebabefacedbad", GCM_AAD_TC4, GCM_PLAIN_TC4,
+      "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c742373806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+      "3612d2e79e3b0785561be14aaca2fccb" },
+    { GCM_KEY_TC3, GCM_IV_TC6, GCM_AAD_TC4, GCM_PLAIN_TC4,
+      "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca701e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+      "619cc5aefffe0bfa462af43c1699d050" },
+};
+static const gcm_vector_t gcm192_vectors[] = {
+    { "000000000000000000000000000000000000000000000000", "000000000000000000000000", "", "", "", "cd33b28ac773f74ba00ed1f312572435" },
+    { GCM_KEY_TC3 "feffe9928665731c", "cafebabefacedbaddecaf888", GCM_AAD_TC4, GCM_PLAIN_TC4,
+      "3980ca0b3c00e841eb06fac4872a2757859e1ceaa6efd984628593b40ca1e19c7d773d00c144c525ac619d18c84a3f4718e2448b2fe324d9ccda2710",
+      "2519498e80f1478f37ba55bd6d27618c" },
+};
+static const gcm_vector_t gcm256_vectors[] = {
+    { "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "", "", "",
+      "530f8afbc74536b9a963b4f1c4cb738b" },
+    { "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000",
+      "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919" },
+    { GCM_KEY_TC3 GCM_KEY_TC3, "cafebabefacedbaddecaf888", GCM_AAD_TC4, GCM_PLAIN_TC4,
+      "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662",
+      "76fc6ece0f4e1768cddf8853bb2d551b" },
+    { GCM_KEY_TC3 GCM_KEY_TC3, GCM_IV_TC6, GCM_AAD_TC4, GCM_PLAIN_TC4,
+      "5a8def2f0c9e53f1f75d7853659e2a20eeb2b22aafde6419a058ab4f6f746bf40fc0c3b780f244452da3ebf1c5d82cdea2418997200ef82e44ae7e3f",
+      "a44a8266ee1c8eb0c8b5d4cf5ae9f19a" },
+};
+
+/* One key size: seal (separate & in-place), open, then each tampering must fail & zero the output */
+#define TEST_GCM(bits) {                                                                                          \
+    for (size_t v = 0; v < sizeof(gcm##bits##_vectors) / sizeof(gcm##bits##_vectors[0]); v++) {                   \
+        const gcm_vector_t* tv = &gcm##bits##_vectors[v];                                                         \
+        aes##bits##_key_t key; aes##bits##_gcm_ctx_t ctx;                                                         \
+        uint8_t iv[64], aad[64], plain[64], cipher[64], tag[16], out[64], out_tag[16];                            \
+        unhex(tv->key, key.bytes);                                                                                \
+        const size_t iv_len = unhex(tv->iv, iv), aad_len = unhex(tv->aad, aad), len = unhex(tv->plain, plain);    \
+        unhex(tv->cipher, cipher); unhex(tv->tag, tag);                                                           \
+        aes##bits##_gcm_init(&ctx, &key);                                                                         \
+        CHECK(aes##bits##_gcm_seal(&ctx, iv, iv_len, aad, aad_len, plain, out, len, out_tag, 16),                 \
+              "GCM-%d vector %zu: seal fails", bits, v);                                                          \
+        CHECK_MEM(out, cipher, len, "GCM-%d vector %zu: seal cipher", bits, v);                                   \
+        CHECK_MEM(out_tag, tag, 16, "GCM-%d vector %zu: seal tag", bits, v);                                      \
+        memcpy(out, plain, len);                                                                                  \
+        aes##bits##_gcm_seal(&ctx, iv, iv_len, aad, aad_len, out, out, len, out_tag, 12);                         \
+        CHECK_MEM(out, cipher, len, "GCM-%d vector %zu: in-place seal cipher", bits, v);                          \
+        CHECK_MEM(out_tag, tag, 12, "GCM-%d vector %zu: truncated seal tag", bits, v);                            \
+        CHECK(aes##bits##_gcm_open(&ctx, iv, iv_len, aad, aad_len, cipher, out, len, tag, 16),                    \
+              "GCM-%d vector %zu: open rejects", bits, v);                                                        \
+        CHECK_MEM(out, plain, len, "GCM-%d vector %zu: open plain", bits, v);                                     \
+        for (int t = 0; t < 3; t++) {                                                                             \
+            uint8_t* target = t == 0 ? tag + 15 : t == 1 ? cipher + len / 2 : aad;                                \
+            if ((t == 1 && !len) || (t == 2 && !aad_len)) continue;                                               \
+            *target ^= 0x80;                                                                                      \
+            memset(out, 0xAA, sizeof(out));                                                                       \
+            CHECK(!aes##bits##_gcm_open(&ctx, iv, iv_len, aad, aad_len, cipher, out, len, tag, 16),               \
+                  "GCM-%d vector %zu: open accepts a tampered %s", bits, v, t == 0 ? "tag" : t == 1 ? "cipher" : "aad"); \
+            for (size_t i = 0; i < len; i++) CHECK(out[i] == 0, "GCM-%d vector %zu: rejected open leaks plain", bits, v); \
+            *target ^= 0x80;                                                                                      \
+        }                                                                                                         \
+        for (size_t n = 0; n <= 17; n++) { /* SP 800-38D tag lengths pass, any other fails & writes nothing */    \
+            const bool valid = n == 4 || n == 8 || (n >= 12 && n <= 16);                                          \
+            memset(out, 0xAA, sizeof(out)); memset(out_tag, 0xAA, sizeof(out_tag));                               \
+            CHECK(aes##bits##_gcm_seal(&ctx, iv, iv_len, aad, aad_len, plain, out, len, out_tag, n) == valid      \
+                  && (valid ? memcmp(out_tag, tag, n) == 0 : out[0] == 0xAA && out_tag[0] == 0xAA),               \
+                  "GCM-%d vector %zu: seal with tag_len %zu", bits, v, n);                                        \
+            memset(out, 0xAA, sizeof(out));                                                                       \
+            CHECK(aes##bits##_gcm_open(&ctx, iv, iv_len, aad, aad_len, cipher, out, len, tag, n) == valid         \
+                  && (valid ? memcmp(out, plain, len) == 0 : out[0] == 0xAA), "GCM-%d vector %zu: open with tag_len %zu", bits, v, n); \
+        }                                                                                                         \
+    }                                                                                                             \
+}
+
+/* SP 800-38D length limits & the empty iv: seal & open refuse them up front & write nothing */
+static void test_gcm_limits(void) {
+    if (sizeof(size_t) < 8) return; /* the limits exceed a 32 bit size_t */
+    aes128_key_t key = { { 0 } }; aes128_gcm_ctx_t ctx;
+    uint8_t iv[12] = { 0 }, buf[16] = { 0 }, tag[16], zero[16] = { 0 };
+    const uint64_t lens[2][2] = { { 0, (1ULL << 36) - 31 }, { 1ULL << 61, 0 } }; /* { aad_len, len } */
+    aes128_gcm_init(&ctx, &key);
+    for (int i = 0; i < 2; i++) {
+        const size_t aad_len = (size_t) lens[i][0], len = (size_t) lens[i][1];
+        memset(tag, 0, sizeof(tag));
+        CHECK(!aes128_gcm_seal(&ctx, iv, 12, buf, aad_len, buf, buf, len, tag, 16),
+              "GCM-128: seal accepts aad_len %llu, len %llu", (unsigned long long) aad_len, (unsigned long long) len);
+        CHECK_MEM(buf, zero, 16, "GCM-128: refused seal writes the cipher");
+        CHECK_MEM(tag, zero, 16, "GCM-128: refused seal writes the tag");
+        CHECK(!aes128_gcm_open(&ctx, iv, 12, buf, aad_len, buf, buf, len, tag, 16),
+              "GCM-128: open accepts aad_len %llu, len %llu", (unsigned long long) aad_len, (unsigned long long) len);
+        CHECK_MEM(buf, zero, 16, "GCM-128: refused open writes the plain");
+    }
+    CHECK(!aes128_gcm_seal(&ctx, iv, 0, buf, 16, buf, buf, 16, tag, 16), "GCM-128: seal accepts an empty iv");
+    CHECK_MEM(buf, zero, 16, "GCM-128: empty iv seal writes the cipher");
+    CHECK_MEM(tag, zero, 16, "GCM-128: empty iv seal writes the tag");
+    CHECK(!aes128_gcm_open(&ctx, iv, 0, buf, 16, buf, buf, 16, tag, 16), "GCM-128: open accepts an empty iv");
+}
+
+typedef struct { const char *key, *nonce, *aad, *plain, *cipher, *tag; } gcm_siv_vector_t;
+
+#define GCM_SIV_KEY_128 "01000000000000000000000000000000"
+#define GCM_SIV_KEY_256 "0100000000000000000000000000000000000000000000000000000000000000"
+#define GCM_SIV_NONCE   "030000000000000000000000"
+#define GCM_SIV_KEY_WRAP "0000000000000000000000000000000000000000000000000000000000000000"
+#define GCM_SIV_NONCE_WRAP "000000000000000000000000"
+static const gcm_siv_vector_t gcm_siv128_vectors[] = {
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "", "", "", "dc20e2d83f25705bb49e439eca56de25" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "", "0100000000000000",
+      "b5d839330ac7b786", "578782fff6013b815b287c22493a364c" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "", "010000000000000000000000",
+      "7323ea61d05932260047d942", "a4978db357391a0bc4fdec8b0d106639" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "", "01000000000000000000000000000000",
+      "743f7c8077ab25f8624e2e948579cf77", "303aaf90f6fe21199c6068577437a0c4" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "", "0100000000000000000000000000000002000000000000000000000000000000",
+      "84e07e62ba83a6585417245d7ec413a9fe427d6315c09b57ce45f2e3936a9445", "1a8e45dcd4578c667cd86847bf6155ff" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "",
+      "010000000000000000000000000000000200000000000000000000000000000003000000000000000000000000000000",
+      "3fd24ce1f5a67b75bf2351f181a475c7b800a5b4d3dcf70106b1eea82fa1d64df42bf7226122fa92e17a40eeaac1201b",
+      "5e6e311dbf395d35b0fe39c2714388f8" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "",
+      "01000000000000000000000000000000020000000000000000000000000000000300000000000000000000000000000004000000000000000000000000000000",
+      "2433668f1058190f6d43e360f4f35cd8e475127cfca7028ea8ab5c20f7ab2af02516a2bdcbc08d521be37ff28c152bba36697f25b4cd169c6590d1dd39566d3f",
+      "8a263dd317aa88d56bdf3936dba75bb8" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "01", "0200000000000000",
+      "1e6daba35669f427", "3b0a1a2560969cdf790d99759abd1508" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "01", "020000000000000000000000",
+      "296c7889fd99f41917f44620", "08299c5102745aaa3a0c469fad9e075a" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "01", "02000000000000000000000000000000",
+      "e2b0c5da79a901c1745f700525cb335b", "8f8936ec039e4e4bb97ebd8c4457441f" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "01", "0200000000000000000000000000000003000000000000000000000000000000",
+      "620048ef3c1e73e57e02bb8562c416a319e73e4caac8e96a1ecb2933145a1d71", "e6af6a7f87287da059a71684ed3498e1" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "01",
+      "020000000000000000000000000000000300000000000000000000000000000004000000000000000000000000000000",
+      "50c8303ea93925d64090d07bd109dfd9515a5a33431019c17d93465999a8b0053201d723120a8562b838cdff25bf9d1e",
+      "6a8cc3865f76897c2e4b245cf31c51f2" },
+    { GCM_SIV_KEY_128, GCM_SIV_NONCE, "01",
+      "02000000000000000000000000000000030000000000000000000000000000000400000000000000000000000000000005000000000000000000000000000000",
+      "2f5c64059db55ee0fb847ed513003746aca4e61c711b5de2e7a77ffd02da42feec601910d3467bb8b36ebbaebce5fba30d36c95f48a3e7980f0e7ac299332a80",
+      "cdc46ae475563de037001ef84ae21744" },
+};
+/* The last two: tags ending in a 0xffffffff counter word, the block counter wraps to 0 mid message */
+static const gcm_siv_vector_t gcm_siv256_vectors[] = {
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "", "", "", "07f5f4169bbf55a8400cd47ea6fd400f" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "", "0100000000000000",
+      "c2ef328e5c71c83b", "843122130f7364b761e0b97427e3df28" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "", "010000000000000000000000",
+      "9aab2aeb3faa0a34aea8e2b1", "8ca50da9ae6559e48fd10f6e5c9ca17e" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "", "01000000000000000000000000000000",
+      "85a01b63025ba19b7fd3ddfc033b3e76", "c9eac6fa700942702e90862383c6c366" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "", "0100000000000000000000000000000002000000000000000000000000000000",
+      "4a6a9db4c8c6549201b9edb53006cba821ec9cf850948a7c86c68ac7539d027f", "e819e63abcd020b006a976397632eb5d" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "",
+      "010000000000000000000000000000000200000000000000000000000000000003000000000000000000000000000000",
+      "c00d121893a9fa603f48ccc1ca3c57ce7499245ea0046db16c53c7c66fe717e39cf6c748837b61f6ee3adcee17534ed5",
+      "790bc96880a99ba804bd12c0e6a22cc4" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "",
+      "01000000000000000000000000000000020000000000000000000000000000000300000000000000000000000000000004000000000000000000000000000000",
+      "c2d5160a1f8683834910acdafc41fbb1632d4a353e8b905ec9a5499ac34f96c7e1049eb080883891a4db8caaa1f99dd004d80487540735234e3744512c6f90ce",
+      "112864c269fc0d9d88c61fa47e39aa08" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "01", "0200000000000000",
+      "1de22967237a8132", "91213f267e3b452f02d01ae33e4ec854" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "01", "020000000000000000000000",
+      "163d6f9cc1b346cd453a2e4c", "c1a4a19ae800941ccdc57cc8413c277f" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "01", "02000000000000000000000000000000",
+      "c91545823cc24f17dbb0e9e807d5ec17", "b292d28ff61189e8e49f3875ef91aff7" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "01", "0200000000000000000000000000000003000000000000000000000000000000",
+      "07dad364bfc2b9da89116d7bef6daaaf6f255510aa654f920ac81b94e8bad365", "aea1bad12702e1965604374aab96dbbc" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "01",
+      "020000000000000000000000000000000300000000000000000000000000000004000000000000000000000000000000",
+      "c67a1f0f567a5198aa1fcc8e3f21314336f7f51ca8b1af61feac35a86416fa47fbca3b5f749cdf564527f2314f42fe25",
+      "03332742b228c647173616cfd44c54eb" },
+    { GCM_SIV_KEY_256, GCM_SIV_NONCE, "01",
+      "02000000000000000000000000000000030000000000000000000000000000000400000000000000000000000000000005000000000000000000000000000000",
+      "67fd45e126bfb9a79930c43aad2d36967d3f0e4d217c1e551f59727870beefc98cb933a8fce9de887b1e40799988db1fc3f91880ed405b2dd298318858467c89",
+      "5bde0285037c5de81e5b570a049b62a0" },
+    { GCM_SIV_KEY_WRAP, GCM_SIV_NONCE_WRAP, "", "000000000000000000000000000000004db923dc793ee6497c76dcc03a98e108",
+      "f3f80f2cf0cb2dd9c5984fcda908456cc537703b5ba70324a6793a7bf218d3ea", "ffffffff000000000000000000000000" },
+    { GCM_SIV_KEY_WRAP, GCM_SIV_NONCE_WRAP, "", "eb3640277c7ffd1303c7a542d02d3e4c0000000000000000",
+      "18ce4f0b8cb4d0cac65fea8f79257b20888e53e72299e56d", "ffffffff000000000000000000000000" },
+};
+
+/* One key size: seal (separate & in-place), open, then each tampering must fail & zero the output */
+#define TEST_GCM_SIV(bits) {                                                                                      \
+    for (size_t v = 0; v < sizeof(gcm_siv##bits##_vectors) / sizeof(gcm_siv##bits##_vectors[0]); v++) {           \
+        const gcm_siv_vector_t* tv = &gcm_siv##bits##_vectors[v];                                                 \
+        aes##bits##_key_t key; aes##bits##_sched_enc_t schedule;                                                  \
+        uint8_t nonce[12], aad[16], plain[64], cipher[64], tag[16], out[64], out_tag[16];                         \
+        unhex(tv->key, key.bytes); unhex(tv->nonce, nonce);                                                       \
+        const size_t aad_len = unhex(tv->aad, aad), len = unhex(tv->plain, plain);                                \
+        unhex(tv->cipher, cipher); unhex(tv->tag, tag);                                                           \
+        aes##bits##_load_key_enc(&key, &schedule);                                                                \
+        CHECK(aes##bits##_gcm_siv_seal(&schedule, nonce, aad, aad_len, plain, out, len, out_tag),                 \
+              "GCM-SIV-%d vector %zu: seal fails", bits, v);                                                      \
+        CHECK_MEM(out, cipher, len, "GCM-SIV-%d vector %zu: seal cipher", bits, v);                               \
+        CHECK_MEM(out_tag, tag, 16, "GCM-SIV-%d vector %zu: seal tag", bits, v);                                  \
+        memcpy(out, plain, len);                                                                                  \
+        aes##bits##_gcm_siv_seal(&schedule, nonce, aad, aad_len, out, out, len, out_tag);                         \
+        CHECK_MEM(out, cipher, len, "GCM-SIV-%d vector %zu: in-place seal cipher", bits, v);                      \
+        CHECK(aes##bits##_gcm_siv_open(&schedule, nonce, aad, aad_len, cipher, out, len, tag),                    \
+              "GCM-SIV-%d vector %zu: open rejects", bits, v);                                                    \
+        CHECK_MEM(out, plain, len, "GCM-SIV-%d vector %zu: open plain", bits, v);                                 \
+        for (int t = 0; t < 3; t++) {                                                                             \
+            uint8_t* target = t == 0 ? tag + 15 : t == 1 ? cipher + len / 2 : aad;                                \
+            if ((t == 1 && !len) || (t == 2 && !aad_len)) continue;                                               \
+            *target ^= 0x80;                                                                                      \
+            memset(out, 0xAA, sizeof(out));                                                                       \
+            CHECK(!aes##bits##_gcm_siv_open(&schedule, nonce, aad, aad_len, cipher, out, len, tag),               \
+                  "GCM-SIV-%d vector %zu: open accepts a tampered %s", bits, v, t == 0 ? "tag" : t == 1 ? "cipher" : "aad"); \
+            for (size_t i = 0; i < len; i++) CHECK(out[i] == 0, "GCM-SIV-%d vector %zu: rejected open leaks plain", bits, v); \
+            *target ^= 0x80;                                                                                      \
+        }                                                                                                         \
+    }                                                                                                             \
+}
+
+/* GMAC, GHASH & POLYVAL: vectors, then 1000 bytes fed in 1 - 37 byte pieces */
+static void test_gmac(const uint8_t* data, size_t len) {
+    aes128_key_t key; aes128_gcm_ctx_t ctx;
+    aes_gmac_stream_t stream;
+    uint8_t iv[12], aad[16], tag[16], out[16], h[32], x[32];
+    unhex("77be63708971c4e240d1cb79e8d77feb", key.bytes); unhex("e0e00f19fed7ba0136a797f3", iv);
+    unhex("7a43ec1d9c0a5a78a0b16533a6213cab", aad); unhex("209fcc8d3675ed938e9c7166709dd946", tag);
+    aes128_gcm_init(&ctx, &key);
+    CHECK(aes128_gmac(&ctx, iv, 12, aad, 16, out, 16), "GMAC-128: fails");
+    CHECK_MEM(out, tag, 16, "GMAC-128: tag");
+    CHECK(aes128_gmac_verify(&ctx, iv, 12, aad, 16, tag, 16), "GMAC-128: verify rejects");
+    CHECK(!aes128_gmac_verify(&ctx, iv, 12, aad, 16, tag, 0), "GMAC-128: verify accepts an empty tag");
+    CHECK(!aes128_gmac(&ctx, iv, 12, aad, 16, out, 0), "GMAC-128: accepts an empty tag");
+    CHECK(!aes128_gmac(&ctx, iv, 12, aad, 16, out, 3), "GMAC-128: accepts a 3 byte tag");
+    CHECK(!aes128_gmac_verify(&ctx, iv, 12, aad, 16, tag, 3), "GMAC-128: verify accepts a 3 byte tag");
+    aad[3] ^= 1;
+    CHECK(!aes128_gmac_verify(&ctx, iv, 12, aad, 16, tag, 16), "GMAC-128: verify accepts tampered aad");
+    aad[3] ^= 1;
+    CHECK(!aes128_gmac(&ctx, iv, 0, aad, 16, out, 16), "GMAC-128: accepts an empty iv");
+    CHECK(!aes128_gmac_verify(&ctx, iv, 0, aad, 16, tag, 16), "GMAC-128: verify accepts an empty iv");
+    CHECK(!aes128_gmac_start(&ctx, &stream, iv, 0), "GMAC-128 stream: start accepts an empty iv");
+    aes_gmac_update(&stream, aad, 16);
+    CHECK(!aes_gmac_final(&stream, out, 16), "GMAC-128 stream: final after an empty iv start");
+    CHECK(!aes128_gmac_start(&ctx, &stream, iv, 0), "GMAC-128 stream: start accepts an empty iv");
+    CHECK(!aes_gmac_final_verify(&stream, tag, 16), "GMAC-128 stream: verify after an empty iv start");
+    CHECK(aes128_gmac_start(&ctx, &stream, iv, 12), "GMAC-128 stream: start fails");
+    aes_gmac_update(&stream, aad, 5); aes_gmac_update(&stream, aad + 5, 0); aes_gmac_update(&stream, aad + 5, 11);
+    CHECK(aes_gmac_final(&stream, out, 16), "GMAC-128 stream: final fails");
+    CHECK_MEM(out, tag, 16, "GMAC-128 stream: tag");
+    aes128_gmac_start(&ctx, &stream, iv, 12);
+    aes_gmac_update(&stream, aad, 16);
+    CHECK(aes_gmac_final_verify(&stream, tag, 12), "GMAC-128 stream: verify rejects a 12 byte tag");
+    aes128_gmac_start(&ctx, &stream, iv, 12);
+    aes_gmac_update(&stream, aad, 15);
+    CHECK(!aes_gmac_final_verify(&stream, tag, 16), "GMAC-128 stream: verify accepts a missing byte");
+    aes128_gmac_start(&ctx, &stream, iv, 12);
+    aes_gmac_update(&stream, aad, 16);
+    CHECK(!aes_gmac_final(&stream, out, 0), "GMAC-128 stream: final accepts an empty tag");
+    for (size_t n = 3; n <= 17; n += 14) {
+        memset(out, 0xAA, sizeof(out));
+        aes128_gmac_start(&ctx, &stream, iv, 12);
+        aes_gmac_update(&stream, aad, 16);
+        CHECK(!aes_gmac_final(&stream, out, n) && out[0] == 0xAA, "GMAC-128 stream: final accepts a %zu byte tag", n);
+        aes128_gmac_start(&ctx, &stream, iv, 12);
+        aes_gmac_update(&stream, aad, 16);
+        CHECK(!aes_gmac_final_verify(&stream, tag, n), "GMAC-128 stream: verify accepts a %zu byte tag", n);
+    }
+    aes128_gmac_start(&ctx, &stream, iv, 12);
+    stream.aad_len = 1ULL << 61; /* as if 2^61 bytes went in */
+    CHECK(!aes_gmac_final(&stream, out, 16), "GMAC-128 stream: final accepts 2^61 bytes of aad");
+
+    /* GHASH(H, {}, C) of test case 2 (C || 0^64 || [128]_64), POLYVAL(H, X_1, X_2) */
+    static aes_ghash_ctx_t ghash; static aes_polyval_ctx_t polyval;
+    unhex("66e94bd4ef8a2c3b884cfa59ca342b2e", h); unhex("0388dace60b6a392f328c2b971b2fe7800000000000000000000000000000080", x);
+    unhex("f38cbb1ad69223dcc3457ae5b6b0f885", tag);
+    aes_ghash_init(&ghash, h);
+    for (int pass = 0; pass < 2; pass++) { /* then in pieces: final restarts the state */
+        if (pass) { aes_ghash_update(&ghash, x, 1); aes_ghash_update(&ghash, x + 1, 20); aes_ghash_update(&ghash, x + 21, 11); }
+        else aes_ghash_update(&ghash, x, 32);
+        aes_ghash_final(&ghash, out);
+        CHECK_MEM(out, tag, 16, "GHASH pass %d: hash", pass);
+    }
+    unhex("25629347589242761d31f826ba4b757b", h); unhex("4f4f95668c83dfb6401762bb2d01a262d1a24ddd2721d006bbe45f20d3c9f362", x);
+    unhex("f7a3b47b846119fae5b7866cf5e5b77e", tag);
+    aes_polyval_init(&polyval, h);
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass) { aes_polyval_update(&polyval, x, 17); aes_polyval_update(&polyval, x + 17, 15); }
+        else aes_polyval_update(&polyval, x, 32);
+        aes_polyval_final(&polyval, out);
+        CHECK_MEM(out, tag, 16, "POLYVAL pass %d: hash", pass);
+    }
+
+    /* Long aad: streamed GMAC & E(J0) ^ GHASH(padded aad || lengths) under H = E(0^128) against one shot GMAC */
+    uint8_t ref[16], j0[16] = { 0 }, lens[16] = { 0 };
+    aes128_gmac(&ctx, iv, 12, data, len, ref, 16);
+    aes128_gmac_start(&ctx, &stream, iv, 12);
+    memset(h, 0, 16);
+    aes128_encrypt_block(&ctx.schedule, h, h);
+    aes_ghash_init(&ghash, h);
+    for (size_t i = 0, step = 1; i < len; i += step, step = step % 37 + 1) {
+        const size_t n = len - i < step ? len - i : step;
+        aes_gmac_update(&stream, data + i, n);
+        aes_ghash_update(&ghash, data + i, n);
+    }
+    CHECK(aes_gmac_final(&stream, out, 16), "GMAC-128 %zu byte stream: final fails", len);
+    CHECK_MEM(out, ref, 16, "GMAC-128 %zu byte stream: tag", len);
+    lens[6] = (uint8_t) ((len << 3) >> 8); lens[7] = (uint8_t) (len << 3);
+    aes_ghash_update(&ghash, j0, (16 - len % 16) % 16); /* aad zero padded */
+    aes_ghash_update(&ghash, lens, 16);
+    aes_ghash_final(&ghash, out);
+    memcpy(j0, iv, 12); j0[15] = 1;
+    aes128_encrypt_block(&ctx.schedule, j0, j0);
+    for (int i = 0; i < 16; i++) out[i] ^= j0[i];
+    CHECK_MEM(out, ref, 16, "GHASH %zu byte stream: differs from GMAC", len);
+}
+
+#define TEST_LONG_LEN 1000 /* 62.5 blocks: the 8 & 16 block stitched loops, then a partial block */
+static uint8_t long_ref[TEST_LONG_LEN + 16], long_siv_ref[TEST_LONG_LEN + 16];
+static bool long_ref_set = false;
+
+/* 16 block loop alone, then with a partial block, with its 8 / 4 / 2 / 1 block tails & a partial block, 256 blocks */
+#define TEST_WIDE_MAX 4096
+static const size_t wide_lens[] = { 256, 257, 511, TEST_WIDE_MAX };
+#define TEST_WIDE_LENS (sizeof(wide_lens) / sizeof(wide_lens[0]))
+static uint8_t wide_ref[3][TEST_WIDE_LENS][TEST_WIDE_MAX + 16]; /* cipher & tag per key size & length */
+static bool wide_ref_set = false;
+
+/* One key size (k: its row of wide_ref): payloads & aad of the wide_lens (each paired with the next aad length) must
+ * seal alike on every tier (the first tier run is the reference) & open back */
+#define TEST_GCM_WIDE(bits, k, plain, aad) {                                                                      \
+    static uint8_t out[TEST_WIDE_MAX + 16];                                                                       \
+    aes##bits##_key_t key; aes##bits##_gcm_ctx_t ctx;                                                             \
+    for (size_t i = 0; i < sizeof(key); i++) key.bytes[i] = (uint8_t) (i * 5 + bits);                             \
+    aes##bits##_gcm_init(&ctx, &key);                                                                             \
+    for (size_t l = 0; l < TEST_WIDE_LENS; l++) {                                                                 \
+        const size_t len = wide_lens[l], aad_len = wide_lens[(l + 1) % TEST_WIDE_LENS];                           \
+        CHECK(aes##bits##_gcm_seal(&ctx, key.bytes, 12, aad, aad_len, plain, out, len, out + len, 16),            \
+              "GCM-%d: %zu byte seal (%zu byte aad) fails", bits, len, aad_len);                                  \
+        if (!wide_ref_set) memcpy(wide_ref[k][l], out, len + 16);                                                 \
+        CHECK_MEM(out, wide_ref[k][l], len + 16, "GCM-%d: %zu byte seal (%zu byte aad) differs from the first tier", bits, len, aad_len); \
+        CHECK(aes##bits##_gcm_open(&ctx, key.bytes, 12, aad, aad_len, out, out, len, out + len, 16) && memcmp(out, plain, len) == 0, \
+              "GCM-%d: %zu byte open (%zu byte aad)", bits, len, aad_len);                                        \
+    }                                                                                                             \
+}
+
+static void test_gcm(void) {
+    TEST_GCM(128)
+    TEST_GCM(192)
+    TEST_GCM(256)
+    TEST_GCM_SIV(128)
+    TEST_GCM_SIV(256)
+
+    /* The first tier run (pure c) is the reference for the long message */
+    static uint8_t plain[TEST_LONG_LEN], out[TEST_LONG_LEN + 16];
+    aes256_key_t key; aes256_gcm_ctx_t ctx;
+    for (size_t i = 0; i < sizeof(key); i++) key.bytes[i] = (uint8_t) (i * 7 + 3);
+    for (size_t i = 0; i < sizeof(plain); i++) plain[i] = (uint8_t) (i * 13 + 5);
+    aes256_gcm_init(&ctx, &key);
+    aes256_gcm_seal(&ctx, key.bytes, 12, plain, 77, plain, out, TEST_LONG_LEN, out + TEST_LONG_LEN, 16);
+    if (!long_ref_set) memcpy(long_ref, out, sizeof(long_ref));
+    CHECK_MEM(out, long_ref, sizeof(long_ref), "GCM-256: %d byte seal differs from the first tier", TEST_LONG_LEN);
+    CHECK(aes256_gcm_open(&ctx, key.bytes, 12, plain, 77, out, out, TEST_LONG_LEN, out + TEST_LONG_LEN, 16),
+          "GCM-256: %d byte open rejects", TEST_LONG_LEN);
+    CHECK_MEM(out, plain, TEST_LONG_LEN, "GCM-256: %d byte open plain", TEST_LONG_LEN);
+    aes256_sched_enc_t schedule;
+    aes256_load_key_enc(&key, &schedule);
+    aes256_gcm_siv_seal(&schedule, key.bytes, plain, 77, plain, out, TEST_LONG_LEN, out + TEST_LONG_LEN);
+    if (!long_ref_set) { memcpy(long_siv_ref, out, sizeof(long_siv_ref)); long_ref_set = true; }
+    CHECK_MEM(out, long_siv_ref, sizeof(long_siv_ref), "GCM-SIV-256: %d byte seal differs from the first tier", TEST_LONG_LEN);
+    CHECK(aes256_gcm_siv_open(&schedule, key.bytes, plain, 77, out, out, TEST_LONG_LEN, out + TEST_LONG_LEN),
+          "GCM-SIV-256: %d byte open rejects", TEST_LONG_LEN);
+    CHECK_MEM(out, plain, TEST_LONG_LEN, "GCM-SIV-256: %d byte open plain", TEST_LONG_LEN);
+    test_gcm_limits();
+    test_gmac(plain, TEST_LONG_LEN);
+
+    static uint8_t wide_plain[TEST_WIDE_MAX], wide_aad[TEST_WIDE_MAX];
+    for (size_t i = 0; i < TEST_WIDE_MAX; i++) { wide_plain[i] = (uint8_t) (i * 29 + 1); wide_aad[i] = (uint8_t) (i * 3 + 7); }
+    TEST_GCM_WIDE(128, 0, wide_plain, wide_aad)
+    TEST_GCM_WIDE(192, 1, wide_plain, wide_aad)
+    TEST_GCM_WIDE(256, 2, wide_plain, wide_aad)
+    wide_ref_set = true;
+}
+
+static void gcm_dispatch_update(void) {
+    aes_dispatch_update();
+    aes_modes_dispatch_update();
+    aes_gcm_dispatch_update();
+}
+
+int main(void) {
+    test_tiers(gcm_dispatch_update, test_gcm);
+    return test_report("aes_gcm_tests");
+}
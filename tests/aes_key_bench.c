@@ -0,0 +1,93 @@
+/* AES key schedule benchmark (keys/second & key setup latency)
+ * Compares one-key-per-call generators (serial keygen chain per key)
+ * against the batched *_load_keys generators (interleaved expansions),
+ * then the latency of one key setup (fresh key per request) for both AES-NI engines
+ * (aeskeygenassist vs aesenclast, toggled through _hardware.aeskga).
+ * Build:
+ *   gcc -O2 -Iinclude src/*.c tests/aes_key_bench.c -o aes_key_bench (backend picked at runtime)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h> /* for clock_gettime */
+#include <x86intrin.h> /* for __rdtsc */
+#include "aes.h"
+
+#define BENCH_KEYS 1024 /* schedules per pass - up to 448 KiB, stays in L2 */
+#define BENCH_PASSES 256
+
+static uint8_t keys[BENCH_KEYS][32];
+static uint8_t scheds[BENCH_KEYS][448];
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Run BODY for every pass & return best-of-3 keys per second */
+#define BENCH_KPS(result, BODY) {                                      \
+    double _best = 0;                                                  \
+    for (int _t = 0; _t < 3; _t++) {                                   \
+        double _start = now();                                         \
+        for (int _p = 0; _p < BENCH_PASSES; _p++) { BODY }             \
+        double _kps = (double)BENCH_PASSES * BENCH_KEYS / (now() - _start); \
+        if (_kps > _best) _best = _kps;                                \
+    }                                                                  \
+    (result) = _best;                                                  \
+}
+
+/* Benchmark one key size & layout: bits = 128, 192, 256 | suffix = (empty), _enc, _dec | sched = full, enc, dec */
+#define BENCH_LAYOUT(bits, suffix, sched) {                                                                                  \
+    const aes##bits##_key_t* k = (const aes##bits##_key_t*) keys; /* packed key types */                                     \
+    aes##bits##_sched_##sched##_t* s = (aes##bits##_sched_##sched##_t*) scheds;                                              \
+    double single, batch;                                                                                                    \
+    BENCH_KPS(single, for (size_t i = 0; i < BENCH_KEYS; i++) aes##bits##_load_key##suffix(k + i, s + i);)                   \
+    BENCH_KPS(batch, aes##bits##_load_keys##suffix(k, s, BENCH_KEYS);)                                                       \
+    printf("AES-%d %-4s | 1-key calls: %7.2f Mkeys/s | batch: %7.2f Mkeys/s | x%.2f\n", bits, #sched, single / 1e6, batch / 1e6, batch / single); \
+}
+#define BENCH_KEY_SIZE(bits)         \
+    BENCH_LAYOUT(bits, ,     full)   \
+    BENCH_LAYOUT(bits, _enc, enc)    \
+    BENCH_LAYOUT(bits, _dec, dec)
+
+/* Cycles per dependent key setup: each key is taken from the previous schedule, so setups can't overlap */
+#define BENCH_LATENCY(result, bits, suffix, sched) {                                                   \
+    aes##bits##_sched_##sched##_t* s = (aes##bits##_sched_##sched##_t*) scheds;                        \
+    double _best = 1e30;                                                                               \
+    for (int _t = 0; _t < 3; _t++) {                                                                   \
+        uint64_t _start = __rdtsc();                                                                   \
+        for (int _i = 0; _i < BENCH_KEYS * 16; _i++)                                                   \
+            aes##bits##_load_key##suffix((const aes##bits##_key_t*) (s->bytes + 16), s);               \
+        double _c = (double)(__rdtsc() - _start) / (BENCH_KEYS * 16);                                  \
+        if (_c < _best) _best = _c;                                                                    \
+    }                                                                                                  \
+    (result) = _best;                                                                                  \
+}
+#define BENCH_ENGINES(bits, suffix, sched) {                                                           \
+    double kga, enclast;                                                                               \
+    _hardware.aeskga = 1; aes_dispatch_update();                                                       \
+    BENCH_LATENCY(kga, bits, suffix, sched)                                                            \
+    _hardware.aeskga = 0; aes_dispatch_update();                                                       \
+    BENCH_LATENCY(enclast, bits, suffix, sched)                                                        \
+    printf("AES-%d %-4s | aeskeygenassist: %6.1f cycles/key | aesenclast: %6.1f cycles/key | x%.2f\n", bits, #sched, kga, enclast, kga / enclast); \
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(keys); i++) ((uint8_t*)keys)[i] = (uint8_t)(i * 131 + 7);
+    BENCH_KEY_SIZE(128)
+    BENCH_KEY_SIZE(192)
+    BENCH_KEY_SIZE(256)
+
+    if (!_hardware.aes || !_hardware.ssse3) return 0; /* engines are AES-NI only */
+    const _Bool detected = _hardware.aeskga;
+    printf("\nKey setup latency (detected engine: %s, toggles need a static non-CRYPTOCORE_ASSUME build)\n", detected ? "aeskeygenassist" : "aesenclast");
+    BENCH_ENGINES(128, _enc, enc)
+    BENCH_ENGINES(128, ,     full)
+    BENCH_ENGINES(192, _enc, enc)
+    BENCH_ENGINES(192, ,     full)
+    BENCH_ENGINES(256, _enc, enc)
+    BENCH_ENGINES(256, ,     full)
+    _hardware.aeskga = detected; aes_dispatch_update();
+    return 0;
+}
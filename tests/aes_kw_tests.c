@@ -0,0 +1,124 @@
+/* AES Key Wrap known answer tests (RFC 3394 4.1 - 4.6 for every key size pairing, RFC 5649 section 6: 20 & 7 byte keys),
+ * unwrap round trips, tampered & truncated wrapped keys, bad lengths (nothing written), in-place wrap & unwrap.
+ * Batches: 150 jobs (more than the lanes in flight) of mixed lengths, KW & KWP, against the single calls, then
+ * unwrapped back with one tampered job. Every backend tier the CPU has is forced in turn.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_kw_tests.c -o aes_kw_tests (returns non-zero on failure)
+
+#include "aes_kw.h"
+#include "test_common.h"
+
+typedef struct { const char *kek, *key, *wrapped; } kw_vector_t;
+
+/* RFC 3394 section 4, by KEK size */
+static const kw_vector_t kw128_vectors[] = {
+    { "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "1fa68b0a8112b447aef34bd8fb5a7b829d3e862371d2cfe5" },
+};
+static const kw_vector_t kw192_vectors[] = {
+    { "000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff", "96778b25ae6ca435f92b5b97c050aed2468ab8a17ad84e5d" },
+    { "000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff0001020304050607",
+      "031d33264e15d33268f24ec260743edce1c6c7ddee725a936ba814915c6762d2" },
+};
+static const kw_vector_t kw256_vectors[] = {
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff",
+      "64e8c3f9ce0f5ba263e9777905818a2a93c8191e7d6e8ae7" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff0001020304050607",
+      "a8f9bc1612c68b3ff6e6f4fbe30e71e4769c8b80a32cb8958cd5d17d6b254da1" },
+    { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff000102030405060708090a0b0c0d0e0f",
+      "28c9f404c4b810f4cbccb35cfb87f8263f5786e2d80ed326cbc7f0e71a99f43bfb988b9b7a02dd21" },
+};
+/* RFC 5649 section 6 (192 bits KEK) */
+static const kw_vector_t kwp192_vectors[] = {
+    { "5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8", "c37b7e6492584340bed12207808941155068f738", "138bdeaa9b8fa7fc61f97742e72248ee5ae6ae5360d1ae6a5f54f373fa543b6a" },
+    { "5840df6e29b02af1ab493b705bf16ea1ae8338f4dcc176a8", "466f7250617369", "afbeb0f07dfbf5419200f2ccb50bb24f" },
+};
+
+/* Vectors of one KEK size: wrap, unwrap, tampered unwrap (zeroed output), in-place round trip (kw or kwp) */
+#define TEST_KW_VECTORS(bits, kw, vectors) {                                                                      \
+    for (size_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++) {                                          \
+        aes##bits##_key_t kek; static aes##bits##_kw_ctx_t ctx;                                                   \
+        uint8_t key[32], wrapped[40], out[40], zero[40] = { 0 };                                                  \
+        unhex(vectors[v].kek, kek.bytes);                                                                         \
+        const size_t key_len = unhex(vectors[v].key, key), wrapped_len = unhex(vectors[v].wrapped, wrapped);     \
+        size_t out_len = 0;                                                                                       \
+        aes##bits##_kw_init(&ctx, &kek);                                                                          \
+        CHECK(aes##bits##_##kw##_wrap(&ctx, key, key_len, out), #kw "-%d vector %zu: wrap rejects", bits, v);    \
+        CHECK_MEM(out, wrapped, wrapped_len, #kw "-%d vector %zu: wrap", bits, v);                                \
+        CHECK(TEST_KW_UNWRAP(bits, kw, wrapped, wrapped_len, out) && out_len == key_len,                          \
+              #kw "-%d vector %zu: unwrap rejects", bits, v);                                                     \
+        CHECK_MEM(out, key, key_len, #kw "-%d vector %zu: unwrap", bits, v);                                      \
+        wrapped[wrapped_len - 1] ^= 1;                                                                            \
+        CHECK(!TEST_KW_UNWRAP(bits, kw, wrapped, wrapped_len, out), #kw "-%d vector %zu: unwrap accepts a tampered key", bits, v); \
+        CHECK_MEM(out, zero, wrapped_len - 8, #kw "-%d vector %zu: tampered unwrap output not zeroed", bits, v);  \
+        memcpy(out, key, key_len); /* in place */                                                                 \
+        CHECK(aes##bits##_##kw##_wrap(&ctx, out, key_len, out) && TEST_KW_UNWRAP(bits, kw, out, wrapped_len, out) \
+              && memcmp(out, key, key_len) == 0, #kw "-%d vector %zu: in-place round trip", bits, v);             \
+    }                                                                                                             \
+}
+/* Unwrap for either flavour (KW output length is the input length - 8) */
+#define TEST_KW_UNWRAP(bits, kw, in, len, out) TEST_KW_UNWRAP_##kw(bits, in, len, out)
+#define TEST_KW_UNWRAP_kw(bits, in, len, out)  (out_len = (len) - 8, aes##bits##_kw_unwrap(&ctx, in, len, out))
+#define TEST_KW_UNWRAP_kwp(bits, in, len, out) aes##bits##_kwp_unwrap(&ctx, in, len, out, &out_len)
+
+#define KW_JOBS 150 /* 64 lanes in flight: lanes refill twice */
+#define KW_MAX 72
+static uint8_t kw_keys[KW_JOBS][KW_MAX];
+static uint8_t kw_wrapped[KW_JOBS][KW_MAX + 16];
+static uint8_t kw_out[KW_JOBS][KW_MAX + 16];
+static const uint8_t kw_zero[KW_MAX + 16]; /* a tampered job's output after unwrap */
+
+/* One KEK size: batch wrap (kw: 16 - 72 bytes in 8 byte steps, kwp: 1 - 72 bytes) against the single calls, batch
+ * unwrap back with job 70 tampered, then a bad length in each direction */
+#define TEST_KW_BATCH(bits, kw, bad_wrap, bad_unwrap) {                                                           \
+    aes##bits##_key_t kek; static aes##bits##_kw_ctx_t ctx;                                                       \
+    static aes_kw_job_t jobs[KW_JOBS];                                                                            \
+    size_t out_len = 0;                                                                                           \
+    for (size_t i = 0; i < sizeof(kek.bytes); i++) kek.bytes[i] = (uint8_t) (i * 13 + bits);                      \
+    aes##bits##_kw_init(&ctx, &kek);                                                                              \
+    for (size_t i = 0; i < KW_JOBS; i++) {                                                                        \
+        const size_t len = TEST_KW_LEN_##kw(i);                                                                   \
+        CHECK(aes##bits##_##kw##_wrap(&ctx, kw_keys[i], len, kw_wrapped[i]), #kw "-%d job %zu: wrap rejects", bits, i); \
+        jobs[i] = (aes_kw_job_t) { kw_keys[i], len, kw_out[i], 0, false };                                        \
+    }                                                                                                             \
+    CHECK(aes##bits##_##kw##_wrap_batch(&ctx, jobs, KW_JOBS), #kw "-%d batch: wrap rejects", bits);               \
+    for (size_t i = 0; i < KW_JOBS; i++) {                                                                        \
+        CHECK(jobs[i].valid && jobs[i].out_len == (((jobs[i].len + 7) & ~(size_t) 7) + 8),                        \
+              #kw "-%d batch job %zu: wrapped length", bits, i);                                                  \
+        CHECK_MEM(kw_out[i], kw_wrapped[i], jobs[i].out_len, #kw "-%d batch job %zu (%zu bytes): wrap", bits, i, jobs[i].len); \
+        jobs[i] = (aes_kw_job_t) { kw_wrapped[i], jobs[i].out_len, kw_out[i], 0, false };                         \
+    }                                                                                                             \
+    kw_wrapped[70][3] ^= 0x10;                                                                                    \
+    CHECK(!aes##bits##_##kw##_unwrap_batch(&ctx, jobs, KW_JOBS), #kw "-%d batch: unwrap accepts a tampered key", bits); \
+    for (size_t i = 0; i < KW_JOBS; i++) {                                                                        \
+        const size_t len = i == 70 ? 0 : TEST_KW_LEN_##kw(i);                                                     \
+        CHECK(jobs[i].valid == (i != 70) && jobs[i].out_len == len, #kw "-%d batch job %zu: unwrap validity", bits, i); \
+        CHECK_MEM(kw_out[i], i == 70 ? kw_zero : kw_keys[i], i == 70 ? jobs[i].len - 8 : len, #kw "-%d batch job %zu: unwrap", bits, i); \
+    }                                                                                                             \
+    memset(kw_out[0], 0x5a, 16);                                                                                  \
+    CHECK(!aes##bits##_##kw##_wrap(&ctx, kw_keys[0], bad_wrap, kw_out[0]) && kw_out[0][0] == 0x5a,                \
+          #kw "-%d: wrap accepts %d bytes", bits, bad_wrap);                                                      \
+    CHECK(!TEST_KW_UNWRAP(bits, kw, kw_wrapped[0], bad_unwrap, kw_out[0]) && kw_out[0][0] == 0x5a,                \
+          #kw "-%d: unwrap accepts %d bytes", bits, bad_unwrap);                                                  \
+    (void) out_len;                                                                                               \
+}
+#define TEST_KW_LEN_kw(i)  (16 + (i) * 8 % (KW_MAX - 8))
+#define TEST_KW_LEN_kwp(i) (1 + (i) * 5 % KW_MAX)
+
+static void test_kw(void) {
+    TEST_KW_VECTORS(128, kw, kw128_vectors)
+    TEST_KW_VECTORS(192, kw, kw192_vectors)
+    TEST_KW_VECTORS(256, kw, kw256_vectors)
+    TEST_KW_VECTORS(192, kwp, kwp192_vectors)
+    for (size_t i = 0; i < KW_JOBS; i++) for (size_t j = 0; j < KW_MAX; j++) kw_keys[i][j] = (uint8_t) (i * 31 + j * 7);
+    TEST_KW_BATCH(128, kw, 12, 16)
+    TEST_KW_BATCH(192, kw, 8, 36)
+    TEST_KW_BATCH(256, kw, 0, 8)
+    TEST_KW_BATCH(128, kwp, 0, 12)
+    TEST_KW_BATCH(192, kwp, 0, 8)
+    TEST_KW_BATCH(256, kwp, 0, 20)
+}
+
+int main(void) {
+    test_tiers(aes_dispatch_update, test_kw);
+    return test_report("aes_kw_tests");
+}
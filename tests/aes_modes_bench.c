@@ -0,0 +1,260 @@
+/* AES modes throughput benchmark (cycles/byte)
+ * Compares a naive mode loop (one encrypt_block call per block)
+ * against the pipelined aes_modes.h kernels (CTR, CBC decryption, multi-buffer CBC encryption, XTS sectors), then GCM (aes_gcm.h) seal / open against plain CTR, GMAC (one shot & streamed aad), OCB (aes_ocb.h) against GCM,
+ * CCM (aes_ccm.h) against a two-pass CBC-MAC then CTR, GCM-SIV against GCM (64 KiB & 64 B messages: per-nonce key derivation),
+ * AES-SIV (aes_siv.h) & AES-CMAC (aes_cmac.h) 64 B messages one call each against one batch,
+ * AES-KW (aes_kw.h) 32 B data keys wrapped & unwrapped one call each against one batch,
+ * AEGIS-128L & AEGIS-256 (aes_aegis.h) seal / open against GCM.
+ * Build:
+ *   gcc -O2 -Iinclude src/*.c tests/aes_modes_bench.c -o aes_modes_bench (backend picked at runtime)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <x86intrin.h> /* for __rdtsc */
+#include "aes_modes.h"
+#include "aes_gcm.h"
+#include "aes_ocb.h"
+#include "aes_ccm.h"
+#include "aes_siv.h"
+#include "aes_cmac.h"
+#include "aes_kw.h"
+#include "aes_aegis.h"
+
+#define BENCH_BLOCKS 4096 /* 64 KiB per pass - stays in L2 */
+#define BENCH_PASSES 256
+#define BENCH_STREAMS 16 /* multi-buffer: 16 streams of 4 KiB - 64 B (4 KiB strides would share L1 sets) */
+#define BENCH_STREAM_LEN (4096 - 64)
+#define BENCH_SECTOR 4096 /* XTS: 16 sectors per pass */
+#define BENCH_SHORT 64 /* GCM-SIV: short message size (one nonce each) */
+
+static uint8_t buf[BENCH_BLOCKS][16];
+static uint8_t out[BENCH_BLOCKS][16];
+
+/* Run BODY for every pass & return best-of-3 cycles per byte (of bytes per pass) */
+#define BENCH_CPB(result, BODY) BENCH_CPB_BYTES(result, sizeof(buf), BODY)
+#define BENCH_CPB_BYTES(result, bytes, BODY) {                         \
+    double _best = 1e30;                                               \
+    for (int _t = 0; _t < 3; _t++) {                                   \
+        uint64_t _start = __rdtsc();                                   \
+        for (int _p = 0; _p < BENCH_PASSES; _p++) { BODY }             \
+        double _cpb = (double)(__rdtsc() - _start) / ((double)BENCH_PASSES * (bytes)); \
+        if (_cpb < _best) _best = _cpb;                                \
+    }                                                                  \
+    (result) = _best;                                                  \
+}
+
+/* Naive CTR32: one block per call, counter bumped in between */
+#define NAIVE_CTR(bits, enc, ctr) {                                         \
+    uint8_t ks[16];                                                         \
+    for (size_t i = 0; i < BENCH_BLOCKS; i++) {                             \
+        aes##bits##_encrypt_block(enc, ctr, ks);                            \
+        for (int j = 0; j < 16; j++) buf[i][j] ^= ks[j];                    \
+        for (int j = 15; j >= 12 && ++ctr[j] == 0; j--);                    \
+    }                                                                       \
+}
+
+/* Two-pass CCM payload: CBC-MAC one block per call, then the CTR pass */
+#define TWO_PASS_CCM(bits, enc, ctr) {                                      \
+    uint8_t y[16] = {0};                                                    \
+    for (size_t i = 0; i < BENCH_BLOCKS; i++) {                             \
+        for (int j = 0; j < 16; j++) y[j] ^= buf[i][j];                     \
+        aes##bits##_encrypt_block(enc, y, y);                               \
+    }                                                                       \
+    aes##bits##_ctr_xor(enc, ctr, AES_CTR64, buf[0], buf[0], sizeof(buf));  \
+}
+
+/* Naive CBC decryption: one block per call, chaining block saved in between */
+#define NAIVE_CBC_DEC(bits, full, iv) {                                     \
+    uint8_t c[16];                                                          \
+    for (size_t i = 0; i < BENCH_BLOCKS; i++) {                             \
+        memcpy(c, buf[i], 16);                                              \
+        aes##bits##_decrypt_block(full, buf[i], buf[i]);                    \
+        for (int j = 0; j < 16; j++) buf[i][j] ^= iv[j];                    \
+        memcpy(iv, c, 16);                                                  \
+    }                                                                       \
+}
+
+/* Naive CBC encryption: the streams one after the other, one block per call */
+#define NAIVE_CBC_ENC(bits, enc, iv) {                                      \
+    for (size_t i = 0; i < BENCH_STREAMS * BENCH_STREAM_LEN / 16; i++) {    \
+        if (i % (BENCH_STREAM_LEN / 16) == 0) memset(iv, 0, 16);            \
+        for (int j = 0; j < 16; j++) buf[i][j] ^= iv[j];                    \
+        aes##bits##_encrypt_block(enc, buf[i], buf[i]);                     \
+        memcpy(iv, buf[i], 16);                                             \
+    }                                                                       \
+}
+
+/* Naive XTS encryption: per sector, one block per call, tweak doubled in between */
+#define NAIVE_XTS_ENC(bits, enc, tenc) {                                    \
+    uint8_t t[16];                                                          \
+    for (size_t i = 0; i < BENCH_BLOCKS; i++) {                             \
+        if (i % (BENCH_SECTOR / 16) == 0) {                                 \
+            memset(t, 0, 16); t[0] = (uint8_t) (i / (BENCH_SECTOR / 16));   \
+            aes##bits##_encrypt_block(tenc, t, t);                          \
+        }                                                                   \
+        for (int j = 0; j < 16; j++) buf[i][j] ^= t[j];                     \
+        aes##bits##_encrypt_block(enc, buf[i], buf[i]);                     \
+        for (int j = 0; j < 16; j++) buf[i][j] ^= t[j];                     \
+        uint8_t c = t[15] >> 7;                                             \
+        for (int j = 15; j > 0; j--) t[j] = (uint8_t) (t[j] << 1 | t[j - 1] >> 7); \
+        t[0] = (uint8_t) (t[0] << 1) ^ (0x87 & (0 - c));                    \
+    }                                                                       \
+}
+
+/* Benchmark XTS for one key size: bits = 128, 256 (data & tweak keys differ) */
+#define BENCH_XTS(bits) {                                                                         \
+    aes##bits##_key_t key, tkey; memset(key.bytes, 0x2b, sizeof(key.bytes)); memset(tkey.bytes, 0x7e, sizeof(tkey.bytes)); \
+    aes##bits##_sched_enc_t enc, tenc; aes##bits##_load_key_enc(&key, &enc); aes##bits##_load_key_enc(&tkey, &tenc); \
+    double naive, mode;                                                                           \
+    BENCH_CPB(naive, NAIVE_XTS_ENC(bits, &enc, &tenc))                                            \
+    BENCH_CPB(mode, aes##bits##_xts_encrypt_sectors(&enc, &tenc, 0, BENCH_SECTOR, buf[0], buf[0], sizeof(buf) / BENCH_SECTOR);) \
+    printf("AES-%d XTS     | 1-block calls: %6.3f c/B | %d B sectors: %6.3f c/B | x%.2f\n", bits, naive, BENCH_SECTOR, mode, naive / mode); \
+}
+
+/* Benchmark GCM-SIV against GCM for one key size: bits = 128, 256 (64 KiB, then 64 B messages over the same bytes) */
+#define BENCH_GCM_SIV(bits) {                                                                     \
+    aes##bits##_key_t key; memset(key.bytes, 0x2b, sizeof(key.bytes));                            \
+    aes##bits##_sched_enc_t enc; aes##bits##_load_key_enc(&key, &enc);                            \
+    static aes##bits##_gcm_ctx_t gcm; aes##bits##_gcm_init(&gcm, &key);                           \
+    uint8_t nonce[12] = {0}, tag[16];                                                             \
+    double gcm_long, siv_long, gcm_short, siv_short, open;                                        \
+    BENCH_CPB(gcm_long, aes##bits##_gcm_seal(&gcm, nonce, 12, NULL, 0, buf[0], out[0], sizeof(buf), tag, 16);) \
+    BENCH_CPB(siv_long, aes##bits##_gcm_siv_seal(&enc, nonce, NULL, 0, buf[0], out[0], sizeof(buf), tag);) \
+    BENCH_CPB(open, aes##bits##_gcm_siv_open(&enc, nonce, NULL, 0, out[0], buf[0], sizeof(buf), tag);) /* valid tag */ \
+    printf("AES-%d GCM-SIV | seal: %6.3f c/B | open: %6.3f c/B | vs GCM: x%.2f\n", bits, siv_long, open, gcm_long / siv_long); \
+    BENCH_CPB(gcm_short, for (size_t i = 0; i < sizeof(buf); i += BENCH_SHORT) { nonce[0] = (uint8_t) i; \
+        aes##bits##_gcm_seal(&gcm, nonce, 12, NULL, 0, buf[0] + i, out[0] + i, BENCH_SHORT, tag, 16); }) \
+    BENCH_CPB(siv_short, for (size_t i = 0; i < sizeof(buf); i += BENCH_SHORT) { nonce[0] = (uint8_t) i; \
+        aes##bits##_gcm_siv_seal(&enc, nonce, NULL, 0, buf[0] + i, out[0] + i, BENCH_SHORT, tag); }) \
+    printf("AES-%d GCM-SIV | %d B messages: GCM %6.3f c/B | GCM-SIV %6.3f c/B | x%.2f\n", bits, BENCH_SHORT, gcm_short, siv_short, gcm_short / siv_short); \
+}
+
+/* Benchmark AES-SIV short messages for one key size: bits = 128, 256 (one call per message, then the whole pass as a batch) */
+#define BENCH_SIV(bits) {                                                                         \
+    aes##bits##_key_t key; memset(key.bytes, 0x2b, sizeof(key.bytes));                            \
+    static aes##bits##_siv_ctx_t siv; aes##bits##_siv_init(&siv, &key, &key);                     \
+    static aes_siv_msg_t msgs[sizeof(buf) / BENCH_SHORT];                                         \
+    for (size_t i = 0; i < sizeof(buf) / BENCH_SHORT; i++)                                        \
+        msgs[i] = (aes_siv_msg_t) { NULL, NULL, 0, buf[0] + i * BENCH_SHORT, out[0] + i * BENCH_SHORT, BENCH_SHORT, {0}, false }; \
+    uint8_t tag[16];                                                                              \
+    double single, batch;                                                                         \
+    BENCH_CPB(single, for (size_t i = 0; i < sizeof(buf); i += BENCH_SHORT)                       \
+        aes##bits##_siv_seal(&siv, NULL, NULL, 0, buf[0] + i, out[0] + i, BENCH_SHORT, tag);)     \
+    BENCH_CPB(batch, aes##bits##_siv_seal_batch(&siv, msgs, sizeof(buf) / BENCH_SHORT);)          \
+    printf("AES-%d SIV     | %d B messages: 1 per call %6.3f c/B | batch %6.3f c/B | x%.2f\n", bits, BENCH_SHORT, single, batch, single / batch); \
+}
+
+/* Benchmark AES-CMAC short messages for one key size: bits = 128, 256 (one call per message, then multi-buffer) */
+#define BENCH_CMAC(bits) {                                                                        \
+    aes##bits##_key_t key; memset(key.bytes, 0x2b, sizeof(key.bytes));                            \
+    static aes##bits##_cmac_ctx_t cmac; aes##bits##_cmac_init(&cmac, &key);                       \
+    static aes_cmac_msg_t msgs[sizeof(buf) / BENCH_SHORT];                                        \
+    static const aes##bits##_cmac_ctx_t* ctxs[sizeof(buf) / BENCH_SHORT];                         \
+    for (size_t i = 0; i < sizeof(buf) / BENCH_SHORT; i++) {                                      \
+        ctxs[i] = &cmac;                                                                          \
+        msgs[i] = (aes_cmac_msg_t) { buf[0] + i * BENCH_SHORT, BENCH_SHORT, {0}, false };         \
+    }                                                                                             \
+    uint8_t tag[16];                                                                              \
+    double single, mb;                                                                            \
+    BENCH_CPB(single, for (size_t i = 0; i < sizeof(buf); i += BENCH_SHORT)                       \
+        aes##bits##_cmac(&cmac, buf[0] + i, BENCH_SHORT, tag);)                                   \
+    BENCH_CPB(mb, aes##bits##_cmac_mb(ctxs, msgs, sizeof(buf) / BENCH_SHORT);)                    \
+    printf("AES-%d CMAC    | %d B messages: 1 per call %6.3f c/B | multi-buffer %6.3f c/B | x%.2f\n", bits, BENCH_SHORT, single, mb, single / mb); \
+}
+
+/* Benchmark AES-KW of 32 B data keys for one KEK size: bits = 128, 256 (one call per key, then one batch) */
+#define BENCH_KW(bits) {                                                                          \
+    aes##bits##_key_t key; memset(key.bytes, 0x2b, sizeof(key.bytes));                            \
+    static aes##bits##_kw_ctx_t kw; aes##bits##_kw_init(&kw, &key);                               \
+    static aes_kw_job_t jobs[sizeof(buf) / 40];                                                   \
+    for (size_t i = 0; i < sizeof(buf) / 40; i++)                                                 \
+        jobs[i] = (aes_kw_job_t) { buf[0] + i * 32, 32, out[0] + i * 40, 0, false };              \
+    double single, batch, unwrap;                                                                 \
+    BENCH_CPB_BYTES(single, sizeof(buf) / 40 * 32, for (size_t i = 0; i < sizeof(buf) / 40; i++)  \
+        aes##bits##_kw_wrap(&kw, buf[0] + i * 32, 32, out[0] + i * 40);)                          \
+    BENCH_CPB_BYTES(batch, sizeof(buf) / 40 * 32, aes##bits##_kw_wrap_batch(&kw, jobs, sizeof(buf) / 40);) \
+    for (size_t i = 0; i < sizeof(buf) / 40; i++)                                                 \
+        jobs[i] = (aes_kw_job_t) { out[0] + i * 40, 40, buf[0] + i * 32, 0, false };              \
+    BENCH_CPB_BYTES(unwrap, sizeof(buf) / 40 * 32, aes##bits##_kw_unwrap_batch(&kw, jobs, sizeof(buf) / 40);) \
+    printf("AES-%d KW      | 32 B keys: 1 per call %6.3f c/B | batch %6.3f c/B | x%.2f | batch unwrap %6.3f c/B\n", bits, single, batch, single / batch, unwrap); \
+}
+
+/* Benchmark AEGIS for one variant: v = 128l (V = 128L, bits = 128), 256, against GCM of the same key size */
+#define BENCH_AEGIS(v, V, bits, nonce_bytes) {                                                    \
+    aes##bits##_key_t key; memset(key.bytes, 0x2b, sizeof(key.bytes));                            \
+    static aes##bits##_gcm_ctx_t gcm; aes##bits##_gcm_init(&gcm, &key);                           \
+    uint8_t nonce[nonce_bytes] = {0}, tag[16];                                                    \
+    double gcm_seal, seal, open;                                                                  \
+    BENCH_CPB(gcm_seal, aes##bits##_gcm_seal(&gcm, nonce, 12, NULL, 0, buf[0], out[0], sizeof(buf), tag, 16);) \
+    BENCH_CPB(seal, aegis##v##_seal(&key, nonce, NULL, 0, buf[0], out[0], sizeof(buf), tag, 16);) \
+    BENCH_CPB(open, aegis##v##_open(&key, nonce, NULL, 0, out[0], buf[0], sizeof(buf), tag, 16);) /* valid tag */ \
+    printf("AEGIS-%-10s| seal: %6.3f c/B | open: %6.3f c/B | vs GCM: x%.2f\n", #V, seal, open, gcm_seal / seal); \
+}
+
+/* Benchmark one key size: bits = 128, 192, 256 */
+#define BENCH_KEY_SIZE(bits) {                                                                    \
+    aes##bits##_key_t key; memset(key.bytes, 0x2b, sizeof(key.bytes));                            \
+    aes##bits##_sched_enc_t enc; aes##bits##_load_key_enc(&key, &enc);                            \
+    uint8_t ctr[16] = {0};                                                                        \
+    double naive, mode;                                                                           \
+    BENCH_CPB(naive, NAIVE_CTR(bits, &enc, ctr))                                                  \
+    BENCH_CPB(mode, aes##bits##_ctr_xor(&enc, ctr, AES_CTR32, buf[0], buf[0], sizeof(buf));)       \
+    printf("AES-%d CTR32   | 1-block calls: %6.3f c/B | mode: %6.3f c/B | x%.2f\n", bits, naive, mode, naive / mode); \
+    BENCH_CPB(mode, aes##bits##_ctr_xor(&enc, ctr, AES_CTR128, buf[0], buf[0], sizeof(buf));)      \
+    printf("AES-%d CTR128  |                             | mode: %6.3f c/B\n", bits, mode);      \
+    static aes##bits##_gcm_ctx_t gcm; aes##bits##_gcm_init(&gcm, &key);                           \
+    uint8_t tag[16];                                                                              \
+    double seal, open;                                                                            \
+    BENCH_CPB(seal, aes##bits##_gcm_seal(&gcm, ctr, 12, NULL, 0, buf[0], out[0], sizeof(buf), tag, 16);) \
+    BENCH_CPB(open, aes##bits##_gcm_open(&gcm, ctr, 12, NULL, 0, out[0], buf[0], sizeof(buf), tag, 16);) /* valid tag */ \
+    printf("AES-%d GCM     | seal: %6.3f c/B | open: %6.3f c/B | vs CTR: x%.2f\n", bits, seal, open, seal / mode); \
+    aes_gmac_stream_t gmac;                                                                       \
+    BENCH_CPB(seal, aes##bits##_gmac(&gcm, ctr, 12, buf[0], sizeof(buf), tag, 16);)               \
+    BENCH_CPB(open, aes##bits##_gmac_start(&gcm, &gmac, ctr, 12);                                 \
+        for (size_t i = 0; i < sizeof(buf); i += 1000) aes_gmac_update(&gmac, buf[0] + i, sizeof(buf) - i < 1000 ? sizeof(buf) - i : 1000); \
+        aes_gmac_final(&gmac, tag, 16);)                                                          \
+    printf("AES-%d GMAC    | aad: %6.3f c/B | 1000 B stream updates: %6.3f c/B\n", bits, seal, open); \
+    static aes##bits##_ocb_ctx_t ocb; aes##bits##_ocb_init(&ocb, &key);                           \
+    double gcm_seal = seal;                                                                       \
+    BENCH_CPB(seal, aes##bits##_ocb_seal(&ocb, ctr, 12, NULL, 0, buf[0], out[0], sizeof(buf), tag, 16);) \
+    BENCH_CPB(open, aes##bits##_ocb_open(&ocb, ctr, 12, NULL, 0, out[0], buf[0], sizeof(buf), tag, 16);) /* valid tag */ \
+    printf("AES-%d OCB     | seal: %6.3f c/B | open: %6.3f c/B | vs GCM: x%.2f\n", bits, seal, open, gcm_seal / seal); \
+    BENCH_CPB(naive, TWO_PASS_CCM(bits, &enc, ctr))                                               \
+    BENCH_CPB(mode, aes##bits##_ccm_seal(&enc, ctr, 12, NULL, 0, buf[0], buf[0], sizeof(buf), tag, 16);) \
+    printf("AES-%d CCM     | two-pass: %6.3f c/B | stitched: %6.3f c/B | x%.2f\n", bits, naive, mode, naive / mode); \
+    aes##bits##_sched_full_t full; aes##bits##_load_key(&key, &full);                             \
+    uint8_t iv[16] = {0};                                                                         \
+    BENCH_CPB(naive, NAIVE_CBC_DEC(bits, &full, iv))                                              \
+    BENCH_CPB(mode, aes##bits##_cbc_decrypt(&full, iv, (const uint8_t (*)[16]) buf, buf, BENCH_BLOCKS);) \
+    printf("AES-%d CBC dec | 1-block calls: %6.3f c/B | mode: %6.3f c/B | x%.2f\n", bits, naive, mode, naive / mode); \
+    const aes##bits##_sched_enc_t* scheds[BENCH_STREAMS]; aes_mb_stream_t streams[BENCH_STREAMS];  \
+    for (int i = 0; i < BENCH_STREAMS; i++) {                                                     \
+        scheds[i] = &enc;                                                                         \
+        streams[i].in = streams[i].out = buf[i * (BENCH_STREAM_LEN / 16)];                        \
+        streams[i].len = BENCH_STREAM_LEN;                                                        \
+    }                                                                                             \
+    BENCH_CPB_BYTES(naive, BENCH_STREAMS * BENCH_STREAM_LEN, NAIVE_CBC_ENC(bits, &enc, iv))       \
+    BENCH_CPB_BYTES(mode, BENCH_STREAMS * BENCH_STREAM_LEN, aes##bits##_cbc_encrypt_mb(scheds, streams, BENCH_STREAMS);) \
+    printf("AES-%d CBC enc | 1-block calls: %6.3f c/B | %d streams: %6.3f c/B | x%.2f\n", bits, naive, BENCH_STREAMS, mode, naive / mode); \
+}
+
+int main(void) {
+    memset(buf, 0xa5, sizeof(buf));
+    BENCH_KEY_SIZE(128)
+    BENCH_KEY_SIZE(192)
+    BENCH_KEY_SIZE(256)
+    BENCH_XTS(128)
+    BENCH_XTS(256)
+    BENCH_GCM_SIV(128)
+    BENCH_GCM_SIV(256)
+    BENCH_SIV(128)
+    BENCH_SIV(256)
+    BENCH_CMAC(128)
+    BENCH_CMAC(256)
+    BENCH_KW(128)
+    BENCH_KW(256)
+    BENCH_AEGIS(128l, 128L, 128, 16)
+    BENCH_AEGIS(256, 256, 256, 32)
+    return 0;
+}
@@ -0,0 +1,490 @@
+/* Block cipher mode known answer tests: CTR (SP 800-38A F.5.1, F.5.3 & F.5.5) with every counter width,
+ * plus counter wrap checks of the 32, 64 & 128 bit counters against a block by block reference.
+ * CBC decryption (SP 800-38A F.2.2, F.2.4 & F.2.6) with full, dec & enc schedules, plus a 70 block message
+ * against a block by block CBC encryption, both separate & in-place, in one call & split (iv carried across).
+ * Multi-buffer CBC & CFB encryption and OFB (SP 800-38A F.2, F.3 CFB128 & F.4 encryption vectors as streams,
+ * then 37 streams of mixed lengths, empty & under a block included, under 3 schedules against a block by block
+ * reference & one stream calls), with the updated ivs. Multi-buffer CBC-MAC against the CBC reference's ivs.
+ * XTS (IEEE 1619-2007 Annex B vectors 1-5 & 10, ciphertext stealing vectors 15-18), as single data units & as
+ * sector batches, plus ciphertext stealing round trips of 16-80 bytes.
+ * Every backend tier the CPU has is forced in turn.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_modes_tests.c -o aes_modes_tests (returns non-zero on failure)
+
+#include "aes_modes.h"
+#include "test_common.h"
+
+/* SP 800-38A Appendix F: one key per size, the shared 4 block plaintext */
+#define SP800_38A_PLAIN "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51" \
+                        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710"
+#define SP800_38A_KEY128 "2b7e151628aed2a6abf7158809cf4f3c"
+#define SP800_38A_KEY192 "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b"
+#define SP800_38A_KEY256 "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4"
+
+/* F.5: initial counter, cipher & the counter after the 4 blocks (no width wraps there) */
+#define CTR_COUNTER      "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"
+#define CTR_COUNTER_NEXT "f0f1f2f3f4f5f6f7f8f9fafbfcfdff03"
+static const char* const ctr128_cipher = "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+                                         "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee";
+static const char* const ctr192_cipher = "1abc932417521ca24f2b0459fe7e6e0b090339ec0aa6faefd5ccc2c6f4ce8e94"
+                                         "1e36b26bd1ebc670d1bd1d665620abf74f78a7f6d29809585a97daec58c6b050";
+static const char* const ctr256_cipher = "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+                                         "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6";
+
+/* F.2: iv & cipher (decryption takes the cipher back to SP800_38A_PLAIN) */
+#define CBC_IV "000102030405060708090a0b0c0d0e0f"
+static const char* const cbc128_cipher = "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+                                         "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7";
+static const char* const cbc192_cipher = "4f021db243bc633d7178183a9fa071e8b4d9ada9ad7dedf4e5e738763f69145a"
+                                         "571b242012fb7ae07fa9baac3df102e008b0e27988598881d920a9e64f5615cd";
+static const char* const cbc256_cipher = "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d"
+                                         "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b";
+
+/* F.3.13, F.3.15 & F.3.17 (CFB128) and F.4.1, F.4.3 & F.4.5 (OFB): cipher, same iv */
+static const char* const cfb128_cipher = "3b3fd92eb72dad20333449f8e83cfb4ac8a64537a0b3a93fcde3cdad9f1ce58b"
+                                         "26751f67a3cbb140b1808cf187a4f4dfc04b05357c5d1c0eeac4c66f9ff7f2e6";
+static const char* const cfb192_cipher = "cdc80d6fddf18cab34c25909c99a417467ce7f7f81173621961a2b70171d3d7a"
+                                         "2e1e8a1dd59b88b1c8e60fed1efac4c9c05f9f9ca9834fa042ae8fba584b09ff";
+static const char* const cfb256_cipher = "dc7e84bfda79164b7ecd8486985d386039ffed143b28b1c832113c6331e5407b"
+                                         "df10132415e54b92a13ed0a8267ae2f975a385741ab9cef82031623d55b1e471";
+static const char* const ofb128_cipher = "3b3fd92eb72dad20333449f8e83cfb4a7789508d16918f03f53c52dac54ed825"
+                                         "9740051e9c5fecf64344f7a82260edcc304c6528f659c77866a510d9c1d6ae5e";
+static const char* const ofb192_cipher = "cdc80d6fddf18cab34c25909c99a4174fcc28b8d4c63837c09e81700c1100401"
+                                         "8d9a9aeac0f6596f559c6d4daf59a5f26d9f200857ca6c3e9cac524bd9acc92a";
+static const char* const ofb256_cipher = "dc7e84bfda79164b7ecd8486985d38604febdc6740d20b3ac88f6ad82a4fb08d"
+                                         "71ab47a086e86eedf39d1c5bba97c4080126141d67f37be8538f5a8be740e484";
+
+static const aes_ctr_width_t ctr_widths[] = { AES_CTR32, AES_CTR64, AES_CTR128 };
+
+#define TEST_BLOCKS 70 /* 2 VAES-512 passes & every tail width */
+#define CTR_WRAP_AT 21 /* blocks before the counter wraps: inside a pass, off every register boundary */
+#define MODES_MAX (16 * TEST_BLOCKS)
+static uint8_t plain[MODES_MAX], cipher[MODES_MAX], out[MODES_MAX];
+
+/* One key size: the F.5 vector with each counter width (separate & in-place, counter advanced past 4 blocks) */
+#define TEST_CTR(bits) {                                                                                          \
+    aes##bits##_key_t key; aes##bits##_sched_enc_t enc;                                                           \
+    uint8_t counter[16], next[16];                                                                                \
+    unhex(SP800_38A_KEY##bits, key.bytes); aes##bits##_load_key_enc(&key, &enc);                                  \
+    const size_t len = unhex(SP800_38A_PLAIN, plain);                                                             \
+    unhex(ctr##bits##_cipher, cipher); unhex(CTR_COUNTER_NEXT, next);                                             \
+    for (size_t w = 0; w < sizeof(ctr_widths) / sizeof(ctr_widths[0]); w++) {                                     \
+        unhex(CTR_COUNTER, counter);                                                                              \
+        aes##bits##_ctr_xor(&enc, counter, ctr_widths[w], plain, out, len);                                       \
+        CHECK_MEM(out, cipher, len, "CTR-%d width %d: F.5 cipher", bits, ctr_widths[w]);                          \
+        CHECK_MEM(counter, next, 16, "CTR-%d width %d: F.5 counter (encrypt)", bits, ctr_widths[w]);              \
+        unhex(CTR_COUNTER, counter);                                                                              \
+        aes##bits##_ctr_xor(&enc, counter, ctr_widths[w], out, out, len);                                         \
+        CHECK_MEM(out, plain, len, "CTR-%d width %d: F.5 in-place decrypt", bits, ctr_widths[w]);                 \
+        CHECK_MEM(counter, next, 16, "CTR-%d width %d: F.5 counter (decrypt)", bits, ctr_widths[w]);              \
+    }                                                                                                             \
+}
+
+/* Reference increment: the low width bits of the big-endian block, wrapping within them */
+static void ctr_ref_inc(uint8_t counter[16], aes_ctr_width_t width) {
+    for (int i = 15; i >= 16 - (int) width / 8; i--)
+        if (++counter[i]) break;
+}
+
+/* Counter whose low bits wrap after CTR_WRAP_AT blocks for every width: all ones but the first byte,
+ * so a carry past the width shows (CTR128 carries into the first byte) */
+static void ctr_wrap_counter(uint8_t counter[16]) {
+    memset(counter, 0xff, 16);
+    counter[0] = 0x5a;
+    counter[15] = (uint8_t) (0x100 - CTR_WRAP_AT);
+}
+
+/* One key size & width: TEST_BLOCKS blocks (and a partial last block) across the wrap against encrypt_blocks
+ * over reference counters, separate & in-place, in one call & split at the wrap */
+#define TEST_CTR_WRAP(bits, width) {                                                                              \
+    aes##bits##_key_t key; aes##bits##_sched_enc_t enc;                                                           \
+    static uint8_t blocks[TEST_BLOCKS][16];                                                                       \
+    uint8_t counter[16], ref[16];                                                                                 \
+    for (size_t i = 0; i < sizeof(key.bytes); i++) key.bytes[i] = (uint8_t) (i * 7 + bits);                       \
+    aes##bits##_load_key_enc(&key, &enc);                                                                         \
+    ctr_wrap_counter(ref);                                                                                        \
+    for (size_t i = 0; i < TEST_BLOCKS; i++) { memcpy(blocks[i], ref, 16); ctr_ref_inc(ref, width); }             \
+    aes##bits##_encrypt_blocks(&enc, (const uint8_t (*)[16]) blocks, blocks, TEST_BLOCKS);                        \
+    for (size_t i = 0; i < MODES_MAX; i++) cipher[i] = plain[i] ^ blocks[i / 16][i % 16];                         \
+    for (size_t len = MODES_MAX - 11; len <= MODES_MAX; len += 11) {                                              \
+        ctr_wrap_counter(counter);                                                                                \
+        aes##bits##_ctr_xor(&enc, counter, width, plain, out, len);                                               \
+        CHECK_MEM(out, cipher, len, "CTR-%d width %d: %zu bytes across the wrap", bits, width, len);              \
+        CHECK_MEM(counter, ref, 16, "CTR-%d width %d: counter after %zu bytes", bits, width, len);                \
+        memcpy(out, plain, len);                                                                                  \
+        ctr_wrap_counter(counter);                                                                                \
+        aes##bits##_ctr_xor(&enc, counter, width, out, out, len);                                                 \
+        CHECK_MEM(out, cipher, len, "CTR-%d width %d: %zu bytes in-place across the wrap", bits, width, len);     \
+    }                                                                                                             \
+    ctr_wrap_counter(counter);                                                                                    \
+    aes##bits##_ctr_xor(&enc, counter, width, plain, out, 16 * (CTR_WRAP_AT - 1));                                \
+    aes##bits##_ctr_xor(&enc, counter, width, plain + 16 * (CTR_WRAP_AT - 1), out + 16 * (CTR_WRAP_AT - 1),       \
+                        MODES_MAX - 16 * (CTR_WRAP_AT - 1));                                                      \
+    CHECK_MEM(out, cipher, MODES_MAX, "CTR-%d width %d: split one block before the wrap", bits, width);           \
+}
+
+/* 128 bit counter of all ones: wraps to zero */
+static void test_ctr128_full_wrap(void) {
+    aes128_key_t key; aes128_sched_enc_t enc;
+    uint8_t counter[16], blocks[3][16] = { { 0 } }, zero[16] = { 0 };
+    unhex(SP800_38A_KEY128, key.bytes); aes128_load_key_enc(&key, &enc);
+    memset(blocks[0], 0xff, 16); blocks[2][15] = 1;
+    memset(counter, 0xff, 16);
+    aes128_encrypt_blocks(&enc, (const uint8_t (*)[16]) blocks, blocks, 3);
+    aes128_ctr_xor(&enc, counter, AES_CTR128, (const uint8_t*) blocks, out, 48); /* plain = keystream: out is zero */
+    CHECK(memcmp(out, zero, 16) == 0 && memcmp(out + 16, zero, 16) == 0 && memcmp(out + 32, zero, 16) == 0,
+          "CTR-128 width 128: all ones counter wraps to zero");
+    CHECK(counter[15] == 2 && memcmp(counter, zero, 15) == 0, "CTR-128 width 128: counter after the full wrap");
+}
+
+/* One key size & schedule (S: full, dec or enc, fn: the matching cbc_decrypt suffix), n blocks of cipher:
+ * separate, in-place & split after `split` blocks, plain & the returned iv (the last cipher block) each time */
+#define TEST_CBC_SCHED(bits, S, fn, n, split, what) {                                                             \
+    uint8_t iv[16];                                                                                               \
+    memcpy(iv, iv0, 16);                                                                                          \
+    aes##bits##_cbc_decrypt##fn(&S, iv, (const uint8_t (*)[16]) cipher, (uint8_t (*)[16]) out, n);                \
+    CHECK_MEM(out, plain, 16 * (n), "CBC-%d %s %s: decrypt", bits, #S, what);                                     \
+    CHECK_MEM(iv, cipher + 16 * ((n) - 1), 16, "CBC-%d %s %s: returned iv", bits, #S, what);                      \
+    memcpy(out, cipher, 16 * (n)); memcpy(iv, iv0, 16);                                                           \
+    aes##bits##_cbc_decrypt##fn(&S, iv, (const uint8_t (*)[16]) out, (uint8_t (*)[16]) out, n);                   \
+    CHECK_MEM(out, plain, 16 * (n), "CBC-%d %s %s: in-place decrypt", bits, #S, what);                            \
+    CHECK_MEM(iv, cipher + 16 * ((n) - 1), 16, "CBC-%d %s %s: in-place returned iv", bits, #S, what);             \
+    memcpy(out, cipher, 16 * (n)); memcpy(iv, iv0, 16);                                                           \
+    aes##bits##_cbc_decrypt##fn(&S, iv, (const uint8_t (*)[16]) out, (uint8_t (*)[16]) out, split);               \
+    CHECK_MEM(iv, cipher + 16 * ((split) - 1), 16, "CBC-%d %s %s: iv after %d blocks", bits, #S, what, split);    \
+    aes##bits##_cbc_decrypt##fn(&S, iv, (const uint8_t (*)[16]) out + (split), (uint8_t (*)[16]) out + (split),   \
+                                (n) - (split));                                                                   \
+    CHECK_MEM(out, plain, 16 * (n), "CBC-%d %s %s: decrypt split after %d blocks", bits, #S, what, split);        \
+    CHECK_MEM(iv, cipher + 16 * ((n) - 1), 16, "CBC-%d %s %s: split returned iv", bits, #S, what);                \
+}
+
+/* One key size: the F.2 vector, then TEST_BLOCKS blocks encrypted block by block, through each schedule type */
+#define TEST_CBC(bits) {                                                                                          \
+    aes##bits##_key_t key; aes##bits##_sched_full_t full;                                                         \
+    aes##bits##_sched_dec_t dec; aes##bits##_sched_enc_t enc;                                                     \
+    uint8_t iv0[16];                                                                                              \
+    unhex(SP800_38A_KEY##bits, key.bytes);                                                                        \
+    aes##bits##_load_key(&key, &full); aes##bits##_load_key_dec(&key, &dec);                                      \
+    aes##bits##_load_key_enc(&key, &enc);                                                                         \
+    unhex(CBC_IV, iv0); unhex(SP800_38A_PLAIN, plain); unhex(cbc##bits##_cipher, cipher);                         \
+    TEST_CBC_SCHED(bits, full, , 4, 1, "F.2")                                                                     \
+    TEST_CBC_SCHED(bits, dec, _dec, 4, 1, "F.2")                                                                  \
+    TEST_CBC_SCHED(bits, enc, _enc, 4, 1, "F.2")                                                                  \
+    for (size_t i = 0; i < MODES_MAX; i++) plain[i] = (uint8_t) (i * 13 + 5);                                     \
+    for (size_t b = 0; b < TEST_BLOCKS; b++) {                                                                    \
+        const uint8_t* prev = b ? cipher + 16 * (b - 1) : iv0;                                                    \
+        for (size_t i = 0; i < 16; i++) cipher[16 * b + i] = plain[16 * b + i] ^ prev[i];                         \
+        aes##bits##_encrypt_block(&enc, cipher + 16 * b, cipher + 16 * b);                                        \
+    }                                                                                                             \
+    TEST_CBC_SCHED(bits, full, , TEST_BLOCKS, 33, "70 blocks")                                                    \
+    TEST_CBC_SCHED(bits, dec, _dec, TEST_BLOCKS, 33, "70 blocks")                                                 \
+    TEST_CBC_SCHED(bits, enc, _enc, TEST_BLOCKS, 33, "70 blocks")                                                 \
+}
+
+static void test_cbc(void) {
+    TEST_CBC(128)
+    TEST_CBC(192)
+    TEST_CBC(256)
+}
+
+/* Multi-buffer modes in test order */
+enum { MB_CBC, MB_CFB, MB_OFB, MB_MODES };
+static const char* const mb_names[MB_MODES] = { "CBC", "CFB", "OFB" };
+
+#define MB_STREAMS 37 /* 2 rounds of 16 lanes & a partial one, lanes refill as streams end */
+#define MB_MAX 300
+static uint8_t mb_in[MB_STREAMS][MB_MAX], mb_out[MB_STREAMS][MB_MAX], mb_ref[MB_STREAMS][MB_MAX];
+
+/* Stream i: every 9th empty, every 7th under a block, the rest 16-299 bytes (whole blocks & partial tails) */
+static size_t mb_len(size_t i) { return i % 9 == 0 ? 0 : i % 7 == 1 ? i % 16 : 16 + (i * 53) % (MB_MAX - 16); }
+
+/* Generates a block by block reference of one multi-buffer stream (iv updated after the last whole block) */
+#define MB_REF_FN(bits)                                                                                           \
+    static void mb_ref##bits(int mode, const aes##bits##_sched_enc_t* s, const uint8_t* in, uint8_t* out,         \
+                             size_t len, uint8_t iv[16]) {                                                        \
+        uint8_t ks[16];                                                                                           \
+        for (; len >= 16; len -= 16, in += 16, out += 16) {                                                       \
+            if (mode == MB_CBC) { for (int i = 0; i < 16; i++) iv[i] ^= in[i]; }                                  \
+            aes##bits##_encrypt_block(s, iv, ks);                                                                 \
+            for (int i = 0; i < 16; i++) out[i] = mode == MB_CBC ? ks[i] : ks[i] ^ in[i];                         \
+            memcpy(iv, mode == MB_OFB ? ks : out, 16);                                                            \
+        }                                                                                                         \
+        if (mode == MB_CBC || !len) return;                                                                       \
+        aes##bits##_encrypt_block(s, iv, ks);                                                                     \
+        for (size_t i = 0; i < len; i++) out[i] = ks[i] ^ in[i];                                                  \
+    }
+MB_REF_FN(128)
+MB_REF_FN(192)
+MB_REF_FN(256)
+#undef MB_REF_FN
+
+/* One key size & mode (fn: cbc_encrypt_mb, cfb_encrypt_mb or ofb_xor_mb, v: its SP 800-38A cipher) */
+#define TEST_MB_MODE(bits, mode, fn, v) {                                                                         \
+    aes_mb_stream_t streams[MB_STREAMS];                                                                          \
+    const aes##bits##_sched_enc_t* schedules[MB_STREAMS];                                                         \
+    uint8_t iv[16];                                                                                               \
+    /* The vector: 4 blocks as one stream, then as 4 streams of a block each (iv handed on) & 3 empty ones */     \
+    unhex(SP800_38A_PLAIN, plain); unhex(v, cipher);                                                              \
+    streams[0] = (aes_mb_stream_t) { plain, out, 64, { 0 } }; unhex(CBC_IV, streams[0].iv);                       \
+    schedules[0] = &enc[0];                                                                                       \
+    aes##bits##_##fn(schedules, streams, 1);                                                                      \
+    CHECK_MEM(out, cipher, 64, "%s-%d mb: SP 800-38A vector", mb_names[mode], bits);                              \
+    memcpy(iv, cipher + 48, 16);                                                                                  \
+    if (mode == MB_OFB) for (int i = 0; i < 16; i++) iv[i] ^= plain[48 + i];                                      \
+    CHECK_MEM(streams[0].iv, iv, 16, "%s-%d mb: SP 800-38A vector iv", mb_names[mode], bits);                     \
+    memcpy(out, plain, 64);                                                                                       \
+    unhex(CBC_IV, iv);                                                                                            \
+    for (size_t b = 0; b < 4; b++) {                                                                              \
+        for (size_t i = 0; i < 4; i++) {                                                                          \
+            streams[i] = (aes_mb_stream_t) { out + 16 * b, out + 16 * b, i == 1 ? 16 : 0, { 0 } };                \
+            memcpy(streams[i].iv, iv, 16); schedules[i] = &enc[0];                                                \
+        }                                                                                                         \
+        aes##bits##_##fn(schedules, streams, 4);                                                                  \
+        CHECK_MEM(streams[0].iv, iv, 16, "%s-%d mb: empty stream changes its iv", mb_names[mode], bits);          \
+        memcpy(iv, streams[1].iv, 16);                                                                            \
+    }                                                                                                             \
+    CHECK_MEM(out, cipher, 64, "%s-%d mb: SP 800-38A vector as in-place block streams", mb_names[mode], bits);    \
+    /* Mixed streams: 3 schedules, every 4th stream in-place */                                                   \
+    for (size_t i = 0; i < MB_STREAMS; i++) {                                                                     \
+        const size_t len = mb_len(i);                                                                             \
+        uint8_t* dst = i % 4 == 3 ? mb_in[i] : mb_out[i];                                                         \
+        for (size_t j = 0; j < MB_MAX; j++) mb_in[i][j] = (uint8_t) (i * 31 + j * 7 + mode);                      \
+        memset(mb_out[i], 0xAA, MB_MAX); memcpy(mb_ref[i], mb_out[i], MB_MAX);                                    \
+        streams[i] = (aes_mb_stream_t) { mb_in[i], dst, len, { 0 } };                                             \
+        for (int j = 0; j < 16; j++) streams[i].iv[j] = (uint8_t) (i + j * 3);                                    \
+        schedules[i] = &enc[i % 3];                                                                               \
+        memcpy(iv, streams[i].iv, 16);                                                                            \
+        if (i % 4 == 3) memcpy(mb_ref[i], mb_in[i], MB_MAX);                                                      \
+        mb_ref##bits(mode, schedules[i], mb_in[i], mb_ref[i], len, iv);                                           \
+        memcpy(ivs[i], iv, 16);                                                                                   \
+    }                                                                                                             \
+    for (size_t i = 0; i < MB_STREAMS; i++) {                                                                     \
+        aes_mb_stream_t one = streams[i];                                                                         \
+        static uint8_t single[MB_MAX];                                                                            \
+        memset(single, 0xAA, MB_MAX);                                                                             \
+        one.out = single;                                                                                         \
+        aes##bits##_##fn(schedules + i, &one, 1);                                                                 \
+        const size_t written = mode == MB_CBC ? one.len & ~(size_t) 15 : one.len; /* CBC: no tail */              \
+        CHECK_MEM(single, mb_ref[i], written, "%s-%d mb: stream %zu alone", mb_names[mode], bits, i);             \
+        CHECK_MEM(one.iv, ivs[i], 16, "%s-%d mb: stream %zu alone iv", mb_names[mode], bits, i);                  \
+    }                                                                                                             \
+    aes##bits##_##fn(schedules, streams, MB_STREAMS);                                                             \
+    for (size_t i = 0; i < MB_STREAMS; i++) {                                                                     \
+        const uint8_t* got = i % 4 == 3 ? mb_in[i] : mb_out[i];                                                   \
+        CHECK_MEM(got, mb_ref[i], MB_MAX, "%s-%d mb: stream %zu (%zu bytes)",                                     \
+                  mb_names[mode], bits, i, mb_len(i));                                                            \
+        CHECK_MEM(streams[i].iv, ivs[i], 16, "%s-%d mb: stream %zu iv", mb_names[mode], bits, i);                 \
+    }                                                                                                             \
+}
+
+/* One key size: CBC-MAC over the mixed streams (3 schedules), the chaining values of CBC encryption without its output */
+#define TEST_MB_MAC(bits) {                                                                                       \
+    aes_mb_stream_t streams[MB_STREAMS];                                                                          \
+    const aes##bits##_sched_enc_t* schedules[MB_STREAMS];                                                         \
+    uint8_t iv[16];                                                                                               \
+    for (size_t i = 0; i < MB_STREAMS; i++) {                                                                     \
+        for (size_t j = 0; j < MB_MAX; j++) mb_in[i][j] = (uint8_t) (i * 29 + j * 5);                             \
+        streams[i] = (aes_mb_stream_t) { mb_in[i], NULL, mb_len(i), { 0 } };                                      \
+        for (int j = 0; j < 16; j++) streams[i].iv[j] = (uint8_t) (i * 7 + j);                                    \
+        schedules[i] = &enc[i % 3];                                                                               \
+        memcpy(iv, streams[i].iv, 16);                                                                            \
+        mb_ref##bits(MB_CBC, schedules[i], mb_in[i], mb_ref[i], mb_len(i), iv);                                   \
+        memcpy(ivs[i], iv, 16);                                                                                   \
+    }                                                                                                             \
+    aes##bits##_cbc_mac_mb(schedules, streams, MB_STREAMS);                                                       \
+    for (size_t i = 0; i < MB_STREAMS; i++)                                                                       \
+        CHECK_MEM(streams[i].iv, ivs[i], 16, "CBC-MAC-%d mb: stream %zu (%zu bytes)", bits, i, mb_len(i));        \
+}
+
+/* One key size: each multi-buffer mode */
+#define TEST_MB(bits) {                                                                                           \
+    aes##bits##_key_t key; aes##bits##_sched_enc_t enc[3];                                                        \
+    static uint8_t ivs[MB_STREAMS][16];                                                                           \
+    unhex(SP800_38A_KEY##bits, key.bytes); aes##bits##_load_key_enc(&key, &enc[0]);                               \
+    for (size_t k = 1; k < 3; k++) {                                                                              \
+        for (size_t i = 0; i < sizeof(key.bytes); i++) key.bytes[i] = (uint8_t) (i * 11 + k * 5 + bits);          \
+        aes##bits##_load_key_enc(&key, &enc[k]);                                                                  \
+    }                                                                                                             \
+    TEST_MB_MODE(bits, MB_CBC, cbc_encrypt_mb, cbc##bits##_cipher)                                                \
+    TEST_MB_MODE(bits, MB_CFB, cfb_encrypt_mb, cfb##bits##_cipher)                                                \
+    TEST_MB_MODE(bits, MB_OFB, ofb_xor_mb, ofb##bits##_cipher)                                                    \
+    TEST_MB_MAC(bits)                                                                                             \
+}
+
+static void test_mb(void) {
+    TEST_MB(128)
+    TEST_MB(192)
+    TEST_MB(256)
+}
+
+static void test_ctr(void) {
+    TEST_CTR(128)
+    TEST_CTR(192)
+    TEST_CTR(256)
+    for (size_t i = 0; i < MODES_MAX; i++) plain[i] = (uint8_t) (i * 13 + 5);
+    for (size_t w = 0; w < sizeof(ctr_widths) / sizeof(ctr_widths[0]); w++) {
+        TEST_CTR_WRAP(128, ctr_widths[w])
+        TEST_CTR_WRAP(192, ctr_widths[w])
+        TEST_CTR_WRAP(256, ctr_widths[w])
+    }
+    test_ctr128_full_wrap();
+}
+
+/* key: data key then tweak key, iv: the data unit number as 16 little-endian bytes,
+ * plain: hex, or NULL for the 00 01 .. ff 00 01 .. counting pattern of the cipher's length */
+typedef struct { const char *key, *iv, *plain, *cipher; } xts_vector_t;
+
+#define XTS_KEY_V4 "2718281828459045235360287471352631415926535897932384626433832795"
+#define XTS_CIPHER_V4 \
+    "27a7479befa1d476489f308cd4cfa6e2a96e4bbe3208ff25287dd3819616e89cc78cf7f5e543445f8333d8fa7f56000005279fa5" \
+    "d8b5e4ad40e736ddb4d35412328063fd2aab53e5ea1e0a9f332500a5df9487d07a5c92cc512c8866c7e860ce93fdf166a24912b4" \
+    "22976146ae20ce846bb7dc9ba94a767aaef20c0d61ad02655ea92dc4c4e41a8952c651d33174be51a10c421110e6d81588ede821" \
+    "03a252d8a750e8768defffed9122810aaeb99f9172af82b604dc4b8e51bcb08235a6f4341332e4ca60482a4ba1a03b3e65008fc5" \
+    "da76b70bf1690db4eae29c5f1badd03c5ccf2a55d705ddcd86d449511ceb7ec30bf12b1fa35b913f9f747a8afd1b130e94bff94e" \
+    "ffd01a91735ca1726acd0b197c4e5b03393697e126826fb6bbde8ecc1e08298516e2c9ed03ff3c1b7860f6de76d4cecd94c81198" \
+    "55ef5297ca67e9f3e7ff72b1e99785ca0a7e7720c5b36dc6d72cac9574c8cbbc2f801e23e56fd344b07f22154beba0f08ce8891e" \
+    "643ed995c94d9a69c9f1b5f499027a78572aeebd74d20cc39881c213ee770b1010e4bea718846977ae119f7a023ab58cca0ad752" \
+    "afe656bb3c17256a9f6e9bf19fdd5a38fc82bbe872c5539edb609ef4f79c203ebb140f2e583cb2ad15b4aa5b655016a8449277db" \
+    "d477ef2c8d6c017db738b18deb4a427d1923ce3ff262735779a418f20a282df920147beabe421ee5319d0568"
+#define XTS_KEY_V15 "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0"
+static const xts_vector_t xts128_vectors[] = {
+    { "0000000000000000000000000000000000000000000000000000000000000000", "00000000000000000000000000000000",
+      "0000000000000000000000000000000000000000000000000000000000000000",
+      "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e" },
+    { "1111111111111111111111111111111122222222222222222222222222222222", "33333333330000000000000000000000",
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f022222222222222222222222222222222", "33333333330000000000000000000000",
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "af85336b597afc1a900b2eb21ec949d292df4c047e0b21532186a5971a227a89" },
+    { XTS_KEY_V4, "00000000000000000000000000000000", NULL, XTS_CIPHER_V4 },
+    { XTS_KEY_V4, "01000000000000000000000000000000", XTS_CIPHER_V4,
+      "264d3ca8512194fec312c8c9891f279fefdd608d0c027b60483a3fa811d65ee59d52d9e40ec5672d81532b38b6b089ce951f0f9c"
+      "35590b8b978d175213f329bb1c2fd30f2f7f30492a61a532a79f51d36f5e31a7c9a12c286082ff7d2394d18f783e1a8e72c722ca"
+      "aaa52d8f065657d2631fd25bfd8e5baad6e527d763517501c68c5edc3cdd55435c532d7125c8614deed9adaa3acade5888b87bef"
+      "641c4c994c8091b5bcd387f3963fb5bc37aa922fbfe3df4e5b915e6eb514717bdd2a74079a5073f5c4bfd46adf7d282e7a393a52"
+      "579d11a028da4d9cd9c77124f9648ee383b1ac763930e7162a8d37f350b2f74b8472cf09902063c6b32e8c2d9290cefbd7346d1c"
+      "779a0df50edcde4531da07b099c638e83a755944df2aef1aa31752fd323dcb710fb4bfbb9d22b925bc3577e1b8949e729a90bbaf"
+      "eacf7f7879e7b1147e28ba0bae940db795a61b15ecf4df8db07b824bb062802cc98a9545bb2aaeed77cb3fc6db15dcd7d80d7d5b"
+      "c406c4970a3478ada8899b329198eb61c193fb6275aa8ca340344a75a862aebe92eee1ce032fd950b47d7704a3876923b4ad6284"
+      "4bf4a09c4dbe8b4397184b7471360c9564880aedddb9baa4af2e75394b08cd32ff479c57a07d3eab5d54de5f9738b8d27f27a9f0"
+      "ab11799d7b7ffefb2704c95c6ad12c39f1e867a4b7b1d7818a4b753dfd2a89ccb45e001a03a867b187f225dd" },
+    { XTS_KEY_V15, "9a785634120000000000000000000000", "000102030405060708090a0b0c0d0e0f10", "6c1625db4671522d3d7599601de7ca09ed" },
+    { XTS_KEY_V15, "9a785634120000000000000000000000", "000102030405060708090a0b0c0d0e0f1011", "d069444b7a7e0cab09e24447d24deb1fedbf" },
+    { XTS_KEY_V15, "9a785634120000000000000000000000", "000102030405060708090a0b0c0d0e0f101112", "e5df1351c0544ba1350b3363cd8ef4beedbf9d" },
+    { XTS_KEY_V15, "9a785634120000000000000000000000", "000102030405060708090a0b0c0d0e0f10111213", "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac" },
+};
+static const xts_vector_t xts256_vectors[] = {
+    { "2718281828459045235360287471352662497757247093699959574966967627"
+      "3141592653589793238462643383279502884197169399375105820974944592", "ff000000000000000000000000000000", NULL,
+      "1c3b3a102f770386e4836c99e370cf9bea00803f5e482357a4ae12d414a3e63b5d31e276f8fe4a8d66b317f9ac683f44680a86ac"
+      "35adfc3345befecb4bb188fd5776926c49a3095eb108fd1098baec70aaa66999a72a82f27d848b21d4a741b0c5cd4d5fff9dac89"
+      "aeba122961d03a757123e9870f8acf1000020887891429ca2a3e7a7d7df7b10355165c8b9a6d0a7de8b062c4500dc4cd120c0f74"
+      "18dae3d0b5781c34803fa75421c790dfe1de1834f280d7667b327f6c8cd7557e12ac3a0f93ec05c52e0493ef31a12d3d9260f79a"
+      "289d6a379bc70c50841473d1a8cc81ec583e9645e07b8d9670655ba5bbcfecc6dc3966380ad8fecb17b6ba02469a020a84e18e8f"
+      "84252070c13e9f1f289be54fbc481457778f616015e1327a02b140f1505eb309326d68378f8374595c849d84f4c333ec44238851"
+      "43cb47bd71c5edae9be69a2ffeceb1bec9de244fbe15992b11b77c040f12bd8f6a975a44a0f90c29a9abc3d4d893927284c58754"
+      "cce294529f8614dcd2aba991925fedc4ae74ffac6e333b93eb4aff0479da9a410e4450e0dd7ae4c6e2910900575da401fc07059f"
+      "645e8b7e9bfdef33943054ff84011493c27b3429eaedb4ed5376441a77ed43851ad77f16f541dfd269d50d6a5f14fb0aab1cbb4c"
+      "1550be97f7ab4066193c4caa773dad38014bd2092fa755c824bb5e54c4f36ffda9fcea70b9c6e693e148c151" },
+};
+
+#define XTS_MAX 512 /* vectors 4 & 5 sector size, 2 of them fit in MODES_MAX */
+
+/* Vector into plain & cipher, returns its length */
+static size_t xts_load(const xts_vector_t* tv, uint8_t* key, uint8_t iv[16]) {
+    unhex(tv->key, key); unhex(tv->iv, iv);
+    const size_t len = unhex(tv->cipher, cipher);
+    if (tv->plain) unhex(tv->plain, plain);
+    else for (size_t i = 0; i < len; i++) plain[i] = (uint8_t) i;
+    return len;
+}
+
+/* One key size: encrypt & decrypt each vector (separate & in-place), then as a one sector batch */
+#define TEST_XTS(bits) {                                                                                          \
+    for (size_t v = 0; v < sizeof(xts##bits##_vectors) / sizeof(xts##bits##_vectors[0]); v++) {                   \
+        uint8_t key[bits / 4], iv[16];                                                                            \
+        aes##bits##_key_t data_key, tweak_key;                                                                    \
+        aes##bits##_sched_enc_t data, tweak; aes##bits##_sched_full_t data_full;                                  \
+        const size_t len = xts_load(&xts##bits##_vectors[v], key, iv);                                            \
+        memcpy(data_key.bytes, key, bits / 8); memcpy(tweak_key.bytes, key + bits / 8, bits / 8);                 \
+        aes##bits##_load_key_enc(&data_key, &data); aes##bits##_load_key(&data_key, &data_full);                  \
+        aes##bits##_load_key_enc(&tweak_key, &tweak);                                                             \
+        CHECK(aes##bits##_xts_encrypt(&data, &tweak, iv, plain, out, len),                                        \
+              "XTS-%d vector %zu: encrypt fails", bits, v);                                                       \
+        CHECK_MEM(out, cipher, len, "XTS-%d vector %zu: encrypt", bits, v);                                       \
+        CHECK(aes##bits##_xts_decrypt(&data_full, &tweak, iv, out, out, len),                                     \
+              "XTS-%d vector %zu: decrypt fails", bits, v);                                                       \
+        CHECK_MEM(out, plain, len, "XTS-%d vector %zu: in-place decrypt", bits, v);                               \
+        memcpy(out, plain, len);                                                                                  \
+        aes##bits##_xts_encrypt(&data, &tweak, iv, out, out, len);                                                \
+        CHECK_MEM(out, cipher, len, "XTS-%d vector %zu: in-place encrypt", bits, v);                              \
+        aes##bits##_xts_decrypt(&data_full, &tweak, iv, cipher, out, len);                                        \
+        CHECK_MEM(out, plain, len, "XTS-%d vector %zu: decrypt", bits, v);                                        \
+        uint64_t sector; memcpy(&sector, iv, 8);                                                                  \
+        CHECK(aes##bits##_xts_encrypt_sectors(&data, &tweak, sector, len, plain, out, 1),                         \
+              "XTS-%d vector %zu: encrypt_sectors fails", bits, v);                                               \
+        CHECK_MEM(out, cipher, len, "XTS-%d vector %zu: encrypt_sectors", bits, v);                               \
+        aes##bits##_xts_decrypt_sectors(&data_full, &tweak, sector, len, cipher, out, 1);                         \
+        CHECK_MEM(out, plain, len, "XTS-%d vector %zu: decrypt_sectors", bits, v);                                \
+        CHECK(!aes##bits##_xts_encrypt(&data, &tweak, iv, plain, out, 15),                                        \
+              "XTS-%d vector %zu: accepts a 15 byte unit", bits, v);                                              \
+    }                                                                                                             \
+}
+
+/* Vectors 4 & 5 are consecutive 512 byte sectors (0 & 1, the second encrypts the first's cipher) */
+static void test_xts_sectors(void) {
+    uint8_t key[32], iv[16];
+    aes128_key_t data_key, tweak_key;
+    aes128_sched_enc_t data, tweak; aes128_sched_full_t data_full;
+    xts_load(&xts128_vectors[4], key, iv);
+    memcpy(out, cipher, XTS_MAX);
+    xts_load(&xts128_vectors[3], key, iv);
+    memcpy(cipher + XTS_MAX, out, XTS_MAX);
+    memcpy(plain + XTS_MAX, cipher, XTS_MAX);
+    memcpy(data_key.bytes, key, 16); memcpy(tweak_key.bytes, key + 16, 16);
+    aes128_load_key_enc(&data_key, &data); aes128_load_key(&data_key, &data_full); aes128_load_key_enc(&tweak_key, &tweak);
+    memcpy(out, plain, 2 * XTS_MAX);
+    aes128_xts_encrypt_sectors(&data, &tweak, 0, XTS_MAX, out, out, 2);
+    CHECK_MEM(out, cipher, 2 * XTS_MAX, "XTS-128 vectors 4 & 5: 2 sector batch encrypt");
+    aes128_xts_decrypt_sectors(&data_full, &tweak, 0, XTS_MAX, out, out, 2);
+    CHECK_MEM(out, plain, 2 * XTS_MAX, "XTS-128 vectors 4 & 5: 2 sector batch decrypt");
+}
+
+/* Ciphertext stealing: every length from 1 to 5 blocks round trips & keeps its full blocks' prefix cipher */
+static void test_xts_stealing(void) {
+    aes256_key_t data_key, tweak_key;
+    aes256_sched_enc_t data, tweak; aes256_sched_full_t data_full;
+    uint8_t iv[16] = { 7 }, full[80];
+    for (size_t i = 0; i < 32; i++) { data_key.bytes[i] = (uint8_t) (i * 3 + 1); tweak_key.bytes[i] = (uint8_t) (i * 5 + 2); }
+    for (size_t i = 0; i < sizeof(plain); i++) plain[i] = (uint8_t) (i * 11 + 9);
+    aes256_load_key_enc(&data_key, &data); aes256_load_key(&data_key, &data_full); aes256_load_key_enc(&tweak_key, &tweak);
+    aes256_xts_encrypt(&data, &tweak, iv, plain, full, sizeof(full));
+    for (size_t len = 16; len <= 80; len++) {
+        aes256_xts_encrypt(&data, &tweak, iv, plain, out, len);
+        const size_t kept = len % 16 ? (len / 16 - 1) * 16 : len; /* blocks before the stolen pair match the full unit */
+        CHECK_MEM(out, full, kept, "XTS-256 stealing: %zu byte unit prefix", len);
+        aes256_xts_decrypt(&data_full, &tweak, iv, out, out, len);
+        CHECK_MEM(out, plain, len, "XTS-256 stealing: %zu byte round trip", len);
+    }
+}
+
+static void test_xts(void) {
+    TEST_XTS(128)
+    TEST_XTS(256)
+    test_xts_sectors();
+    test_xts_stealing();
+}
+
+static void modes_dispatch_update(void) {
+    aes_dispatch_update();
+    aes_modes_dispatch_update();
+}
+
+int main(void) {
+    test_tiers(modes_dispatch_update, test_ctr);
+    test_tiers(modes_dispatch_update, test_cbc);
+    test_tiers(modes_dispatch_update, test_mb);
+    test_tiers(modes_dispatch_update, test_xts);
+    return test_report("aes_modes_tests");
+}
@@ -0,0 +1,170 @@
+/* AES-OCB known answer tests (RFC 7253 Appendix A: the AES-128 sample results, the 96 bit tag sample and
+ * the iterated check over every key size & 128, 96 & 64 bit tags; the Appendix A sample inputs under 192 & 256 bit
+ * keys, results from OpenSSL), plus tag rejection (tampered tag, cipher & aad) & parameter limits.
+ * Every backend tier the CPU has is forced in turn.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_ocb_tests.c -o aes_ocb_tests (returns non-zero on failure)
+
+#include "aes_ocb.h"
+#include "test_common.h"
+
+/* aad & plain are the 00 01 02 .. counting pattern of their length, cipher is C || T as printed in the RFC */
+typedef struct { const char *key, *nonce; size_t aad_len, len, tag_len; const char* cipher; } ocb_vector_t;
+
+#define OCB_KEY "000102030405060708090a0b0c0d0e0f"
+static const ocb_vector_t ocb128_vectors[] = {
+    { OCB_KEY, "bbaa99887766554433221100",  0,  0, 16, "785407bfffc8ad9edcc5520ac9111ee6" },
+    { OCB_KEY, "bbaa99887766554433221101",  8,  8, 16, "6820b3657b6f615a5725bda0d3b4eb3a257c9af1f8f03009" },
+    { OCB_KEY, "bbaa99887766554433221102",  8,  0, 16, "81017f8203f081277152fade694a0a00" },
+    { OCB_KEY, "bbaa99887766554433221103",  0,  8, 16, "45dd69f8f5aae72414054cd1f35d82760b2cd00d2f99bfa9" },
+    { OCB_KEY, "bbaa99887766554433221104", 16, 16, 16, "571d535b60b277188be5147170a9a22c3ad7a4ff3835b8c5701c1ccec8fc3358" },
+    { OCB_KEY, "bbaa99887766554433221105", 16,  0, 16, "8cf761b6902ef764462ad86498ca6b97" },
+    { OCB_KEY, "bbaa99887766554433221106",  0, 16, 16, "5ce88ec2e0692706a915c00aeb8b2396f40e1c743f52436bdf06d8fa1eca343d" },
+    { OCB_KEY, "bbaa99887766554433221107", 24, 24, 16,
+      "1ca2207308c87c010756104d8840ce1952f09673a448a122c92c62241051f57356d7f3c90bb0e07f" },
+    { OCB_KEY, "bbaa99887766554433221108", 24,  0, 16, "6dc225a071fc1b9f7c69f93b0f1e10de" },
+    { OCB_KEY, "bbaa99887766554433221109",  0, 24, 16,
+      "221bd0de7fa6fe993eccd769460a0af2d6cded0c395b1c3ce725f32494b9f914d85c0b1eb38357ff" },
+    { OCB_KEY, "bbaa9988776655443322110a", 32, 32, 16,
+      "bd6f6c496201c69296c11efd138a467abd3c707924b964deaffc40319af5a48540fbba186c5553c68ad9f592a79a4240" },
+    { OCB_KEY, "bbaa9988776655443322110b", 32,  0, 16, "fe80690bee8a485d11f32965bc9d2a32" },
+    { OCB_KEY, "bbaa9988776655443322110c",  0, 32, 16,
+      "2942bfc773bda23cabc6acfd9bfd5835bd300f0973792ef46040c53f1432bcdfb5e1dde3bc18a5f840b52e653444d5df" },
+    { OCB_KEY, "bbaa9988776655443322110d", 40, 40, 16,
+      "d5ca91748410c1751ff8a2f618255b68a0a12e093ff454606e59f9c1d0ddc54b65e8628e568bad7aed07ba06a4a69483a7035490c5769e60" },
+    { OCB_KEY, "bbaa9988776655443322110e", 40,  0, 16, "c5cd9d1850c141e358649994ee701b68" },
+    { OCB_KEY, "bbaa9988776655443322110f",  0, 40, 16,
+      "4412923493c57d5de0d700f753cce0d1d2d95060122e9f15a5ddbfc5787e50b5cc55ee507bcb084e479ad363ac366b95a98ca5f3000b1479" },
+    { "0f0e0d0c0b0a09080706050403020100", "bbaa9988776655443322110d", 40, 40, 12,
+      "1792a4e31e0755fb03e31b22116e6c2ddf9efd6e33d536f1a0124b0a55bae884ed93481529c76b6ad0c515f4d1cdd4fdac4f02aa" },
+};
+
+#define OCB_KEY192 "000102030405060708090a0b0c0d0e0f1011121314151617"
+static const ocb_vector_t ocb192_vectors[] = {
+    { OCB_KEY192, "bbaa9988776655443322110d",  0,  0, 16, "4b25a0643dd63475c62d9b8ac54e9670" },
+    { OCB_KEY192, "bbaa9988776655443322110d",  8,  8, 16, "2b54b5786c1085b0bb78a035c32f3d40caf5dabb7556ab88" },
+    { OCB_KEY192, "bbaa9988776655443322110d",  0, 24, 16,
+      "86b418c98b14be157cad07cf20189dc8190ce4b7b7d95d2d66c455367097c4e4395e34202d71bde3" },
+    { OCB_KEY192, "bbaa9988776655443322110d", 24,  0, 16, "8fbaeb91b544c6945ed8460b7c50c917" },
+    { OCB_KEY192, "bbaa9988776655443322110d", 40, 40, 16,
+      "86b418c98b14be157cad07cf20189dc87a9e6fd19a07bec6d6acef811d9a860c9671666bf650dd2b6e9ca93fc80b9dcf1b25ae2fda9b2520" },
+    { OCB_KEY192, "bbaa9988776655443322110d", 40, 40, 12,
+      "533ff72dbfdefb3e8a42deba0af43cda461980ec0233ea5bd5a1cc450c8a825ea905897a93081cd9185cddfc24140b9b35c616ab" },
+};
+
+#define OCB_KEY256 "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+static const ocb_vector_t ocb256_vectors[] = {
+    { OCB_KEY256, "bbaa9988776655443322110d",  0,  0, 16, "eb9eee34b0e73cc3ef79363af0522db8" },
+    { OCB_KEY256, "bbaa9988776655443322110d",  8,  8, 16, "c854720e705cf3ecc45504734aaf7aedc07df165f23ec16f" },
+    { OCB_KEY256, "bbaa9988776655443322110d",  0, 24, 16,
+      "4cf8f8f885db86893ff518086d149f0cc642eadf463dc94b4a1ad2a5f0ec7dc81d32e3756ae8ccca" },
+    { OCB_KEY256, "bbaa9988776655443322110d", 24,  0, 16, "39401a8cf760cd9495905caa66888402" },
+    { OCB_KEY256, "bbaa9988776655443322110d", 40, 40, 16,
+      "4cf8f8f885db86893ff518086d149f0c1546ebef5cc9a1dec375ea2770754b1f595448474b661dd37e1a5a800d577bf389b87b957d316209" },
+    { OCB_KEY256, "bbaa9988776655443322110d", 40, 40, 12,
+      "7848eccc369a5ef54bd52e4a97bdaf813f41119f5ad32e2ced8ccbf9bdea5f95df8a60be1deb24570b1a0716581c1d30ca512072" },
+};
+
+static uint8_t pattern[64];
+
+/* One key size: seal (separate & in-place), open, tampered tag / cipher / aad & a shorter tag length per vector */
+#define TEST_OCB_VECTORS(bits) {                                                                                  \
+    for (size_t v = 0; v < sizeof(ocb##bits##_vectors) / sizeof(ocb##bits##_vectors[0]); v++) {                   \
+        const ocb_vector_t* tv = &ocb##bits##_vectors[v];                                                         \
+        aes##bits##_key_t key; static aes##bits##_ocb_ctx_t ctx;                                                  \
+        uint8_t nonce[15], expected[64], out[64], tag[16];                                                        \
+        unhex(tv->key, key.bytes);                                                                                \
+        const size_t nonce_len = unhex(tv->nonce, nonce), len = tv->len, tag_len = tv->tag_len;                   \
+        unhex(tv->cipher, expected);                                                                              \
+        aes##bits##_ocb_init(&ctx, &key);                                                                         \
+        CHECK(aes##bits##_ocb_seal(&ctx, nonce, nonce_len, pattern, tv->aad_len, pattern, out, len, tag,          \
+                                   tag_len),                                                                      \
+              "OCB-%d vector %zu: seal fails", bits, v);                                                          \
+        CHECK_MEM(out, expected, len, "OCB-%d vector %zu: seal cipher", bits, v);                                 \
+        CHECK_MEM(tag, expected + len, tag_len, "OCB-%d vector %zu: seal tag", bits, v);                          \
+        memcpy(out, pattern, len);                                                                                \
+        aes##bits##_ocb_seal(&ctx, nonce, nonce_len, pattern, tv->aad_len, out, out, len, tag, tag_len);          \
+        CHECK_MEM(out, expected, len, "OCB-%d vector %zu: in-place seal cipher", bits, v);                        \
+        CHECK(aes##bits##_ocb_open(&ctx, nonce, nonce_len, pattern, tv->aad_len, expected, out, len,              \
+                                   expected + len, tag_len),                                                      \
+              "OCB-%d vector %zu: open rejects", bits, v);                                                        \
+        CHECK_MEM(out, pattern, len, "OCB-%d vector %zu: open plain", bits, v);                                   \
+        uint8_t aad[64];                                                                                          \
+        memcpy(aad, pattern, tv->aad_len);                                                                        \
+        for (int t = 0; t < 3; t++) {                                                                             \
+            uint8_t* target = t == 0 ? expected + len + tag_len - 1 : t == 1 ? expected + len / 2 : aad;          \
+            if ((t == 1 && !len) || (t == 2 && !tv->aad_len)) continue;                                           \
+            *target ^= 0x80;                                                                                      \
+            memset(out, 0xAA, sizeof(out));                                                                       \
+            CHECK(!aes##bits##_ocb_open(&ctx, nonce, nonce_len, aad, tv->aad_len, expected, out, len,             \
+                                        expected + len, tag_len),                                                 \
+                  "OCB-%d vector %zu: open accepts a tampered %s", bits, v,                                       \
+                  t == 0 ? "tag" : t == 1 ? "cipher" : "aad");                                                    \
+            for (size_t i = 0; i < len; i++)                                                                      \
+                CHECK(out[i] == 0, "OCB-%d vector %zu: rejected open leaks plain", bits, v);                      \
+            *target ^= 0x80;                                                                                      \
+        }                                                                                                         \
+        /* The tag length is part of the nonce block: a truncated tag of the right prefix must not verify */      \
+        CHECK(!aes##bits##_ocb_open(&ctx, nonce, nonce_len, pattern, tv->aad_len, expected, out, len,             \
+                                    expected + len, 8),                                                           \
+              "OCB-%d vector %zu: open accepts a shorter tag length", bits, v);                                   \
+    }                                                                                                             \
+}
+
+static void test_ocb_vectors(void) {
+    TEST_OCB_VECTORS(128)
+    TEST_OCB_VECTORS(192)
+    TEST_OCB_VECTORS(256)
+    static aes128_ocb_ctx_t ctx; aes128_key_t key; uint8_t tag[16], out[16];
+    memcpy(key.bytes, pattern, 16);
+    aes128_ocb_init(&ctx, &key);
+    CHECK(!aes128_ocb_seal(&ctx, pattern, 0, NULL, 0, pattern, out, 16, tag, 16), "OCB-128: seal accepts nonce_len 0");
+    CHECK(!aes128_ocb_seal(&ctx, pattern, 16, NULL, 0, pattern, out, 16, tag, 16), "OCB-128: seal accepts nonce_len 16");
+    CHECK(!aes128_ocb_seal(&ctx, pattern, 12, NULL, 0, pattern, out, 16, tag, 0), "OCB-128: seal accepts tag_len 0");
+    CHECK(!aes128_ocb_open(&ctx, pattern, 12, NULL, 0, pattern, out, 16, tag, 17), "OCB-128: open accepts tag_len 17");
+}
+
+/* RFC 7253 Appendix A iterated check: K = 0^(KEYLEN - 8) || TAGLEN, 128 rounds of 3 seals over zero strings
+ * (nonces 3i + 1 .. 3i + 3), then the tag of a final seal with the concatenated outputs as aad (nonce 385) */
+#define OCB_ITER_MAX (128 * 127 + 128 * 3 * 16)
+static uint8_t ocb_iter[OCB_ITER_MAX];
+
+#define TEST_OCB_ITER(bits, taglen, expected_hex) {                                                               \
+    static aes##bits##_ocb_ctx_t ctx; aes##bits##_key_t key;                                                      \
+    uint8_t nonce[12] = { 0 }, zeros[128] = { 0 }, tag[16], expected[16];                                         \
+    memset(key.bytes, 0, sizeof(key.bytes)); key.bytes[sizeof(key.bytes) - 1] = taglen;                           \
+    aes##bits##_ocb_init(&ctx, &key);                                                                             \
+    size_t c = 0;                                                                                                 \
+    for (size_t i = 0; i < 128; i++) {                                                                            \
+        for (size_t j = 1; j <= 3; j++) {                                                                         \
+            const size_t n = 3 * i + j, aad_len = j == 2 ? 0 : i, len = j == 3 ? 0 : i;                           \
+            nonce[10] = (uint8_t) (n >> 8); nonce[11] = (uint8_t) n;                                              \
+            aes##bits##_ocb_seal(&ctx, nonce, 12, zeros, aad_len, zeros, ocb_iter + c, len, ocb_iter + c + len,   \
+                                 taglen / 8);                                                                     \
+            c += len + taglen / 8;                                                                                \
+        }                                                                                                         \
+    }                                                                                                             \
+    nonce[10] = 385 >> 8; nonce[11] = 385 & 0xFF;                                                                 \
+    aes##bits##_ocb_seal(&ctx, nonce, 12, ocb_iter, c, NULL, NULL, 0, tag, taglen / 8);                           \
+    unhex(expected_hex, expected);                                                                                \
+    CHECK_MEM(tag, expected, taglen / 8, "OCB-%d: iterated check with %d bit tags", bits, taglen);                \
+}
+
+static void test_ocb(void) {
+    for (size_t i = 0; i < sizeof(pattern); i++) pattern[i] = (uint8_t) i;
+    test_ocb_vectors();
+    TEST_OCB_ITER(128, 128, "67e944d23256c5e0b6c61fa22fdf1ea2")
+    TEST_OCB_ITER(192, 128, "f673f2c3e7174aae7bae986ca9f29e17")
+    TEST_OCB_ITER(256, 128, "d90eb8e9c977c88b79dd793d7ffa161c")
+    TEST_OCB_ITER(128, 96, "77a3d8e73589158d25d01209")
+    TEST_OCB_ITER(192, 96, "05d56ead2752c86be6932c5e")
+    TEST_OCB_ITER(256, 96, "5458359ac23b0cba9e6330dd")
+    TEST_OCB_ITER(128, 64, "192c9b7bd90ba06a")
+    TEST_OCB_ITER(192, 64, "0066bc6e0ef34e24")
+    TEST_OCB_ITER(256, 64, "7d4ea5d445501cbe")
+}
+
+int main(void) {
+    test_tiers(aes_dispatch_update, test_ocb);
+    return test_report("aes_ocb_tests");
+}
@@ -0,0 +1,205 @@
+/* AES-SIV known answer tests (RFC 5297 Appendix A.1 deterministic & A.2 nonce-based with 3 components, AES-128),
+ * plus tag rejection (tampered siv, cipher & aad) & the component limit.
+ * Every key size against a block by block S2V & CTR reference: 0 - 3 aad components of 0 - 40 bytes & 0 - 300 byte
+ * messages, one at a time, then as one batch (groups, short & long messages mixed) with a tampered message in it.
+ * Every backend tier the CPU has is forced in turn.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_siv_tests.c -o aes_siv_tests (returns non-zero on failure)
+
+#include "aes_siv.h"
+#include "aes_modes.h"
+#include "test_common.h"
+
+/* key is mac_key || ctr_key, aad: up to 3 components ("" ends the list early) */
+typedef struct { const char *key, *aad[3], *plain, *siv, *cipher; } siv_vector_t;
+
+static const siv_vector_t siv128_vectors[] = {
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+      { "101112131415161718191a1b1c1d1e1f2021222324252627", "", "" },
+      "112233445566778899aabbccddee", "85632d07c6e8f37f950acd320a2ecc93", "40c02b9690c4dc04daef7f6afe5c" },
+    { "7f7e7d7c7b7a79787776757473727170404142434445464748494a4b4c4d4e4f",
+      { "00112233445566778899aabbccddeeffdeaddadadeaddadaffeeddccbbaa99887766554433221100",
+        "102030405060708090a0", "09f911029d74e35bd84156c5635688c0" },
+      "7468697320697320736f6d6520706c61696e7465787420746f20656e6372797074207573696e67205349562d414553",
+      "7bdb6e3b432667eb06f4d14bff2fbd0f",
+      "cb900f2fddbe404326601965c889bf17dba77ceb094fa663b7a3f748ba8af829ea64ad544a272e9c485b62a3fd5c0d" },
+};
+
+/* One vector: seal (separate & in-place), open, then each tampering must fail & zero the output */
+static void test_siv_vector(const siv_vector_t* tv, size_t v) {
+    aes128_key_t keys[2]; static aes128_siv_ctx_t ctx;
+    uint8_t key[32], aad[3][64], plain[64], siv[16], cipher[64], out[64], out_siv[16];
+    const uint8_t* comps[3]; size_t lens[3], n = 0;
+    unhex(tv->key, key); memcpy(keys[0].bytes, key, 16); memcpy(keys[1].bytes, key + 16, 16);
+    for (; n < 3 && tv->aad[n][0]; n++) { lens[n] = unhex(tv->aad[n], aad[n]); comps[n] = aad[n]; }
+    const size_t len = unhex(tv->plain, plain);
+    unhex(tv->siv, siv); unhex(tv->cipher, cipher);
+    aes128_siv_init(&ctx, &keys[0], &keys[1]);
+    CHECK(aes128_siv_seal(&ctx, comps, lens, n, plain, out, len, out_siv), "SIV-128 vector %zu: seal fails", v);
+    CHECK_MEM(out_siv, siv, 16, "SIV-128 vector %zu: seal siv", v);
+    CHECK_MEM(out, cipher, len, "SIV-128 vector %zu: seal cipher", v);
+    memcpy(out, plain, len);
+    aes128_siv_seal(&ctx, comps, lens, n, out, out, len, out_siv);
+    CHECK_MEM(out, cipher, len, "SIV-128 vector %zu: in-place seal cipher", v);
+    CHECK(aes128_siv_open(&ctx, comps, lens, n, cipher, out, len, siv), "SIV-128 vector %zu: open rejects", v);
+    CHECK_MEM(out, plain, len, "SIV-128 vector %zu: open plain", v);
+    for (int t = 0; t < 3; t++) {
+        uint8_t* target = t == 0 ? siv + 15 : t == 1 ? cipher + len / 2 : aad[n - 1];
+        *target ^= 0x80;
+        memset(out, 0xAA, sizeof(out));
+        CHECK(!aes128_siv_open(&ctx, comps, lens, n, cipher, out, len, siv),
+              "SIV-128 vector %zu: open accepts a tampered %s", v, t == 0 ? "siv" : t == 1 ? "cipher" : "aad");
+        for (size_t i = 0; i < len; i++) CHECK(out[i] == 0, "SIV-128 vector %zu: rejected open leaks plain", v);
+        *target ^= 0x80;
+    }
+    if (n > 1) { /* components are not a concatenation */
+        size_t joined[3] = { lens[0] + lens[1], 0, 0 };
+        uint8_t both[128];
+        const uint8_t* first[3] = { both, comps[2], NULL };
+        memcpy(both, aad[0], lens[0]); memcpy(both + lens[0], aad[1], lens[1]);
+        joined[1] = lens[2];
+        CHECK(!aes128_siv_open(&ctx, first, joined, n - 1, cipher, out, len, siv), "SIV-128 vector %zu: open accepts joined aad", v);
+    }
+}
+
+/* Block by block reference: CMAC, S2V (RFC 5297 2.4) & CTR with a 128 bit increment */
+#define SIV_REF_FNS(bits)                                                                                         \
+    static void cmac_ref##bits(const aes##bits##_sched_enc_t* s, const uint8_t* m, size_t len, uint8_t out[16]) { \
+        uint8_t k[16] = { 0 }, y[16] = { 0 }, b[16];                                                              \
+        aes##bits##_encrypt_block(s, k, k);                                                                       \
+        const size_t n = len ? (len + 15) / 16 : 1, r = len - 16 * (n - 1);                                       \
+        for (int d = 0; d < (r == 16 ? 1 : 2); d++) {                                                             \
+            const uint8_t c = k[0] >> 7;                                                                          \
+            for (int i = 0; i < 15; i++) k[i] = (uint8_t) (k[i] << 1 | k[i + 1] >> 7);                            \
+            k[15] = (uint8_t) (k[15] << 1) ^ (c ? 0x87 : 0);                                                      \
+        }                                                                                                         \
+        for (size_t i = 0; i < n; i++) {                                                                          \
+            memset(b, 0, 16);                                                                                     \
+            if (i < n - 1) memcpy(b, m + 16 * i, 16);                                                             \
+            else { memcpy(b, m + 16 * i, r); if (r < 16) b[r] = 0x80; for (int j = 0; j < 16; j++) b[j] ^= k[j]; } \
+            for (int j = 0; j < 16; j++) y[j] ^= b[j];                                                            \
+            aes##bits##_encrypt_block(s, y, y);                                                                   \
+        }                                                                                                         \
+        memcpy(out, y, 16);                                                                                       \
+    }                                                                                                             \
+    static void siv_ref##bits(const aes##bits##_sched_enc_t* mac, const aes##bits##_sched_enc_t* ctr,             \
+                              const uint8_t* const* aad, const size_t* lens, size_t n, const uint8_t* plain, uint8_t* out, size_t len, uint8_t siv[16]) { \
+        static uint8_t t[512];                                                                                    \
+        uint8_t d[16] = { 0 }, c[16], q[16], ks[16];                                                              \
+        cmac_ref##bits(mac, d, 16, d);                                                                            \
+        for (size_t i = 0; i <= n; i++) {                                                                         \
+            if (i == n && len >= 16) {                                                                            \
+                memcpy(t, plain, len);                                                                            \
+                for (int j = 0; j < 16; j++) t[len - 16 + j] ^= d[j];                                             \
+                cmac_ref##bits(mac, t, len, siv);                                                                 \
+                break;                                                                                            \
+            }                                                                                                     \
+            const uint8_t c0 = d[0] >> 7;                                                                         \
+            for (int j = 0; j < 15; j++) d[j] = (uint8_t) (d[j] << 1 | d[j + 1] >> 7);                            \
+            d[15] = (uint8_t) (d[15] << 1) ^ (c0 ? 0x87 : 0);                                                     \
+            if (i == n) {                                                                                         \
+                memset(c, 0, 16); memcpy(c, plain, len); c[len] = 0x80;                                           \
+                for (int j = 0; j < 16; j++) c[j] ^= d[j];                                                        \
+                cmac_ref##bits(mac, c, 16, siv);                                                                  \
+                break;                                                                                            \
+            }                                                                                                     \
+            cmac_ref##bits(mac, aad[i], lens[i], c);                                                              \
+            for (int j = 0; j < 16; j++) d[j] ^= c[j];                                                            \
+        }                                                                                                         \
+        memcpy(q, siv, 16); q[8] &= 0x7F; q[12] &= 0x7F;                                                          \
+        for (size_t i = 0; i < len; i += 16) {                                                                    \
+            aes##bits##_encrypt_block(ctr, q, ks);                                                                \
+            for (size_t j = 0; j < 16 && i + j < len; j++) out[i + j] = plain[i + j] ^ ks[j];                     \
+            for (int j = 15; j >= 0 && ++q[j] == 0; j--) {}                                                       \
+        }                                                                                                         \
+    }
+SIV_REF_FNS(128)
+SIV_REF_FNS(192)
+SIV_REF_FNS(256)
+#undef SIV_REF_FNS
+
+#define SIV_MSGS 37 /* 2 full groups & a partial one */
+#define SIV_MAX 300
+static uint8_t siv_plain[SIV_MSGS][SIV_MAX], siv_out[SIV_MSGS][SIV_MAX], siv_ref[SIV_MSGS][SIV_MAX], siv_aad[3][40];
+static const uint8_t* const siv_comps[3] = { siv_aad[0], siv_aad[1], siv_aad[2] };
+
+/* Message i: 0 - 3 aad components, every 5th empty, mostly under 64 bytes (batched keystream), some long */
+static size_t siv_len(size_t i) { return i % 5 == 0 ? 0 : i % 3 == 0 ? 64 + (i * 37) % (SIV_MAX - 64) : (i * 7) % 64; }
+static size_t siv_num_aad(size_t i) { return i % 4; }
+
+/* One key size: singles & the batch against the reference, then a tampered message in an open batch */
+#define TEST_SIV_REF(bits) {                                                                                      \
+    aes##bits##_key_t keys[2]; static aes##bits##_siv_ctx_t ctx;                                                  \
+    aes##bits##_sched_enc_t mac, ctr;                                                                             \
+    static aes_siv_msg_t msgs[SIV_MSGS];                                                                          \
+    static uint8_t sivs[SIV_MSGS][16];                                                                            \
+    size_t lens[SIV_MSGS][3];                                                                                     \
+    uint8_t siv[16];                                                                                              \
+    for (size_t i = 0; i < sizeof(keys[0].bytes); i++) { keys[0].bytes[i] = (uint8_t) (i * 3 + bits); keys[1].bytes[i] = (uint8_t) (i * 5 + 1); } \
+    aes##bits##_siv_init(&ctx, &keys[0], &keys[1]);                                                               \
+    aes##bits##_load_key_enc(&keys[0], &mac); aes##bits##_load_key_enc(&keys[1], &ctr);                           \
+    for (size_t i = 0; i < SIV_MSGS; i++) {                                                                       \
+        const size_t len = siv_len(i), n = siv_num_aad(i);                                                        \
+        for (size_t j = 0; j < n; j++) lens[i][j] = (i * 11 + j * 13) % 41;                                       \
+        for (size_t j = 0; j < SIV_MAX; j++) siv_plain[i][j] = (uint8_t) (i * 31 + j * 7);                        \
+        siv_ref##bits(&mac, &ctr, siv_comps, lens[i], n, siv_plain[i], siv_ref[i], len, sivs[i]);                 \
+        memset(siv_out[i], 0xAA, SIV_MAX);                                                                        \
+        CHECK(aes##bits##_siv_seal(&ctx, siv_comps, lens[i], n, siv_plain[i], siv_out[i], len, siv),              \
+              "SIV-%d message %zu: seal fails", bits, i);                                                         \
+        CHECK_MEM(siv, sivs[i], 16, "SIV-%d message %zu (%zu bytes, %zu aad): siv", bits, i, len, n);             \
+        CHECK_MEM(siv_out[i], siv_ref[i], len, "SIV-%d message %zu (%zu bytes, %zu aad): cipher", bits, i, len, n); \
+        CHECK(aes##bits##_siv_open(&ctx, siv_comps, lens[i], n, siv_out[i], siv_out[i], len, siv),                \
+              "SIV-%d message %zu: in-place open rejects", bits, i);                                              \
+        CHECK_MEM(siv_out[i], siv_plain[i], len, "SIV-%d message %zu: in-place open plain", bits, i);             \
+        memset(siv_out[i], 0xAA, SIV_MAX);                                                                        \
+        msgs[i] = (aes_siv_msg_t) { n ? siv_comps : NULL, lens[i], n, siv_plain[i], siv_out[i], len, { 0 }, false }; \
+    }                                                                                                             \
+    CHECK(aes##bits##_siv_seal_batch(&ctx, msgs, SIV_MSGS), "SIV-%d batch: seal fails", bits);                    \
+    for (size_t i = 0; i < SIV_MSGS; i++) {                                                                       \
+        CHECK_MEM(msgs[i].siv, sivs[i], 16, "SIV-%d batch message %zu: siv", bits, i);                            \
+        CHECK_MEM(siv_out[i], siv_ref[i], msgs[i].len, "SIV-%d batch message %zu: cipher", bits, i);              \
+        CHECK(siv_out[i][msgs[i].len] == 0xAA, "SIV-%d batch message %zu: writes past its end", bits, i);         \
+        msgs[i].in = siv_out[i]; /* open in-place */                                                              \
+    }                                                                                                             \
+    msgs[7].siv[3] ^= 1;                                                                                          \
+    CHECK(!aes##bits##_siv_open_batch(&ctx, msgs, SIV_MSGS), "SIV-%d batch: open accepts a tampered message", bits); \
+    for (size_t i = 0; i < SIV_MSGS; i++) {                                                                       \
+        CHECK(msgs[i].valid == (i != 7), "SIV-%d batch message %zu: open validity", bits, i);                     \
+        if (i != 7) CHECK_MEM(siv_out[i], siv_plain[i], msgs[i].len, "SIV-%d batch message %zu: open plain", bits, i); \
+        else for (size_t j = 0; j < msgs[i].len; j++) CHECK(siv_out[i][j] == 0, "SIV-%d batch: rejected open leaks plain", bits); \
+    }                                                                                                             \
+}
+
+static void test_siv(void) {
+    for (size_t v = 0; v < sizeof(siv128_vectors) / sizeof(siv128_vectors[0]); v++) test_siv_vector(&siv128_vectors[v], v);
+    for (size_t j = 0; j < 3; j++) for (size_t i = 0; i < sizeof(siv_aad[j]); i++) siv_aad[j][i] = (uint8_t) (i * 13 + j);
+    TEST_SIV_REF(128)
+    TEST_SIV_REF(192)
+    TEST_SIV_REF(256)
+    /* 126 components is the limit */
+    static const uint8_t* comps[127]; static size_t lens[127];
+    static aes128_siv_ctx_t ctx; aes128_key_t key = { { 0 } };
+    static aes_siv_msg_t msgs[2];
+    uint8_t buf[16] = { 0 }, siv[16];
+    for (size_t i = 0; i < 127; i++) { comps[i] = siv_aad[i % 3]; lens[i] = i % 40; }
+    aes128_siv_init(&ctx, &key, &key);
+    CHECK(aes128_siv_seal(&ctx, comps, lens, 126, buf, buf, 16, siv), "SIV-128: seal rejects 126 aad components");
+    CHECK(aes128_siv_open(&ctx, comps, lens, 126, buf, buf, 16, siv), "SIV-128: open rejects 126 aad components");
+    CHECK(!aes128_siv_seal(&ctx, comps, lens, 127, buf, buf, 16, siv), "SIV-128: seal accepts 127 aad components");
+    msgs[0] = (aes_siv_msg_t) { comps, lens, 126, buf, buf, 16, { 0 }, false };
+    msgs[1] = (aes_siv_msg_t) { comps, lens, 127, buf, buf, 16, { 0 }, false };
+    CHECK(!aes128_siv_seal_batch(&ctx, msgs, 2), "SIV-128: batch seal accepts 127 aad components");
+    CHECK(aes128_siv_seal_batch(&ctx, msgs, 1), "SIV-128: batch seal rejects 126 aad components");
+    CHECK(!aes128_siv_open_batch(&ctx, msgs, 2) && msgs[0].valid && !msgs[1].valid,
+          "SIV-128: batch open with 127 aad components");
+}
+
+static void siv_dispatch_update(void) {
+    aes_dispatch_update();
+    aes_modes_dispatch_update();
+}
+
+int main(void) {
+    test_tiers(siv_dispatch_update, test_siv);
+    return test_report("aes_siv_tests");
+}
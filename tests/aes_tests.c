@@ -1,47 +1,132 @@
+/* AES known answer tests (FIPS-197 Appendix A key expansions, Appendix B & C ciphers)
+ * & schedule layout round trips (enc / dec / batched loaders against the full schedule,
+ * enc layout decryption of 1-33 blocks against the full schedule).
+ * Every backend tier the CPU has is forced in turn (c, ssse3, aesni, vaes256, vaes512),
+ * both AES-NI key expansion engines run on the aesni & vaes tiers.
+ */
+// Build: gcc -O2 -Iinclude src/*.c tests/aes_tests.c -o aes_tests (returns non-zero on failure)
+
 #include "aes.h"
+#include "test_common.h"
 
-/* Self test return cases
- *   0: no error
- *   1: encryption failed
- *   2: decryption failed
- *   3: both failed
- */
-int aes128_self_test(void) {
-    uint8_t plain[] = { 0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34 };
-    uint8_t enc_key[] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
-    uint8_t cipher[] = { 0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb, 0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32 };
-    uint8_t computed_cipher[16];
-    uint8_t computed_plain[16];
-    int out = 0;
-    __m128i key_schedule[20];
-    aes128_load_key(enc_key, key_schedule);
-    aes128_enc(key_schedule, plain, computed_cipher);
-    aes128_dec(key_schedule, cipher, computed_plain);
-    if (memcmp(cipher, computed_cipher, sizeof(cipher))) out = 1;
-    if (memcmp(plain, computed_plain, sizeof(plain))) out |= 2;
-    return out;
+#define TEST_BLOCKS 37 /* 4 passes of 8 + 4 + 1: every width of the block pipelines & an odd VAES pair tail */
+
+/* FIPS-197 vectors: expansion key & last round key (Appendix A), then cipher key, plain & cipher (B & C) */
+typedef struct { const char *exp_key, *last_rk, *key, *plain, *cipher; } aes_vector_t;
+static const aes_vector_t aes128_vectors[] = {
+    { "2b7e151628aed2a6abf7158809cf4f3c", "d014f9a8c9ee2589e13f0cc8b6630ca6",
+      "2b7e151628aed2a6abf7158809cf4f3c", "3243f6a8885a308d313198a2e0370734", "3925841d02dc09fbdc118597196a0b32" },
+    { "2b7e151628aed2a6abf7158809cf4f3c", "d014f9a8c9ee2589e13f0cc8b6630ca6",
+      "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a" },
+};
+static const aes_vector_t aes192_vectors[] = {
+    { "8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b", "e98ba06f448c773c8ecc720401002202",
+      "000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff", "dda97ca4864cdfe06eaf70a0ec0d7191" },
+};
+static const aes_vector_t aes256_vectors[] = {
+    { "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4", "fe4890d1e6188d0b046df344706c631e",
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff", "8ea2b7ca516745bfeafc49904b496089" },
+};
+
+/* One key size: last round key of the enc & full layouts, then single & bulk transforms */
+#define TEST_KEY_SIZE(bits, rounds) {                                                                             \
+    for (size_t v = 0; v < sizeof(aes##bits##_vectors) / sizeof(aes##bits##_vectors[0]); v++) {                  \
+        const aes_vector_t* tv = &aes##bits##_vectors[v];                                                         \
+        aes##bits##_key_t key; aes##bits##_sched_full_t full; aes##bits##_sched_enc_t enc;                        \
+        uint8_t rk[16], plain[16], cipher[16], out[16];                                                           \
+        unhex(tv->exp_key, key.bytes); unhex(tv->last_rk, rk);                                                    \
+        aes##bits##_load_key(&key, &full); aes##bits##_load_key_enc(&key, &enc);                                  \
+        CHECK_MEM(full.bytes + 16 * rounds, rk, 16, "AES-%d %s: full schedule round key %d", bits, engine, rounds); \
+        CHECK_MEM(enc.bytes + 16 * rounds, rk, 16, "AES-%d %s: enc schedule round key %d", bits, engine, rounds);   \
+        unhex(tv->key, key.bytes); unhex(tv->plain, plain); unhex(tv->cipher, cipher);                            \
+        aes##bits##_load_key(&key, &full); aes##bits##_load_key_enc(&key, &enc);                                  \
+        aes##bits##_encrypt_block(&enc, plain, out);                                                              \
+        CHECK_MEM(out, cipher, 16, "AES-%d %s: vector %zu encrypt_block", bits, engine, v);                       \
+        aes##bits##_decrypt_block(&full, cipher, out);                                                            \
+        CHECK_MEM(out, plain, 16, "AES-%d %s: vector %zu decrypt_block", bits, engine, v);                        \
+        for (size_t i = 0; i < TEST_BLOCKS; i++) memcpy(blocks[i], plain, 16);                                    \
+        aes##bits##_encrypt_blocks(&enc, (const uint8_t (*)[16]) blocks, blocks, TEST_BLOCKS);                    \
+        for (size_t i = 0; i < TEST_BLOCKS; i++)                                                                  \
+            CHECK_MEM(blocks[i], cipher, 16, "AES-%d %s: vector %zu encrypt_blocks block %zu", bits, engine, v, i); \
+        aes##bits##_decrypt_blocks(&full, (const uint8_t (*)[16]) blocks, blocks, TEST_BLOCKS);                   \
+        for (size_t i = 0; i < TEST_BLOCKS; i++)                                                                  \
+            CHECK_MEM(blocks[i], plain, 16, "AES-%d %s: vector %zu decrypt_blocks block %zu", bits, engine, v, i); \
+    }                                                                                                             \
 }
 
-#ifdef TESTING_AES
+static uint8_t blocks[TEST_BLOCKS][16];
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>     //for memcmp
+static void test_fips197(void) {
+    const _Bool detected = _hardware.aeskga;
+    for (int e = 0; e < 2; e++) {
+        /* AES-NI key expansion engines (aesenclast needs SSSE3), the fallback tiers have one */
+        if (e && !(_hardware.aes && _hardware.ssse3)) break;
+        _hardware.aeskga = e ? !detected : detected; aes_dispatch_update();
+        const char* engine = !_hardware.aes ? "soft" : _hardware.ssse3 && !_hardware.aeskga ? "aesenclast" : "aeskeygenassist";
+        TEST_KEY_SIZE(128, 10)
+        TEST_KEY_SIZE(192, 12)
+        TEST_KEY_SIZE(256, 14)
+    }
+    _hardware.aeskga = detected; aes_dispatch_update();
+}
 
-int main() {
-    uint8_t input[16]; memset(input, 0, 16); input[0] = 'A';
-    uint8_t output[16];
-    uint8_t keyText[16] = "This is my key.";
+#define TEST_KEYS 13 /* batched loaders: lanes of 8 + 4 + 1 */
+#define TEST_DEC_ENC_BLOCKS 33 /* enc layout decryption: every block count up to 2 full passes & a lone block */
 
-    __m128i key[20];
+/* One key size: each layout (single & batched loaders) against the full schedule over TEST_BLOCKS blocks */
+#define TEST_LAYOUTS(bits) {                                                                                      \
+    static aes##bits##_key_t keys[TEST_KEYS];                                                                     \
+    static aes##bits##_sched_full_t full[TEST_KEYS], fulls[TEST_KEYS];                                            \
+    static aes##bits##_sched_enc_t enc[TEST_KEYS], encs[TEST_KEYS];                                               \
+    static aes##bits##_sched_dec_t dec[TEST_KEYS], decs[TEST_KEYS];                                               \
+    for (size_t i = 0; i < sizeof(keys); i++) ((uint8_t*) keys)[i] = (uint8_t) (i * 73 + bits);                   \
+    for (size_t k = 0; k < TEST_KEYS; k++) {                                                                      \
+        aes##bits##_load_key(&keys[k], &full[k]);                                                                 \
+        aes##bits##_load_key_enc(&keys[k], &enc[k]);                                                              \
+        aes##bits##_load_key_dec(&keys[k], &dec[k]);                                                              \
+    }                                                                                                             \
+    aes##bits##_load_keys(keys, fulls, TEST_KEYS);                                                                \
+    aes##bits##_load_keys_enc(keys, encs, TEST_KEYS);                                                             \
+    aes##bits##_load_keys_dec(keys, decs, TEST_KEYS);                                                             \
+    CHECK_MEM(fulls, full, sizeof(full), "AES-%d: load_keys != load_key", bits);                                  \
+    CHECK_MEM(encs, enc, sizeof(enc), "AES-%d: load_keys_enc != load_key_enc", bits);                             \
+    CHECK_MEM(decs, dec, sizeof(dec), "AES-%d: load_keys_dec != load_key_dec", bits);                             \
+    CHECK_MEM(enc, full, sizeof(enc[0]), "AES-%d: enc layout != full schedule head", bits);                       \
+    for (size_t k = 0; k < TEST_KEYS; k++) {                                                                      \
+        const aes##bits##_sched_enc_t* head = (const aes##bits##_sched_enc_t*) &full[k];                          \
+        aes##bits##_encrypt_blocks(head, (const uint8_t (*)[16]) plain, cipher, TEST_BLOCKS);                     \
+        aes##bits##_encrypt_blocks(&enc[k], (const uint8_t (*)[16]) plain, blocks, TEST_BLOCKS);                  \
+        CHECK_MEM(blocks, cipher, sizeof(blocks), "AES-%d key %zu: encrypt with enc layout", bits, k);            \
+        aes##bits##_decrypt_blocks(&full[k], (const uint8_t (*)[16]) cipher, blocks, TEST_BLOCKS);                \
+        CHECK_MEM(blocks, plain, sizeof(blocks), "AES-%d key %zu: decrypt with full layout", bits, k);            \
+        aes##bits##_decrypt_blocks_dec(&dec[k], (const uint8_t (*)[16]) cipher, blocks, TEST_BLOCKS);             \
+        CHECK_MEM(blocks, plain, sizeof(blocks), "AES-%d key %zu: decrypt with dec layout", bits, k);             \
+        aes##bits##_decrypt_block_dec(&dec[k], cipher[0], blocks[0]);                                             \
+        CHECK_MEM(blocks[0], plain[0], 16, "AES-%d key %zu: decrypt_block with dec layout", bits, k);             \
+        memcpy(blocks, cipher, sizeof(blocks));                                                                   \
+        aes##bits##_decrypt_blocks_dec(&dec[k], (const uint8_t (*)[16]) blocks, blocks, TEST_BLOCKS);             \
+        CHECK_MEM(blocks, plain, sizeof(blocks), "AES-%d key %zu: in-place decrypt with dec layout", bits, k);    \
+        for (size_t n = 1; n <= TEST_DEC_ENC_BLOCKS; n++) {                                                       \
+            aes##bits##_decrypt_blocks(&full[k], (const uint8_t (*)[16]) cipher, ref, n);                         \
+            aes##bits##_decrypt_blocks_enc(&enc[k], (const uint8_t (*)[16]) cipher, blocks, n);                   \
+            CHECK_MEM(blocks, ref, 16 * n, "AES-%d key %zu: decrypt %zu blocks with enc layout", bits, k, n);     \
+        }                                                                                                         \
+        aes##bits##_decrypt_block_enc(&enc[k], cipher[0], blocks[0]);                                             \
+        CHECK_MEM(blocks[0], plain[0], 16, "AES-%d key %zu: decrypt_block with enc layout", bits, k);             \
+    }                                                                                                             \
+}
 
-    aes128_load_key(keyText, key);
-    aes128_enc(key, input, output);
+static uint8_t plain[TEST_BLOCKS][16], cipher[TEST_BLOCKS][16], ref[TEST_BLOCKS][16];
 
-    for (unsigned int i = 0; i < 16; i++)
-        printf("%02X", output[i]);
+static void test_layouts(void) {
+    for (size_t i = 0; i < sizeof(plain); i++) ((uint8_t*) plain)[i] = (uint8_t) (i * 29 + 1);
+    TEST_LAYOUTS(128)
+    TEST_LAYOUTS(192)
+    TEST_LAYOUTS(256)
+}
 
-    getchar();
-    return 0;
+int main(void) {
+    test_tiers(aes_dispatch_update, test_fips197);
+    test_tiers(aes_dispatch_update, test_layouts);
+    return test_report("aes_tests");
 }
-#endif
@@ -0,0 +1,75 @@
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+/* Shared helpers for the known answer tests: hex vectors, failure checks & backend tier forcing
+ * Tiers are forced by toggling _hardware & re-picking backends (static non-CRYPTOCORE_ASSUME builds,
+ * ifunc & CRYPTOCORE_ASSUME_* builds run every pass on their one backend) */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "common.h"
+
+static int test_failures = 0;
+static const char* test_tier = "default";
+
+/* Record a failed check (printf style context), never aborts so every vector reports */
+#define CHECK(cond, ...) do {                                  \
+    if (!(cond)) {                                             \
+        test_failures++;                                       \
+        printf("FAIL [%s] ", test_tier); printf(__VA_ARGS__); \
+        printf("\n");                                          \
+    }                                                          \
+} while (0)
+#define CHECK_MEM(a, b, len, ...) CHECK(memcmp((a), (b), (len)) == 0, __VA_ARGS__)
+
+/* Hex string to bytes, returns the byte count (vectors are written as in their documents) */
+static size_t unhex(const char* hex, uint8_t* out) {
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2) {
+        unsigned int byte;
+        sscanf(hex, "%2x", &byte);
+        out[n++] = (uint8_t) byte;
+    }
+    return n;
+}
+
+/* Backend tiers in dispatch order (highest last) */
+#define TEST_TIERS 5
+static const char* const test_tier_names[TEST_TIERS] = { "c", "ssse3", "aesni", "vaes256", "vaes512" };
+
+/* Flags for tier t from the detected ones, false if the CPU lacks it */
+static bool test_tier_flags(const hardware_t* detected, int t, hardware_t* hw) {
+    *hw = *detected;
+    hw->ssse3   = t >= 1;
+    hw->aes     = t >= 2;
+    hw->pclmul  = t >= 2 && detected->pclmul;
+    hw->vaes    = t >= 3;
+    hw->vaes512 = t >= 4;
+    hw->vpclmul = t >= 4 && detected->vpclmul;
+    return (!hw->ssse3 || detected->ssse3) && (!hw->aes || detected->aes) &&
+           (!hw->vaes || detected->vaes) && (!hw->vaes512 || detected->vaes512);
+}
+
+/* Run body once per tier the CPU has (update calls the tested modules' *_dispatch_update), then restore */
+static void test_tiers(void (*update)(void), void (*body)(void)) {
+    const hardware_t detected = _hardware;
+    for (int t = 0; t < TEST_TIERS; t++) {
+        hardware_t hw;
+        if (!test_tier_flags(&detected, t, &hw)) continue;
+        _hardware = hw; update();
+        test_tier = test_tier_names[t];
+        body();
+    }
+    _hardware = detected; update();
+    test_tier = "default";
+}
+
+/* Summary line & exit status */
+static int test_report(const char* name) {
+    printf("%s: %s (%d failed checks)\n", name, test_failures ? "FAIL" : "PASS", test_failures);
+    return test_failures != 0;
+}
+
+#endif // TEST_COMMON_H